@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Adaptive busy-poll statistics
+ */
+
+#include <string.h>
+#include <ufprog/bits.h>
+#include <ufprog/busy_poll.h>
+
+/* Minimum samples required before delaying the first poll */
+#define BUSY_POLL_MIN_SAMPLES			4
+
+/* Halve the histogram once this many samples are collected */
+#define BUSY_POLL_DECAY_SAMPLES			64
+
+/* Percentile of completion time used as the initial delay */
+#define BUSY_POLL_DELAY_PERCENTILE		10
+
+/* Polls expected between the initial delay and the average completion time */
+#define BUSY_POLL_INTERVAL_DIV			8
+
+void UFPROG_API busy_poll_stat_reset(struct busy_poll_stat *stat)
+{
+	if (stat)
+		memset(stat, 0, sizeof(*stat));
+}
+
+void UFPROG_API busy_poll_stat_add(struct busy_poll_stat *stat, uint64_t us)
+{
+	uint32_t i, bucket;
+
+	if (!stat)
+		return;
+
+	if (stat->samples >= BUSY_POLL_DECAY_SAMPLES) {
+		stat->samples = 0;
+
+		for (i = 0; i < BUSY_POLL_HIST_BUCKETS; i++) {
+			stat->hist[i] >>= 1;
+			stat->samples += stat->hist[i];
+		}
+
+		stat->total_us >>= 1;
+	}
+
+	bucket = us ? fls64(us) - 1 : 0;
+	if (bucket >= BUSY_POLL_HIST_BUCKETS)
+		bucket = BUSY_POLL_HIST_BUCKETS - 1;
+
+	stat->hist[bucket]++;
+	stat->samples++;
+	stat->total_us += us;
+}
+
+void UFPROG_API busy_poll_stat_info(const struct busy_poll_stat *stat, uint32_t rtt_us, struct busy_poll_info *info)
+{
+	uint32_t i, threshold, cumulative = 0, delay = 0;
+
+	memset(info, 0, sizeof(*info));
+
+	if (!stat || !stat->samples)
+		return;
+
+	info->samples = stat->samples;
+	info->avg_us = (uint32_t)(stat->total_us / stat->samples);
+
+	if (stat->samples < BUSY_POLL_MIN_SAMPLES)
+		return;
+
+	threshold = (stat->samples * BUSY_POLL_DELAY_PERCENTILE + 99) / 100;
+
+	for (i = 0; i < BUSY_POLL_HIST_BUCKETS; i++) {
+		cumulative += stat->hist[i];
+		if (cumulative >= threshold) {
+			/* Lower edge of the bucket never exceeds any sample in it */
+			delay = i ? 1U << i : 0;
+			break;
+		}
+	}
+
+	/* The first status read itself takes one round-trip */
+	if (delay > rtt_us)
+		info->initial_delay_us = delay - rtt_us;
+
+	if (info->avg_us > delay) {
+		info->interval_us = (info->avg_us - delay) / BUSY_POLL_INTERVAL_DIV;
+
+		/* Back-to-back polling is already paced by the round-trip time */
+		if (info->interval_us <= rtt_us)
+			info->interval_us = 0;
+	}
+}
+
+void UFPROG_API busy_poll_rtt_update(uint32_t *rtt_us, uint64_t sample_us)
+{
+	if (sample_us > UINT32_MAX)
+		sample_us = UINT32_MAX;
+
+	if (!*rtt_us)
+		*rtt_us = (uint32_t)sample_us;
+	else
+		*rtt_us = (uint32_t)((*rtt_us * 7ULL + sample_us) / 8);
+}
@@ -8,8 +8,11 @@
 #include <stdbool.h>
 #include <ufprog/crc32.h>
 
-static uint32_t crc32_reflected_table[CRC32_TABLE_NUM_ENTRIES];
-static uint32_t crc32_normal_table[CRC32_TABLE_NUM_ENTRIES];
+#define CRC32_SLICES			8
+
+/* Slice-by-8 tables. The first slice is the classic byte-wise table */
+static uint32_t crc32_reflected_table[CRC32_SLICES][CRC32_TABLE_NUM_ENTRIES];
+static uint32_t crc32_normal_table[CRC32_SLICES][CRC32_TABLE_NUM_ENTRIES];
 
 /* Reflected */
 uint32_t crc32_reflected_cal(uint32_t crc, const void *data, size_t length, const uint32_t *crc32_table)
@@ -61,15 +64,75 @@ void crc32_normal_init(uint32_t *crc32_table, uint32_t poly)
 	}
 }
 
-/* Default polynomial calculation */
+/* Default polynomial calculation using slice-by-8 */
 uint32_t crc32_no_comp(uint32_t crc, const void *data, size_t length)
 {
-	return crc32_reflected_cal(crc, data, length, crc32_reflected_table);
+	const uint32_t (*t)[CRC32_TABLE_NUM_ENTRIES] = crc32_reflected_table;
+	const uint8_t *buf = (const uint8_t *)data;
+	uint32_t lo, hi;
+
+	while (length && ((uintptr_t)buf & (CRC32_SLICES - 1))) {
+		crc = t[0][(uint8_t)(crc ^ *buf++)] ^ (crc >> 8);
+		length--;
+	}
+
+	while (length >= CRC32_SLICES) {
+		lo = crc ^ ((uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) |
+			    ((uint32_t)buf[3] << 24));
+		hi = (uint32_t)buf[4] | ((uint32_t)buf[5] << 8) | ((uint32_t)buf[6] << 16) | ((uint32_t)buf[7] << 24);
+
+		crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+		      t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+
+		buf += CRC32_SLICES;
+		length -= CRC32_SLICES;
+	}
+
+	return crc32_reflected_cal(crc, buf, length, t[0]);
 }
 
 uint32_t crc32_be_no_comp(uint32_t crc, const void *data, size_t length)
 {
-	return crc32_normal_cal(crc, data, length, crc32_normal_table);
+	const uint32_t (*t)[CRC32_TABLE_NUM_ENTRIES] = crc32_normal_table;
+	const uint8_t *buf = (const uint8_t *)data;
+	uint32_t hi, lo;
+
+	while (length && ((uintptr_t)buf & (CRC32_SLICES - 1))) {
+		crc = t[0][(uint8_t)((crc >> 24) ^ *buf++)] ^ (crc << 8);
+		length--;
+	}
+
+	while (length >= CRC32_SLICES) {
+		hi = crc ^ (((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) |
+			    (uint32_t)buf[3]);
+		lo = ((uint32_t)buf[4] << 24) | ((uint32_t)buf[5] << 16) | ((uint32_t)buf[6] << 8) | (uint32_t)buf[7];
+
+		crc = t[7][hi >> 24] ^ t[6][(hi >> 16) & 0xff] ^ t[5][(hi >> 8) & 0xff] ^ t[4][hi & 0xff] ^
+		      t[3][lo >> 24] ^ t[2][(lo >> 16) & 0xff] ^ t[1][(lo >> 8) & 0xff] ^ t[0][lo & 0xff];
+
+		buf += CRC32_SLICES;
+		length -= CRC32_SLICES;
+	}
+
+	return crc32_normal_cal(crc, buf, length, t[0]);
+}
+
+static void crc32_make_slices(uint32_t (*t)[CRC32_TABLE_NUM_ENTRIES], bool reflected)
+{
+	uint32_t i, j, v;
+
+	for (i = 0; i < CRC32_TABLE_NUM_ENTRIES; i++) {
+		v = t[0][i];
+
+		for (j = 1; j < CRC32_SLICES; j++) {
+			if (reflected)
+				v = (v >> 8) ^ t[0][v & 0xff];
+			else
+				v = (v << 8) ^ t[0][v >> 24];
+
+			t[j][i] = v;
+		}
+	}
 }
 
 void make_crc_table(void)
@@ -79,8 +142,11 @@ void make_crc_table(void)
 	if (init)
 		return;
 
-	crc32_reflected_init(crc32_reflected_table, CRC32_REFLECTED_POLYNOMIAL);
-	crc32_normal_init(crc32_normal_table, CRC32_NORMAL_POLYNOMIAL);
+	crc32_reflected_init(crc32_reflected_table[0], CRC32_REFLECTED_POLYNOMIAL);
+	crc32_normal_init(crc32_normal_table[0], CRC32_NORMAL_POLYNOMIAL);
+
+	crc32_make_slices(crc32_reflected_table, true);
+	crc32_make_slices(crc32_normal_table, false);
 
 	init = true;
 }
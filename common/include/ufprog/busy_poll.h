@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Adaptive busy-poll statistics
+ */
+#pragma once
+
+#ifndef _UFPROG_BUSY_POLL_H_
+#define _UFPROG_BUSY_POLL_H_
+
+#include <stdint.h>
+#include <ufprog/common.h>
+
+EXTERN_C_BEGIN
+
+/* Histogram bucket n holds completion times in [2^n, 2^(n+1)) us */
+#define BUSY_POLL_HIST_BUCKETS			32
+
+struct busy_poll_stat {
+	uint32_t hist[BUSY_POLL_HIST_BUCKETS];
+	uint32_t samples;
+	uint64_t total_us;
+};
+
+struct busy_poll_info {
+	uint32_t samples;
+	uint32_t avg_us;
+	uint32_t initial_delay_us;
+	uint32_t interval_us;
+};
+
+void UFPROG_API busy_poll_stat_reset(struct busy_poll_stat *stat);
+void UFPROG_API busy_poll_stat_add(struct busy_poll_stat *stat, uint64_t us);
+void UFPROG_API busy_poll_stat_info(const struct busy_poll_stat *stat, uint32_t rtt_us, struct busy_poll_info *info);
+
+void UFPROG_API busy_poll_rtt_update(uint32_t *rtt_us, uint64_t sample_us);
+
+EXTERN_C_END
+
+#endif /* _UFPROG_BUSY_POLL_H_ */
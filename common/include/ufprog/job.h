@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Asynchronous job queue
+ */
+#pragma once
+
+#ifndef _UFPROG_JOB_H_
+#define _UFPROG_JOB_H_
+
+#include <stdint.h>
+#include <ufprog/common.h>
+
+EXTERN_C_BEGIN
+
+/*
+ * A job queue owns a small pool of worker threads which run submitted jobs synchronously, usually one queue per
+ * device. Progress and completion are never reported from worker threads. Instead the notify handle of the queue
+ * becomes signaled, and callbacks are invoked by ufprog_job_queue_dispatch() in the thread calling it. The notify
+ * handle is a file descriptor which becomes readable on POSIX, and an event HANDLE on Windows.
+ */
+struct ufprog_job_queue;
+struct ufprog_job;
+
+enum ufprog_job_op {
+	UFPROG_JOB_READ,
+	UFPROG_JOB_WRITE,
+	UFPROG_JOB_ERASE,
+	UFPROG_JOB_VERIFY,
+
+	__MAX_UFPROG_JOB_OP
+};
+
+/* Called in worker thread. Should check ufprog_job_cancelled() periodically. */
+typedef ufprog_status (UFPROG_API *ufprog_job_fn)(struct ufprog_job *job, void *priv);
+typedef void (UFPROG_API *ufprog_job_free_fn)(void *priv);
+
+typedef void (UFPROG_API *ufprog_job_progress_cb)(void *priv, struct ufprog_job *job, uint64_t done, uint64_t total);
+typedef void (UFPROG_API *ufprog_job_complete_cb)(void *priv, struct ufprog_job *job, ufprog_status result);
+
+struct ufprog_job_callbacks {
+	ufprog_job_progress_cb progress;
+	ufprog_job_complete_cb complete;
+	void *priv;
+};
+
+ufprog_status UFPROG_API ufprog_job_queue_create(uint32_t workers, struct ufprog_job_queue **outq);
+ufprog_status UFPROG_API ufprog_job_queue_destroy(struct ufprog_job_queue *q);
+uintptr_t UFPROG_API ufprog_job_queue_notify_handle(struct ufprog_job_queue *q);
+uint32_t UFPROG_API ufprog_job_queue_workers(struct ufprog_job_queue *q);
+uint32_t UFPROG_API ufprog_job_queue_dispatch(struct ufprog_job_queue *q);
+
+ufprog_status UFPROG_API ufprog_job_submit(struct ufprog_job_queue *q, ufprog_job_fn run, ufprog_job_free_fn free_priv,
+					   void *priv, const struct ufprog_job_callbacks *cbs,
+					   struct ufprog_job **outjob);
+ufprog_status UFPROG_API ufprog_job_cancel(struct ufprog_job *job);
+void UFPROG_API ufprog_job_release(struct ufprog_job *job);
+
+ufprog_bool UFPROG_API ufprog_job_cancelled(struct ufprog_job *job);
+void UFPROG_API ufprog_job_report_progress(struct ufprog_job *job, uint64_t done, uint64_t total);
+
+EXTERN_C_END
+
+#endif /* _UFPROG_JOB_H_ */
@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Checkpoint journal for resumable long-running operations
+ */
+#pragma once
+
+#ifndef _UFPROG_JOURNAL_H_
+#define _UFPROG_JOURNAL_H_
+
+#include <stdint.h>
+#include <ufprog/common.h>
+#include <ufprog/sha256.h>
+
+EXTERN_C_BEGIN
+
+#define UFPROG_JOURNAL_CHIP_ID_LEN		128
+#define UFPROG_JOURNAL_SYNC_INTERVAL_US		1000000
+
+/* Phase value reserved for a completed operation */
+#define UFPROG_JOURNAL_PHASE_DONE		0xffffffff
+
+enum ufprog_journal_op {
+	JOURNAL_OP_READ,
+	JOURNAL_OP_WRITE,
+	JOURNAL_OP_ERASE,
+};
+
+/*
+ * Everything which must be identical for a journal to be resumed.
+ * Meaning of start/size/flags and of checkpoint positions is defined by the caller.
+ */
+struct ufprog_journal_info {
+	uint32_t op;
+	uint32_t flags;
+	uint64_t start;
+	uint64_t size;
+	char chip_id[UFPROG_JOURNAL_CHIP_ID_LEN];
+	uint8_t image_digest[SHA256_DIGEST_SIZE];
+};
+
+struct ufprog_journal;
+
+ufprog_status UFPROG_API ufprog_journal_open(const char *path, const struct ufprog_journal_info *info,
+					     ufprog_bool resume, struct ufprog_journal **outjnl, uint32_t *retphase,
+					     uint64_t *retpos);
+ufprog_status UFPROG_API ufprog_journal_checkpoint(struct ufprog_journal *jnl, uint32_t phase, uint64_t pos);
+ufprog_status UFPROG_API ufprog_journal_sync(struct ufprog_journal *jnl);
+void UFPROG_API ufprog_journal_close(struct ufprog_journal *jnl);
+
+EXTERN_C_END
+
+#endif /* _UFPROG_JOURNAL_H_ */
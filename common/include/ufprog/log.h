@@ -28,10 +28,16 @@ typedef enum log_level {
 
 #define DEFAULT_LOG_LEVEL			LOG_INFO
 
+/* Messages below this level are compiled out */
+#ifndef UFP_LOG_MIN_LEVEL
+#define UFP_LOG_MIN_LEVEL			LOG_DEBUG
+#endif
+
 struct log_data {
 	uint32_t /* log_level */ level;
 	const char *module;
 	const char *body;
+	uint64_t time_us;	/* Time since asynchronous logging started, or 0 if not recorded */
 };
 
 /* Application should set the log print callback to their own implementation */
@@ -41,6 +47,14 @@ ufprog_status UFPROG_API set_log_print_cb(void *priv, log_print_t fn);
 
 /* Useful functions provided by this library */
 uint32_t /* log_level */ UFPROG_API set_log_print_level(uint32_t /* log_level */ level);
+ufprog_bool UFPROG_API log_level_enabled(uint32_t /* log_level */ level);
+
+/*
+ * Queue messages into a ring buffer printed by a background thread.
+ * log_async_stop() waits for other threads still posting messages, then drains the ring.
+ */
+ufprog_status UFPROG_API log_async_start(void);
+void UFPROG_API log_async_stop(void);
 
 ufprog_status UFPROG_API log_print(uint32_t /* log_level */ level, const char *module, const char *text);
 ufprog_status UFPROG_API log_vprintf(uint32_t /* log_level */ level, const char *module, const char *fmt, va_list args);
@@ -49,20 +63,25 @@ ufprog_status log_printf(uint32_t /* log_level */ level, const char *module, con
 typedef void (UFPROG_API *console_print_t)(void *priv, uint32_t /* log_level */ level, const char *text);
 ufprog_status UFPROG_API default_console_log(const struct log_data *data, void *priv, console_print_t cprint);
 
-#define log_dbg(...)		log_printf(LOG_DEBUG, NULL, __VA_ARGS__)
-#define log_errdbg(...)		log_printf(LOG_ERR_DEBUG, NULL, __VA_ARGS__)
-#define log_notice(...)		log_printf(LOG_NOTICE, NULL, __VA_ARGS__)
-#define log_info(...)		log_printf(LOG_INFO, NULL, __VA_ARGS__)
-#define log_warn(...)		log_printf(LOG_WARN, NULL, __VA_ARGS__)
-#define log_err(...)		log_printf(LOG_ERR, NULL, __VA_ARGS__)
+/* Level is checked before any argument is evaluated */
+#define log_enabled(_level)	((_level) >= UFP_LOG_MIN_LEVEL && log_level_enabled(_level))
+#define log_gated(_level, _module, ...)	\
+	(log_enabled(_level) ? log_printf(_level, _module, __VA_ARGS__) : UFP_OK)
+
+#define log_dbg(...)		log_gated(LOG_DEBUG, NULL, __VA_ARGS__)
+#define log_errdbg(...)		log_gated(LOG_ERR_DEBUG, NULL, __VA_ARGS__)
+#define log_notice(...)		log_gated(LOG_NOTICE, NULL, __VA_ARGS__)
+#define log_info(...)		log_gated(LOG_INFO, NULL, __VA_ARGS__)
+#define log_warn(...)		log_gated(LOG_WARN, NULL, __VA_ARGS__)
+#define log_err(...)		log_gated(LOG_ERR, NULL, __VA_ARGS__)
 
 #ifdef UFP_MODULE_NAME
-#define logm_dbg(...)		log_printf(LOG_DEBUG, UFP_MODULE_NAME, __VA_ARGS__)
-#define logm_errdbg(...)	log_printf(LOG_ERR_DEBUG, UFP_MODULE_NAME, __VA_ARGS__)
-#define logm_notice(...)	log_printf(LOG_NOTICE, UFP_MODULE_NAME, __VA_ARGS__)
-#define logm_info(...)		log_printf(LOG_INFO, UFP_MODULE_NAME, __VA_ARGS__)
-#define logm_warn(...)		log_printf(LOG_WARN, UFP_MODULE_NAME, __VA_ARGS__)
-#define logm_err(...)		log_printf(LOG_ERR, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_dbg(...)		log_gated(LOG_DEBUG, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_errdbg(...)	log_gated(LOG_ERR_DEBUG, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_notice(...)	log_gated(LOG_NOTICE, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_info(...)		log_gated(LOG_INFO, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_warn(...)		log_gated(LOG_WARN, UFP_MODULE_NAME, __VA_ARGS__)
+#define logm_err(...)		log_gated(LOG_ERR, UFP_MODULE_NAME, __VA_ARGS__)
 #else
 #define logm_dbg		log_dbg
 #define logm_errdbg		log_errdbg
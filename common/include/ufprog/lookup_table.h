@@ -9,25 +9,42 @@
 #ifndef _UFPROG_LOOKUP_TABLE_
 #define _UFPROG_LOOKUP_TABLE_
 
+#include <stdint.h>
 #include <ufprog/common.h>
 
 EXTERN_C_BEGIN
 
+/*
+ * A table can hold string keys and integer/pointer keys at the same time. String keys are copied into the table on
+ * insertion. Inserting an existing key replaces its value.
+ *
+ * Entries are enumerated in insertion order. The callback may delete any entry, including the current one, and may
+ * insert new entries, which will also be enumerated. Key passed to lookup_table_enum() callback is NULL for
+ * integer/pointer keys.
+ */
 struct ufprog_lookup_table;
 
 typedef int (UFPROG_API *ufprog_lookup_table_entry_cb)(void *priv, struct ufprog_lookup_table *tbl, const char *key,
 						       void *ptr);
+typedef int (UFPROG_API *ufprog_lookup_table_int_entry_cb)(void *priv, struct ufprog_lookup_table *tbl, uintptr_t key,
+							   void *ptr);
 
 ufprog_status UFPROG_API lookup_table_create(struct ufprog_lookup_table **outtbl, uint32_t init_size);
 ufprog_status UFPROG_API lookup_table_destroy(struct ufprog_lookup_table *tbl);
 ufprog_status UFPROG_API lookup_table_insert(struct ufprog_lookup_table *tbl, const char *key, const void *ptr);
+ufprog_status UFPROG_API lookup_table_insert_int(struct ufprog_lookup_table *tbl, uintptr_t key, const void *ptr);
 ufprog_status UFPROG_API lookup_table_insert_ptr(struct ufprog_lookup_table *tbl, const void *ptr);
 ufprog_status UFPROG_API lookup_table_delete(struct ufprog_lookup_table *tbl, const char *key);
+ufprog_status UFPROG_API lookup_table_delete_int(struct ufprog_lookup_table *tbl, uintptr_t key);
 ufprog_status UFPROG_API lookup_table_delete_ptr(struct ufprog_lookup_table *tbl, const void *ptr);
 ufprog_bool UFPROG_API lookup_table_find(struct ufprog_lookup_table *tbl, const char *key, void **retptr);
+ufprog_bool UFPROG_API lookup_table_find_int(struct ufprog_lookup_table *tbl, uintptr_t key, void **retptr);
+ufprog_bool UFPROG_API lookup_table_find_ptr(struct ufprog_lookup_table *tbl, const void *ptr);
 uint32_t UFPROG_API lookup_table_length(struct ufprog_lookup_table *tbl);
 ufprog_status UFPROG_API lookup_table_enum(struct ufprog_lookup_table *tbl, ufprog_lookup_table_entry_cb cb,
 					   void *priv);
+ufprog_status UFPROG_API lookup_table_enum_int(struct ufprog_lookup_table *tbl, ufprog_lookup_table_int_entry_cb cb,
+					       void *priv);
 
 EXTERN_C_END
 
@@ -9,16 +9,29 @@
 #ifndef _UFPROG_MISC_H_
 #define _UFPROG_MISC_H_
 
+#include <stdint.h>
 #include <ufprog/common.h>
 
 EXTERN_C_BEGIN
 
 char *UFPROG_API bin_to_hex_str(char *buf, size_t bufsize, const void *data, size_t datasize, ufprog_bool space,
 				ufprog_bool uppercase);
+ufprog_bool UFPROG_API hex_str_to_bin(const char *str, void *buf, size_t bufsize, size_t *retlen);
 
 ufprog_status UFPROG_API read_file_contents(const char *filename, void **outdata, size_t *retsize);
 ufprog_status UFPROG_API write_file_contents(const char *filename, const void *data, size_t len, ufprog_bool create);
 
+/* Counter-based PRNG (SplitMix64). Any value of the sequence can be regenerated from its index. */
+static inline uint64_t splitmix64(uint64_t seed, uint64_t index)
+{
+	uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return z ^ (z >> 31);
+}
+
 EXTERN_C_END
 
 #endif /* _UFPROG_MISC_H_ */
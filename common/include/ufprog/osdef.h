@@ -80,9 +80,33 @@ ufprog_bool UFPROG_API os_free_mutex(mutex_handle mutex);
 ufprog_bool UFPROG_API os_mutex_lock(mutex_handle mutex);
 ufprog_bool UFPROG_API os_mutex_unlock(mutex_handle mutex);
 
+/* Thread */
+typedef struct os_thread_handle *thread_handle;
+typedef void (UFPROG_API *os_thread_fn)(void *priv);
+ufprog_bool UFPROG_API os_create_thread(thread_handle *outthread, os_thread_fn fn, void *priv);
+ufprog_bool UFPROG_API os_join_thread(thread_handle thread);
+
+/* Auto-reset event */
+#define OS_WAIT_INFINITE		UINT32_MAX
+
+typedef struct os_event_handle *event_handle;
+ufprog_bool UFPROG_API os_create_event(event_handle *outevent);
+ufprog_bool UFPROG_API os_free_event(event_handle event);
+ufprog_bool UFPROG_API os_set_event(event_handle event);
+ufprog_bool UFPROG_API os_wait_event(event_handle event, uint32_t timeout_ms);
+
+/* Manual-reset notifier which can be waited by poll()/select() (fd) or WaitForMultipleObjects() (HANDLE) */
+typedef struct os_notifier_handle *notifier_handle;
+ufprog_bool UFPROG_API os_create_notifier(notifier_handle *outnotifier);
+ufprog_bool UFPROG_API os_free_notifier(notifier_handle notifier);
+ufprog_bool UFPROG_API os_notify(notifier_handle notifier);
+ufprog_bool UFPROG_API os_clear_notifier(notifier_handle notifier);
+uintptr_t UFPROG_API os_get_notifier_native_handle(notifier_handle notifier);
+
 /* High-resolution timer */
 uint64_t UFPROG_API os_get_timer_us(void);
 void UFPROG_API os_udelay(uint64_t us);
+void UFPROG_API os_usleep(uint64_t us);
 
 /* Module related */
 typedef struct os_module_handle *module_handle;
@@ -119,12 +143,14 @@ ufprog_bool UFPROG_API os_enum_file(const char *dir, ufprog_bool recursive, void
 ufprog_status UFPROG_API os_open_file(const char *file, ufprog_bool read, ufprog_bool write, ufprog_bool trunc,
 				      ufprog_bool create, file_handle *outhandle);
 ufprog_bool UFPROG_API os_close_file(file_handle handle);
+ufprog_status UFPROG_API os_delete_file(const char *file);
 ufprog_bool UFPROG_API os_get_file_size(file_handle handle, uint64_t *retval);
 ufprog_bool UFPROG_API os_set_file_pointer(file_handle handle, enum os_file_seek_method method, uint64_t distance,
 					   uint64_t *retpointer);
 ufprog_bool UFPROG_API os_set_end_of_file(file_handle handle);
 ufprog_bool UFPROG_API os_read_file(file_handle handle, size_t len, void *buf, size_t *retlen);
 ufprog_bool UFPROG_API os_write_file(file_handle handle, size_t len, const void *buf, size_t *retlen);
+ufprog_bool UFPROG_API os_flush_file(file_handle handle);
 
 ufprog_status UFPROG_API os_open_file_mapping(const char *file, uint64_t size, size_t mapsize, ufprog_bool write,
 					      ufprog_bool trunc, file_mapping *outmapping);
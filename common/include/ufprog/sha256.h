@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SHA-256 message digest helpers
+ */
+#pragma once
+
+#ifndef _UFPROG_SHA256_H_
+#define _UFPROG_SHA256_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ufprog/common.h>
+
+EXTERN_C_BEGIN
+
+#define SHA256_BLOCK_SIZE		64
+#define SHA256_DIGEST_SIZE		32
+
+struct sha256_context {
+	uint32_t state[8];
+	uint64_t length;
+	uint32_t buflen;
+	uint8_t buf[SHA256_BLOCK_SIZE];
+};
+
+void UFPROG_API sha256_init(struct sha256_context *ctx);
+void UFPROG_API sha256_update(struct sha256_context *ctx, const void *data, size_t length);
+void UFPROG_API sha256_final(struct sha256_context *ctx, uint8_t *digest);
+
+static inline void sha256(const void *data, size_t length, uint8_t *digest)
+{
+	struct sha256_context ctx;
+
+	sha256_init(&ctx);
+	sha256_update(&ctx, data, length);
+	sha256_final(&ctx, digest);
+}
+
+EXTERN_C_END
+
+#endif /* _UFPROG_SHA256_H_ */
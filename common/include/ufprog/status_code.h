@@ -20,6 +20,7 @@ enum ufprog_status {
 	UFP_ALREADY_EXIST,
 	UFP_NOT_EXIST,
 	UFP_TIMEOUT,
+	UFP_CANCELLED,
 
 	UFP_LOCK_FAIL = 100,
 
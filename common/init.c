@@ -7,10 +7,12 @@
 
 #include <stdlib.h>
 #include "crc32.h"
+#include "sha256.h"
 
 static int ufprog_common_init(void)
 {
 	make_crc_table();
+	sha256_probe_hw();
 
 	return 0;
 }
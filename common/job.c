@@ -0,0 +1,463 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Asynchronous job queue
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ufprog/job.h>
+#include <ufprog/osdef.h>
+#include <ufprog/log.h>
+
+#define JOB_QUEUE_MAX_WORKERS			16
+
+enum job_state {
+	JOB_QUEUED,
+	JOB_RUNNING,
+	JOB_DONE,
+	JOB_DISPATCHED,
+};
+
+struct ufprog_job {
+	struct ufprog_job_queue *q;
+	struct ufprog_job *next;		/* Link in pending list */
+	struct ufprog_job *event_next;		/* Link in event list */
+
+	ufprog_job_fn run;
+	ufprog_job_free_fn free_priv;
+	void *priv;
+	struct ufprog_job_callbacks cbs;
+
+	uint32_t refcnt;
+	enum job_state state;
+	ufprog_status result;
+	bool cancel;
+
+	bool event_queued;
+	bool progress_pending;
+	uint64_t done;
+	uint64_t total;
+};
+
+struct ufprog_job_queue {
+	mutex_handle lock;
+	event_handle wake;
+	notifier_handle notifier;
+
+	thread_handle workers[JOB_QUEUE_MAX_WORKERS];
+	uint32_t nworkers;
+
+	struct ufprog_job *pending_head, *pending_tail;
+	struct ufprog_job *event_head, *event_tail;
+
+	uint32_t refcnt;
+	bool stopping;
+};
+
+static void job_queue_free(struct ufprog_job_queue *q)
+{
+	if (q->notifier)
+		os_free_notifier(q->notifier);
+
+	if (q->wake)
+		os_free_event(q->wake);
+
+	if (q->lock)
+		os_free_mutex(q->lock);
+
+	free(q);
+}
+
+static void job_queue_put(struct ufprog_job_queue *q)
+{
+	bool last;
+
+	os_mutex_lock(q->lock);
+	last = !--q->refcnt;
+	os_mutex_unlock(q->lock);
+
+	if (last)
+		job_queue_free(q);
+}
+
+static void job_put(struct ufprog_job *job)
+{
+	struct ufprog_job_queue *q = job->q;
+	bool last;
+
+	os_mutex_lock(q->lock);
+	last = !--job->refcnt;
+	os_mutex_unlock(q->lock);
+
+	if (!last)
+		return;
+
+	if (job->free_priv)
+		job->free_priv(job->priv);
+
+	free(job);
+
+	job_queue_put(q);
+}
+
+/* Must be called with queue locked. Returns true if the notifier needs to be signaled. */
+static bool job_queue_event(struct ufprog_job *job)
+{
+	struct ufprog_job_queue *q = job->q;
+
+	if (job->event_queued)
+		return false;
+
+	job->event_queued = true;
+	job->event_next = NULL;
+
+	if (q->event_tail)
+		q->event_tail->event_next = job;
+	else
+		q->event_head = job;
+
+	q->event_tail = job;
+
+	return true;
+}
+
+static void UFPROG_API job_worker(void *priv)
+{
+	struct ufprog_job_queue *q = priv;
+	struct ufprog_job *job;
+	ufprog_status ret;
+	bool notify;
+
+	while (true) {
+		os_mutex_lock(q->lock);
+
+		while (!q->stopping && !q->pending_head) {
+			os_mutex_unlock(q->lock);
+			os_wait_event(q->wake, OS_WAIT_INFINITE);
+			os_mutex_lock(q->lock);
+		}
+
+		if (q->stopping) {
+			os_mutex_unlock(q->lock);
+
+			/* The event is auto-reset. Pass the wakeup on to the next worker. */
+			os_set_event(q->wake);
+			break;
+		}
+
+		job = q->pending_head;
+		q->pending_head = job->next;
+		if (!q->pending_head)
+			q->pending_tail = NULL;
+
+		job->state = JOB_RUNNING;
+
+		if (q->pending_head)
+			os_set_event(q->wake);
+
+		os_mutex_unlock(q->lock);
+
+		ret = job->run(job, job->priv);
+
+		os_mutex_lock(q->lock);
+		job->state = JOB_DONE;
+		job->result = ret;
+		notify = job_queue_event(job);
+		os_mutex_unlock(q->lock);
+
+		if (notify)
+			os_notify(q->notifier);
+	}
+}
+
+ufprog_status UFPROG_API ufprog_job_queue_create(uint32_t workers, struct ufprog_job_queue **outq)
+{
+	struct ufprog_job_queue *q;
+
+	if (!outq)
+		return UFP_INVALID_PARAMETER;
+
+	if (!workers)
+		workers = 1;
+	else if (workers > JOB_QUEUE_MAX_WORKERS)
+		workers = JOB_QUEUE_MAX_WORKERS;
+
+	q = calloc(1, sizeof(*q));
+	if (!q) {
+		log_err("No memory for job queue\n");
+		return UFP_NOMEM;
+	}
+
+	if (!os_create_mutex(&q->lock) || !os_create_event(&q->wake) || !os_create_notifier(&q->notifier)) {
+		log_err("Failed to create synchronization objects for job queue\n");
+		job_queue_free(q);
+		return UFP_FAIL;
+	}
+
+	q->refcnt = 1;
+
+	for (q->nworkers = 0; q->nworkers < workers; q->nworkers++) {
+		if (!os_create_thread(&q->workers[q->nworkers], job_worker, q)) {
+			log_err("Failed to create worker thread for job queue\n");
+			ufprog_job_queue_destroy(q);
+			return UFP_FAIL;
+		}
+	}
+
+	*outq = q;
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_job_queue_destroy(struct ufprog_job_queue *q)
+{
+	struct ufprog_job *job;
+	uint32_t i;
+
+	if (!q)
+		return UFP_INVALID_PARAMETER;
+
+	os_mutex_lock(q->lock);
+
+	q->stopping = true;
+
+	/* Jobs not yet started are completed as cancelled. Running jobs will see ufprog_job_cancelled() return true. */
+	while (q->pending_head) {
+		job = q->pending_head;
+		q->pending_head = job->next;
+
+		job->state = JOB_DONE;
+		job->result = UFP_CANCELLED;
+		job_queue_event(job);
+	}
+
+	q->pending_tail = NULL;
+
+	os_mutex_unlock(q->lock);
+
+	os_set_event(q->wake);
+
+	for (i = 0; i < q->nworkers; i++)
+		os_join_thread(q->workers[i]);
+
+	q->nworkers = 0;
+
+	/* Deliver remaining completions so that every job gets its completion callback */
+	ufprog_job_queue_dispatch(q);
+
+	job_queue_put(q);
+
+	return UFP_OK;
+}
+
+uintptr_t UFPROG_API ufprog_job_queue_notify_handle(struct ufprog_job_queue *q)
+{
+	if (!q)
+		return (uintptr_t)-1;
+
+	return os_get_notifier_native_handle(q->notifier);
+}
+
+uint32_t UFPROG_API ufprog_job_queue_workers(struct ufprog_job_queue *q)
+{
+	if (!q)
+		return 0;
+
+	return q->nworkers;
+}
+
+uint32_t UFPROG_API ufprog_job_queue_dispatch(struct ufprog_job_queue *q)
+{
+	struct ufprog_job *job, *next;
+	uint32_t completed = 0;
+	bool progress, done;
+	uint64_t pdone, ptotal;
+
+	if (!q)
+		return 0;
+
+	/* Clear first. Events queued after taking the list will signal the notifier again. */
+	os_clear_notifier(q->notifier);
+
+	os_mutex_lock(q->lock);
+	job = q->event_head;
+	q->event_head = q->event_tail = NULL;
+	os_mutex_unlock(q->lock);
+
+	while (job) {
+		os_mutex_lock(q->lock);
+
+		next = job->event_next;
+		job->event_queued = false;
+
+		progress = job->progress_pending;
+		job->progress_pending = false;
+		pdone = job->done;
+		ptotal = job->total;
+
+		done = job->state == JOB_DONE;
+		if (done)
+			job->state = JOB_DISPATCHED;
+
+		os_mutex_unlock(q->lock);
+
+		/* Callbacks are invoked without lock held, so they may submit or cancel jobs */
+		if (progress && job->cbs.progress)
+			job->cbs.progress(job->cbs.priv, job, pdone, ptotal);
+
+		if (done) {
+			if (job->cbs.complete)
+				job->cbs.complete(job->cbs.priv, job, job->result);
+
+			completed++;
+
+			/* Drop the reference held by the queue */
+			job_put(job);
+		}
+
+		job = next;
+	}
+
+	return completed;
+}
+
+ufprog_status UFPROG_API ufprog_job_submit(struct ufprog_job_queue *q, ufprog_job_fn run, ufprog_job_free_fn free_priv,
+					   void *priv, const struct ufprog_job_callbacks *cbs,
+					   struct ufprog_job **outjob)
+{
+	struct ufprog_job *job;
+
+	if (!q || !run)
+		return UFP_INVALID_PARAMETER;
+
+	job = calloc(1, sizeof(*job));
+	if (!job) {
+		log_err("No memory for job\n");
+		return UFP_NOMEM;
+	}
+
+	job->q = q;
+	job->run = run;
+	job->free_priv = free_priv;
+	job->priv = priv;
+	job->state = JOB_QUEUED;
+	job->refcnt = outjob ? 2 : 1;
+
+	if (cbs)
+		memcpy(&job->cbs, cbs, sizeof(*cbs));
+
+	os_mutex_lock(q->lock);
+
+	if (q->stopping) {
+		os_mutex_unlock(q->lock);
+		free(job);
+		return UFP_FAIL;
+	}
+
+	q->refcnt++;
+
+	if (q->pending_tail)
+		q->pending_tail->next = job;
+	else
+		q->pending_head = job;
+
+	q->pending_tail = job;
+
+	os_mutex_unlock(q->lock);
+
+	os_set_event(q->wake);
+
+	if (outjob)
+		*outjob = job;
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_job_cancel(struct ufprog_job *job)
+{
+	struct ufprog_job *p, *prev = NULL;
+	struct ufprog_job_queue *q;
+	ufprog_status ret = UFP_OK;
+	bool notify = false;
+
+	if (!job)
+		return UFP_INVALID_PARAMETER;
+
+	q = job->q;
+
+	os_mutex_lock(q->lock);
+
+	switch (job->state) {
+	case JOB_QUEUED:
+		for (p = q->pending_head; p != job; p = p->next)
+			prev = p;
+
+		if (prev)
+			prev->next = job->next;
+		else
+			q->pending_head = job->next;
+
+		if (q->pending_tail == job)
+			q->pending_tail = prev;
+
+		job->state = JOB_DONE;
+		job->result = UFP_CANCELLED;
+		notify = job_queue_event(job);
+		break;
+
+	case JOB_RUNNING:
+		job->cancel = true;
+		break;
+
+	default:
+		ret = UFP_FAIL;
+	}
+
+	os_mutex_unlock(q->lock);
+
+	if (notify)
+		os_notify(q->notifier);
+
+	return ret;
+}
+
+void UFPROG_API ufprog_job_release(struct ufprog_job *job)
+{
+	if (job)
+		job_put(job);
+}
+
+ufprog_bool UFPROG_API ufprog_job_cancelled(struct ufprog_job *job)
+{
+	ufprog_bool ret;
+
+	if (!job)
+		return false;
+
+	os_mutex_lock(job->q->lock);
+	ret = job->cancel || job->q->stopping;
+	os_mutex_unlock(job->q->lock);
+
+	return ret;
+}
+
+void UFPROG_API ufprog_job_report_progress(struct ufprog_job *job, uint64_t done, uint64_t total)
+{
+	bool notify;
+
+	if (!job)
+		return;
+
+	os_mutex_lock(job->q->lock);
+	job->done = done;
+	job->total = total;
+	job->progress_pending = true;
+	notify = job_queue_event(job);
+	os_mutex_unlock(job->q->lock);
+
+	if (notify)
+		os_notify(job->q->notifier);
+}
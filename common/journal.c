@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Checkpoint journal for resumable long-running operations
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <ufprog/crc32.h>
+#include <ufprog/endian.h>
+#include <ufprog/journal.h>
+#include <ufprog/osdef.h>
+#include <ufprog/log.h>
+
+#define JOURNAL_MAGIC				0x4a504655	/* UFPJ */
+#define JOURNAL_RECORD_MAGIC			0x52504655	/* UFPR */
+#define JOURNAL_VERSION				1
+
+/* All fields are little-endian */
+struct journal_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t op;
+	uint32_t flags;
+	uint64_t start;
+	uint64_t size;
+	char chip_id[UFPROG_JOURNAL_CHIP_ID_LEN];
+	uint8_t image_digest[SHA256_DIGEST_SIZE];
+	uint32_t reserved;
+	uint32_t crc;
+};
+
+struct journal_record {
+	uint32_t magic;
+	uint32_t phase;
+	uint64_t pos;
+	uint32_t reserved;
+	uint32_t crc;
+};
+
+struct ufprog_journal {
+	file_handle file;
+	uint64_t last_sync_time;
+	ufprog_bool dirty;
+};
+
+static void journal_fill_header(struct journal_header *hdr, const struct ufprog_journal_info *info)
+{
+	memset(hdr, 0, sizeof(*hdr));
+
+	hdr->magic = htole32(JOURNAL_MAGIC);
+	hdr->version = htole32(JOURNAL_VERSION);
+	hdr->op = htole32(info->op);
+	hdr->flags = htole32(info->flags);
+	hdr->start = htole64(info->start);
+	hdr->size = htole64(info->size);
+	memcpy(hdr->chip_id, info->chip_id, sizeof(hdr->chip_id));
+	hdr->chip_id[sizeof(hdr->chip_id) - 1] = 0;
+	memcpy(hdr->image_digest, info->image_digest, sizeof(hdr->image_digest));
+	hdr->crc = htole32(crc32(0, hdr, offsetof(struct journal_header, crc)));
+}
+
+static ufprog_status journal_check_header(const struct journal_header *hdr, const struct journal_header *expected)
+{
+	if (hdr->magic != expected->magic || hdr->version != expected->version ||
+	    le32toh(hdr->crc) != crc32(0, hdr, offsetof(struct journal_header, crc))) {
+		log_err("Journal header is invalid\n");
+		return UFP_FILE_READ_FAILURE;
+	}
+
+	if (memcmp(hdr->chip_id, expected->chip_id, sizeof(hdr->chip_id))) {
+		log_err("Journal was recorded for a different flash chip (%.*s)\n", (int)sizeof(hdr->chip_id),
+			hdr->chip_id);
+		return UFP_FAIL;
+	}
+
+	if (hdr->op != expected->op || hdr->flags != expected->flags || hdr->start != expected->start ||
+	    hdr->size != expected->size) {
+		log_err("Journal was recorded for a different operation or range\n");
+		return UFP_FAIL;
+	}
+
+	if (memcmp(hdr->image_digest, expected->image_digest, sizeof(hdr->image_digest))) {
+		log_err("Journal was recorded for a different image\n");
+		return UFP_FAIL;
+	}
+
+	return UFP_OK;
+}
+
+static bool journal_record_valid(const struct journal_record *rec)
+{
+	if (le32toh(rec->magic) != JOURNAL_RECORD_MAGIC)
+		return false;
+
+	return le32toh(rec->crc) == crc32(0, rec, offsetof(struct journal_record, crc));
+}
+
+static ufprog_status journal_create(struct ufprog_journal *jnl, const struct journal_header *hdr)
+{
+	if (!os_set_file_pointer(jnl->file, FILE_SEEK_BEGIN, 0, NULL) || !os_set_end_of_file(jnl->file))
+		return UFP_FILE_WRITE_FAILURE;
+
+	if (!os_write_file(jnl->file, sizeof(*hdr), hdr, NULL))
+		return UFP_FILE_WRITE_FAILURE;
+
+	jnl->dirty = true;
+
+	return ufprog_journal_sync(jnl);
+}
+
+static ufprog_status journal_load(struct ufprog_journal *jnl, const struct journal_header *expected,
+				  uint32_t *retphase, uint64_t *retpos)
+{
+	struct journal_record rec;
+	struct journal_header hdr;
+	uint64_t size, i, nrecs;
+	ufprog_status ret;
+
+	if (!os_get_file_size(jnl->file, &size))
+		return UFP_FILE_READ_FAILURE;
+
+	if (size < sizeof(hdr)) {
+		log_info("No usable journal found. Operation will start from the beginning\n");
+		return journal_create(jnl, expected);
+	}
+
+	if (!os_read_file(jnl->file, sizeof(hdr), &hdr, NULL))
+		return UFP_FILE_READ_FAILURE;
+
+	ret = journal_check_header(&hdr, expected);
+	if (ret)
+		return ret;
+
+	/* Take the last intact record. A torn record at the tail is discarded. */
+	nrecs = (size - sizeof(hdr)) / sizeof(rec);
+
+	for (i = 0; i < nrecs; i++) {
+		if (!os_read_file(jnl->file, sizeof(rec), &rec, NULL))
+			return UFP_FILE_READ_FAILURE;
+
+		if (!journal_record_valid(&rec))
+			break;
+
+		*retphase = le32toh(rec.phase);
+		*retpos = le64toh(rec.pos);
+	}
+
+	if (!os_set_file_pointer(jnl->file, FILE_SEEK_BEGIN, sizeof(hdr) + i * sizeof(rec), NULL) ||
+	    !os_set_end_of_file(jnl->file))
+		return UFP_FILE_WRITE_FAILURE;
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_journal_open(const char *path, const struct ufprog_journal_info *info,
+					     ufprog_bool resume, struct ufprog_journal **outjnl, uint32_t *retphase,
+					     uint64_t *retpos)
+{
+	struct ufprog_journal *jnl;
+	struct journal_header hdr;
+	ufprog_status ret;
+
+	if (!path || !info || !outjnl || !retphase || !retpos)
+		return UFP_INVALID_PARAMETER;
+
+	*retphase = 0;
+	*retpos = 0;
+
+	jnl = calloc(1, sizeof(*jnl));
+	if (!jnl) {
+		log_err("No memory for journal\n");
+		return UFP_NOMEM;
+	}
+
+	ret = os_open_file(path, true, true, false, true, &jnl->file);
+	if (ret) {
+		free(jnl);
+		return ret;
+	}
+
+	journal_fill_header(&hdr, info);
+
+	if (resume)
+		ret = journal_load(jnl, &hdr, retphase, retpos);
+	else
+		ret = journal_create(jnl, &hdr);
+
+	if (ret) {
+		os_close_file(jnl->file);
+		free(jnl);
+		return ret;
+	}
+
+	jnl->last_sync_time = os_get_timer_us();
+	*outjnl = jnl;
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_journal_checkpoint(struct ufprog_journal *jnl, uint32_t phase, uint64_t pos)
+{
+	struct journal_record rec;
+
+	if (!jnl)
+		return UFP_INVALID_PARAMETER;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = htole32(JOURNAL_RECORD_MAGIC);
+	rec.phase = htole32(phase);
+	rec.pos = htole64(pos);
+	rec.crc = htole32(crc32(0, &rec, offsetof(struct journal_record, crc)));
+
+	if (!os_write_file(jnl->file, sizeof(rec), &rec, NULL))
+		return UFP_FILE_WRITE_FAILURE;
+
+	jnl->dirty = true;
+
+	/* Records reach the OS immediately. Only pay for flushing to disk periodically. */
+	if (phase == UFPROG_JOURNAL_PHASE_DONE ||
+	    os_get_timer_us() - jnl->last_sync_time >= UFPROG_JOURNAL_SYNC_INTERVAL_US)
+		return ufprog_journal_sync(jnl);
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_journal_sync(struct ufprog_journal *jnl)
+{
+	if (!jnl)
+		return UFP_INVALID_PARAMETER;
+
+	if (!jnl->dirty)
+		return UFP_OK;
+
+	if (!os_flush_file(jnl->file))
+		return UFP_FILE_WRITE_FAILURE;
+
+	jnl->dirty = false;
+	jnl->last_sync_time = os_get_timer_us();
+
+	return UFP_OK;
+}
+
+void UFPROG_API ufprog_journal_close(struct ufprog_journal *jnl)
+{
+	if (!jnl)
+		return;
+
+	ufprog_journal_sync(jnl);
+	os_close_file(jnl->file);
+	free(jnl);
+}
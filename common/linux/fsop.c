@@ -302,6 +302,25 @@ ufprog_bool UFPROG_API os_close_file(file_handle handle)
 	return true;
 }
 
+ufprog_status UFPROG_API os_delete_file(const char *file)
+{
+	int err;
+
+	if (!file)
+		return UFP_INVALID_PARAMETER;
+
+	if (unlink(file) < 0) {
+		err = errno;
+		if (err == ENOENT)
+			return UFP_FILE_NOT_EXIST;
+
+		log_err("unlink() for '%s' failed with %u: %s\n", file, err, strerror(err));
+		return UFP_FAIL;
+	}
+
+	return UFP_OK;
+}
+
 ufprog_bool UFPROG_API os_get_file_size(file_handle handle, uint64_t *retval)
 {
 	struct stat st;
@@ -469,6 +488,22 @@ ufprog_bool UFPROG_API os_write_file(file_handle handle, size_t len, const void
 	return ret;
 }
 
+ufprog_bool UFPROG_API os_flush_file(file_handle handle)
+{
+	int err;
+
+	if (!handle)
+		return false;
+
+	if (fsync(handle->fd) < 0) {
+		err = errno;
+		log_err("fsync() for '%s' failed with %u: %s\n", handle->path, err, strerror(err));
+		return false;
+	}
+
+	return true;
+}
+
 ufprog_status UFPROG_API os_open_file_mapping(const char *file, uint64_t size, size_t mapsize, ufprog_bool write,
 					      ufprog_bool trunc, file_mapping *outmapping)
 {
@@ -18,6 +18,7 @@
 #include <pwd.h>
 #include <pthread.h>
 #include <sys/types.h>
+#include <sys/eventfd.h>
 #include <ufprog/log.h>
 #include <ufprog/dirs.h>
 #include <ufprog/misc.h>
@@ -535,6 +536,251 @@ ufprog_bool UFPROG_API os_mutex_unlock(mutex_handle mutex)
 	return false;
 }
 
+struct os_thread {
+	pthread_t thread;
+	os_thread_fn fn;
+	void *priv;
+};
+
+static void *os_thread_entry(void *arg)
+{
+	struct os_thread *t = arg;
+
+	t->fn(t->priv);
+
+	return NULL;
+}
+
+ufprog_bool UFPROG_API os_create_thread(thread_handle *outthread, os_thread_fn fn, void *priv)
+{
+	struct os_thread *t;
+	int err;
+
+	if (!outthread || !fn)
+		return false;
+
+	t = malloc(sizeof(*t));
+	if (!t) {
+		log_err("No memory for thread object\n");
+		return false;
+	}
+
+	t->fn = fn;
+	t->priv = priv;
+
+	err = pthread_create(&t->thread, NULL, os_thread_entry, t);
+	if (err) {
+		log_err("pthread_create() failed with %u: %s\n", err, strerror(err));
+		free(t);
+		return false;
+	}
+
+	*outthread = (thread_handle)t;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_join_thread(thread_handle thread)
+{
+	struct os_thread *t = (struct os_thread *)thread;
+	int err;
+
+	if (!t)
+		return false;
+
+	err = pthread_join(t->thread, NULL);
+	if (err)
+		log_err("pthread_join() failed with %u: %s\n", err, strerror(err));
+
+	free(t);
+
+	return err ? false : true;
+}
+
+struct os_event {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool signaled;
+};
+
+ufprog_bool UFPROG_API os_create_event(event_handle *outevent)
+{
+	struct os_event *ev;
+	int err;
+
+	if (!outevent)
+		return false;
+
+	ev = calloc(1, sizeof(*ev));
+	if (!ev) {
+		log_err("No memory for event object\n");
+		return false;
+	}
+
+	err = pthread_mutex_init(&ev->lock, NULL);
+	if (err) {
+		log_err("pthread_mutex_init() failed with %u: %s\n", err, strerror(err));
+		free(ev);
+		return false;
+	}
+
+	err = pthread_cond_init(&ev->cond, NULL);
+	if (err) {
+		log_err("pthread_cond_init() failed with %u: %s\n", err, strerror(err));
+		pthread_mutex_destroy(&ev->lock);
+		free(ev);
+		return false;
+	}
+
+	*outevent = (event_handle)ev;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_free_event(event_handle event)
+{
+	struct os_event *ev = (struct os_event *)event;
+
+	if (!ev)
+		return false;
+
+	pthread_cond_destroy(&ev->cond);
+	pthread_mutex_destroy(&ev->lock);
+	free(ev);
+
+	return true;
+}
+
+ufprog_bool UFPROG_API os_set_event(event_handle event)
+{
+	struct os_event *ev = (struct os_event *)event;
+
+	if (!ev)
+		return false;
+
+	pthread_mutex_lock(&ev->lock);
+	ev->signaled = true;
+	pthread_cond_signal(&ev->cond);
+	pthread_mutex_unlock(&ev->lock);
+
+	return true;
+}
+
+ufprog_bool UFPROG_API os_wait_event(event_handle event, uint32_t timeout_ms)
+{
+	struct os_event *ev = (struct os_event *)event;
+	struct timespec ts;
+	ufprog_bool ret;
+	int err = 0;
+
+	if (!ev)
+		return false;
+
+	if (timeout_ms != OS_WAIT_INFINITE) {
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += timeout_ms / 1000;
+		ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+		if (ts.tv_nsec >= 1000000000) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000;
+		}
+	}
+
+	pthread_mutex_lock(&ev->lock);
+
+	while (!ev->signaled && err != ETIMEDOUT) {
+		if (timeout_ms == OS_WAIT_INFINITE)
+			err = pthread_cond_wait(&ev->cond, &ev->lock);
+		else
+			err = pthread_cond_timedwait(&ev->cond, &ev->lock, &ts);
+	}
+
+	ret = ev->signaled;
+	ev->signaled = false;
+
+	pthread_mutex_unlock(&ev->lock);
+
+	return ret;
+}
+
+struct os_notifier {
+	int fd;
+};
+
+ufprog_bool UFPROG_API os_create_notifier(notifier_handle *outnotifier)
+{
+	struct os_notifier *n;
+
+	if (!outnotifier)
+		return false;
+
+	n = malloc(sizeof(*n));
+	if (!n) {
+		log_err("No memory for notifier object\n");
+		return false;
+	}
+
+	n->fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (n->fd < 0) {
+		log_err("eventfd() failed with %u: %s\n", errno, strerror(errno));
+		free(n);
+		return false;
+	}
+
+	*outnotifier = (notifier_handle)n;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_free_notifier(notifier_handle notifier)
+{
+	struct os_notifier *n = (struct os_notifier *)notifier;
+
+	if (!n)
+		return false;
+
+	close(n->fd);
+	free(n);
+
+	return true;
+}
+
+ufprog_bool UFPROG_API os_notify(notifier_handle notifier)
+{
+	struct os_notifier *n = (struct os_notifier *)notifier;
+	uint64_t val = 1;
+
+	if (!n)
+		return false;
+
+	/* Only fails with EAGAIN if the counter is about to overflow, which still leaves it signaled */
+	if (write(n->fd, &val, sizeof(val)) < 0 && errno != EAGAIN)
+		return false;
+
+	return true;
+}
+
+ufprog_bool UFPROG_API os_clear_notifier(notifier_handle notifier)
+{
+	struct os_notifier *n = (struct os_notifier *)notifier;
+	uint64_t val;
+
+	if (!n)
+		return false;
+
+	if (read(n->fd, &val, sizeof(val)) < 0 && errno != EAGAIN)
+		return false;
+
+	return true;
+}
+
+uintptr_t UFPROG_API os_get_notifier_native_handle(notifier_handle notifier)
+{
+	struct os_notifier *n = (struct os_notifier *)notifier;
+
+	if (!n)
+		return (uintptr_t)-1;
+
+	return (uintptr_t)n->fd;
+}
+
 static inline uint64_t get_timer_us(void)
 {
 	struct timespec t;
@@ -560,6 +806,17 @@ void UFPROG_API os_udelay(uint64_t us)
 		;
 }
 
+void UFPROG_API os_usleep(uint64_t us)
+{
+	struct timespec t;
+
+	t.tv_sec = us / 1000000;
+	t.tv_nsec = (us % 1000000) * 1000;
+
+	while (nanosleep(&t, &t) < 0 && errno == EINTR)
+		;
+}
+
 ufprog_status UFPROG_API os_read_text_file(const char *filename, char **outdata, size_t *retlen)
 {
 	return read_file_contents(filename, (void **)outdata, retlen);
@@ -7,10 +7,63 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <string.h>
 #include <malloc.h>
 #include <ufprog/log.h>
 
+#if defined(_MSC_VER)
+#define LOG_THREAD_LOCAL			__declspec(thread)
+#else
+#define LOG_THREAD_LOCAL			__thread
+#endif
+
+/* Messages fitting in this buffer are formatted without heap allocation */
+#define LOG_FMT_BUF_SIZE			1024
+
+#define LOG_ASYNC_RING_SIZE			256
+#define LOG_ASYNC_TEXT_LEN			256
+#define LOG_ASYNC_MODULE_LEN			32
+#define LOG_ASYNC_IDLE_MS			200
+#define LOG_ASYNC_REPEAT_FLUSH_US		1000000
+
+struct log_async_entry {
+	uint32_t level;
+	uint64_t time_us;
+	bool has_module;
+	char module[LOG_ASYNC_MODULE_LEN];
+	char *text;
+	char buf[LOG_ASYNC_TEXT_LEN];
+};
+
+struct log_async_sink {
+	thread_handle thread;
+	mutex_handle lock;
+	event_handle data_event;
+	event_handle space_event;
+	event_handle idle_event;
+	volatile bool stop;
+
+	/* Threads currently posting to this sink. Protected by log_async_ref_lock. */
+	uint32_t users;
+
+	uint64_t start_time;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t dropped;
+
+	/* Identical consecutive messages are counted instead of queued */
+	bool last_valid;
+	uint32_t last_level;
+	bool last_has_module;
+	char last_module[LOG_ASYNC_MODULE_LEN];
+	char last_text[LOG_ASYNC_TEXT_LEN];
+	uint64_t last_time;
+	uint32_t repeats;
+
+	struct log_async_entry ring[LOG_ASYNC_RING_SIZE];
+};
+
 /* Log text prefix */
 static const char *log_prefixes[] = {
 	[LOG_DEBUG] = "(Debug)",
@@ -28,6 +81,15 @@ static uint32_t current_log_level = DEFAULT_LOG_LEVEL;
 static log_print_t log_print_fn;
 static void *log_print_priv;
 
+/* Per-thread formatting buffer */
+static LOG_THREAD_LOCAL char log_fmt_buf[LOG_FMT_BUF_SIZE];
+
+/* Asynchronous sink. NULL if messages are printed synchronously. */
+static struct log_async_sink *log_async;
+
+/* Protects log_async and sink user count. Created by first log_async_start() and never freed. */
+static mutex_handle log_async_ref_lock;
+
 ufprog_status UFPROG_API set_log_print_cb(void *priv, log_print_t fn)
 {
 	if (!fn)
@@ -51,10 +113,319 @@ uint32_t /* log_level */ UFPROG_API set_log_print_level(uint32_t /* log_level */
 	return old_level;
 }
 
-ufprog_status UFPROG_API log_print(uint32_t /* log_level */ level, const char *module, const char *text)
+ufprog_bool UFPROG_API log_level_enabled(uint32_t /* log_level */ level)
+{
+	return log_print_fn && level < __MAX_LOG_LEVEL && level >= current_log_level;
+}
+
+static void log_emit(uint32_t level, const char *module, const char *text, uint64_t time_us)
 {
 	struct log_data ld;
 
+	ld.level = level;
+	ld.module = module;
+	ld.body = text;
+	ld.time_us = time_us;
+
+	log_print_fn(log_print_priv, &ld);
+}
+
+static void log_async_copy_module(char *dst, bool *has_module, const char *module)
+{
+	*has_module = !!module;
+
+	if (module)
+		snprintf(dst, LOG_ASYNC_MODULE_LEN, "%s", module);
+}
+
+/* Must be called with lock held. Lock may be released while waiting for space. */
+static void log_async_enqueue(struct log_async_sink *s, uint32_t level, const char *module, const char *text,
+			      uint64_t time_us)
+{
+	struct log_async_entry *e;
+	size_t len;
+
+	while (s->head - s->tail >= LOG_ASYNC_RING_SIZE) {
+		/* Warnings and errors are never lost, other messages are dropped instead of stalling the caller */
+		if (level < LOG_WARN) {
+			s->dropped++;
+			return;
+		}
+
+		os_mutex_unlock(s->lock);
+		os_set_event(s->data_event);
+		os_wait_event(s->space_event, LOG_ASYNC_IDLE_MS);
+		os_mutex_lock(s->lock);
+	}
+
+	e = &s->ring[s->head % LOG_ASYNC_RING_SIZE];
+
+	e->level = level;
+	e->time_us = time_us;
+	log_async_copy_module(e->module, &e->has_module, module);
+
+	len = strlen(text);
+	if (len < sizeof(e->buf)) {
+		memcpy(e->buf, text, len + 1);
+		e->text = e->buf;
+	} else {
+		e->text = malloc(len + 1);
+		if (!e->text) {
+			s->dropped++;
+			return;
+		}
+
+		memcpy(e->text, text, len + 1);
+	}
+
+	s->head++;
+}
+
+/* Must be called with lock held */
+static void log_async_flush_repeats(struct log_async_sink *s)
+{
+	char text[64];
+
+	if (!s->repeats)
+		return;
+
+	snprintf(text, sizeof(text), "Last message repeated %u time(s)\n", s->repeats);
+	s->repeats = 0;
+
+	log_async_enqueue(s, s->last_level, s->last_has_module ? s->last_module : NULL, text, s->last_time);
+}
+
+static ufprog_status log_async_post(struct log_async_sink *s, uint32_t level, const char *module, const char *text)
+{
+	uint64_t now = os_get_timer_us() - s->start_time;
+	size_t len = strlen(text);
+
+	os_mutex_lock(s->lock);
+
+	if (s->last_valid && s->last_level == level && len < sizeof(s->last_text) &&
+	    s->last_has_module == !!module && (!module || !strncmp(s->last_module, module, LOG_ASYNC_MODULE_LEN - 1)) &&
+	    !strcmp(s->last_text, text)) {
+		s->repeats++;
+		s->last_time = now;
+		os_mutex_unlock(s->lock);
+		return UFP_OK;
+	}
+
+	log_async_flush_repeats(s);
+	log_async_enqueue(s, level, module, text, now);
+
+	s->last_valid = len < sizeof(s->last_text);
+	s->last_level = level;
+	s->last_time = now;
+	log_async_copy_module(s->last_module, &s->last_has_module, module);
+	if (s->last_valid)
+		memcpy(s->last_text, text, len + 1);
+
+	os_mutex_unlock(s->lock);
+
+	os_set_event(s->data_event);
+
+	return UFP_OK;
+}
+
+static void log_async_drain(struct log_async_sink *s)
+{
+	char text[64], repeat_text[64], module[LOG_ASYNC_MODULE_LEN];
+	uint32_t dropped, repeat_level = 0;
+	struct log_async_entry *e;
+	bool has_module = false;
+	uint64_t repeat_time = 0;
+
+	repeat_text[0] = 0;
+
+	os_mutex_lock(s->lock);
+
+	while (s->tail != s->head) {
+		e = &s->ring[s->tail % LOG_ASYNC_RING_SIZE];
+
+		/* The slot is not reused by producers before tail advances */
+		os_mutex_unlock(s->lock);
+
+		log_emit(e->level, e->has_module ? e->module : NULL, e->text, e->time_us);
+
+		if (e->text != e->buf)
+			free(e->text);
+
+		os_mutex_lock(s->lock);
+		s->tail++;
+		os_set_event(s->space_event);
+	}
+
+	/*
+	 * The ring is empty now, so the repeated message has already been printed. The summary is printed directly
+	 * instead of being queued, as this thread must never wait for ring space.
+	 */
+	if (s->repeats && (s->stop || os_get_timer_us() - s->start_time - s->last_time >= LOG_ASYNC_REPEAT_FLUSH_US)) {
+		snprintf(repeat_text, sizeof(repeat_text), "Last message repeated %u time(s)\n", s->repeats);
+		repeat_level = s->last_level;
+		repeat_time = s->last_time;
+		has_module = s->last_has_module;
+		if (has_module)
+			memcpy(module, s->last_module, sizeof(module));
+
+		s->repeats = 0;
+	}
+
+	dropped = s->dropped;
+	s->dropped = 0;
+
+	os_mutex_unlock(s->lock);
+
+	if (repeat_text[0])
+		log_emit(repeat_level, has_module ? module : NULL, repeat_text, repeat_time);
+
+	if (dropped) {
+		snprintf(text, sizeof(text), "%u log message(s) dropped\n", dropped);
+		log_emit(LOG_WARN, NULL, text, os_get_timer_us() - s->start_time);
+	}
+}
+
+static void UFPROG_API log_async_thread(void *priv)
+{
+	struct log_async_sink *s = priv;
+
+	while (!s->stop) {
+		os_wait_event(s->data_event, LOG_ASYNC_IDLE_MS);
+		log_async_drain(s);
+	}
+
+	log_async_drain(s);
+}
+
+static struct log_async_sink *log_async_get(void)
+{
+	struct log_async_sink *s;
+
+	if (!log_async_ref_lock)
+		return NULL;
+
+	os_mutex_lock(log_async_ref_lock);
+	s = log_async;
+	if (s)
+		s->users++;
+	os_mutex_unlock(log_async_ref_lock);
+
+	return s;
+}
+
+static void log_async_put(struct log_async_sink *s)
+{
+	os_mutex_lock(log_async_ref_lock);
+
+	/* Signal with lock held, so that log_async_stop() can not free the sink before this returns */
+	if (!--s->users && log_async != s)
+		os_set_event(s->idle_event);
+
+	os_mutex_unlock(log_async_ref_lock);
+}
+
+ufprog_status UFPROG_API log_async_start(void)
+{
+	struct log_async_sink *s;
+
+	if (log_async)
+		return UFP_OK;
+
+	if (!log_async_ref_lock) {
+		if (!os_create_mutex(&log_async_ref_lock))
+			return UFP_FAIL;
+	}
+
+	s = calloc(1, sizeof(*s));
+	if (!s)
+		return UFP_NOMEM;
+
+	if (!os_create_mutex(&s->lock))
+		goto cleanup;
+
+	if (!os_create_event(&s->data_event))
+		goto cleanup_mutex;
+
+	if (!os_create_event(&s->space_event))
+		goto cleanup_data_event;
+
+	if (!os_create_event(&s->idle_event))
+		goto cleanup_space_event;
+
+	s->start_time = os_get_timer_us();
+
+	if (!os_create_thread(&s->thread, log_async_thread, s))
+		goto cleanup_idle_event;
+
+	os_mutex_lock(log_async_ref_lock);
+	log_async = s;
+	os_mutex_unlock(log_async_ref_lock);
+
+	return UFP_OK;
+
+cleanup_idle_event:
+	os_free_event(s->idle_event);
+
+cleanup_space_event:
+	os_free_event(s->space_event);
+
+cleanup_data_event:
+	os_free_event(s->data_event);
+
+cleanup_mutex:
+	os_free_mutex(s->lock);
+
+cleanup:
+	free(s);
+
+	return UFP_FAIL;
+}
+
+void UFPROG_API log_async_stop(void)
+{
+	struct log_async_sink *s;
+	uint32_t users;
+
+	if (!log_async_ref_lock)
+		return;
+
+	/* Messages logged from now on are printed synchronously */
+	os_mutex_lock(log_async_ref_lock);
+	s = log_async;
+	log_async = NULL;
+	os_mutex_unlock(log_async_ref_lock);
+
+	if (!s)
+		return;
+
+	/* Wait for threads still posting. The drain thread keeps running so that producers waiting for space proceed. */
+	while (true) {
+		os_mutex_lock(log_async_ref_lock);
+		users = s->users;
+		os_mutex_unlock(log_async_ref_lock);
+
+		if (!users)
+			break;
+
+		os_wait_event(s->idle_event, LOG_ASYNC_IDLE_MS);
+	}
+
+	s->stop = true;
+	os_set_event(s->data_event);
+	os_join_thread(s->thread);
+
+	os_free_event(s->idle_event);
+	os_free_event(s->space_event);
+	os_free_event(s->data_event);
+	os_free_mutex(s->lock);
+	free(s);
+}
+
+ufprog_status UFPROG_API log_print(uint32_t /* log_level */ level, const char *module, const char *text)
+{
+	struct log_async_sink *s;
+	ufprog_status ret;
+
 	if (!text)
 		return UFP_OK;
 
@@ -67,11 +438,14 @@ ufprog_status UFPROG_API log_print(uint32_t /* log_level */ level, const char *m
 	if (level < current_log_level)
 		return UFP_OK;
 
-	ld.level = level;
-	ld.module = module;
-	ld.body = text;
+	s = log_async_get();
+	if (s) {
+		ret = log_async_post(s, level, module, text);
+		log_async_put(s);
+		return ret;
+	}
 
-	log_print_fn(log_print_priv, &ld);
+	log_emit(level, module, text, 0);
 
 	return UFP_OK;
 }
@@ -96,13 +470,19 @@ ufprog_status UFPROG_API log_vprintf(uint32_t /* log_level */ level, const char
 		return UFP_OK;
 
 	va_copy(args_cpy, args);
-	len = vsnprintf(NULL, 0, fmt, args);
+	len = vsnprintf(log_fmt_buf, sizeof(log_fmt_buf), fmt, args);
 
 	if (len < 0) {
 		ret = UFP_FAIL;
 		goto out;
 	}
 
+	if ((size_t)len < sizeof(log_fmt_buf)) {
+		ret = log_print(level, module, log_fmt_buf);
+		goto out;
+	}
+
+	/* Oversize message */
 	buf = malloc(len + 1);
 	if (!buf) {
 		ret = UFP_NOMEM;
@@ -118,6 +498,8 @@ ufprog_status UFPROG_API log_vprintf(uint32_t /* log_level */ level, const char
 	ret = log_print(level, module, buf);
 
 out:
+	va_end(args_cpy);
+
 	if (buf)
 		free(buf);
 
@@ -138,7 +520,8 @@ ufprog_status log_printf(uint32_t /* log_level */ level, const char *module, con
 
 ufprog_status UFPROG_API default_console_log(const struct log_data *data, void *priv, console_print_t cprint)
 {
-	size_t len, prefix_len = 0, module_name_len = 0, body_len;
+	size_t len, prefix_len = 0, module_name_len = 0, time_len = 0, body_len;
+	char sbuf[LOG_FMT_BUF_SIZE], tbuf[24];
 	const char *prefix;
 	char *buf, *p;
 
@@ -152,16 +535,30 @@ ufprog_status UFPROG_API default_console_log(const struct log_data *data, void *
 	if (data->module)
 		module_name_len = strlen(data->module) + 2;
 
+	if (data->time_us) {
+		time_len = snprintf(tbuf, sizeof(tbuf), "[%5u.%06u] ", (uint32_t)(data->time_us / 1000000),
+				    (uint32_t)(data->time_us % 1000000));
+	}
+
 	body_len = strlen(data->body);
 
-	len = prefix_len + module_name_len + body_len;
+	len = time_len + prefix_len + module_name_len + body_len;
 
-	buf = malloc(len + 1);
-	if (!buf)
-		return UFP_NOMEM;
+	if (len < sizeof(sbuf)) {
+		buf = sbuf;
+	} else {
+		buf = malloc(len + 1);
+		if (!buf)
+			return UFP_NOMEM;
+	}
 
 	p = buf;
 
+	if (time_len) {
+		memcpy(p, tbuf, time_len);
+		p += time_len;
+	}
+
 	if (prefix_len) {
 		snprintf(p, buf - p + len + 1, "%s ", prefix);
 		p += prefix_len;
@@ -176,7 +573,8 @@ ufprog_status UFPROG_API default_console_log(const struct log_data *data, void *
 
 	cprint(priv, data->level, buf);
 
-	free(buf);
+	if (buf != sbuf)
+		free(buf);
 
 	return UFP_OK;
 }
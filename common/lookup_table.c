@@ -5,16 +5,302 @@
  * Lookup table implementation
  */
 
-#include <stdio.h>
+#include <malloc.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <ufprog/lookup_table.h>
-#include <json-c/linkhash.h>
 
 #define LOOKTABLE_DEFAULT_INIT_SIZE		10
+#define LOOKTABLE_MIN_SLOTS			16
+
+#define LOOKTABLE_SLOT_EMPTY			UINT32_MAX
+#define LOOKTABLE_SLOT_DELETED			(UINT32_MAX - 1)
+
+/*
+ * Entries are kept in insertion order in a dense array. The open-addressing slot array only stores indices of
+ * entries, so probing never moves entries and enumeration is not disturbed by deletion.
+ */
+struct lookup_table_entry {
+	char *key;				/* Owned copy. NULL for integer/pointer keys */
+	uintptr_t ikey;
+	void *ptr;
+	uint32_t hash;
+	bool used;
+};
+
+struct ufprog_lookup_table {
+	uint32_t *slots;
+	uint32_t slot_mask;
+	uint32_t slots_used;			/* Including deleted slots */
+
+	struct lookup_table_entry *entries;
+	uint32_t entry_count;			/* Including deleted entries */
+	uint32_t entry_capacity;
+
+	uint32_t length;
+	uint32_t enum_depth;
+};
+
+static uint32_t lookup_table_hash_str(const char *key)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*key) {
+		hash ^= (uint8_t)*key++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static uint32_t lookup_table_hash_int(uintptr_t key)
+{
+	uint64_t h = key;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return (uint32_t)h;
+}
+
+static uint32_t lookup_table_find_slot(const struct ufprog_lookup_table *tbl, uint32_t hash, const char *key,
+				       uintptr_t ikey)
+{
+	const struct lookup_table_entry *e;
+	uint32_t i, idx;
+
+	for (i = hash & tbl->slot_mask; ; i = (i + 1) & tbl->slot_mask) {
+		idx = tbl->slots[i];
+
+		if (idx == LOOKTABLE_SLOT_EMPTY)
+			return LOOKTABLE_SLOT_EMPTY;
+
+		if (idx == LOOKTABLE_SLOT_DELETED)
+			continue;
+
+		e = &tbl->entries[idx];
+
+		if (e->hash != hash)
+			continue;
+
+		if (key) {
+			if (e->key && !strcmp(e->key, key))
+				return i;
+		} else {
+			if (!e->key && e->ikey == ikey)
+				return i;
+		}
+	}
+}
+
+static uint32_t lookup_table_free_slot(const struct ufprog_lookup_table *tbl, uint32_t hash)
+{
+	uint32_t i;
+
+	for (i = hash & tbl->slot_mask; ; i = (i + 1) & tbl->slot_mask) {
+		if (tbl->slots[i] == LOOKTABLE_SLOT_EMPTY || tbl->slots[i] == LOOKTABLE_SLOT_DELETED)
+			return i;
+	}
+}
+
+static ufprog_status lookup_table_rebuild(struct ufprog_lookup_table *tbl, uint32_t nslots)
+{
+	uint32_t *slots, mask = nslots - 1, i, j;
+
+	slots = malloc(nslots * sizeof(*slots));
+	if (!slots)
+		return UFP_NOMEM;
+
+	memset(slots, 0xff, nslots * sizeof(*slots));
+
+	/* Entry indices must stay valid for an ongoing enumeration */
+	if (!tbl->enum_depth && tbl->entry_count > tbl->length) {
+		for (i = 0, j = 0; i < tbl->entry_count; i++) {
+			if (!tbl->entries[i].used)
+				continue;
+
+			if (i != j)
+				tbl->entries[j] = tbl->entries[i];
+
+			j++;
+		}
+
+		tbl->entry_count = j;
+	}
+
+	for (i = 0; i < tbl->entry_count; i++) {
+		if (!tbl->entries[i].used)
+			continue;
+
+		for (j = tbl->entries[i].hash & mask; slots[j] != LOOKTABLE_SLOT_EMPTY; j = (j + 1) & mask)
+			;
+
+		slots[j] = i;
+	}
+
+	free(tbl->slots);
+
+	tbl->slots = slots;
+	tbl->slot_mask = mask;
+	tbl->slots_used = tbl->length;
+
+	return UFP_OK;
+}
+
+static ufprog_status lookup_table_reserve(struct ufprog_lookup_table *tbl)
+{
+	struct lookup_table_entry *entries;
+	uint32_t nslots, ncap;
+	ufprog_status ret;
+
+	/* Keep at least one quarter of slots empty so that probing always terminates quickly */
+	if ((tbl->slots_used + 1) * 4 > (tbl->slot_mask + 1) * 3) {
+		nslots = tbl->slot_mask + 1;
+		while ((tbl->length + 1) * 2 > nslots)
+			nslots <<= 1;
+
+		ret = lookup_table_rebuild(tbl, nslots);
+		if (ret)
+			return ret;
+	}
+
+	if (tbl->entry_count < tbl->entry_capacity)
+		return UFP_OK;
+
+	if (!tbl->enum_depth && tbl->entry_count > tbl->length) {
+		ret = lookup_table_rebuild(tbl, tbl->slot_mask + 1);
+		if (ret)
+			return ret;
+
+		if (tbl->entry_count < tbl->entry_capacity)
+			return UFP_OK;
+	}
+
+	ncap = tbl->entry_capacity * 2;
+
+	entries = realloc(tbl->entries, ncap * sizeof(*entries));
+	if (!entries)
+		return UFP_NOMEM;
+
+	tbl->entries = entries;
+	tbl->entry_capacity = ncap;
+
+	return UFP_OK;
+}
+
+static ufprog_status lookup_table_do_insert(struct ufprog_lookup_table *tbl, const char *key, uintptr_t ikey,
+					    const void *ptr)
+{
+	struct lookup_table_entry *e;
+	uint32_t hash, slot;
+	ufprog_status ret;
+	size_t keylen;
+	char *nkey = NULL;
+
+	hash = key ? lookup_table_hash_str(key) : lookup_table_hash_int(ikey);
+
+	slot = lookup_table_find_slot(tbl, hash, key, ikey);
+	if (slot != LOOKTABLE_SLOT_EMPTY) {
+		tbl->entries[tbl->slots[slot]].ptr = (void *)ptr;
+		return UFP_OK;
+	}
+
+	if (key) {
+		keylen = strlen(key);
+
+		nkey = malloc(keylen + 1);
+		if (!nkey)
+			return UFP_NOMEM;
+
+		memcpy(nkey, key, keylen + 1);
+	}
+
+	ret = lookup_table_reserve(tbl);
+	if (ret) {
+		if (nkey)
+			free(nkey);
+
+		return ret;
+	}
+
+	slot = lookup_table_free_slot(tbl, hash);
+	if (tbl->slots[slot] == LOOKTABLE_SLOT_EMPTY)
+		tbl->slots_used++;
+
+	tbl->slots[slot] = tbl->entry_count;
+
+	e = &tbl->entries[tbl->entry_count++];
+	e->key = nkey;
+	e->ikey = ikey;
+	e->ptr = (void *)ptr;
+	e->hash = hash;
+	e->used = true;
+
+	tbl->length++;
+
+	return UFP_OK;
+}
+
+static ufprog_status lookup_table_do_delete(struct ufprog_lookup_table *tbl, const char *key, uintptr_t ikey)
+{
+	struct lookup_table_entry *e;
+	uint32_t hash, slot;
+
+	hash = key ? lookup_table_hash_str(key) : lookup_table_hash_int(ikey);
+
+	slot = lookup_table_find_slot(tbl, hash, key, ikey);
+	if (slot == LOOKTABLE_SLOT_EMPTY)
+		return UFP_FAIL;
+
+	e = &tbl->entries[tbl->slots[slot]];
+
+	if (e->key)
+		free(e->key);
+
+	e->key = NULL;
+	e->ptr = NULL;
+	e->used = false;
+
+	tbl->slots[slot] = LOOKTABLE_SLOT_DELETED;
+	tbl->length--;
+
+	if (!tbl->length && !tbl->enum_depth) {
+		memset(tbl->slots, 0xff, (tbl->slot_mask + 1) * sizeof(*tbl->slots));
+		tbl->slots_used = 0;
+		tbl->entry_count = 0;
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_bool lookup_table_do_find(struct ufprog_lookup_table *tbl, const char *key, uintptr_t ikey,
+					void **retptr)
+{
+	uint32_t hash, slot;
+
+	if (retptr)
+		*retptr = NULL;
+
+	hash = key ? lookup_table_hash_str(key) : lookup_table_hash_int(ikey);
+
+	slot = lookup_table_find_slot(tbl, hash, key, ikey);
+	if (slot == LOOKTABLE_SLOT_EMPTY)
+		return false;
+
+	if (retptr)
+		*retptr = tbl->entries[tbl->slots[slot]].ptr;
+
+	return true;
+}
 
 ufprog_status UFPROG_API lookup_table_create(struct ufprog_lookup_table **outtbl, uint32_t init_size)
 {
-	struct lh_table *lht;
+	struct ufprog_lookup_table *tbl;
+	uint32_t nslots = LOOKTABLE_MIN_SLOTS;
 
 	if (!outtbl)
 		return UFP_INVALID_PARAMETER;
@@ -24,134 +310,186 @@ ufprog_status UFPROG_API lookup_table_create(struct ufprog_lookup_table **outtbl
 	if (!init_size)
 		init_size = LOOKTABLE_DEFAULT_INIT_SIZE;
 
-	lht = lh_kchar_table_new(init_size, NULL);
-	if (!lht)
+	while (init_size * 2 > nslots)
+		nslots <<= 1;
+
+	tbl = calloc(1, sizeof(*tbl));
+	if (!tbl)
+		return UFP_NOMEM;
+
+	tbl->slots = malloc(nslots * sizeof(*tbl->slots));
+	tbl->entries = malloc(init_size * sizeof(*tbl->entries));
+
+	if (!tbl->slots || !tbl->entries) {
+		if (tbl->slots)
+			free(tbl->slots);
+
+		if (tbl->entries)
+			free(tbl->entries);
+
+		free(tbl);
 		return UFP_NOMEM;
+	}
+
+	memset(tbl->slots, 0xff, nslots * sizeof(*tbl->slots));
+
+	tbl->slot_mask = nslots - 1;
+	tbl->entry_capacity = init_size;
 
-	*outtbl = (void *)lht;
+	*outtbl = tbl;
 
 	return UFP_OK;
 }
 
 ufprog_status UFPROG_API lookup_table_destroy(struct ufprog_lookup_table *tbl)
 {
+	uint32_t i;
+
 	if (!tbl)
 		return UFP_INVALID_PARAMETER;
 
-	lh_table_free((void *)tbl);
+	for (i = 0; i < tbl->entry_count; i++) {
+		if (tbl->entries[i].key)
+			free(tbl->entries[i].key);
+	}
+
+	free(tbl->entries);
+	free(tbl->slots);
+	free(tbl);
 
 	return UFP_OK;
 }
 
 ufprog_status UFPROG_API lookup_table_insert(struct ufprog_lookup_table *tbl, const char *key, const void *ptr)
 {
-	int ret;
-
 	if (!tbl || !key)
 		return UFP_INVALID_PARAMETER;
 
-	ret = lh_table_insert((void *)tbl, key, ptr);
-	if (!ret)
-		return UFP_OK;
+	return lookup_table_do_insert(tbl, key, 0, ptr);
+}
 
-	return UFP_NOMEM;
+ufprog_status UFPROG_API lookup_table_insert_int(struct ufprog_lookup_table *tbl, uintptr_t key, const void *ptr)
+{
+	if (!tbl)
+		return UFP_INVALID_PARAMETER;
+
+	return lookup_table_do_insert(tbl, NULL, key, ptr);
 }
 
 ufprog_status UFPROG_API lookup_table_insert_ptr(struct ufprog_lookup_table *tbl, const void *ptr)
 {
-	char key[20];
-
 	if (!tbl || !ptr)
 		return UFP_INVALID_PARAMETER;
 
-	snprintf(key, sizeof(key), "%p", ptr);
-
-	return lookup_table_insert(tbl, key, ptr);
+	return lookup_table_do_insert(tbl, NULL, (uintptr_t)ptr, ptr);
 }
 
 ufprog_status UFPROG_API lookup_table_delete(struct ufprog_lookup_table *tbl, const char *key)
 {
-	int ret;
-
 	if (!tbl || !key)
 		return UFP_INVALID_PARAMETER;
 
-	ret = lh_table_delete((void *)tbl, key);
-	if (!ret)
-		return UFP_OK;
+	return lookup_table_do_delete(tbl, key, 0);
+}
+
+ufprog_status UFPROG_API lookup_table_delete_int(struct ufprog_lookup_table *tbl, uintptr_t key)
+{
+	if (!tbl)
+		return UFP_INVALID_PARAMETER;
 
-	return UFP_FAIL;
+	return lookup_table_do_delete(tbl, NULL, key);
 }
 
 ufprog_status UFPROG_API lookup_table_delete_ptr(struct ufprog_lookup_table *tbl, const void *ptr)
 {
-	char key[20];
-
 	if (!tbl || !ptr)
 		return UFP_INVALID_PARAMETER;
 
-	snprintf(key, sizeof(key), "%p", ptr);
-
-	return lookup_table_delete(tbl, key);
+	return lookup_table_do_delete(tbl, NULL, (uintptr_t)ptr);
 }
 
 ufprog_bool UFPROG_API lookup_table_find(struct ufprog_lookup_table *tbl, const char *key, void **retptr)
 {
-	struct lh_entry *e;
-
 	if (!tbl || !key)
 		return false;
 
-	if (retptr)
-		*retptr = NULL;
+	return lookup_table_do_find(tbl, key, 0, retptr);
+}
 
-	e = lh_table_lookup_entry((void *)tbl, key);
-	if (!e)
+ufprog_bool UFPROG_API lookup_table_find_int(struct ufprog_lookup_table *tbl, uintptr_t key, void **retptr)
+{
+	if (!tbl)
 		return false;
 
-	if (retptr)
-		*retptr = lh_entry_v(e);
+	return lookup_table_do_find(tbl, NULL, key, retptr);
+}
 
-	return true;
+ufprog_bool UFPROG_API lookup_table_find_ptr(struct ufprog_lookup_table *tbl, const void *ptr)
+{
+	if (!tbl || !ptr)
+		return false;
+
+	return lookup_table_do_find(tbl, NULL, (uintptr_t)ptr, NULL);
 }
 
 uint32_t UFPROG_API lookup_table_length(struct ufprog_lookup_table *tbl)
 {
-	int ret;
-
 	if (!tbl)
-		return UFP_INVALID_PARAMETER;
-
-	ret = lh_table_length((void *)tbl);
-	if (ret < 0)
 		return 0;
 
-	return ret;
+	return tbl->length;
 }
 
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable: 4706)
-#endif /* _MSC_VER */
-
 ufprog_status UFPROG_API lookup_table_enum(struct ufprog_lookup_table *tbl, ufprog_lookup_table_entry_cb cb, void *priv)
 {
-	struct lh_entry *e, *tmp;
-	struct lh_table *lht = (struct lh_table *)tbl;
+	struct lookup_table_entry *e;
+	uint32_t i;
 	int ret;
 
 	if (!tbl || !cb)
 		return UFP_INVALID_PARAMETER;
 
-	lh_foreach_safe(lht, e, tmp) {
-		ret = cb(priv, tbl, lh_entry_k(e), lh_entry_v(e));
+	tbl->enum_depth++;
+
+	/* The entry array may be reallocated by the callback, so it's always indexed freshly */
+	for (i = 0; i < tbl->entry_count; i++) {
+		e = &tbl->entries[i];
+		if (!e->used)
+			continue;
+
+		ret = cb(priv, tbl, e->key, e->ptr);
 		if (ret)
 			break;
 	}
 
+	tbl->enum_depth--;
+
 	return UFP_OK;
 }
 
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif /* _MSC_VER */
+ufprog_status UFPROG_API lookup_table_enum_int(struct ufprog_lookup_table *tbl, ufprog_lookup_table_int_entry_cb cb,
+					       void *priv)
+{
+	struct lookup_table_entry *e;
+	uint32_t i;
+	int ret;
+
+	if (!tbl || !cb)
+		return UFP_INVALID_PARAMETER;
+
+	tbl->enum_depth++;
+
+	for (i = 0; i < tbl->entry_count; i++) {
+		e = &tbl->entries[i];
+		if (!e->used || e->key)
+			continue;
+
+		ret = cb(priv, tbl, e->ikey, e->ptr);
+		if (ret)
+			break;
+	}
+
+	tbl->enum_depth--;
+
+	return UFP_OK;
+}
@@ -54,6 +54,59 @@ char *UFPROG_API bin_to_hex_str(char *buf, size_t bufsize, const void *data, siz
 	return buf;
 }
 
+static int hex_char_val(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+
+	return -1;
+}
+
+ufprog_bool UFPROG_API hex_str_to_bin(const char *str, void *buf, size_t bufsize, size_t *retlen)
+{
+	uint8_t *p = buf;
+	size_t len = 0;
+	int hi, lo;
+
+	if (!str || !buf)
+		return false;
+
+	if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+		str += 2;
+
+	while (*str) {
+		if (*str == ' ' || *str == ':') {
+			str++;
+			continue;
+		}
+
+		hi = hex_char_val(str[0]);
+		if (hi < 0)
+			return false;
+
+		lo = hex_char_val(str[1]);
+		if (lo < 0)
+			return false;
+
+		if (len >= bufsize)
+			return false;
+
+		p[len++] = (uint8_t)((hi << 4) | lo);
+		str += 2;
+	}
+
+	if (retlen)
+		*retlen = len;
+
+	return true;
+}
+
 ufprog_status UFPROG_API read_file_contents(const char *filename, void **outdata, size_t *retsize)
 {
 	ufprog_status ret = UFP_FAIL;
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SHA-256 message digest helpers
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <ufprog/sha256.h>
+#include "sha256.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_HAS_SHANI
+#endif
+
+typedef void (*sha256_blocks_fn)(uint32_t *state, const uint8_t *data, size_t nblocks);
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t sha256_h0[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+#define ROR32(_v, _n)		(((_v) >> (_n)) | ((_v) << (32 - (_n))))
+#define SHA256_CH(_x, _y, _z)	(((_x) & (_y)) ^ (~(_x) & (_z)))
+#define SHA256_MAJ(_x, _y, _z)	(((_x) & (_y)) ^ ((_x) & (_z)) ^ ((_y) & (_z)))
+#define SHA256_S0(_x)		(ROR32(_x, 2) ^ ROR32(_x, 13) ^ ROR32(_x, 22))
+#define SHA256_S1(_x)		(ROR32(_x, 6) ^ ROR32(_x, 11) ^ ROR32(_x, 25))
+#define SHA256_G0(_x)		(ROR32(_x, 7) ^ ROR32(_x, 18) ^ ((_x) >> 3))
+#define SHA256_G1(_x)		(ROR32(_x, 17) ^ ROR32(_x, 19) ^ ((_x) >> 10))
+
+static void sha256_blocks_generic(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+	uint32_t w[64], s[8], t1, t2;
+	uint32_t i;
+
+	while (nblocks--) {
+		for (i = 0; i < 16; i++) {
+			w[i] = ((uint32_t)data[i * 4] << 24) | ((uint32_t)data[i * 4 + 1] << 16) |
+			       ((uint32_t)data[i * 4 + 2] << 8) | (uint32_t)data[i * 4 + 3];
+		}
+
+		for (i = 16; i < 64; i++)
+			w[i] = SHA256_G1(w[i - 2]) + w[i - 7] + SHA256_G0(w[i - 15]) + w[i - 16];
+
+		memcpy(s, state, sizeof(s));
+
+		for (i = 0; i < 64; i++) {
+			t1 = s[7] + SHA256_S1(s[4]) + SHA256_CH(s[4], s[5], s[6]) + sha256_k[i] + w[i];
+			t2 = SHA256_S0(s[0]) + SHA256_MAJ(s[0], s[1], s[2]);
+
+			s[7] = s[6];
+			s[6] = s[5];
+			s[5] = s[4];
+			s[4] = s[3] + t1;
+			s[3] = s[2];
+			s[2] = s[1];
+			s[1] = s[0];
+			s[0] = t1 + t2;
+		}
+
+		for (i = 0; i < 8; i++)
+			state[i] += s[i];
+
+		data += SHA256_BLOCK_SIZE;
+	}
+}
+
+#ifdef SHA256_HAS_SHANI
+/* Intel SHA Extensions. Each iteration of the inner loop does four rounds. */
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_blocks_shani(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+	const __m128i bswap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i state0, state1, abef_save, cdgh_save, msg, tmp, m[4];
+	uint32_t i;
+
+	tmp = _mm_loadu_si128((const __m128i *)&state[0]);
+	state1 = _mm_loadu_si128((const __m128i *)&state[4]);
+
+	tmp = _mm_shuffle_epi32(tmp, 0xb1);			/* CDAB */
+	state1 = _mm_shuffle_epi32(state1, 0x1b);		/* EFGH */
+	state0 = _mm_alignr_epi8(tmp, state1, 8);		/* ABEF */
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);		/* CDGH */
+
+	while (nblocks--) {
+		abef_save = state0;
+		cdgh_save = state1;
+
+		for (i = 0; i < 16; i++) {
+			if (i < 4) {
+				m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + i * 16)), bswap_mask);
+			} else {
+				tmp = _mm_alignr_epi8(m[(i - 1) & 3], m[(i - 2) & 3], 4);
+				m[i & 3] = _mm_sha256msg1_epu32(m[i & 3], m[(i - 3) & 3]);
+				m[i & 3] = _mm_add_epi32(m[i & 3], tmp);
+				m[i & 3] = _mm_sha256msg2_epu32(m[i & 3], m[(i - 1) & 3]);
+			}
+
+			msg = _mm_add_epi32(m[i & 3], _mm_loadu_si128((const __m128i *)&sha256_k[i * 4]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+			msg = _mm_shuffle_epi32(msg, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		}
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+
+		data += SHA256_BLOCK_SIZE;
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);			/* FEBA */
+	state1 = _mm_shuffle_epi32(state1, 0xb1);		/* DCHG */
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0);		/* DCBA */
+	state1 = _mm_alignr_epi8(state1, tmp, 8);		/* HGFE */
+
+	_mm_storeu_si128((__m128i *)&state[0], state0);
+	_mm_storeu_si128((__m128i *)&state[4], state1);
+}
+#endif
+
+static sha256_blocks_fn sha256_blocks = sha256_blocks_generic;
+
+void sha256_probe_hw(void)
+{
+#ifdef SHA256_HAS_SHANI
+	uint32_t eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return;
+
+	if (!(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3))
+		return;
+
+	if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+		return;
+
+	if (ebx & (1 << 29))
+		sha256_blocks = sha256_blocks_shani;
+#endif
+}
+
+void UFPROG_API sha256_init(struct sha256_context *ctx)
+{
+	memcpy(ctx->state, sha256_h0, sizeof(ctx->state));
+	ctx->length = 0;
+	ctx->buflen = 0;
+}
+
+void UFPROG_API sha256_update(struct sha256_context *ctx, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	size_t chksz, nblocks;
+
+	ctx->length += length;
+
+	if (ctx->buflen) {
+		chksz = SHA256_BLOCK_SIZE - ctx->buflen;
+		if (chksz > length)
+			chksz = length;
+
+		memcpy(ctx->buf + ctx->buflen, p, chksz);
+		ctx->buflen += (uint32_t)chksz;
+		p += chksz;
+		length -= chksz;
+
+		if (ctx->buflen < SHA256_BLOCK_SIZE)
+			return;
+
+		sha256_blocks(ctx->state, ctx->buf, 1);
+		ctx->buflen = 0;
+	}
+
+	nblocks = length / SHA256_BLOCK_SIZE;
+	if (nblocks) {
+		sha256_blocks(ctx->state, p, nblocks);
+		p += nblocks * SHA256_BLOCK_SIZE;
+		length -= nblocks * SHA256_BLOCK_SIZE;
+	}
+
+	if (length) {
+		memcpy(ctx->buf, p, length);
+		ctx->buflen = (uint32_t)length;
+	}
+}
+
+void UFPROG_API sha256_final(struct sha256_context *ctx, uint8_t *digest)
+{
+	uint64_t bits = ctx->length << 3;
+	uint32_t i;
+
+	ctx->buf[ctx->buflen++] = 0x80;
+
+	if (ctx->buflen > SHA256_BLOCK_SIZE - sizeof(uint64_t)) {
+		memset(ctx->buf + ctx->buflen, 0, SHA256_BLOCK_SIZE - ctx->buflen);
+		sha256_blocks(ctx->state, ctx->buf, 1);
+		ctx->buflen = 0;
+	}
+
+	memset(ctx->buf + ctx->buflen, 0, SHA256_BLOCK_SIZE - sizeof(uint64_t) - ctx->buflen);
+
+	for (i = 0; i < sizeof(uint64_t); i++)
+		ctx->buf[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (i * 8));
+
+	sha256_blocks(ctx->state, ctx->buf, 1);
+
+	for (i = 0; i < 8; i++) {
+		digest[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+		digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+		digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+		digest[i * 4 + 3] = (uint8_t)ctx->state[i];
+	}
+}
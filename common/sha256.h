@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SHA-256 message digest internal helpers
+ */
+#pragma once
+
+#ifndef _SHA256_H_
+#define _SHA256_H_
+
+void sha256_probe_hw(void);
+
+#endif /* _SHA256_H_ */
@@ -329,6 +329,38 @@ ufprog_bool UFPROG_API os_close_file(file_handle handle)
 	return true;
 }
 
+ufprog_status UFPROG_API os_delete_file(const char *file)
+{
+	LPWSTR lpwsFileName;
+	DWORD dwLastError;
+	BOOL bRet;
+
+	if (!file)
+		return UFP_INVALID_PARAMETER;
+
+	/* Convert filepath from UTF-8 to UCS-2 */
+	lpwsFileName = utf8_to_wcs(file);
+	if (!lpwsFileName) {
+		log_err("Unable to convert file name to UTF-16\n");
+		return UFP_NOMEM;
+	}
+
+	bRet = DeleteFileW(lpwsFileName);
+	dwLastError = GetLastError();
+
+	free(lpwsFileName);
+
+	if (!bRet) {
+		if (dwLastError == ERROR_FILE_NOT_FOUND)
+			return UFP_FILE_NOT_EXIST;
+
+		log_sys_error_utf8(dwLastError, "Failed to delete file '%s'", file);
+		return UFP_FAIL;
+	}
+
+	return UFP_OK;
+}
+
 ufprog_bool UFPROG_API os_get_file_size(file_handle handle, uint64_t *retval)
 {
 	LARGE_INTEGER fsz;
@@ -472,6 +504,19 @@ ufprog_bool UFPROG_API os_write_file(file_handle handle, size_t len, const void
 	return ret;
 }
 
+ufprog_bool UFPROG_API os_flush_file(file_handle handle)
+{
+	if (!handle)
+		return false;
+
+	if (!FlushFileBuffers(handle->hFile)) {
+		log_sys_error_utf8(GetLastError(), "Failed to flush file '%s'", handle->path);
+		return false;
+	}
+
+	return true;
+}
+
 ufprog_status UFPROG_API os_open_file_mapping(const char *file, uint64_t size, size_t mapsize, ufprog_bool write,
 					      ufprog_bool trunc, file_mapping *outmapping)
 {
@@ -499,6 +499,151 @@ ufprog_bool UFPROG_API os_mutex_unlock(mutex_handle mutex)
 	return ReleaseMutex((HANDLE)mutex);
 }
 
+struct os_thread {
+	HANDLE hThread;
+	os_thread_fn fn;
+	void *priv;
+};
+
+static DWORD WINAPI os_thread_entry(LPVOID lpParameter)
+{
+	struct os_thread *t = lpParameter;
+
+	t->fn(t->priv);
+
+	return 0;
+}
+
+ufprog_bool UFPROG_API os_create_thread(thread_handle *outthread, os_thread_fn fn, void *priv)
+{
+	struct os_thread *t;
+
+	if (!outthread || !fn)
+		return false;
+
+	t = malloc(sizeof(*t));
+	if (!t) {
+		log_err("No memory for thread object\n");
+		return false;
+	}
+
+	t->fn = fn;
+	t->priv = priv;
+
+	t->hThread = CreateThread(NULL, 0, os_thread_entry, t, 0, NULL);
+	if (!t->hThread) {
+		log_err("CreateThread() failed with %u\n", GetLastError());
+		free(t);
+		return false;
+	}
+
+	*outthread = (thread_handle)t;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_join_thread(thread_handle thread)
+{
+	struct os_thread *t = (struct os_thread *)thread;
+	DWORD dwResult;
+
+	if (!t)
+		return false;
+
+	dwResult = WaitForSingleObject(t->hThread, INFINITE);
+	CloseHandle(t->hThread);
+	free(t);
+
+	return dwResult == WAIT_OBJECT_0;
+}
+
+ufprog_bool UFPROG_API os_create_event(event_handle *outevent)
+{
+	HANDLE hEvent;
+
+	if (!outevent)
+		return false;
+
+	hEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+	if (!hEvent) {
+		*outevent = NULL;
+		return false;
+	}
+
+	*outevent = (event_handle)hEvent;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_free_event(event_handle event)
+{
+	if (!event)
+		return false;
+
+	return CloseHandle((HANDLE)event);
+}
+
+ufprog_bool UFPROG_API os_set_event(event_handle event)
+{
+	if (!event)
+		return false;
+
+	return SetEvent((HANDLE)event);
+}
+
+ufprog_bool UFPROG_API os_wait_event(event_handle event, uint32_t timeout_ms)
+{
+	if (!event)
+		return false;
+
+	return WaitForSingleObject((HANDLE)event, timeout_ms == OS_WAIT_INFINITE ? INFINITE : timeout_ms) ==
+		WAIT_OBJECT_0;
+}
+
+ufprog_bool UFPROG_API os_create_notifier(notifier_handle *outnotifier)
+{
+	HANDLE hEvent;
+
+	if (!outnotifier)
+		return false;
+
+	hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+	if (!hEvent) {
+		*outnotifier = NULL;
+		return false;
+	}
+
+	*outnotifier = (notifier_handle)hEvent;
+	return true;
+}
+
+ufprog_bool UFPROG_API os_free_notifier(notifier_handle notifier)
+{
+	if (!notifier)
+		return false;
+
+	return CloseHandle((HANDLE)notifier);
+}
+
+ufprog_bool UFPROG_API os_notify(notifier_handle notifier)
+{
+	if (!notifier)
+		return false;
+
+	return SetEvent((HANDLE)notifier);
+}
+
+ufprog_bool UFPROG_API os_clear_notifier(notifier_handle notifier)
+{
+	if (!notifier)
+		return false;
+
+	return ResetEvent((HANDLE)notifier);
+}
+
+uintptr_t UFPROG_API os_get_notifier_native_handle(notifier_handle notifier)
+{
+	return (uintptr_t)notifier;
+}
+
 uint64_t UFPROG_API os_get_timer_us(void)
 {
 	LARGE_INTEGER t;
@@ -524,6 +669,18 @@ void UFPROG_API os_udelay(uint64_t us)
 	} while (t.QuadPart <= te.QuadPart);
 }
 
+void UFPROG_API os_usleep(uint64_t us)
+{
+	/* Sleep() only has millisecond granularity. Spin for the remainder. */
+	if (us >= 1000) {
+		Sleep((DWORD)(us / 1000));
+		us %= 1000;
+	}
+
+	if (us)
+		os_udelay(us);
+}
+
 ufprog_status UFPROG_API os_read_text_file(const char *filename, char **outdata, size_t *retlen)
 {
 	char *rawdata, *utf8_data;
@@ -193,6 +193,17 @@ ufprog_status ftdi_write(struct ft_handle *handle, const void *buf, size_t len)
 	return UFP_OK;
 }
 
+/* D2XX reads in background, so a plain write does not block the reading side */
+ufprog_status ftdi_write_async(struct ft_handle *handle, const void *buf, size_t len)
+{
+	return ftdi_write(handle, buf, len);
+}
+
+ufprog_status ftdi_write_flush(struct ft_handle *handle)
+{
+	return UFP_OK;
+}
+
 ufprog_status ftdi_vendor_cmd_get(struct ft_handle *handle, uint8_t request, void *buf, uint16_t len)
 {
 	FT_STATUS ftStatus;
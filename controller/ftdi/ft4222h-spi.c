@@ -352,12 +352,24 @@ ufprog_status ft4222_spi_master_init(struct ufprog_interface *ftdev, struct json
 		return UFP_NOMEM;
 	}
 
+	/* Outgoing data for single I/O reading. Never modified afterwards. */
+	ftdev->dummy_buffer = malloc(FT4222_SINGLEIO_XFER_MAX_LEN);
+	if (!ftdev->dummy_buffer) {
+		logm_err("No memory for dummy buffer\n");
+		free(ftdev->scratch_buffer);
+		ftdev->scratch_buffer = NULL;
+		return UFP_NOMEM;
+	}
+
+	memset(ftdev->dummy_buffer, 0xff, FT4222_SINGLEIO_XFER_MAX_LEN);
+
 	return UFP_OK;
 }
 
 ufprog_status ft4222_spi_master_cleanup(struct ufprog_interface *ftdev)
 {
 	free(ftdev->scratch_buffer);
+	free(ftdev->dummy_buffer);
 
 	return UFP_OK;
 }
@@ -466,57 +478,79 @@ static ufprog_status ft4222_spi_end_generic_xfer(struct ufprog_interface *ftdev)
 	return ret;
 }
 
-static ufprog_status ft4222_spi_generic_xfer_one(struct ufprog_interface *ftdev, const struct ufprog_spi_transfer *xfer)
+/*
+ * Single I/O transfer with the next chunk always queued before reading back the current one.
+ * tx == NULL sends 0xff. rx == NULL discards readback data.
+ * skip is the length of readback data of previously sent bytes to be discarded first.
+ */
+static ufprog_status ft4222_spi_sio_xfer(struct ufprog_interface *ftdev, const void *tx, void *rx, size_t len,
+					 size_t skip)
 {
-	const uint8_t *ptx;
-	uint16_t chksz;
-	uint8_t *prx;
-	size_t len;
+	ufprog_status ret = UFP_OK;
+	const uint8_t *ptx = tx;
+	size_t chksz, nextsz;
+	uint8_t *prx = rx;
 
-	if (xfer->buswidth > 1 || xfer->dtr) {
-		logm_err("Only single I/O single rate is supported in generic transfer mode\n");
-		return UFP_UNSUPPORTED;
-	}
+	chksz = len;
+	if (chksz > FT4222_SINGLEIO_XFER_MAX_LEN)
+		chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
 
-	if (xfer->speed)
-		STATUS_CHECK_RET(ft4222_spi_master_set_clk(ftdev, xfer->speed, NULL));
+	if (chksz)
+		STATUS_CHECK_GOTO_RET(ftdi_write_async(ftdev->handle, ptx ? ptx : ftdev->dummy_buffer, chksz), ret, out);
 
-	len = xfer->len;
+	if (skip)
+		STATUS_CHECK_GOTO_RET(ftdi_read(ftdev->handle, ftdev->scratch_buffer, skip), ret, out);
 
-	if (xfer->dir == SPI_DATA_IN) {
-		ptx = ftdev->scratch_buffer;
-		prx = xfer->buf.rx;
+	while (len) {
+		chksz = len;
+		if (chksz > FT4222_SINGLEIO_XFER_MAX_LEN)
+			chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
 
-		if (len) {
-			if (len > FT4222_SINGLEIO_XFER_MAX_LEN)
-				chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
-			else
-				chksz = (uint16_t)len;
+		nextsz = len - chksz;
+		if (nextsz > FT4222_SINGLEIO_XFER_MAX_LEN)
+			nextsz = FT4222_SINGLEIO_XFER_MAX_LEN;
 
-			memset(ftdev->scratch_buffer, 0xff, chksz);
+		if (nextsz) {
+			STATUS_CHECK_GOTO_RET(ftdi_write_async(ftdev->handle, ptx ? ptx + chksz : ftdev->dummy_buffer,
+							       nextsz), ret, out);
 		}
-	} else {
-		ptx = xfer->buf.tx;
-		prx = ftdev->scratch_buffer;
-	}
 
-	while (len) {
-		if (len > FT4222_SINGLEIO_XFER_MAX_LEN)
-			chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
-		else
-			chksz = (uint16_t)len;
+		STATUS_CHECK_GOTO_RET(ftdi_read(ftdev->handle, prx ? prx : ftdev->scratch_buffer, chksz), ret, out);
 
-		STATUS_CHECK_RET(ftdi_write(ftdev->handle, ptx, chksz));
-		STATUS_CHECK_RET(ftdi_read(ftdev->handle, prx, chksz));
+		if (ptx)
+			ptx += chksz;
 
-		if (xfer->dir == SPI_DATA_IN)
+		if (prx)
 			prx += chksz;
-		else
-			ptx += chksz;
 
 		len -= chksz;
 	}
 
+out:
+	/* Always drain queued writes since they reference caller's buffer */
+	if (ret) {
+		ftdi_write_flush(ftdev->handle);
+		return ret;
+	}
+
+	return ftdi_write_flush(ftdev->handle);
+}
+
+static ufprog_status ft4222_spi_generic_xfer_one(struct ufprog_interface *ftdev, const struct ufprog_spi_transfer *xfer)
+{
+	if (xfer->buswidth > 1 || xfer->dtr) {
+		logm_err("Only single I/O single rate is supported in generic transfer mode\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	if (xfer->speed)
+		STATUS_CHECK_RET(ft4222_spi_master_set_clk(ftdev, xfer->speed, NULL));
+
+	if (xfer->dir == SPI_DATA_IN)
+		STATUS_CHECK_RET(ft4222_spi_sio_xfer(ftdev, NULL, xfer->buf.rx, xfer->len, 0));
+	else
+		STATUS_CHECK_RET(ft4222_spi_sio_xfer(ftdev, xfer->buf.tx, NULL, xfer->len, 0));
+
 	if (xfer->end)
 		return ft4222_spi_end_generic_xfer(ftdev);
 
@@ -582,6 +616,14 @@ ufprog_status UFPROG_API ufprog_spi_mem_adjust_op_size(struct ufprog_interface *
 	if (bw <= 1)
 		return UFP_OK;
 
+	/* Addressed reads can be chained */
+	if (op->data.dir == SPI_DATA_IN && op->addr.len && ftdev && ftdev->hwver.fwver >= 3) {
+		if (op->data.len > (size_t)FT4222_MULTIIO_MIO_RD_MAX_LEN * FT4222_MULTIIO_MAX_CHAIN)
+			op->data.len = (size_t)FT4222_MULTIIO_MIO_RD_MAX_LEN * FT4222_MULTIIO_MAX_CHAIN;
+
+		return UFP_OK;
+	}
+
 	if (op->data.len > FT4222_MULTIIO_MIO_WR_MAX_LEN)
 		op->data.len = FT4222_MULTIIO_MIO_WR_MAX_LEN;
 
@@ -663,13 +705,63 @@ ufprog_bool UFPROG_API ufprog_spi_mem_supports_op(struct ufprog_interface *ftdev
 	return false;
 }
 
+/*
+ * Split a multi I/O read into transactions of at most FT4222_MULTIIO_MIO_RD_MAX_LEN bytes with advancing address.
+ * All transactions are sent at once and data is read back in one go, without a round trip in between.
+ */
+static ufprog_status ft4222_spi_mem_chained_read(struct ufprog_interface *ftdev, const struct ufprog_spi_mem_op *op,
+						 size_t sio_wr_len, size_t mio_wr_len)
+{
+	uint8_t *p = ftdev->scratch_buffer;
+	size_t len, chksz, offs = 0;
+	uint64_t addr;
+	uint32_t i, n;
+
+	n = (uint32_t)((op->data.len + FT4222_MULTIIO_MIO_RD_MAX_LEN - 1) / FT4222_MULTIIO_MIO_RD_MAX_LEN);
+	if (!op->addr.len || n > FT4222_MULTIIO_MAX_CHAIN)
+		return UFP_INVALID_PARAMETER;
+
+	len = op->data.len;
+
+	while (len) {
+		chksz = len;
+		if (chksz > FT4222_MULTIIO_MIO_RD_MAX_LEN)
+			chksz = FT4222_MULTIIO_MIO_RD_MAX_LEN;
+
+		*p++ = (sio_wr_len & 0xF) | 0x80;
+		*p++ = (mio_wr_len >> 8) & 0xff;
+		*p++ = mio_wr_len & 0xff;
+		*p++ = (chksz >> 8) & 0xff;
+		*p++ = chksz & 0xff;
+
+		if (op->cmd.len)
+			*p++ = op->cmd.opcode & 0xff;
+
+		addr = op->addr.val + offs;
+
+		for (i = 0; i < op->addr.len; i++)
+			*p++ = (addr >> (8 * (op->addr.len - i - 1))) & 0xff;
+
+		if (op->dummy.len) {
+			memset(p, 0xff, op->dummy.len);
+			p += op->dummy.len;
+		}
+
+		offs += chksz;
+		len -= chksz;
+	}
+
+	STATUS_CHECK_RET(ftdi_write(ftdev->handle, ftdev->scratch_buffer, p - ftdev->scratch_buffer));
+
+	return ftdi_read(ftdev->handle, op->data.buf.rx, op->data.len);
+}
+
 ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *ftdev, const struct ufprog_spi_mem_op *op)
 {
 	size_t len, chksz, sio_wr_len = 0, sio_rd_len = 0, mio_wr_len = 0, mio_rd_len = 0;
 	bool sio_write_once = false;
 	ufprog_status ret = UFP_OK;
 	uint8_t *buf, *buf_data;
-	const uint8_t *tbuf;
 	uint32_t i, bw = 0;
 
 	if (!ftdev)
@@ -770,53 +862,14 @@ ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *ftdev,
 
 		/* Send all outgoing data */
 		STATUS_CHECK_GOTO_RET(ftdi_write(ftdev->handle, buf_data, sio_wr_len), ret, out);
-		/* Discard all readback data */
-		STATUS_CHECK_GOTO_RET(ftdi_read(ftdev->handle, ftdev->scratch_buffer, sio_wr_len), ret, out);
 
+		/* Readback of the command phase is discarded while the first data chunk is already in flight */
 		if (op->data.dir == SPI_DATA_IN) {
-			if (sio_rd_len > FT4222_SINGLEIO_XFER_MAX_LEN)
-				chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
-			else
-				chksz = sio_rd_len;
-
-			memset(ftdev->scratch_buffer, 0xff, chksz);
-
-			len = op->data.len;
-			buf = op->data.buf.rx;
-
-			while (len) {
-				if (len > FT4222_SINGLEIO_XFER_MAX_LEN)
-					chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
-				else
-					chksz = len;
-
-				/* Send dummy data for receiving */
-				STATUS_CHECK_GOTO_RET(ftdi_write(ftdev->handle, ftdev->scratch_buffer, chksz), ret,
-								 out);
-				/* Read data */
-				STATUS_CHECK_GOTO_RET(ftdi_read(ftdev->handle, buf, chksz), ret, out);
-
-				len -= chksz;
-				buf += chksz;
-			}
+			STATUS_CHECK_GOTO_RET(ft4222_spi_sio_xfer(ftdev, NULL, op->data.buf.rx, op->data.len,
+								  sio_wr_len), ret, out);
 		} else {
-			len = op->data.len;
-			tbuf = op->data.buf.tx;
-
-			while (len) {
-				if (len > FT4222_SINGLEIO_XFER_MAX_LEN)
-					chksz = FT4222_SINGLEIO_XFER_MAX_LEN;
-				else
-					chksz = len;
-
-				/* Send all outgoing data */
-				STATUS_CHECK_GOTO_RET(ftdi_write(ftdev->handle, tbuf, chksz), ret, out);
-				/* Discard all readback data */
-				STATUS_CHECK_GOTO_RET(ftdi_read(ftdev->handle, ftdev->scratch_buffer, chksz), ret, out);
-
-				len -= chksz;
-				tbuf += chksz;
-			}
+			STATUS_CHECK_GOTO_RET(ft4222_spi_sio_xfer(ftdev, op->data.buf.tx, NULL, op->data.len,
+								  sio_wr_len), ret, out);
 		}
 
 		STATUS_CHECK_GOTO_RET(ft4222_spi_end_generic_xfer(ftdev), ret, out);
@@ -834,6 +887,11 @@ ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *ftdev,
 	ftdev->scratch_buffer[4] = mio_rd_len & 0xff;
 
 	if (ftdev->hwver.fwver >= 3) {
+		if (mio_rd_len > FT4222_MULTIIO_MIO_RD_MAX_LEN) {
+			ret = ft4222_spi_mem_chained_read(ftdev, op, sio_wr_len, mio_wr_len);
+			goto out;
+		}
+
 		/* Send all outgoing data */
 		len = FT4222_MULTIIO_CMD_LEN + sio_wr_len + mio_wr_len;
 		STATUS_CHECK_GOTO_RET(ftdi_write(ftdev->handle, ftdev->scratch_buffer, len), ret, out);
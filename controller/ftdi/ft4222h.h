@@ -21,6 +21,9 @@
 #define FT4222_MULTIIO_MIO_RD_MAX_LEN		0xffff
 #define FT4222_SINGLEIO_XFER_MAX_LEN		0xffff
 
+/* Multi I/O reads beyond FT4222_MULTIIO_MIO_RD_MAX_LEN are split into chained transactions */
+#define FT4222_MULTIIO_MAX_CHAIN		16
+
 #define FT4222_MULTIIO_BUF_LEN			(FT4222_MULTIIO_CMD_LEN + FT4222_MULTIIO_SIO_WR_MAX_LEN + \
 						 FT4222_MULTIIO_MIO_WR_MAX_LEN)
 
@@ -134,6 +137,7 @@ struct ufprog_interface {
 
 	uint32_t max_buck_size;
 	uint8_t *scratch_buffer;
+	uint8_t *dummy_buffer;
 	struct ft4222_spi_master_info spim;
 
 	mutex_handle lock;
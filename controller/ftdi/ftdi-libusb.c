@@ -233,6 +233,105 @@ ufprog_status ftdi_write(struct ft_handle *handle, const void *buf, size_t len)
 	return UFP_OK;
 }
 
+static void LIBUSB_CALL ftdi_write_async_cb(struct libusb_transfer *transfer)
+{
+	int *done = transfer->user_data;
+
+	*done = 1;
+}
+
+static void ftdi_write_cancel_all(struct ft_handle *handle)
+{
+	uint32_t i;
+
+	for (i = 0; i < handle->out_count; i++)
+		libusb_cancel_transfer(handle->out_xfers[(handle->out_head + i) % FTDI_MAX_ASYNC_WRITES]);
+}
+
+static ufprog_status ftdi_write_wait_oldest(struct ft_handle *handle)
+{
+	uint32_t slot = handle->out_head;
+	struct libusb_transfer *xfer = handle->out_xfers[slot];
+	ufprog_status ret = UFP_OK;
+	int err;
+
+	while (!handle->out_done[slot]) {
+		err = libusb_handle_events_completed(ufprog_global_libusb_context(), &handle->out_done[slot]);
+		if (err && err != LIBUSB_ERROR_INTERRUPTED) {
+			logm_err("Failed to handle usb events: %s\n", libusb_strerror(err));
+			ftdi_write_cancel_all(handle);
+			ret = UFP_DEVICE_IO_ERROR;
+		}
+	}
+
+	handle->out_head = (handle->out_head + 1) % FTDI_MAX_ASYNC_WRITES;
+	handle->out_count--;
+
+	if (ret)
+		return ret;
+
+	if (xfer->status != LIBUSB_TRANSFER_COMPLETED || xfer->actual_length != xfer->length) {
+		logm_warn("Incomplete bulk data transfer through usb: %u of %u written\n", xfer->actual_length,
+			  xfer->length);
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	return UFP_OK;
+}
+
+ufprog_status ftdi_write_async(struct ft_handle *handle, const void *buf, size_t len)
+{
+	uint32_t slot;
+	int err;
+
+	if (len > INT_MAX)
+		return ftdi_write(handle, buf, len);
+
+	if (handle->out_count == FTDI_MAX_ASYNC_WRITES)
+		STATUS_CHECK_RET(ftdi_write_wait_oldest(handle));
+
+	slot = (handle->out_head + handle->out_count) % FTDI_MAX_ASYNC_WRITES;
+
+	if (!handle->out_xfers[slot]) {
+		handle->out_xfers[slot] = libusb_alloc_transfer(0);
+		if (!handle->out_xfers[slot]) {
+			logm_err("No memory for usb transfer\n");
+			return UFP_NOMEM;
+		}
+	}
+
+	/* The buffer must stay untouched until the transfer is flushed */
+	libusb_fill_bulk_transfer(handle->out_xfers[slot], handle->handle, handle->out_ep, (uint8_t *)buf, (int)len,
+				  ftdi_write_async_cb, &handle->out_done[slot], handle->timeout);
+
+	handle->out_done[slot] = 0;
+
+	err = libusb_submit_transfer(handle->out_xfers[slot]);
+	if (err) {
+		logm_err("Failed to submit usb transfer: %s\n", libusb_strerror(err));
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	handle->out_count++;
+
+	return UFP_OK;
+}
+
+ufprog_status ftdi_write_flush(struct ft_handle *handle)
+{
+	ufprog_status ret = UFP_OK, ret2;
+
+	while (handle->out_count) {
+		ret2 = ftdi_write_wait_oldest(handle);
+		if (ret2 && !ret) {
+			ftdi_write_cancel_all(handle);
+			ret = ret2;
+		}
+	}
+
+	return ret;
+}
+
 ufprog_status ftdi_setup_handle(struct ft_handle *handle, struct libusb_device_handle *dev_handle,
 				uint8_t interface_number, uint8_t config_index, size_t max_read_size)
 {
@@ -373,6 +472,15 @@ ufprog_status ftdi_setup_handle(struct ft_handle *handle, struct libusb_device_h
 
 ufprog_status ftdi_cleanup_handle(struct ft_handle *handle)
 {
+	uint32_t i;
+
+	ftdi_write_flush(handle);
+
+	for (i = 0; i < FTDI_MAX_ASYNC_WRITES; i++) {
+		if (handle->out_xfers[i])
+			libusb_free_transfer(handle->out_xfers[i]);
+	}
+
 	if (handle->in_buffer)
 		free(handle->in_buffer);
 
@@ -9,8 +9,12 @@
 #ifndef _UFPROG_FTDI_LIBUSB_H_
 #define _UFPROG_FTDI_LIBUSB_H_
 
+#include <stdbool.h>
 #include <ufprog/libusb.h>
 
+/* Outgoing bulk transfers allowed in flight by ftdi_write_async() */
+#define FTDI_MAX_ASYNC_WRITES		2
+
 struct ft_handle {
 	struct libusb_device_handle *handle;
 	uint8_t *in_buffer;
@@ -26,6 +30,12 @@ struct ft_handle {
 	uint8_t *in_fifo;
 	size_t fifo_size;
 	size_t fifo_used;
+
+	/* Queue of asynchronous writes */
+	struct libusb_transfer *out_xfers[FTDI_MAX_ASYNC_WRITES];
+	int out_done[FTDI_MAX_ASYNC_WRITES];
+	uint32_t out_head;
+	uint32_t out_count;
 };
 
 ufprog_status ftdi_setup_handle(struct ft_handle *handle, struct libusb_device_handle *dev_handle,
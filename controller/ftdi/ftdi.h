@@ -43,6 +43,8 @@ ufprog_status ftdi_reset(struct ft_handle *handle);
 ufprog_status ftdi_purge_all(struct ft_handle *handle);
 ufprog_status ftdi_read(struct ft_handle *handle, void *buf, size_t len);
 ufprog_status ftdi_write(struct ft_handle *handle, const void *buf, size_t len);
+ufprog_status ftdi_write_async(struct ft_handle *handle, const void *buf, size_t len);
+ufprog_status ftdi_write_flush(struct ft_handle *handle);
 ufprog_status ftdi_vendor_cmd_get(struct ft_handle *handle, uint8_t request, void *buf, uint16_t len);
 ufprog_status ftdi_vendor_cmd_set(struct ft_handle *handle, uint8_t request, const void *buf, uint16_t len);
 ufprog_status ftdi_set_latency_timer(struct ft_handle *handle, uint8_t latency_ms);
@@ -19,6 +19,9 @@
 #define SERPROG_SPI_IF_MAJOR			1
 #define SERPROG_SPI_IF_MINOR			0
 
+#define SERPROG_SPIMEM_MAX_CMD_LEN		2
+#define SERPROG_SPIMEM_MAX_ADDR_LEN		8
+
 static ufprog_status serprog_read(struct ufprog_interface *dev, void *data, size_t len)
 {
 	ufprog_status ret;
@@ -38,6 +41,33 @@ static ufprog_status serprog_read(struct ufprog_interface *dev, void *data, size
 	return UFP_OK;
 }
 
+/* Keep reading until @len bytes are received or @wait_ms elapsed beyond the regular serial timeout */
+static ufprog_status serprog_read_extended(struct ufprog_interface *dev, void *data, size_t len, uint64_t wait_ms)
+{
+	uint64_t end_us = os_get_timer_us() + (wait_ms + dev->timeout_ms) * 1000;
+	uint8_t *p = data;
+	ufprog_status ret;
+	size_t retlen;
+
+	while (len) {
+		ret = serial_port_read(dev->port, p, len, &retlen);
+		if (ret) {
+			logm_err("Failed to read data from serial port\n");
+			return ret;
+		}
+
+		p += retlen;
+		len -= retlen;
+
+		if (len && os_get_timer_us() > end_us) {
+			logm_err("Serial port read timed out\n");
+			return UFP_TIMEOUT;
+		}
+	}
+
+	return UFP_OK;
+}
+
 static ufprog_status serprog_write(struct ufprog_interface *dev, const void *data, size_t len)
 {
 	ufprog_status ret;
@@ -110,11 +140,16 @@ static ufprog_status serprog_query(struct ufprog_interface *dev, uint8_t cmd, vo
 	return serprog_exec(dev, cmd, NULL, 0, data, len, true);
 }
 
+static bool serprog_cmd_supported(struct ufprog_interface *dev, uint8_t cmd)
+{
+	return !!(dev->cmdmap[cmd / 8] & BIT(cmd % 8));
+}
+
 ufprog_status serprog_spi_init(struct ufprog_interface *dev)
 {
 	uint32_t cmdbitmap, spi_freq;
 	char name[17] = { 0 };
-	uint8_t data[32];
+	uint8_t data[4];
 	uint16_t ver;
 
 	STATUS_CHECK_RET(serprog_sync(dev));
@@ -122,8 +157,9 @@ ufprog_status serprog_spi_init(struct ufprog_interface *dev)
 	STATUS_CHECK_RET(serprog_query(dev, S_CMD_Q_IFACE, &ver, 2));
 	ver = le16toh(ver);
 
-	STATUS_CHECK_RET(serprog_query(dev, S_CMD_Q_CMDMAP, data, 32));
-	cmdbitmap = data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+	STATUS_CHECK_RET(serprog_query(dev, S_CMD_Q_CMDMAP, dev->cmdmap, sizeof(dev->cmdmap)));
+	cmdbitmap = dev->cmdmap[0] | ((uint32_t)dev->cmdmap[1] << 8) | ((uint32_t)dev->cmdmap[2] << 16) |
+		    ((uint32_t)dev->cmdmap[3] << 24);
 
 	if (cmdbitmap & BIT(S_CMD_Q_PGMNAME)) {
 		STATUS_CHECK_RET(serprog_query(dev, S_CMD_Q_PGMNAME, name, 16));
@@ -162,6 +198,14 @@ ufprog_status serprog_spi_init(struct ufprog_interface *dev)
 		STATUS_CHECK_RET(serprog_exec(dev, S_CMD_S_PIN_STATE, data, 1, NULL, 0, true));
 	}
 
+	if (serprog_cmd_supported(dev, S_CMD_O_SPIMEM_OP) && serprog_cmd_supported(dev, S_CMD_Q_SPIMEM_CAPS)) {
+		STATUS_CHECK_RET(serprog_query(dev, S_CMD_Q_SPIMEM_CAPS, &dev->spimem_caps, 1));
+
+		logm_info("spi-mem extension:%s%s%s\n", dev->spimem_caps & SERPROG_SPIMEM_DUAL ? " dual" : "",
+			  dev->spimem_caps & SERPROG_SPIMEM_QUAD ? " quad" : "",
+			  serprog_cmd_supported(dev, S_CMD_O_SPIMEM_POLL) ? " poll" : "");
+	}
+
 	return UFP_OK;
 }
 
@@ -242,6 +286,40 @@ ufprog_status UFPROG_API ufprog_spi_mem_adjust_op_size(struct ufprog_interface *
 	return UFP_OK;
 }
 
+static bool serprog_buswidth_supported(struct ufprog_interface *dev, uint8_t buswidth)
+{
+	switch (buswidth) {
+	case 1:
+		return true;
+
+	case 2:
+		return !!(dev->spimem_caps & SERPROG_SPIMEM_DUAL);
+
+	case 4:
+		return !!(dev->spimem_caps & SERPROG_SPIMEM_QUAD);
+
+	default:
+		return false;
+	}
+}
+
+static bool serprog_spi_mem_is_single_io(const struct ufprog_spi_mem_op *op)
+{
+	if (op->cmd.len && op->cmd.buswidth != 1)
+		return false;
+
+	if (op->addr.len && op->addr.buswidth != 1)
+		return false;
+
+	if (op->dummy.len && op->dummy.buswidth != 1)
+		return false;
+
+	if (op->data.len && op->data.buswidth != 1)
+		return false;
+
+	return true;
+}
+
 ufprog_bool UFPROG_API ufprog_spi_mem_supports_op(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
 {
 	size_t n = 0;
@@ -249,22 +327,22 @@ ufprog_bool UFPROG_API ufprog_spi_mem_supports_op(struct ufprog_interface *dev,
 	if (!dev)
 		return false;
 
-	if (op->cmd.len && (op->cmd.buswidth != 1 || op->cmd.dtr))
+	if (op->cmd.len && (!serprog_buswidth_supported(dev, op->cmd.buswidth) || op->cmd.dtr))
 		return false;
 
 	n += op->cmd.len;
 
-	if (op->addr.len && (op->addr.buswidth != 1 || op->addr.dtr))
+	if (op->addr.len && (!serprog_buswidth_supported(dev, op->addr.buswidth) || op->addr.dtr))
 		return false;
 
 	n += op->addr.len;
 
-	if (op->dummy.len && (op->dummy.buswidth != 1 || op->dummy.dtr))
+	if (op->dummy.len && (!serprog_buswidth_supported(dev, op->dummy.buswidth) || op->dummy.dtr))
 		return false;
 
 	n += op->dummy.len;
 
-	if (op->data.len && (op->data.buswidth != 1 || op->data.dtr))
+	if (op->data.len && (!serprog_buswidth_supported(dev, op->data.buswidth) || op->data.dtr))
 		return false;
 
 	if (op->data.dir == SPI_DATA_OUT) {
@@ -275,15 +353,12 @@ ufprog_bool UFPROG_API ufprog_spi_mem_supports_op(struct ufprog_interface *dev,
 	return true;
 }
 
-ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
+static ufprog_status serprog_spiop_exec(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
 {
 	size_t nout = 0, nin = 0;
 	uint8_t buf[256], resp;
 	uint32_t i;
 
-	if (!dev)
-		return UFP_INVALID_PARAMETER;
-
 	nout = op->cmd.len + op->addr.len + op->dummy.len;
 
 	if (op->data.dir == SPI_DATA_OUT)
@@ -336,3 +411,194 @@ ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *dev, co
 
 	return UFP_OK;
 }
+
+static size_t serprog_put_le(uint8_t *buf, uint32_t val, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (val >> i * 8) & 0xff;
+
+	return len;
+}
+
+/*
+ * spi-mem op header of the extension commands:
+ *   [0] cmd length, [1] cmd buswidth
+ *   [2] addr length, [3] addr buswidth
+ *   [4] dummy length in bytes, [5] dummy buswidth
+ *   [6] data buswidth, bit 7 set for data in
+ *   [7..9] data length, little-endian
+ * followed by opcode and address bytes. Dummy cycles are generated by the programmer.
+ */
+static ufprog_status serprog_spimem_fill_hdr(const struct ufprog_spi_mem_op *op, uint8_t *buf, size_t *retlen)
+{
+	size_t n = SERPROG_SPIMEM_OP_HDR_LEN;
+	uint32_t i;
+
+	if (op->cmd.len > SERPROG_SPIMEM_MAX_CMD_LEN || op->addr.len > SERPROG_SPIMEM_MAX_ADDR_LEN)
+		return UFP_UNSUPPORTED;
+
+	buf[0] = op->cmd.len;
+	buf[1] = op->cmd.buswidth;
+	buf[2] = op->addr.len;
+	buf[3] = op->addr.buswidth;
+	buf[4] = op->dummy.len;
+	buf[5] = op->dummy.buswidth;
+	buf[6] = op->data.buswidth & SERPROG_SPIMEM_DATA_BW_M;
+
+	if (op->data.dir == SPI_DATA_IN)
+		buf[6] |= SERPROG_SPIMEM_DATA_IN;
+
+	serprog_put_le(buf + 7, (uint32_t)op->data.len, 3);
+
+	for (i = 0; i < op->cmd.len; i++)
+		buf[n++] = (op->cmd.opcode >> i * 8) & 0xff;
+
+	for (i = 0; i < op->addr.len; i++)
+		buf[n++] = (op->addr.val >> (op->addr.len - i - 1) * 8) & 0xff;
+
+	*retlen = n;
+
+	return UFP_OK;
+}
+
+static ufprog_status serprog_spimem_exec(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
+{
+	uint8_t buf[32], resp;
+	size_t n;
+
+	buf[0] = S_CMD_O_SPIMEM_OP;
+	STATUS_CHECK_RET(serprog_spimem_fill_hdr(op, buf + 1, &n));
+
+	STATUS_CHECK_RET(serprog_write(dev, buf, n + 1));
+
+	if (op->data.dir == SPI_DATA_OUT && op->data.len)
+		STATUS_CHECK_RET(serprog_write(dev, op->data.buf.tx, op->data.len));
+
+	STATUS_CHECK_RET(serprog_read(dev, &resp, 1));
+
+	if (resp != S_ACK) {
+		logm_err("Serprog returned wrong response\n");
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	if (op->data.dir == SPI_DATA_IN && op->data.len)
+		STATUS_CHECK_RET(serprog_read(dev, op->data.buf.rx, op->data.len));
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
+{
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (serprog_spi_mem_is_single_io(op))
+		return serprog_spiop_exec(dev, op);
+
+	return serprog_spimem_exec(dev, op);
+}
+
+static ufprog_status serprog_host_poll_status(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op,
+					      uint16_t mask, uint16_t match, uint32_t initial_delay_us,
+					      uint32_t polling_rate_us, uint32_t timeout_ms)
+{
+	uint64_t end_us;
+	uint8_t *buf;
+	uint16_t val;
+
+	if (initial_delay_us)
+		os_usleep(initial_delay_us);
+
+	buf = op->data.buf.rx;
+	end_us = os_get_timer_us() + (uint64_t)timeout_ms * 1000;
+
+	do {
+		STATUS_CHECK_RET(ufprog_spi_mem_exec_op(dev, op));
+
+		if (op->data.len == 2)
+			val = ((uint16_t)buf[0] << 8) | buf[1];
+		else
+			val = buf[0];
+
+		if ((val & mask) == match)
+			return UFP_OK;
+
+		if (polling_rate_us)
+			os_usleep(polling_rate_us);
+	} while (os_get_timer_us() <= end_us);
+
+	/* Last check */
+	STATUS_CHECK_RET(ufprog_spi_mem_exec_op(dev, op));
+
+	if (op->data.len == 2)
+		val = ((uint16_t)buf[0] << 8) | buf[1];
+	else
+		val = buf[0];
+
+	if ((val & mask) == match)
+		return UFP_OK;
+
+	return UFP_TIMEOUT;
+}
+
+ufprog_status UFPROG_API ufprog_spi_mem_poll_status(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op,
+						    uint16_t mask, uint16_t match, uint32_t initial_delay_us,
+						    uint32_t polling_rate_us, uint32_t timeout_ms)
+{
+	uint8_t buf[48], resp;
+	uint64_t wait_ms;
+	size_t n;
+
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (op->data.len < 1 || op->data.len > 2 || op->data.dir != SPI_DATA_IN)
+		return UFP_UNSUPPORTED;
+
+	if (!ufprog_spi_mem_supports_op(dev, op))
+		return UFP_UNSUPPORTED;
+
+	if (!serprog_cmd_supported(dev, S_CMD_O_SPIMEM_POLL))
+		return serprog_host_poll_status(dev, op, mask, match, initial_delay_us, polling_rate_us, timeout_ms);
+
+	buf[0] = S_CMD_O_SPIMEM_POLL;
+	STATUS_CHECK_RET(serprog_spimem_fill_hdr(op, buf + 1, &n));
+	n++;
+	n += serprog_put_le(buf + n, mask, 2);
+	n += serprog_put_le(buf + n, match, 2);
+	n += serprog_put_le(buf + n, initial_delay_us, 4);
+	n += serprog_put_le(buf + n, polling_rate_us, 4);
+	n += serprog_put_le(buf + n, timeout_ms, 4);
+
+	STATUS_CHECK_RET(serprog_write(dev, buf, n));
+
+	/*
+	 * ACK followed by the poll result, which arrives only after the programmer finishes polling.
+	 * A NAK is sent alone, so it must be checked before waiting for the result.
+	 */
+	wait_ms = (uint64_t)timeout_ms + initial_delay_us / 1000 + 1;
+
+	STATUS_CHECK_RET(serprog_read_extended(dev, &resp, 1, wait_ms));
+
+	if (resp != S_ACK) {
+		logm_err("Serprog returned wrong response\n");
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	STATUS_CHECK_RET(serprog_read_extended(dev, &resp, 1, wait_ms));
+
+	/* Last status value read by the programmer */
+	STATUS_CHECK_RET(serprog_read(dev, op->data.buf.rx, op->data.len));
+
+	if (resp == SERPROG_POLL_TIMEOUT)
+		return UFP_TIMEOUT;
+
+	if (resp != SERPROG_POLL_MATCH) {
+		logm_err("Serprog returned invalid poll result %u\n", resp);
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	return UFP_OK;
+}
@@ -35,8 +35,29 @@
 #define S_CMD_S_SPI_FREQ				0x14	/* Set SPI clock frequency			*/
 #define S_CMD_S_PIN_STATE				0x15	/* Enable/disable output drivers		*/
 
+/* Optional extension commands, negotiated through S_CMD_Q_CMDMAP */
+#define S_CMD_Q_SPIMEM_CAPS				0x40	/* Query spi-mem extension capabilities		*/
+#define S_CMD_O_SPIMEM_OP				0x41	/* Perform spi-mem operation with multi-I/O	*/
+#define S_CMD_O_SPIMEM_POLL				0x42	/* Poll status register until match/timeout	*/
+
 #define BUS_SPI						BIT(3)
 
+#define SERPROG_CMDMAP_SIZE				32
+
+/* Capabilities returned by S_CMD_Q_SPIMEM_CAPS */
+#define SERPROG_SPIMEM_DUAL				BIT(0)
+#define SERPROG_SPIMEM_QUAD				BIT(1)
+
+/* Byte 6 of spi-mem op header */
+#define SERPROG_SPIMEM_DATA_IN				BIT(7)
+#define SERPROG_SPIMEM_DATA_BW_M			0x0f
+
+#define SERPROG_SPIMEM_OP_HDR_LEN			10
+
+/* Result byte of S_CMD_O_SPIMEM_POLL */
+#define SERPROG_POLL_MATCH				0
+#define SERPROG_POLL_TIMEOUT				1
+
 struct ufprog_interface {
 	const char *path;
 	serial_port port;
@@ -47,6 +68,9 @@ struct ufprog_interface {
 	uint32_t min_spi_freq;
 	uint32_t curr_spi_freq;
 
+	uint8_t cmdmap[SERPROG_CMDMAP_SIZE];
+	uint8_t spimem_caps;
+
 	mutex_handle lock;
 };
 
@@ -0,0 +1,378 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SPI master interface driver for Linux spidev
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+/* Identical values are defined by api_spi.h */
+#undef SPI_MODE_0
+#undef SPI_MODE_1
+#undef SPI_MODE_2
+#undef SPI_MODE_3
+
+#include <ufprog/api_spi.h>
+#include <ufprog/log.h>
+#include "spidev.h"
+
+#define SPIDEV_SPI_IF_MAJOR			1
+#define SPIDEV_SPI_IF_MINOR			0
+
+uint32_t spidev_caps;
+
+ufprog_status spidev_spi_init(struct ufprog_interface *dev)
+{
+	if (ioctl(dev->fd, SPI_IOC_RD_MODE32, &dev->mode) < 0) {
+		logm_err("Failed to get SPI mode of %s: %s\n", dev->path, strerror(errno));
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	if (ioctl(dev->fd, SPI_IOC_RD_MAX_SPEED_HZ, &dev->max_speed) < 0) {
+		logm_err("Failed to get SPI max speed of %s: %s\n", dev->path, strerror(errno));
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	dev->speed = dev->max_speed;
+
+	spidev_caps = 0;
+
+	if ((dev->mode & (SPI_TX_DUAL | SPI_TX_QUAD)) && (dev->mode & (SPI_RX_DUAL | SPI_RX_QUAD)))
+		spidev_caps |= UFP_SPI_GEN_DUAL;
+
+	if ((dev->mode & SPI_TX_QUAD) && (dev->mode & SPI_RX_QUAD))
+		spidev_caps |= UFP_SPI_GEN_QUAD;
+
+	logm_dbg("Mode 0x%x, max speed %uHz, buffer size %zu\n", dev->mode, dev->max_speed, spidev_bufsiz);
+
+	return UFP_OK;
+}
+
+static ufprog_status spidev_set_mode32(struct ufprog_interface *dev, uint32_t mode)
+{
+	if (ioctl(dev->fd, SPI_IOC_WR_MODE32, &mode) < 0) {
+		logm_err("Failed to set SPI mode 0x%x: %s\n", mode, strerror(errno));
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	dev->mode = mode;
+
+	return UFP_OK;
+}
+
+static bool spidev_buswidth_supported(struct ufprog_interface *dev, uint8_t buswidth, bool tx)
+{
+	switch (buswidth) {
+	case 1:
+		return true;
+
+	case 2:
+		if (tx)
+			return !!(dev->mode & (SPI_TX_DUAL | SPI_TX_QUAD));
+		return !!(dev->mode & (SPI_RX_DUAL | SPI_RX_QUAD));
+
+	case 4:
+		if (tx)
+			return !!(dev->mode & SPI_TX_QUAD);
+		return !!(dev->mode & SPI_RX_QUAD);
+
+	default:
+		return false;
+	}
+}
+
+static ufprog_status spidev_message(struct ufprog_interface *dev, struct spi_ioc_transfer *xfers, uint32_t count)
+{
+	if (!count)
+		return UFP_OK;
+
+	if (ioctl(dev->fd, SPI_IOC_MESSAGE(count), xfers) < 0) {
+		logm_err("SPI message with %u transfers failed: %s\n", count, strerror(errno));
+		return UFP_DEVICE_IO_ERROR;
+	}
+
+	return UFP_OK;
+}
+
+uint32_t UFPROG_API ufprog_spi_if_version(void)
+{
+	return MAKE_VERSION(SPIDEV_SPI_IF_MAJOR, SPIDEV_SPI_IF_MINOR);
+}
+
+uint32_t UFPROG_API ufprog_spi_if_caps(void)
+{
+	return spidev_caps;
+}
+
+size_t UFPROG_API ufprog_spi_max_read_granularity(void)
+{
+	return spidev_bufsiz - SPIDEV_MAX_HDR_LEN;
+}
+
+size_t UFPROG_API ufprog_spi_generic_xfer_max_size(void)
+{
+	return spidev_bufsiz;
+}
+
+ufprog_status UFPROG_API ufprog_spi_set_speed(struct ufprog_interface *dev, uint32_t hz, uint32_t *rethz)
+{
+	if (!dev || !hz)
+		return UFP_INVALID_PARAMETER;
+
+	if (dev->max_speed && hz > dev->max_speed)
+		hz = dev->max_speed;
+
+	/* Applied per transfer */
+	dev->speed = hz;
+
+	if (rethz)
+		*rethz = hz;
+
+	return UFP_OK;
+}
+
+uint32_t UFPROG_API ufprog_spi_get_speed(struct ufprog_interface *dev)
+{
+	if (!dev)
+		return 0;
+
+	return dev->speed;
+}
+
+ufprog_status UFPROG_API ufprog_spi_set_mode(struct ufprog_interface *dev, uint32_t mode)
+{
+	ufprog_status ret;
+	uint32_t newmode;
+
+	if (!dev || mode > 3)
+		return UFP_INVALID_PARAMETER;
+
+	newmode = dev->mode & ~(SPI_CPHA | SPI_CPOL);
+
+	if (mode & SPI_MODE_CPHA)
+		newmode |= SPI_CPHA;
+
+	if (mode & SPI_MODE_CPOL)
+		newmode |= SPI_CPOL;
+
+	os_mutex_lock(dev->lock);
+	ret = spidev_set_mode32(dev, newmode);
+	os_mutex_unlock(dev->lock);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_spi_set_cs_pol(struct ufprog_interface *dev, ufprog_bool positive)
+{
+	ufprog_status ret;
+	uint32_t newmode;
+
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (positive)
+		newmode = dev->mode | SPI_CS_HIGH;
+	else
+		newmode = dev->mode & ~SPI_CS_HIGH;
+
+	os_mutex_lock(dev->lock);
+	ret = spidev_set_mode32(dev, newmode);
+	os_mutex_unlock(dev->lock);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_spi_generic_xfer(struct ufprog_interface *dev, const struct ufprog_spi_transfer *xfers,
+						 uint32_t count)
+{
+	struct spi_ioc_transfer ioxfers[SPIDEV_MAX_XFERS];
+	ufprog_status ret = UFP_OK;
+	uint32_t i, n = 0;
+	size_t msglen = 0;
+
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	for (i = 0; i < count; i++) {
+		if (xfers[i].dtr || !spidev_buswidth_supported(dev, xfers[i].buswidth, xfers[i].dir == SPI_DATA_OUT))
+			return UFP_UNSUPPORTED;
+
+		if (xfers[i].len > spidev_bufsiz)
+			return UFP_INVALID_PARAMETER;
+	}
+
+	os_mutex_lock(dev->lock);
+
+	memset(ioxfers, 0, sizeof(ioxfers));
+
+	for (i = 0; i < count; i++) {
+		/* Flush accumulated transfers with chip select kept asserted */
+		if (n == SPIDEV_MAX_XFERS || msglen + xfers[i].len > spidev_bufsiz) {
+			ioxfers[n - 1].cs_change = 1;
+			STATUS_CHECK_GOTO_RET(spidev_message(dev, ioxfers, n), ret, out);
+			memset(ioxfers, 0, sizeof(ioxfers));
+			n = 0;
+			msglen = 0;
+		}
+
+		ioxfers[n].len = (uint32_t)xfers[i].len;
+		ioxfers[n].speed_hz = xfers[i].speed ? xfers[i].speed : dev->speed;
+		ioxfers[n].bits_per_word = 8;
+
+		if (xfers[i].dir == SPI_DATA_OUT) {
+			ioxfers[n].tx_buf = (uintptr_t)xfers[i].buf.tx;
+			ioxfers[n].tx_nbits = xfers[i].buswidth;
+		} else {
+			ioxfers[n].rx_buf = (uintptr_t)xfers[i].buf.rx;
+			ioxfers[n].rx_nbits = xfers[i].buswidth;
+		}
+
+		msglen += xfers[i].len;
+		n++;
+
+		if (xfers[i].end) {
+			STATUS_CHECK_GOTO_RET(spidev_message(dev, ioxfers, n), ret, out);
+			memset(ioxfers, 0, sizeof(ioxfers));
+			n = 0;
+			msglen = 0;
+		}
+	}
+
+	/* Chip select stays asserted for following calls */
+	if (n) {
+		ioxfers[n - 1].cs_change = 1;
+		ret = spidev_message(dev, ioxfers, n);
+	}
+
+out:
+	os_mutex_unlock(dev->lock);
+
+	return ret;
+}
+
+static size_t spidev_spi_mem_hdr_len(const struct ufprog_spi_mem_op *op)
+{
+	return op->cmd.len + op->addr.len + op->dummy.len;
+}
+
+ufprog_status UFPROG_API ufprog_spi_mem_adjust_op_size(struct ufprog_interface *dev, struct ufprog_spi_mem_op *op)
+{
+	size_t n;
+
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	n = spidev_spi_mem_hdr_len(op);
+	if (n >= spidev_bufsiz)
+		return UFP_UNSUPPORTED;
+
+	if (op->data.len > spidev_bufsiz - n)
+		op->data.len = spidev_bufsiz - n;
+
+	return UFP_OK;
+}
+
+ufprog_bool UFPROG_API ufprog_spi_mem_supports_op(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
+{
+	if (!dev)
+		return false;
+
+	if (op->cmd.len && (op->cmd.dtr || op->cmd.len > 2 || !spidev_buswidth_supported(dev, op->cmd.buswidth, true)))
+		return false;
+
+	if (op->addr.len && (op->addr.dtr || op->addr.len > 8 ||
+	    !spidev_buswidth_supported(dev, op->addr.buswidth, true)))
+		return false;
+
+	if (op->dummy.len && (op->dummy.dtr || !spidev_buswidth_supported(dev, op->dummy.buswidth, true)))
+		return false;
+
+	if (op->data.len && (op->data.dtr ||
+	    !spidev_buswidth_supported(dev, op->data.buswidth, op->data.dir == SPI_DATA_OUT)))
+		return false;
+
+	if (spidev_spi_mem_hdr_len(op) > SPIDEV_MAX_HDR_LEN)
+		return false;
+
+	return true;
+}
+
+ufprog_status UFPROG_API ufprog_spi_mem_exec_op(struct ufprog_interface *dev, const struct ufprog_spi_mem_op *op)
+{
+	struct spi_ioc_transfer ioxfers[4];
+	uint8_t hdr[SPIDEV_MAX_HDR_LEN];
+	ufprog_status ret;
+	uint32_t i, n = 0;
+	uint8_t *p = hdr;
+
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (spidev_spi_mem_hdr_len(op) > sizeof(hdr) || spidev_spi_mem_hdr_len(op) + op->data.len > spidev_bufsiz)
+		return UFP_INVALID_PARAMETER;
+
+	memset(ioxfers, 0, sizeof(ioxfers));
+
+	/* One transfer per phase. All phases go in one message. */
+	if (op->cmd.len) {
+		p[0] = op->cmd.opcode & 0xff;
+		if (op->cmd.len > 1)
+			p[1] = (op->cmd.opcode >> 8) & 0xff;
+
+		ioxfers[n].tx_buf = (uintptr_t)p;
+		ioxfers[n].len = op->cmd.len;
+		ioxfers[n].tx_nbits = op->cmd.buswidth;
+		p += op->cmd.len;
+		n++;
+	}
+
+	if (op->addr.len) {
+		for (i = 0; i < op->addr.len; i++)
+			p[i] = (op->addr.val >> (8 * (op->addr.len - i - 1))) & 0xff;
+
+		ioxfers[n].tx_buf = (uintptr_t)p;
+		ioxfers[n].len = op->addr.len;
+		ioxfers[n].tx_nbits = op->addr.buswidth;
+		p += op->addr.len;
+		n++;
+	}
+
+	if (op->dummy.len) {
+		memset(p, 0xff, op->dummy.len);
+
+		ioxfers[n].tx_buf = (uintptr_t)p;
+		ioxfers[n].len = op->dummy.len;
+		ioxfers[n].tx_nbits = op->dummy.buswidth;
+		p += op->dummy.len;
+		n++;
+	}
+
+	if (op->data.len) {
+		if (op->data.dir == SPI_DATA_OUT) {
+			ioxfers[n].tx_buf = (uintptr_t)op->data.buf.tx;
+			ioxfers[n].tx_nbits = op->data.buswidth;
+		} else {
+			ioxfers[n].rx_buf = (uintptr_t)op->data.buf.rx;
+			ioxfers[n].rx_nbits = op->data.buswidth;
+		}
+
+		ioxfers[n].len = (uint32_t)op->data.len;
+		n++;
+	}
+
+	for (i = 0; i < n; i++) {
+		ioxfers[i].speed_hz = dev->speed;
+		ioxfers[i].bits_per_word = 8;
+	}
+
+	os_mutex_lock(dev->lock);
+	ret = spidev_message(dev, ioxfers, n);
+	os_mutex_unlock(dev->lock);
+
+	return ret;
+}
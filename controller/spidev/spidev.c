@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Interface driver for SPI using Linux spidev
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <ufprog/api_controller.h>
+#include <ufprog/config.h>
+#include <ufprog/log.h>
+#include <ufprog/string.h>
+#include "spidev.h"
+
+#define SPIDEV_DRV_API_VER_MAJOR			1
+#define SPIDEV_DRV_API_VER_MINOR			0
+
+size_t spidev_bufsiz = SPIDEV_DEFAULT_BUFSIZ;
+
+ufprog_status UFPROG_API ufprog_plugin_init(void)
+{
+	unsigned long bufsiz;
+	FILE *f;
+
+	f = fopen(SPIDEV_BUFSIZ_PARAM, "r");
+	if (!f) {
+		logm_dbg("Unable to read %s, assuming %u bytes\n", SPIDEV_BUFSIZ_PARAM, SPIDEV_DEFAULT_BUFSIZ);
+		return UFP_OK;
+	}
+
+	if (fscanf(f, "%lu", &bufsiz) == 1 && bufsiz > SPIDEV_MAX_HDR_LEN)
+		spidev_bufsiz = bufsiz;
+
+	fclose(f);
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_plugin_cleanup(void)
+{
+	return UFP_OK;
+}
+
+const char *UFPROG_API ufprog_plugin_desc(void)
+{
+	return "Linux spidev";
+}
+
+uint32_t UFPROG_API ufprog_controller_supported_if(void)
+{
+	return IFM_SPI;
+}
+
+static int UFPROG_API spidev_try_match_open(void *priv, struct json_object *match, int index)
+{
+	struct ufprog_interface *dev = priv;
+	const char *path;
+	ufprog_status ret;
+
+	ret = json_read_str(match, "path", &path, NULL);
+	if (ret || !path) {
+		logm_warn("Invalid spidev path in match#%u\n", index);
+		return 0;
+	}
+
+	dev->fd = open(path, O_RDWR);
+	if (dev->fd < 0) {
+		logm_warn("Failed to open %s: %s\n", path, strerror(errno));
+		return 0;
+	}
+
+	dev->path = os_strdup(path);
+	if (!dev->path) {
+		close(dev->fd);
+		dev->fd = -1;
+		return 0;
+	}
+
+	return 1;
+}
+
+ufprog_status UFPROG_API ufprog_device_open(uint32_t if_type, struct json_object *config, ufprog_bool thread_safe,
+					    struct ufprog_interface **outifdev)
+{
+	struct ufprog_interface *dev;
+	ufprog_status ret;
+
+	if (!outifdev)
+		return UFP_INVALID_PARAMETER;
+
+	*outifdev = NULL;
+
+	if (if_type != IF_SPI)
+		return UFP_UNSUPPORTED;
+
+	if (!config) {
+		logm_err("Device connection configuration required\n");
+		return UFP_DEVICE_MISSING_CONFIG;
+	}
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		logm_err("No memory for device object\n");
+		return UFP_NOMEM;
+	}
+
+	dev->fd = -1;
+
+	STATUS_CHECK_GOTO_RET(json_array_foreach(config, "match", spidev_try_match_open, dev, NULL), ret, cleanup);
+
+	if (dev->fd < 0) {
+		logm_errdbg("No matched device opened\n");
+		ret = UFP_DEVICE_NOT_FOUND;
+		goto cleanup;
+	}
+
+	if (thread_safe) {
+		if (!os_create_mutex(&dev->lock)) {
+			logm_err("Failed to create lock for thread-safe");
+			ret = UFP_LOCK_FAIL;
+			goto cleanup;
+		}
+	}
+
+	logm_info("Opened spidev device %s\n", dev->path);
+
+	STATUS_CHECK_GOTO_RET(spidev_spi_init(dev), ret, cleanup);
+
+	*outifdev = dev;
+	return UFP_OK;
+
+cleanup:
+	if (dev->fd >= 0)
+		close(dev->fd);
+
+	if (dev->path)
+		free(dev->path);
+
+	if (dev->lock)
+		os_free_mutex(dev->lock);
+
+	free(dev);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_device_free(struct ufprog_interface *dev)
+{
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	close(dev->fd);
+
+	free(dev->path);
+
+	if (dev->lock)
+		os_free_mutex(dev->lock);
+
+	free(dev);
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_device_lock(struct ufprog_interface *dev)
+{
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (!dev->lock)
+		return UFP_OK;
+
+	return os_mutex_lock(dev->lock) ? UFP_OK : UFP_LOCK_FAIL;
+}
+
+ufprog_status UFPROG_API ufprog_device_unlock(struct ufprog_interface *dev)
+{
+	if (!dev)
+		return UFP_INVALID_PARAMETER;
+
+	if (!dev->lock)
+		return UFP_OK;
+
+	return os_mutex_unlock(dev->lock) ? UFP_OK : UFP_LOCK_FAIL;
+}
+
+uint32_t UFPROG_API ufprog_plugin_api_version(void)
+{
+	return MAKE_VERSION(SPIDEV_DRV_API_VER_MAJOR, SPIDEV_DRV_API_VER_MINOR);
+}
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Linux spidev definitions
+ */
+#pragma once
+
+#ifndef _UFPROG_SPIDEV_H_
+#define _UFPROG_SPIDEV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <ufprog/osdef.h>
+#include <ufprog/config.h>
+
+#define SPIDEV_BUFSIZ_PARAM			"/sys/module/spidev/parameters/bufsiz"
+#define SPIDEV_DEFAULT_BUFSIZ			4096
+
+/* Room reserved for opcode/address/dummy bytes in one message */
+#define SPIDEV_MAX_HDR_LEN			32
+
+/* Transfers submitted in one SPI_IOC_MESSAGE by generic xfer */
+#define SPIDEV_MAX_XFERS			16
+
+struct ufprog_interface {
+	char *path;
+	int fd;
+
+	uint32_t mode;
+	uint32_t speed;
+	uint32_t max_speed;
+
+	mutex_handle lock;
+};
+
+/* Maximum bytes of one message, taken from the spidev module parameter */
+extern size_t spidev_bufsiz;
+
+/* Generic transfer capabilities of the last opened device */
+extern uint32_t spidev_caps;
+
+ufprog_status spidev_spi_init(struct ufprog_interface *dev);
+
+#endif /* _UFPROG_SPIDEV_H_ */
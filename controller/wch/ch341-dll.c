@@ -179,3 +179,48 @@ ufprog_status UFPROG_API ufprog_device_free(struct ufprog_interface *wchdev)
 	return UFP_OK;
 
 }
+
+ufprog_status ch341_stream_xfer(struct ch34x_handle *handle, const void *out, size_t outlen, void *in, size_t inlen)
+{
+	const uint8_t *pout = out;
+	size_t chksz, npackets;
+	uint8_t *pin = in;
+	ULONG iolen;
+
+	npackets = inlen / CH341_STREAM_DATA_LEN;
+
+	/* Let the vendor library pipeline all full-sized packets */
+	if (CH341WriteRead && npackets) {
+		iolen = 0;
+
+		if (!CH341WriteRead(handle->iIndex, (ULONG)(npackets * CH341_PACKET_LEN), (PVOID)pout,
+				    CH341_STREAM_DATA_LEN, (ULONG)npackets, &iolen, pin)) {
+			logm_err("CH341WriteRead() failed\n");
+			return UFP_DEVICE_IO_ERROR;
+		}
+
+		if (iolen != npackets * CH341_STREAM_DATA_LEN) {
+			logm_err("CH341WriteRead() returned incomplete data\n");
+			return UFP_DEVICE_IO_ERROR;
+		}
+
+		pout += npackets * CH341_PACKET_LEN;
+		pin += npackets * CH341_STREAM_DATA_LEN;
+		inlen -= npackets * CH341_STREAM_DATA_LEN;
+	}
+
+	while (inlen) {
+		chksz = inlen;
+		if (chksz > CH341_STREAM_DATA_LEN)
+			chksz = CH341_STREAM_DATA_LEN;
+
+		STATUS_CHECK_RET(ch341_write(handle, pout, chksz + 1, NULL));
+		STATUS_CHECK_RET(ch341_read(handle, pin, chksz, NULL));
+
+		pout += chksz + 1;
+		pin += chksz;
+		inlen -= chksz;
+	}
+
+	return UFP_OK;
+}
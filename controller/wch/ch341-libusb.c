@@ -18,6 +18,9 @@
  /* So, keep sync with vendor dll */
 #define CH341_MAX_PACKET_SIZE		0x1000
 
+/* Consecutive event handling failures before giving up reaping stream transfers */
+#define CH341_STREAM_EVENT_RETRIES	16
+
 struct ch34x_handle {
 	struct libusb_device_handle *handle;
 };
@@ -205,6 +208,126 @@ ufprog_status ch341_write(struct ch34x_handle *handle, const void *buf, size_t l
 	return UFP_OK;
 }
 
+struct ch341_stream_state {
+	uint32_t pending;
+	bool failed;
+};
+
+static void LIBUSB_CALL ch341_stream_xfer_cb(struct libusb_transfer *transfer)
+{
+	struct ch341_stream_state *st = transfer->user_data;
+
+	if (transfer->status != LIBUSB_TRANSFER_COMPLETED || transfer->actual_length != transfer->length)
+		st->failed = true;
+
+	st->pending--;
+}
+
+ufprog_status ch341_stream_xfer(struct ch34x_handle *handle, const void *out, size_t outlen, void *in, size_t inlen)
+{
+	struct libusb_transfer *transfers[CH341_MAX_STREAM_PACKETS + 1] = { 0 };
+	uint32_t i, n, npackets, submitted = 0, errors = 0;
+	struct ch341_stream_state *st;
+	ufprog_status ret = UFP_OK;
+	bool cancelled = false;
+	size_t chksz;
+	int err;
+
+	npackets = (uint32_t)((inlen + CH341_STREAM_DATA_LEN - 1) / CH341_STREAM_DATA_LEN);
+
+	if (outlen > CH341_MAX_PACKET_SIZE || npackets > CH341_MAX_STREAM_PACKETS)
+		return UFP_INVALID_PARAMETER;
+
+	n = npackets + 1;
+
+	/* Transfers which can't be reaped are leaked along with this, so it must not live on the stack */
+	st = calloc(1, sizeof(*st));
+	if (!st) {
+		logm_err("No memory for usb stream state\n");
+		return UFP_NOMEM;
+	}
+
+	for (i = 0; i < n; i++) {
+		transfers[i] = libusb_alloc_transfer(0);
+		if (!transfers[i]) {
+			logm_err("No memory for usb transfer\n");
+			ret = UFP_NOMEM;
+			goto cleanup;
+		}
+	}
+
+	/* Each stream packet is answered by one short IN packet. Queue them all before sending. */
+	for (i = 0; i < npackets; i++) {
+		chksz = inlen - i * CH341_STREAM_DATA_LEN;
+		if (chksz > CH341_STREAM_DATA_LEN)
+			chksz = CH341_STREAM_DATA_LEN;
+
+		libusb_fill_bulk_transfer(transfers[i], handle->handle, CH341_BULK_EP_IN,
+					  (uint8_t *)in + i * CH341_STREAM_DATA_LEN, (int)chksz, ch341_stream_xfer_cb,
+					  st, CH341_RW_TIMEOUT);
+	}
+
+	libusb_fill_bulk_transfer(transfers[npackets], handle->handle, CH341_BULK_EP_OUT, (uint8_t *)out, (int)outlen,
+				  ch341_stream_xfer_cb, st, CH341_RW_TIMEOUT);
+
+	for (i = 0; i < n; i++) {
+		err = libusb_submit_transfer(transfers[i]);
+		if (err) {
+			logm_err("Failed to submit usb transfer: %s\n", libusb_strerror(err));
+			ret = UFP_DEVICE_IO_ERROR;
+			break;
+		}
+
+		st->pending++;
+		submitted++;
+	}
+
+	while (true) {
+		/* On any failure, cancel all transfers once and keep handling events to reap their completions */
+		if ((ret || st->failed) && !cancelled) {
+			for (i = 0; i < submitted; i++)
+				libusb_cancel_transfer(transfers[i]);
+
+			cancelled = true;
+			ret = UFP_DEVICE_IO_ERROR;
+		}
+
+		if (!st->pending)
+			break;
+
+		err = libusb_handle_events_completed(ufprog_global_libusb_context(), NULL);
+		if (!err || err == LIBUSB_ERROR_INTERRUPTED) {
+			errors = 0;
+			continue;
+		}
+
+		logm_err("Failed to handle usb events: %s\n", libusb_strerror(err));
+		ret = UFP_DEVICE_IO_ERROR;
+
+		if (++errors >= CH341_STREAM_EVENT_RETRIES)
+			break;
+	}
+
+	if (ret)
+		logm_warn("Incomplete stream transfer through usb\n");
+
+	if (st->pending) {
+		/* Freeing transfers still owned by libusb is not allowed */
+		logm_err("%u usb transfers could not be reaped and are leaked\n", st->pending);
+		return ret;
+	}
+
+cleanup:
+	for (i = 0; i < n; i++) {
+		if (transfers[i])
+			libusb_free_transfer(transfers[i]);
+	}
+
+	free(st);
+
+	return ret;
+}
+
 ufprog_status ch341_read(struct ch34x_handle *handle, void *buf, size_t len, size_t *retlen)
 {
 	int ret, transferred;
@@ -42,33 +42,45 @@ static ufprog_status ch341_spi_set_cs(struct ufprog_interface *wchdev, bool acti
 
 static ufprog_status ch341_spi_fdx_xfer(struct ufprog_interface *wchdev, const void *tx, void *rx, size_t len)
 {
-	uint8_t iobuf[CH341_PACKET_LEN];
+	uint8_t iobuf[CH341_MAX_STREAM_PACKETS * CH341_PACKET_LEN];
+	uint8_t rxbuf[CH341_MAX_STREAM_PACKETS * CH341_STREAM_DATA_LEN];
+	size_t i, chksz, batchsz, outlen;
 	const uint8_t *ptx = tx;
-	uint8_t *prx = rx;
-	size_t chksz;
+	uint8_t *prx = rx, *pkt;
 
 	while (len) {
-		chksz = len;
-		if (chksz > CH341_PACKET_LEN - 1)
-			chksz = CH341_PACKET_LEN - 1;
-
-		iobuf[0] = CH341_CMD_SPI_STREAM;
-		if (ptx) {
-			ch341_bitswap(ptx, &iobuf[1], chksz);
-			ptx += chksz;
-		} else {
-			memset(&iobuf[1], 0, chksz);
+		batchsz = len;
+		if (batchsz > sizeof(rxbuf))
+			batchsz = sizeof(rxbuf);
+
+		/* Every full stream packet occupies exactly one USB packet */
+		for (i = 0, outlen = 0; i < batchsz; i += chksz) {
+			chksz = batchsz - i;
+			if (chksz > CH341_STREAM_DATA_LEN)
+				chksz = CH341_STREAM_DATA_LEN;
+
+			pkt = &iobuf[outlen];
+			pkt[0] = CH341_CMD_SPI_STREAM;
+
+			if (ptx)
+				ch341_bitswap(ptx + i, &pkt[1], chksz);
+			else
+				memset(&pkt[1], 0, chksz);
+
+			outlen += chksz + 1;
 		}
 
-		STATUS_CHECK_RET(ch341_write(wchdev->handle, iobuf, chksz + 1, NULL));
-		STATUS_CHECK_RET(ch341_read(wchdev->handle, iobuf, chksz, NULL));
+		STATUS_CHECK_RET(ch341_stream_xfer(wchdev->handle, iobuf, outlen, prx ? prx : rxbuf, batchsz));
+
+		if (ptx)
+			ptx += batchsz;
 
 		if (prx) {
-			ch341_bitswap(iobuf, prx, chksz);
-			prx += chksz;
+			ch341_bitswap(prx, prx, batchsz);
+			prx += batchsz;
 		}
 
-		len -= chksz;
+		len -= batchsz;
 	}
 
 	return UFP_OK;
@@ -5,6 +5,7 @@
  * Common implementation for WCH CH341 chip
  */
 
+#include <string.h>
 #include <ufprog/api_controller.h>
 #include <ufprog/log.h>
 #include "ch341.h"
@@ -49,9 +50,21 @@ static const uint8_t bitswap_table[256] = {
 
 void ch341_bitswap(const uint8_t *buf, uint8_t *out, size_t len)
 {
-	size_t i;
+	size_t i = 0;
+	uint64_t v;
 
-	for (i = 0; i < len; i++)
+	/* Reverse bits within each byte, eight bytes at a time */
+	for (; i + sizeof(v) <= len; i += sizeof(v)) {
+		memcpy(&v, buf + i, sizeof(v));
+
+		v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+		v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+		v = ((v >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((v & 0x0f0f0f0f0f0f0f0fULL) << 4);
+
+		memcpy(out + i, &v, sizeof(v));
+	}
+
+	for (; i < len; i++)
 		out[i] = bitswap_table[buf[i]];
 }
 
@@ -22,6 +22,12 @@ struct ch34x_handle;
 #define CH341_USB_BULK_ENDPOINT			2
 #define CH341_PACKET_LEN			0x20
 
+/* Each stream packet carries one command byte followed by its data */
+#define CH341_STREAM_DATA_LEN			(CH341_PACKET_LEN - 1)
+
+/* Stream packets batched in one 4KB bulk transfer */
+#define CH341_MAX_STREAM_PACKETS		128
+
 #define CH341_SPI_MAX_CS			3
 #define CH341_RW_TIMEOUT			5000
 
@@ -56,6 +62,7 @@ ufprog_status ch341_init(struct ufprog_interface *wchdev, bool thread_safe);
 
 ufprog_status ch341_write(struct ch34x_handle *handle, const void *buf, size_t len, size_t *retlen);
 ufprog_status ch341_read(struct ch34x_handle *handle, void *buf, size_t len, size_t *retlen);
+ufprog_status ch341_stream_xfer(struct ch34x_handle *handle, const void *out, size_t outlen, void *in, size_t inlen);
 
 ufprog_status ch341_spi_init(struct ufprog_interface *wchdev, struct json_object *config);
 
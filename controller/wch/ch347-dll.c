@@ -251,3 +251,8 @@ ufprog_status UFPROG_API ufprog_device_free(struct ufprog_interface *wchdev)
 	return UFP_OK;
 
 }
+
+ufprog_status ch347_xfer_batch(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count)
+{
+	return ch347_xfer_batch_sequential(handle, pkts, count);
+}
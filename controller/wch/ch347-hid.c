@@ -22,6 +22,10 @@
 
 #define CH347_HID_PACKET_SIZE		(CH347_HID_REPORT_SIZE - CH347_HID_REPORT_HDR_LEN - CH347_SPI_CMD_LEN)
 
+/* In reports buffered by the background reader */
+#define CH347_HID_RING_SIZE		16
+#define CH347_HID_READER_POLL_MS	50
+
 struct ch347_hid_open_info {
 	struct hid_device_info *hiddevinfo;
 	hid_device *hiddev;
@@ -30,6 +34,19 @@ struct ch347_hid_open_info {
 struct ch34x_handle {
 	hid_device *dev;
 	uint8_t report[CH347_HID_REPORT_SIZE + 1];
+
+	/* Background reader */
+	thread_handle reader;
+	mutex_handle ring_lock;
+	event_handle data_event;
+	event_handle space_event;
+	volatile bool reader_stop;
+	bool reader_error;
+
+	uint32_t ring_head;
+	uint32_t ring_tail;
+	uint32_t ring_count;
+	uint8_t ring[CH347_HID_RING_SIZE][CH347_HID_REPORT_SIZE + 1];
 };
 
 ufprog_status UFPROG_API ufprog_plugin_init(void)
@@ -94,6 +111,87 @@ static hid_device *ch347_hid_open(struct hid_device_info *devinfo, const char *h
 	return hiddev;
 }
 
+static void UFPROG_API ch347_hid_reader(void *priv)
+{
+	struct ch34x_handle *handle = priv;
+	uint32_t count;
+	int ret;
+
+	while (!handle->reader_stop) {
+		os_mutex_lock(handle->ring_lock);
+		count = handle->ring_count;
+		os_mutex_unlock(handle->ring_lock);
+
+		if (count == CH347_HID_RING_SIZE) {
+			os_wait_event(handle->space_event, CH347_HID_READER_POLL_MS);
+			continue;
+		}
+
+		/* Only the reader touches the tail slot */
+		ret = hid_read_timeout(handle->dev, handle->ring[handle->ring_tail], sizeof(handle->ring[0]),
+				       CH347_HID_READER_POLL_MS);
+		if (!ret)
+			continue;
+
+		os_mutex_lock(handle->ring_lock);
+
+		if (ret < 0) {
+			handle->reader_error = true;
+		} else {
+			handle->ring_tail = (handle->ring_tail + 1) % CH347_HID_RING_SIZE;
+			handle->ring_count++;
+		}
+
+		os_mutex_unlock(handle->ring_lock);
+
+		os_set_event(handle->data_event);
+
+		if (ret < 0)
+			break;
+	}
+}
+
+static ufprog_status ch347_hid_reader_start(struct ch34x_handle *handle)
+{
+	if (!os_create_mutex(&handle->ring_lock) || !os_create_event(&handle->data_event) ||
+	    !os_create_event(&handle->space_event)) {
+		logm_err("Failed to create synchronization objects for HID reader\n");
+		return UFP_FAIL;
+	}
+
+	if (!os_create_thread(&handle->reader, ch347_hid_reader, handle)) {
+		logm_err("Failed to create HID reader thread\n");
+		return UFP_FAIL;
+	}
+
+	return UFP_OK;
+}
+
+static void ch347_hid_reader_stop(struct ch34x_handle *handle)
+{
+	if (handle->reader) {
+		handle->reader_stop = true;
+		os_set_event(handle->space_event);
+		os_join_thread(handle->reader);
+		handle->reader = NULL;
+	}
+
+	if (handle->space_event) {
+		os_free_event(handle->space_event);
+		handle->space_event = NULL;
+	}
+
+	if (handle->data_event) {
+		os_free_event(handle->data_event);
+		handle->data_event = NULL;
+	}
+
+	if (handle->ring_lock) {
+		os_free_mutex(handle->ring_lock);
+		handle->ring_lock = NULL;
+	}
+}
+
 static int UFPROG_API ch347_hid_try_match_open(void *priv, struct json_object *match, int index)
 {
 	struct ch347_hid_open_info *oi = priv;
@@ -176,6 +274,8 @@ ufprog_status UFPROG_API ufprog_device_open(uint32_t if_type, struct json_object
 	wchdev->handle->dev = oi.hiddev;
 	wchdev->max_payload_len = CH347_HID_PACKET_SIZE;
 
+	STATUS_CHECK_GOTO_RET(ch347_hid_reader_start(wchdev->handle), ret, cleanup);
+
 	STATUS_CHECK_GOTO_RET(ch347_init(wchdev, thread_safe), ret, cleanup);
 
 	switch (if_type) {
@@ -198,6 +298,9 @@ ufprog_status UFPROG_API ufprog_device_open(uint32_t if_type, struct json_object
 	return UFP_OK;
 
 cleanup:
+	if (wchdev)
+		ch347_hid_reader_stop(wchdev->handle);
+
 	hid_close(oi.hiddev);
 
 	if (wchdev) {
@@ -215,6 +318,8 @@ ufprog_status UFPROG_API ufprog_device_free(struct ufprog_interface *wchdev)
 	if (!wchdev)
 		return UFP_INVALID_PARAMETER;
 
+	ch347_hid_reader_stop(wchdev->handle);
+
 	if (wchdev->handle->dev)
 		hid_close(wchdev->handle->dev);
 
@@ -250,24 +355,63 @@ ufprog_status ch347_write(struct ch34x_handle *handle, const void *buf, size_t l
 	return UFP_OK;
 }
 
+static ufprog_status ch347_hid_wait_report(struct ch34x_handle *handle, uint8_t **outreport)
+{
+	uint64_t now, deadline = os_get_timer_us() + (uint64_t)CH347_SPI_RW_TIMEOUT * 1000;
+	bool error;
+
+	while (true) {
+		os_mutex_lock(handle->ring_lock);
+
+		if (handle->ring_count) {
+			*outreport = handle->ring[handle->ring_head];
+			os_mutex_unlock(handle->ring_lock);
+			return UFP_OK;
+		}
+
+		error = handle->reader_error;
+		os_mutex_unlock(handle->ring_lock);
+
+		if (error) {
+			logm_err("Failed to read report: %S\n", hid_error(handle->dev));
+			return UFP_DEVICE_IO_ERROR;
+		}
+
+		now = os_get_timer_us();
+		if (now >= deadline) {
+			logm_err("Timed out waiting for in report\n");
+			return UFP_TIMEOUT;
+		}
+
+		os_wait_event(handle->data_event, (uint32_t)((deadline - now + 999) / 1000));
+	}
+}
+
+static void ch347_hid_release_report(struct ch34x_handle *handle)
+{
+	os_mutex_lock(handle->ring_lock);
+	handle->ring_head = (handle->ring_head + 1) % CH347_HID_RING_SIZE;
+	handle->ring_count--;
+	os_mutex_unlock(handle->ring_lock);
+
+	os_set_event(handle->space_event);
+}
+
 ufprog_status ch347_read(struct ch34x_handle *handle, void *buf, size_t len, size_t *retlen)
 {
 	uint32_t report_len;
-	int ret;
+	uint8_t *report;
 
 	if (len > CH347_HID_REPORT_SIZE - CH347_HID_REPORT_HDR_LEN)
 		len = CH347_HID_REPORT_SIZE - CH347_HID_REPORT_HDR_LEN;
 
-	ret = hid_read(handle->dev, handle->report, len + CH347_HID_REPORT_HDR_LEN + 1);
-	if (ret < 0) {
-		logm_err("Failed to read report: %S\n", hid_error(handle->dev));
-		return UFP_DEVICE_IO_ERROR;
-	}
+	STATUS_CHECK_RET(ch347_hid_wait_report(handle, &report));
 
-	report_len = handle->report[0] | ((uint32_t)handle->report[1] << 8);
+	report_len = report[0] | ((uint32_t)report[1] << 8);
 
 	if (report_len > CH347_HID_REPORT_SIZE - CH347_HID_REPORT_HDR_LEN) {
 		logm_err("In report length field is too big: %u returned\n", report_len);
+		ch347_hid_release_report(handle);
 		return UFP_DEVICE_IO_ERROR;
 	}
 
@@ -275,13 +419,39 @@ ufprog_status ch347_read(struct ch34x_handle *handle, void *buf, size_t len, siz
 		logm_warn("In report is bigger than requested length: %lu returned, only %u requested\n",
 			 report_len, len);
 	} else if (report_len < len) {
-		memset(handle->report + CH347_HID_REPORT_HDR_LEN + report_len, 0, len - report_len);
+		memset(report + CH347_HID_REPORT_HDR_LEN + report_len, 0, len - report_len);
 	}
 
-	memcpy(buf, handle->report + CH347_HID_REPORT_HDR_LEN, len);
+	memcpy(buf, report + CH347_HID_REPORT_HDR_LEN, len);
+
+	ch347_hid_release_report(handle);
 
 	if (retlen)
 		*retlen = len;
 
 	return UFP_OK;
 }
+
+ufprog_status ch347_xfer_batch(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count)
+{
+	size_t retlen;
+	uint32_t i;
+
+	/* Out reports go back to back. Replies are meanwhile drained by the reader into the ring. */
+	for (i = 0; i < count; i++) {
+		if (pkts[i].outlen)
+			STATUS_CHECK_RET(ch347_write(handle, pkts[i].out, pkts[i].outlen, NULL));
+	}
+
+	for (i = 0; i < count; i++) {
+		pkts[i].actual = 0;
+
+		if (!pkts[i].inlen)
+			continue;
+
+		STATUS_CHECK_RET(ch347_read(handle, pkts[i].in, pkts[i].inlen, &retlen));
+		pkts[i].actual = (uint32_t)retlen;
+	}
+
+	return UFP_OK;
+}
@@ -268,3 +268,135 @@ ufprog_status ch347_read(struct ch34x_handle *handle, void *buf, size_t len, siz
 
 	return UFP_OK;
 }
+
+struct ch347_batch_state {
+	uint32_t pending;
+	bool failed;
+};
+
+static void LIBUSB_CALL ch347_batch_xfer_cb(struct libusb_transfer *transfer)
+{
+	struct ch347_batch_state *st = transfer->user_data;
+
+	if (transfer->status != LIBUSB_TRANSFER_COMPLETED)
+		st->failed = true;
+	else if (!(transfer->endpoint & LIBUSB_ENDPOINT_IN) && transfer->actual_length != transfer->length)
+		st->failed = true;
+
+	st->pending--;
+}
+
+static void ch347_batch_cancel(struct libusb_transfer **transfers, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+		libusb_cancel_transfer(transfers[i]);
+}
+
+ufprog_status ch347_xfer_batch(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count)
+{
+	struct libusb_transfer *transfers[CH347_PIPE_DEPTH * 2] = { 0 };
+	struct libusb_transfer *in_xfers[CH347_PIPE_DEPTH] = { 0 };
+	uint32_t i, n = 0, nin = 0, submitted = 0;
+	struct ch347_batch_state st = { 0 };
+	ufprog_status ret = UFP_OK;
+	int err;
+
+	if (count > CH347_PIPE_DEPTH)
+		return UFP_INVALID_PARAMETER;
+
+	for (i = 0; i < count; i++) {
+		if (pkts[i].outlen > CH347_MAX_PACKET_SIZE || pkts[i].inlen > CH347_MAX_PACKET_SIZE)
+			return UFP_INVALID_PARAMETER;
+
+		pkts[i].actual = 0;
+	}
+
+	/* Queue all replies first so that none of them is left waiting in the device */
+	for (i = 0; i < count; i++) {
+		if (!pkts[i].inlen)
+			continue;
+
+		transfers[n] = libusb_alloc_transfer(0);
+		if (!transfers[n]) {
+			logm_err("No memory for usb transfer\n");
+			ret = UFP_NOMEM;
+			goto cleanup;
+		}
+
+		libusb_fill_bulk_transfer(transfers[n], handle->handle, CH347_VCP_EP_IN, pkts[i].in, (int)pkts[i].inlen,
+					  ch347_batch_xfer_cb, &st, CH347_SPI_RW_TIMEOUT);
+
+		in_xfers[nin++] = transfers[n++];
+	}
+
+	for (i = 0; i < count; i++) {
+		if (!pkts[i].outlen)
+			continue;
+
+		transfers[n] = libusb_alloc_transfer(0);
+		if (!transfers[n]) {
+			logm_err("No memory for usb transfer\n");
+			ret = UFP_NOMEM;
+			goto cleanup;
+		}
+
+		libusb_fill_bulk_transfer(transfers[n], handle->handle, CH347_VCP_EP_OUT, (uint8_t *)pkts[i].out,
+					  (int)pkts[i].outlen, ch347_batch_xfer_cb, &st, CH347_SPI_RW_TIMEOUT);
+
+		n++;
+	}
+
+	for (i = 0; i < n; i++) {
+		err = libusb_submit_transfer(transfers[i]);
+		if (err) {
+			logm_err("Failed to submit usb transfer: %s\n", libusb_strerror(err));
+			ch347_batch_cancel(transfers, submitted);
+			ret = UFP_DEVICE_IO_ERROR;
+			break;
+		}
+
+		st.pending++;
+		submitted++;
+	}
+
+	while (st.pending) {
+		err = libusb_handle_events_completed(ufprog_global_libusb_context(), NULL);
+		if (err && err != LIBUSB_ERROR_INTERRUPTED && !ret) {
+			logm_err("Failed to handle usb events: %s\n", libusb_strerror(err));
+			ch347_batch_cancel(transfers, submitted);
+			ret = UFP_DEVICE_IO_ERROR;
+		}
+
+		if (st.failed && !ret) {
+			ch347_batch_cancel(transfers, submitted);
+			ret = UFP_DEVICE_IO_ERROR;
+		}
+	}
+
+	if (st.failed && !ret)
+		ret = UFP_DEVICE_IO_ERROR;
+
+	for (i = 0, nin = 0; i < count; i++) {
+		if (!pkts[i].inlen)
+			continue;
+
+		if (in_xfers[nin]->status == LIBUSB_TRANSFER_COMPLETED) {
+			pkts[i].actual = in_xfers[nin]->actual_length;
+		} else if (in_xfers[nin]->status == LIBUSB_TRANSFER_TIMED_OUT) {
+			logm_err("No response for packet %u of %u in time\n", i + 1, count);
+		}
+
+		nin++;
+	}
+
+	if (ret)
+		logm_warn("Incomplete pipelined transfer through usb\n");
+
+cleanup:
+	for (i = 0; i < n; i++)
+		libusb_free_transfer(transfers[i]);
+
+	return ret;
+}
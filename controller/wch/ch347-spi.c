@@ -19,43 +19,44 @@
 #define CH347_SPI_IF_MAJOR			1
 #define CH347_SPI_IF_MINOR			0
 
-static ufprog_status ch347_spi_write_packet(struct ufprog_interface *wchdev, uint8_t cmd, const void *buf, uint32_t len)
+static uint32_t ch347_spi_fill_packet(uint8_t *pkt, uint8_t cmd, const void *buf, uint32_t len)
 {
-	if (len > CH347_MAX_XFER_LEN)
-		return UFP_INVALID_PARAMETER;
+	pkt[0] = cmd;
+	pkt[1] = len & 0xff;
+	pkt[2] = (len >> 8) & 0xff;
 
-	wchdev->iobuf[0] = cmd;
-	wchdev->iobuf[1] = len & 0xff;
-	wchdev->iobuf[2] = (len >> 8) & 0xff;
+	memcpy(pkt + CH347_SPI_CMD_LEN, buf, len);
+
+	return CH347_SPI_CMD_LEN + len;
+}
 
-	memcpy(wchdev->iobuf + CH347_SPI_CMD_LEN, buf, len);
+static ufprog_status ch347_spi_write_packet(struct ufprog_interface *wchdev, uint8_t cmd, const void *buf, uint32_t len)
+{
+	if (len > CH347_MAX_XFER_LEN - CH347_SPI_CMD_LEN)
+		return UFP_INVALID_PARAMETER;
 
-	return ch347_write(wchdev->handle, wchdev->iobuf, CH347_SPI_CMD_LEN + len, NULL);
+	return ch347_write(wchdev->handle, wchdev->iobuf, ch347_spi_fill_packet(wchdev->iobuf, cmd, buf, len), NULL);
 }
 
-static ufprog_status ch347_spi_read_packet(struct ufprog_interface *wchdev, uint8_t cmd, void *buf, uint32_t len,
-					   uint32_t *retlen)
+static ufprog_status ch347_spi_parse_packet(uint8_t cmd, const uint8_t *pkt, size_t pktlen, void *buf, uint32_t len,
+					    uint32_t *retlen)
 {
 	uint32_t packet_len;
-	size_t retlen_raw;
-
-	STATUS_CHECK_RET(ch347_read(wchdev->handle, wchdev->iobuf, CH347_SPI_CMD_LEN + len, &retlen_raw));
 
-	if (retlen_raw < CH347_SPI_CMD_LEN) {
+	if (pktlen < CH347_SPI_CMD_LEN) {
 		log_err("CH347-DLL SPI: read-back packet is too small.\n");
 		return UFP_DEVICE_IO_ERROR;
 	}
 
-	if (wchdev->iobuf[0] != cmd) {
-		log_err("CH347-DLL SPI: read-back packet cmd mismatch. Expect %02x but got %02x.\n",
-			cmd, wchdev->iobuf[0]);
+	if (pkt[0] != cmd) {
+		log_err("CH347-DLL SPI: read-back packet cmd mismatch. Expect %02x but got %02x.\n", cmd, pkt[0]);
 		return UFP_DEVICE_IO_ERROR;
 	}
 
-	packet_len = wchdev->iobuf[1] | wchdev->iobuf[2] << 8;
-	if (packet_len > retlen_raw - CH347_SPI_CMD_LEN) {
+	packet_len = pkt[1] | pkt[2] << 8;
+	if (packet_len > pktlen - CH347_SPI_CMD_LEN) {
 		log_err("CH347-DLL SPI: read-back packet is too small. Payload is incomplete: %luB of %uB returned.\n",
-			retlen_raw - CH347_SPI_CMD_LEN, packet_len);
+			pktlen - CH347_SPI_CMD_LEN, packet_len);
 		return UFP_DEVICE_IO_ERROR;
 	}
 
@@ -64,7 +65,7 @@ static ufprog_status ch347_spi_read_packet(struct ufprog_interface *wchdev, uint
 		packet_len = len;
 	}
 
-	memcpy(buf, wchdev->iobuf + 3, packet_len);
+	memcpy(buf, pkt + CH347_SPI_CMD_LEN, packet_len);
 
 	if (retlen)
 		*retlen = packet_len;
@@ -72,6 +73,43 @@ static ufprog_status ch347_spi_read_packet(struct ufprog_interface *wchdev, uint
 	return UFP_OK;
 }
 
+static ufprog_status ch347_spi_read_packet(struct ufprog_interface *wchdev, uint8_t cmd, void *buf, uint32_t len,
+					   uint32_t *retlen)
+{
+	size_t retlen_raw;
+
+	STATUS_CHECK_RET(ch347_read(wchdev->handle, wchdev->iobuf, CH347_SPI_CMD_LEN + len, &retlen_raw));
+
+	return ch347_spi_parse_packet(cmd, wchdev->iobuf, retlen_raw, buf, len, retlen);
+}
+
+/*
+ * Collect payloads of @count pipelined replies into @buf.
+ * The device may split a reply into more packets than requested. Payloads are always in order, so they are simply
+ * concatenated and the caller reads whatever is missing afterwards.
+ */
+static ufprog_status ch347_spi_collect_replies(struct ufprog_interface *wchdev, uint8_t cmd, uint32_t count,
+					       uint8_t *buf, uint32_t len, uint32_t *retlen)
+{
+	uint32_t i, chksz, total = 0;
+
+	for (i = 0; i < count; i++) {
+		if (total >= len) {
+			log_err("CH347-DLL SPI: unexpected extra reply packet %u of %u.\n", i + 1, count);
+			return UFP_DEVICE_IO_ERROR;
+		}
+
+		STATUS_CHECK_RET(ch347_spi_parse_packet(cmd, wchdev->pipe_in[i], wchdev->pipe_pkts[i].actual,
+							buf + total, len - total, &chksz));
+
+		total += chksz;
+	}
+
+	*retlen = total;
+
+	return UFP_OK;
+}
+
 static ufprog_status ch347_spi_get_config(struct ufprog_interface *wchdev)
 {
 	struct ch347_spi_hw_config cfg;
@@ -298,18 +336,36 @@ uint32_t UFPROG_API ufprog_spi_get_speed_list(struct ufprog_interface *wchdev, u
 
 static ufprog_status ch347_spi_single_read(struct ufprog_interface *wchdev, void *buf, uint32_t len)
 {
-	uint32_t chksz, outlen = htole32(len);
+	uint32_t n, chksz, batchsz, outlen = htole32(len);
+	struct ch347_xfer_pkt *pkt;
 	uint8_t *pbuf = buf;
+	bool first = true;
 
-	STATUS_CHECK_RET(ch347_spi_write_packet(wchdev, CH347_CMD_SPI_BLCK_RD, &outlen, sizeof(outlen)));
-
+	/* The request is sent along with the first batch of reply reads */
 	while (len) {
-		if (len > wchdev->max_payload_len)
-			chksz = wchdev->max_payload_len;
-		else
-			chksz = len;
+		for (n = 0, batchsz = 0; n < CH347_PIPE_DEPTH && batchsz < len; n++) {
+			chksz = len - batchsz;
+			if (chksz > wchdev->max_payload_len)
+				chksz = wchdev->max_payload_len;
+
+			pkt = &wchdev->pipe_pkts[n];
+			pkt->outlen = 0;
+			pkt->in = wchdev->pipe_in[n];
+			pkt->inlen = CH347_SPI_CMD_LEN + chksz;
 
-		STATUS_CHECK_RET(ch347_spi_read_packet(wchdev, CH347_CMD_SPI_BLCK_RD, pbuf, chksz, &chksz));
+			batchsz += chksz;
+		}
+
+		if (first) {
+			pkt = &wchdev->pipe_pkts[0];
+			pkt->out = wchdev->pipe_out[0];
+			pkt->outlen = ch347_spi_fill_packet(wchdev->pipe_out[0], CH347_CMD_SPI_BLCK_RD, &outlen,
+							    sizeof(outlen));
+			first = false;
+		}
+
+		STATUS_CHECK_RET(ch347_xfer_batch(wchdev->handle, wchdev->pipe_pkts, n));
+		STATUS_CHECK_RET(ch347_spi_collect_replies(wchdev, CH347_CMD_SPI_BLCK_RD, n, pbuf, len, &chksz));
 
 		pbuf += chksz;
 		len -= chksz;
@@ -340,21 +396,39 @@ static ufprog_status ch347_spi_read(struct ufprog_interface *wchdev, void *buf,
 
 static ufprog_status ch347_spi_single_write(struct ufprog_interface *wchdev, const void *buf, uint32_t len)
 {
+	struct ch347_xfer_pkt *pkt;
 	const uint8_t *pbuf = buf;
 	uint8_t unknown_data;
-	uint32_t chksz;
+	uint32_t i, n, chksz;
 
+	/* Keep a window of packets in flight. Every packet must still be acknowledged by the device. */
 	while (len) {
-		if (len > wchdev->max_payload_len)
-			chksz = wchdev->max_payload_len;
-		else
+		for (n = 0; n < CH347_PIPE_DEPTH && len; n++) {
 			chksz = len;
+			if (chksz > wchdev->max_payload_len)
+				chksz = wchdev->max_payload_len;
 
-		STATUS_CHECK_RET(ch347_spi_write_packet(wchdev, CH347_CMD_SPI_BLCK_WR, pbuf, chksz));
-		STATUS_CHECK_RET(ch347_spi_read_packet(wchdev, CH347_CMD_SPI_BLCK_WR, &unknown_data, 1, NULL));
+			pkt = &wchdev->pipe_pkts[n];
+			pkt->out = wchdev->pipe_out[n];
+			pkt->outlen = ch347_spi_fill_packet(wchdev->pipe_out[n], CH347_CMD_SPI_BLCK_WR, pbuf, chksz);
+			pkt->in = wchdev->pipe_in[n];
+			pkt->inlen = CH347_SPI_CMD_LEN + 1;
 
-		pbuf += chksz;
-		len -= chksz;
+			pbuf += chksz;
+			len -= chksz;
+		}
+
+		STATUS_CHECK_RET(ch347_xfer_batch(wchdev->handle, wchdev->pipe_pkts, n));
+
+		for (i = 0; i < n; i++) {
+			if (!wchdev->pipe_pkts[i].actual) {
+				log_err("CH347-DLL SPI: missing acknowledgement for packet %u of %u.\n", i + 1, n);
+				return UFP_DEVICE_IO_ERROR;
+			}
+
+			STATUS_CHECK_RET(ch347_spi_parse_packet(CH347_CMD_SPI_BLCK_WR, wchdev->pipe_in[i],
+								wchdev->pipe_pkts[i].actual, &unknown_data, 1, NULL));
+		}
 	}
 
 	return UFP_OK;
@@ -398,19 +472,33 @@ static ufprog_status ch347_spi_generic_xfer_one(struct ufprog_interface *wchdev,
 
 static ufprog_status ch347_spi_fdx_xfer(struct ufprog_interface *wchdev, void *buf, size_t len)
 {
-	uint32_t chksz, rdlen, retlen;
+	uint32_t n, chksz, batchsz, rdlen, retlen;
+	struct ch347_xfer_pkt *pkt;
 	uint8_t *pbuf = buf, *prbuf;
 
 	while (len) {
-		if (len > wchdev->max_payload_len)
-			chksz = wchdev->max_payload_len;
-		else
-			chksz = (uint32_t)len;
+		for (n = 0, batchsz = 0; n < CH347_PIPE_DEPTH && batchsz < len; n++) {
+			if (len - batchsz > wchdev->max_payload_len)
+				chksz = wchdev->max_payload_len;
+			else
+				chksz = (uint32_t)(len - batchsz);
+
+			pkt = &wchdev->pipe_pkts[n];
+			pkt->out = wchdev->pipe_out[n];
+			pkt->outlen = ch347_spi_fill_packet(wchdev->pipe_out[n], CH347_CMD_SPI_RD_WR, pbuf + batchsz,
+							    chksz);
+			pkt->in = wchdev->pipe_in[n];
+			pkt->inlen = CH347_SPI_CMD_LEN + chksz;
+
+			batchsz += chksz;
+		}
 
-		STATUS_CHECK_RET(ch347_spi_write_packet(wchdev, CH347_CMD_SPI_RD_WR, pbuf, chksz));
+		/* Outgoing data has been copied, so replies can overwrite the buffer in place */
+		STATUS_CHECK_RET(ch347_xfer_batch(wchdev->handle, wchdev->pipe_pkts, n));
+		STATUS_CHECK_RET(ch347_spi_collect_replies(wchdev, CH347_CMD_SPI_RD_WR, n, pbuf, batchsz, &retlen));
 
-		rdlen = chksz;
-		prbuf = pbuf;
+		rdlen = batchsz - retlen;
+		prbuf = pbuf + retlen;
 
 		while (rdlen) {
 			STATUS_CHECK_RET(ch347_spi_read_packet(wchdev, CH347_CMD_SPI_RD_WR, prbuf, rdlen, &retlen));
@@ -419,8 +507,8 @@ static ufprog_status ch347_spi_fdx_xfer(struct ufprog_interface *wchdev, void *b
 			rdlen -= retlen;
 		}
 
-		pbuf += chksz;
-		len -= chksz;
+		pbuf += batchsz;
+		len -= batchsz;
 	}
 
 	return UFP_OK;
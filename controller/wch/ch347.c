@@ -24,6 +24,26 @@ ufprog_status ch347_init(struct ufprog_interface *wchdev, bool thread_safe)
 	return UFP_OK;
 }
 
+ufprog_status ch347_xfer_batch_sequential(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count)
+{
+	size_t retlen;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		if (pkts[i].outlen)
+			STATUS_CHECK_RET(ch347_write(handle, pkts[i].out, pkts[i].outlen, NULL));
+
+		if (pkts[i].inlen) {
+			STATUS_CHECK_RET(ch347_read(handle, pkts[i].in, pkts[i].inlen, &retlen));
+			pkts[i].actual = (uint32_t)retlen;
+		} else {
+			pkts[i].actual = 0;
+		}
+	}
+
+	return UFP_OK;
+}
+
 uint32_t UFPROG_API ufprog_plugin_api_version(void)
 {
 	return MAKE_VERSION(CH347_DRV_API_VER_MAJOR, CH347_DRV_API_VER_MINOR);
@@ -33,6 +33,9 @@ struct ch34x_handle;
 #error CH347_PACKET_LEN too large
 #endif
 
+/* Maximum packets kept in flight by pipelined transfers */
+#define CH347_PIPE_DEPTH			8
+
 /*
  * The time used for write is significantly longer than that for read.
  * While using 512B packet size, writing a 4093B packet using lowest speed uses 1.22s
@@ -105,6 +108,19 @@ struct ch347_spi_hw_config {
 	uint8_t Reserved[4];
 };
 
+/*
+ * One element of a pipelined batch.
+ * out is sent as one bulk packet if outlen is not zero.
+ * in receives one bulk packet of at most inlen bytes if inlen is not zero. actual is its real length.
+ */
+struct ch347_xfer_pkt {
+	const void *out;
+	uint32_t outlen;
+	void *in;
+	uint32_t inlen;
+	uint32_t actual;
+};
+
 struct ufprog_interface {
 	struct ch34x_handle *handle;
 
@@ -114,6 +130,10 @@ struct ufprog_interface {
 	uint32_t max_payload_len;
 	uint8_t iobuf[CH347_MAX_XFER_LEN];
 
+	struct ch347_xfer_pkt pipe_pkts[CH347_PIPE_DEPTH];
+	uint8_t pipe_out[CH347_PIPE_DEPTH][CH347_SPI_CMD_LEN + CH347_PACKET_LEN];
+	uint8_t pipe_in[CH347_PIPE_DEPTH][CH347_SPI_CMD_LEN + CH347_PACKET_LEN];
+
 	mutex_handle lock;
 };
 
@@ -121,6 +141,8 @@ ufprog_status ch347_init(struct ufprog_interface *wchdev, bool thread_safe);
 
 ufprog_status ch347_write(struct ch34x_handle *handle, const void *buf, size_t len, size_t *retlen);
 ufprog_status ch347_read(struct ch34x_handle *handle, void *buf, size_t len, size_t *retlen);
+ufprog_status ch347_xfer_batch(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count);
+ufprog_status ch347_xfer_batch_sequential(struct ch34x_handle *handle, struct ch347_xfer_pkt *pkts, uint32_t count);
 
 ufprog_status ch347_spi_init(struct ufprog_interface *wchdev, struct json_object *config);
 
@@ -24,6 +24,7 @@ fn_CH347GetDeviceInfor CH347GetDeviceInfor;
 fn_CH34xReadData CH34xReadData;
 fn_CH34xWriteData CH34xWriteData;
 fn_CH34xSetTimeout CH34xSetTimeout;
+fn_CH341WriteRead CH341WriteRead;
 
 static module_handle hCh34xDll;
 
@@ -85,6 +86,9 @@ int ch341_dll_init(void)
 		return -1;
 	}
 
+	/* Optional. Used for batched stream transfer. */
+	CH341WriteRead = (fn_CH341WriteRead)os_find_module_symbol(hCh34xDll, "CH341WriteRead");
+
 	return 0;
 }
 
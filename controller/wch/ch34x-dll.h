@@ -59,6 +59,8 @@ typedef VOID (WINAPI *fn_CH341CloseDevice)(ULONG iIndex);
 typedef BOOL (WINAPI *fn_CH347GetDeviceInfor)(ULONG iIndex, mDeviceInforS *DevInformation);
 typedef BOOL (WINAPI *fn_CH34xReadData)(ULONG iIndex, PVOID oBuffer, PULONG ioLength);
 typedef BOOL (WINAPI *fn_CH34xWriteData)(ULONG iIndex, PVOID iBuffer, PULONG ioLength);
+typedef BOOL (WINAPI *fn_CH341WriteRead)(ULONG iIndex, ULONG iWriteLength, PVOID iWriteBuffer, ULONG iReadStep,
+					 ULONG iReadTimes, PULONG oReadLength, PVOID oReadBuffer);
 /* Unit: ms. ULONG_MAX means no timeout */
 typedef BOOL (WINAPI *fn_CH34xSetTimeout)(ULONG iIndex, ULONG iWriteTimeout, ULONG iReadTimeout);
 
@@ -69,6 +71,7 @@ extern fn_CH347GetDeviceInfor CH347GetDeviceInfor;
 extern fn_CH34xReadData CH34xReadData;
 extern fn_CH34xWriteData CH34xWriteData;
 extern fn_CH34xSetTimeout CH34xSetTimeout;
+extern fn_CH341WriteRead CH341WriteRead;
 
 int ch341_dll_init(void);
 int ch347_dll_init(void);
@@ -219,7 +219,12 @@ static ufprog_status ftl_basic_read_pages(struct ufprog_nand_ftl *ftl, const str
 				break;
 		}
 
-		ret = ufprog_nand_read_pages(nand, curr_page, curr_cnt, rdbuf, raw, flags, &retcnt);
+		if (cb && cb->direct_len) {
+			ret = ufprog_nand_read_pages_range(nand, curr_page, curr_cnt, 0, cb->direct_len, cb->direct, raw,
+							   flags, &retcnt);
+		} else {
+			ret = ufprog_nand_read_pages(nand, curr_page, curr_cnt, rdbuf, raw, flags, &retcnt);
+		}
 
 		if (cb && retcnt) {
 			ret = cb->post(cb, retcnt);
@@ -262,6 +267,25 @@ static ufprog_status ftl_basic_read_page(struct ufprog_nand_ftl *ftl, const stru
 	return ftl_basic_read_pages(ftl, part, page, 1, buf, raw, 0, NULL, NULL);
 }
 
+static ufprog_status ftl_basic_verify_block(struct nand_ftl_basic *bftl, uint32_t block, uint32_t page,
+					     uint32_t count, bool raw, struct ufprog_ftl_callback *cb)
+{
+	struct nand_chip *nand = bftl->nftl.nand;
+	ufprog_status ret;
+	uint32_t retcnt;
+
+	/* Uncorrectable pages are left for the comparison to catch */
+	ret = ufprog_nand_read_pages(nand, page, count, cb->verify_buffer, raw, NAND_READ_F_IGNORE_ECC_ERROR,
+				     &retcnt);
+	if (ret) {
+		logm_err("Failed to read back block %u at 0x%" PRIx64 "\n", block,
+			 (uint64_t)(page + retcnt) << nand->maux.page_shift);
+		return ret;
+	}
+
+	return cb->verify(cb, cb->verify_buffer, count);
+}
+
 static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const struct ufprog_ftl_part *part,
 					     uint32_t page, uint32_t count, const void *buf, bool raw,
 					     bool ignore_error, uint32_t *retcount, struct ufprog_ftl_callback *cb)
@@ -269,6 +293,7 @@ static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const st
 	uint32_t curr_block, end_block, offset_page, curr_page, curr_cnt, retries, retcnt, wrcnt = 0;
 	struct nand_ftl_basic *bftl = container_of(ftl, struct nand_ftl_basic, nftl);
 	struct nand_chip *nand = bftl->nftl.nand;
+	bool prepared = false;
 	const uint8_t *p = buf;
 	const void *wrbuf;
 	ufprog_status ret;
@@ -310,15 +335,24 @@ static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const st
 		else
 			wrbuf = p;
 
-		if (cb && cb->pre) {
+		/* Data of a failed block is still in buffer. Do not let the caller prepare the next data. */
+		if (cb && cb->pre && !prepared) {
 			ret = cb->pre(cb, curr_cnt);
 			if (ret)
 				break;
+
+			prepared = true;
 		}
 
 		ret = ufprog_nand_write_pages(nand, curr_page, curr_cnt, wrbuf, raw, ignore_error, &retcnt);
 
-		if (cb && retcnt) {
+		if (!ret && cb && cb->verify) {
+			ret = ftl_basic_verify_block(bftl, curr_block, curr_page, curr_cnt, raw, cb);
+			if (ret && ret != UFP_DATA_VERIFICATION_FAIL)
+				break;
+		}
+
+		if (!ret && cb && retcnt) {
 			ret = cb->post(cb, retcnt);
 			if (ret) {
 				wrcnt += retcnt;
@@ -327,8 +361,14 @@ static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const st
 		}
 
 		if (ret) {
-			logm_warn("Failed to write block %u at 0x%" PRIx64 ", starting torture test ...\n", curr_block,
-				  (uint64_t)(curr_page + retcnt) << nand->maux.page_shift);
+			if (ret == UFP_DATA_VERIFICATION_FAIL) {
+				logm_warn("Verification failed on block %u at 0x%" PRIx64 ", "
+					  "starting torture test ...\n", curr_block,
+					  (uint64_t)curr_page << nand->maux.page_shift);
+			} else {
+				logm_warn("Failed to write block %u at 0x%" PRIx64 ", starting torture test ...\n",
+					  curr_block, (uint64_t)(curr_page + retcnt) << nand->maux.page_shift);
+			}
 
 			/* Do torture test only when we're writing to the beginning of the block */
 			if (offset_page)
@@ -337,7 +377,7 @@ static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const st
 			ret = ufprog_nand_torture_block(nand, curr_block);
 			if (ret) {
 				if (!ignore_error) {
-					logm_warn("Torture test failed on block %u. Aborting ...\n");
+					logm_warn("Torture test failed on block %u. Aborting ...\n", curr_block);
 					break;
 				}
 
@@ -366,6 +406,12 @@ static ufprog_status ftl_basic_write_pages(struct ufprog_nand_ftl *ftl, const st
 		curr_block++;
 		p += curr_cnt * nand->maux.oob_page_size;
 		retries = FTL_SKB_RETRIES;
+		prepared = false;
+	}
+
+	if (count && !retries && !ret) {
+		logm_err("Too many retries for write at block %u\n", curr_block);
+		ret = UFP_FLASH_PROGRAM_FAILED;
 	}
 
 	if (retcount)
@@ -420,7 +466,7 @@ static ufprog_status ftl_basic_erase_blocks(struct ufprog_nand_ftl *ftl, const s
 			ret = ufprog_nand_torture_block(nand, curr_block);
 			if (ret) {
 				if (!spread) {
-					logm_warn("Torture test failed on block %u. Aborting ...\n");
+					logm_warn("Torture test failed on block %u. Aborting ...\n", curr_block);
 					break;
 				}
 
@@ -189,13 +189,17 @@ ufprog_status UFPROG_API ufprog_ftl_read_pages(struct ufprog_nand_ftl *ftl, cons
 			return UFP_INVALID_PARAMETER;
 	}
 
+	if (cb && cb->direct_len && (!cb->pre || cb->direct_len > ftl->nand->maux.oob_page_size))
+		return UFP_INVALID_PARAMETER;
+
 	if (!validate_virt_part_info(ftl, part, page, count))
 		return UFP_INVALID_PARAMETER;
 
 	if (!count)
 		return UFP_OK;
 
-	if (ftl->driver && ftl->driver->read_pages && ftl->instance)
+	/* Drivers are not aware of direct read. Use page-based read which handles it. */
+	if (ftl->driver && ftl->driver->read_pages && ftl->instance && !(cb && cb->direct_len))
 		return ftl->driver->read_pages(ftl->instance, part, page, count, buf, raw, flags, retcount, cb);
 
 	if (ftl->read_pages)
@@ -244,10 +248,14 @@ ufprog_status UFPROG_API ufprog_ftl_write_pages(struct ufprog_nand_ftl *ftl, con
 	if (!validate_virt_part_info(ftl, part, page, count))
 		return UFP_INVALID_PARAMETER;
 
+	if (cb && cb->verify && !cb->verify_buffer)
+		return UFP_INVALID_PARAMETER;
+
 	if (!count)
 		return UFP_OK;
 
-	if (ftl->driver && ftl->driver->write_pages && ftl->instance)
+	/* Drivers are not aware of verify callback. Use page-based write which does read back. */
+	if (ftl->driver && ftl->driver->write_pages && ftl->instance && !(cb && cb->verify))
 		return ftl->driver->write_pages(ftl->instance, part, page, count, buf, raw, ignore_error, retcount, cb);
 
 	if (ftl->write_pages)
@@ -330,6 +338,7 @@ static ufprog_status generic_ftl_read_pages(struct ufprog_nand_ftl *ftl, const s
 					    uint32_t *retcount, struct ufprog_ftl_callback *cb)
 {
 	ufprog_status ret = UFP_OK;
+	bool copy = false;
 	uint32_t rdcnt = 0;
 	uint8_t *p = buf;
 	void *rdbuf;
@@ -340,6 +349,20 @@ static ufprog_status generic_ftl_read_pages(struct ufprog_nand_ftl *ftl, const s
 		else
 			rdbuf = p;
 
+		if (cb && cb->pre) {
+			ret = cb->pre(cb, 1);
+			if (ret)
+				break;
+		}
+
+		/* Only a whole page can be read here. Partial page goes through buffer. */
+		if (cb && cb->direct_len) {
+			if (cb->direct_len == ftl->nand->maux.oob_page_size)
+				rdbuf = cb->direct;
+			else
+				copy = true;
+		}
+
 		ret = ftl_read_page(ftl, part, page, rdbuf, raw);
 		if (ret) {
 			if (ret == UFP_ECC_UNCORRECTABLE) {
@@ -354,6 +377,9 @@ static ufprog_status generic_ftl_read_pages(struct ufprog_nand_ftl *ftl, const s
 			ret = UFP_OK;
 		}
 
+		if (copy)
+			memcpy(cb->direct, rdbuf, cb->direct_len);
+
 		page++;
 		count--;
 		rdcnt++;
@@ -405,6 +431,19 @@ static ufprog_status generic_ftl_write_pages(struct ufprog_nand_ftl *ftl, const
 			ret = UFP_OK;
 		}
 
+		if (cb && cb->verify) {
+			ret = ftl_read_page(ftl, part, page, cb->verify_buffer, raw);
+			if (ret && ret != UFP_ECC_UNCORRECTABLE) {
+				logm_err("Failed to read back page %u at 0x%" PRIx64 "\n", page,
+					 (uint64_t)page << ftl->nand->maux.page_shift);
+				break;
+			}
+
+			ret = cb->verify(cb, cb->verify_buffer, 1);
+			if (ret)
+				break;
+		}
+
 		page++;
 		count--;
 		wrcnt++;
@@ -30,6 +30,22 @@ struct ufprog_ftl_callback {
 	ufprog_status (*pre)(struct ufprog_ftl_callback *cb, uint32_t requested_count);
 	ufprog_status (*post)(struct ufprog_ftl_callback *cb, uint32_t actual_count);
 	void *buffer;
+
+	/*
+	 * Optional, write only. Pages just programmed are read back into verify_buffer and passed to verify before
+	 * post is called. Returning UFP_DATA_VERIFICATION_FAIL lets the FTL retire the block and write the same data
+	 * again if it is able to. Data prepared by pre is reused for the rewrite.
+	 */
+	ufprog_status (*verify)(struct ufprog_ftl_callback *cb, const void *data, uint32_t count);
+	void *verify_buffer;
+
+	/*
+	 * Optional, read only. A non-zero direct_len asks the FTL to store pages to direct instead of buffer, and pre
+	 * must set direct for each batch. Only the first direct_len bytes of each page are stored, back to back.
+	 * A direct_len less than the page size with OOB requires raw read or On-die ECC.
+	 */
+	uint32_t direct_len;
+	void *direct;
 };
 
 #define API_NAME_FTL_CREATE_INSTANCE		"ufprog_ftl_create_instance"
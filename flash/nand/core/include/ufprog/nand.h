@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <ufprog/common.h>
 #include <ufprog/ecc.h>
+#include <ufprog/job.h>
 
 EXTERN_C_BEGIN
 
@@ -36,6 +37,10 @@ EXTERN_C_BEGIN
 #define PAGE_FILL_F_SRC_SKIP_NON_DATA		BIT(5)
 
 struct nand_chip;
+struct nand_page_layout_prog;
+
+/* Called for each page read with corrected or uncorrectable bitflips. @bitflips is the maximum of all steps. */
+typedef void (UFPROG_API *nand_ecc_report_cb)(void *priv, uint32_t page, int bitflips);
 
 struct nand_id {
 	uint8_t id[NAND_ID_MAX_LEN];
@@ -104,6 +109,9 @@ ufprog_status UFPROG_API ufprog_nand_select_die(struct nand_chip *nand, uint32_t
 ufprog_status UFPROG_API ufprog_nand_read_page(struct nand_chip *nand, uint32_t page, void *buf, ufprog_bool raw);
 ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
 						ufprog_bool raw, uint32_t flags, uint32_t *retcount);
+ufprog_status UFPROG_API ufprog_nand_read_pages_range(struct nand_chip *nand, uint32_t page, uint32_t count,
+						      uint32_t column, uint32_t len, void *buf, ufprog_bool raw,
+						      uint32_t flags, uint32_t *retcount);
 ufprog_status UFPROG_API ufprog_nand_write_page(struct nand_chip *nand, uint32_t page, const void *buf,
 						ufprog_bool raw);
 ufprog_status UFPROG_API ufprog_nand_write_pages(struct nand_chip *nand, uint32_t page, uint32_t count, const void *buf,
@@ -141,6 +149,7 @@ ufprog_bool UFPROG_API ufprog_nand_bbm_add_mark_pos(struct nand_chip *nand, stru
 ufprog_status UFPROG_API ufprog_nand_set_ecc(struct nand_chip *nand, struct ufprog_nand_ecc_chip *ecc);
 struct ufprog_nand_ecc_chip *UFPROG_API ufprog_nand_get_ecc(struct nand_chip *nand);
 struct ufprog_nand_ecc_chip *UFPROG_API ufprog_nand_default_ecc(struct nand_chip *nand);
+ufprog_status UFPROG_API ufprog_nand_set_ecc_report_cb(struct nand_chip *nand, nand_ecc_report_cb cb, void *priv);
 ufprog_status UFPROG_API ufprog_nand_get_bbm_config(struct nand_chip *nand, struct nand_bbm_config *ret_bbmcfg);
 
 ufprog_status UFPROG_API ufprog_nand_generate_page_layout(struct nand_chip *nand, struct nand_page_layout **out_layout);
@@ -149,7 +158,27 @@ uint32_t UFPROG_API ufprog_nand_page_layout_to_map(const struct nand_page_layout
 uint32_t UFPROG_API ufprog_nand_fill_page_by_layout(const struct nand_page_layout *layout, void *dst, const void *src,
 						    uint32_t count, uint32_t flags);
 
+ufprog_status UFPROG_API ufprog_nand_compile_page_layout(const struct nand_page_layout *layout, uint32_t fill_flags,
+							 uint32_t cmp_types, struct nand_page_layout_prog **out_prog);
+void UFPROG_API ufprog_nand_free_page_layout_prog(struct nand_page_layout_prog *prog);
+uint32_t UFPROG_API ufprog_nand_fill_page_by_prog(const struct nand_page_layout_prog *prog, void *dst, const void *src,
+						  uint32_t count);
+ufprog_bool UFPROG_API ufprog_nand_compare_page_by_prog(const struct nand_page_layout_prog *prog, const void *buf,
+							const void *gold, uint32_t len, uint32_t *retpos);
+uint32_t UFPROG_API ufprog_nand_count_bitflips_by_prog(const struct nand_page_layout_prog *prog, const void *buf,
+						       const void *gold, uint32_t len);
+
 ufprog_status UFPROG_API ufprog_nand_torture_block(struct nand_chip *nand, uint32_t block);
+ufprog_status UFPROG_API ufprog_nand_torture_block_with_buf(struct nand_chip *nand, uint32_t block, void *buf);
+
+/*
+ * buf holds count pages of oob_page_size bytes. Unused for erase, which erases all blocks covered by the range.
+ * NAND operations are not reentrant, so the queue must have only one worker.
+ */
+ufprog_status UFPROG_API ufprog_nand_submit_job(struct ufprog_job_queue *q, struct nand_chip *nand,
+						enum ufprog_job_op op, uint32_t page, uint32_t count, void *buf,
+						ufprog_bool raw, const struct ufprog_job_callbacks *cbs,
+						struct ufprog_job **outjob);
 
 static inline uint64_t nand_flash_compute_chip_blocks(const struct nand_memorg *memorg)
 {
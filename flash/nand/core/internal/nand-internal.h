@@ -48,6 +48,32 @@ struct nand_flash_otp_ops {
 
 #define NAND_OTP_OPS(_ops)			.otp_ops = (_ops)
 
+enum nand_page_layout_op_type {
+	NAND_PAGE_LAYOUT_OP_COPY,
+	NAND_PAGE_LAYOUT_OP_FILL_FF,
+};
+
+struct nand_page_layout_op {
+	uint32_t op;
+	uint32_t dst;
+	uint32_t src;
+	uint32_t len;
+};
+
+struct nand_page_layout_run {
+	uint32_t offset;
+	uint32_t len;
+};
+
+/* Page layout compiled into merged copy/fill operations and compare runs, all in page order */
+struct nand_page_layout_prog {
+	uint32_t size;
+	uint32_t num_ops;
+	uint32_t num_runs;
+	struct nand_page_layout_op *ops;
+	struct nand_page_layout_run *runs;
+};
+
 struct nand_chip {
 	const char *model;
 	const char *vendor;
@@ -68,8 +94,8 @@ struct nand_chip {
 
 	ufprog_status (*read_page)(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
 				   void *buf);
-	ufprog_status (*read_pages)(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
-				    uint32_t flags, uint32_t *retcount);
+	ufprog_status (*read_pages)(struct nand_chip *nand, uint32_t page, uint32_t count, uint32_t column,
+				    uint32_t len, void *buf, uint32_t flags, uint32_t *retcount);
 	ufprog_status (*write_page)(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
 				    const void *buf);
 	ufprog_status (*write_pages)(struct nand_chip *nand, uint32_t page, uint32_t count, const void *buf,
@@ -88,6 +114,9 @@ struct nand_chip {
 	struct nand_bbm_config bbm_config;
 	uint32_t ecc_steps;
 
+	nand_ecc_report_cb ecc_report_cb;
+	void *ecc_report_priv;
+
 	/* private fields */
 	struct nand_memaux_info maux;
 };
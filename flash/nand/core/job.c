@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * NAND flash asynchronous jobs
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ufprog/log.h>
+#include "internal/nand-internal.h"
+
+struct nand_job {
+	struct nand_chip *nand;
+	enum ufprog_job_op op;
+	uint32_t page;
+	uint32_t count;
+	uint8_t *buf;
+	bool raw;
+
+	/* verify only */
+	uint8_t *vbuf;
+	struct nand_page_layout_prog *prog;
+};
+
+static ufprog_status nand_job_erase(struct ufprog_job *job, struct nand_job *j)
+{
+	uint32_t block, first, last;
+	ufprog_status ret;
+
+	first = j->page >> j->nand->maux.pages_per_block_shift;
+	last = (j->page + j->count - 1) >> j->nand->maux.pages_per_block_shift;
+
+	for (block = first; block <= last; block++) {
+		if (ufprog_job_cancelled(job))
+			return UFP_CANCELLED;
+
+		ret = ufprog_nand_erase_block(j->nand, block << j->nand->maux.pages_per_block_shift);
+		if (ret)
+			return ret;
+
+		ufprog_job_report_progress(job, block - first + 1, last - first + 1);
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_job_verify(struct nand_job *j, uint32_t page, uint32_t count, const uint8_t *gold)
+{
+	uint32_t i, pos, oob_page_size = j->nand->maux.oob_page_size;
+	const uint8_t *p = j->vbuf;
+	ufprog_status ret;
+	bool match;
+
+	ret = ufprog_nand_read_pages(j->nand, page, count, j->vbuf, j->raw, 0, NULL);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		if (j->prog)
+			match = ufprog_nand_compare_page_by_prog(j->prog, p, gold, oob_page_size, &pos);
+		else
+			match = !memcmp(p, gold, oob_page_size);
+
+		if (!match) {
+			logm_err("Data verification failed in page %u\n", page + i);
+			return UFP_DATA_VERIFICATION_FAIL;
+		}
+
+		gold += oob_page_size;
+		p += oob_page_size;
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status UFPROG_API nand_job_run(struct ufprog_job *job, void *priv)
+{
+	struct nand_job *j = priv;
+	uint32_t done, n, ppb;
+	ufprog_status ret;
+	uint8_t *p;
+
+	if (j->op == UFPROG_JOB_ERASE)
+		return nand_job_erase(job, j);
+
+	ppb = j->nand->memorg.pages_per_block;
+
+	/* Transfer block by block, with the first and last chunk aligned to block boundary */
+	for (done = 0; done < j->count; done += n) {
+		if (ufprog_job_cancelled(job))
+			return UFP_CANCELLED;
+
+		n = ppb - ((j->page + done) & j->nand->maux.pages_per_block_mask);
+		if (n > j->count - done)
+			n = j->count - done;
+
+		p = j->buf + (size_t)done * j->nand->maux.oob_page_size;
+
+		switch (j->op) {
+		case UFPROG_JOB_READ:
+			ret = ufprog_nand_read_pages(j->nand, j->page + done, n, p, j->raw, 0, NULL);
+			break;
+
+		case UFPROG_JOB_WRITE:
+			ret = ufprog_nand_write_pages(j->nand, j->page + done, n, p, j->raw, false, NULL);
+			break;
+
+		default:
+			ret = nand_job_verify(j, j->page + done, n, p);
+		}
+
+		if (ret)
+			return ret;
+
+		ufprog_job_report_progress(job, done + n, j->count);
+	}
+
+	return UFP_OK;
+}
+
+static void UFPROG_API nand_job_free(void *priv)
+{
+	struct nand_job *j = priv;
+
+	ufprog_nand_free_page_layout_prog(j->prog);
+	free(j);
+}
+
+static ufprog_status nand_job_compile_verify_prog(struct nand_job *j)
+{
+	const struct nand_page_layout *layout = NULL;
+	struct nand_page_layout *genlayout = NULL;
+	ufprog_status ret;
+
+	/* ECC parity and markers are regenerated on write, so only data bytes are compared */
+	if (j->nand->ecc)
+		layout = ufprog_ecc_get_page_layout(j->nand->ecc, false);
+
+	if (!layout) {
+		STATUS_CHECK_RET(ufprog_nand_generate_page_layout(j->nand, &genlayout));
+		layout = genlayout;
+	}
+
+	ret = ufprog_nand_compile_page_layout(layout, 0, BIT(NAND_PAGE_BYTE_DATA) | BIT(NAND_PAGE_BYTE_OOB_DATA) |
+					      BIT(NAND_PAGE_BYTE_OOB_FREE), &j->prog);
+
+	if (genlayout)
+		ufprog_nand_free_page_layout(genlayout);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_nand_submit_job(struct ufprog_job_queue *q, struct nand_chip *nand,
+						enum ufprog_job_op op, uint32_t page, uint32_t count, void *buf,
+						ufprog_bool raw, const struct ufprog_job_callbacks *cbs,
+						struct ufprog_job **outjob)
+{
+	struct nand_job *j;
+	ufprog_status ret;
+	size_t extra = 0;
+
+	if (!q || !nand || op >= __MAX_UFPROG_JOB_OP || !count || (op != UFPROG_JOB_ERASE && !buf))
+		return UFP_INVALID_PARAMETER;
+
+	if (page >= nand->maux.page_count || count > nand->maux.page_count - page)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	/* Jobs run by multiple workers may issue commands to the chip concurrently */
+	if (ufprog_job_queue_workers(q) > 1) {
+		logm_err("NAND jobs require a job queue with only one worker\n");
+		return UFP_INVALID_PARAMETER;
+	}
+
+	if (op == UFPROG_JOB_VERIFY)
+		extra = nand->maux.oob_block_size;
+
+	j = calloc(1, sizeof(*j) + extra);
+	if (!j) {
+		logm_err("No memory for job\n");
+		return UFP_NOMEM;
+	}
+
+	j->nand = nand;
+	j->op = op;
+	j->page = page;
+	j->count = count;
+	j->buf = buf;
+	j->raw = raw;
+
+	if (op == UFPROG_JOB_VERIFY) {
+		j->vbuf = (uint8_t *)j + sizeof(*j);
+
+		if (!raw) {
+			ret = nand_job_compile_verify_prog(j);
+			if (ret) {
+				logm_err("Failed to prepare page layout for verification\n");
+				free(j);
+				return ret;
+			}
+		}
+	}
+
+	ret = ufprog_job_submit(q, nand_job_run, nand_job_free, j, cbs, outjob);
+	if (ret)
+		nand_job_free(j);
+
+	return ret;
+}
@@ -247,6 +247,7 @@ ufprog_status UFPROG_API ufprog_nand_select_die(struct nand_chip *nand, uint32_t
 void UFPROG_API ufprog_nand_print_ecc_result(struct nand_chip *nand, uint32_t page)
 {
 	const struct nand_ecc_status *status = ufprog_ecc_get_status(nand->ecc);
+	int maxbf;
 	uint32_t i;
 
 	if (!status->per_step) {
@@ -257,17 +258,26 @@ void UFPROG_API ufprog_nand_print_ecc_result(struct nand_chip *nand, uint32_t pa
 		else if (status->step_bitflips[0] < 0)
 			logm_err("Uncorrectable bitflips detected in page %u\n", page);
 
+		if (nand->ecc_report_cb)
+			nand->ecc_report_cb(nand->ecc_report_priv, page, status->step_bitflips[0]);
+
 		return;
 	}
 
-	for (i = 0; i < nand->ecc_steps; i++) {
+	for (i = 0, maxbf = 0; i < nand->ecc_steps; i++) {
 		if (status->step_bitflips[i] == 1)
 			logm_dbg("1 bitflip corrected in page %u step %u\n", page, i);
 		else if (status->step_bitflips[i] > 1)
 			logm_dbg("%u bitflips corrected in page %u step %u\n", status->step_bitflips[i], page, i);
 		else if (status->step_bitflips[i] < 0)
 			logm_err("Uncorrectable bitflips detected in page %u step %u\n", page, i);
+
+		if (maxbf >= 0 && (status->step_bitflips[i] < 0 || status->step_bitflips[i] > maxbf))
+			maxbf = status->step_bitflips[i];
 	}
+
+	if (nand->ecc_report_cb)
+		nand->ecc_report_cb(nand->ecc_report_priv, page, maxbf);
 }
 
 ufprog_status UFPROG_API ufprog_nand_read_page(struct nand_chip *nand, uint32_t page, void *buf, ufprog_bool raw)
@@ -300,8 +310,8 @@ ufprog_status UFPROG_API ufprog_nand_read_page(struct nand_chip *nand, uint32_t
 	return ret;
 }
 
-ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
-						ufprog_bool raw, uint32_t flags, uint32_t *retcount)
+static ufprog_status nand_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, uint32_t column,
+				     uint32_t len, void *buf, ufprog_bool raw, uint32_t flags, uint32_t *retcount)
 {
 	ufprog_status ret = UFP_OK;
 	uint32_t rdcnt = 0;
@@ -310,9 +320,6 @@ ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t
 	if (retcount)
 		*retcount = 0;
 
-	if (!nand || !buf)
-		return UFP_INVALID_PARAMETER;
-
 	if (page >= nand->maux.page_count || (page + count) > nand->maux.page_count)
 		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
 
@@ -323,10 +330,10 @@ ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t
 		STATUS_CHECK_RET(ufprog_ecc_set_enable(nand->ecc, !raw));
 
 	if (nand->read_pages)
-		return nand->read_pages(nand, page, count, buf, flags, retcount);
+		return nand->read_pages(nand, page, count, column, len, buf, flags, retcount);
 
 	while (count) {
-		ret = nand->read_page(nand, page, 0, nand->maux.oob_page_size, p);
+		ret = nand->read_page(nand, page, column, len, p);
 		if (ret) {
 			if (!(flags & NAND_READ_F_IGNORE_IO_ERROR))
 				break;
@@ -355,7 +362,7 @@ ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t
 		page++;
 		count--;
 		rdcnt++;
-		p += nand->maux.oob_page_size;
+		p += len;
 	}
 
 	if (retcount)
@@ -364,6 +371,41 @@ ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t
 	return ret;
 }
 
+ufprog_status UFPROG_API ufprog_nand_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
+						ufprog_bool raw, uint32_t flags, uint32_t *retcount)
+{
+	if (retcount)
+		*retcount = 0;
+
+	if (!nand || !buf)
+		return UFP_INVALID_PARAMETER;
+
+	return nand_read_pages(nand, page, count, 0, nand->maux.oob_page_size, buf, raw, flags, retcount);
+}
+
+ufprog_status UFPROG_API ufprog_nand_read_pages_range(struct nand_chip *nand, uint32_t page, uint32_t count,
+						      uint32_t column, uint32_t len, void *buf, ufprog_bool raw,
+						      uint32_t flags, uint32_t *retcount)
+{
+	if (retcount)
+		*retcount = 0;
+
+	if (!nand || !buf || !len)
+		return UFP_INVALID_PARAMETER;
+
+	if (column >= nand->maux.oob_page_size || len > nand->maux.oob_page_size - column)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	/* A partial page can not be decoded by an external ECC engine. Only On-die ECC works on it. */
+	if (!raw && nand->ecc && nand->ecc->type != NAND_ECC_NONE && nand->ecc->type != NAND_ECC_ON_DIE &&
+	    (column || len < nand->maux.oob_page_size)) {
+		logm_err("Partial page read with ECC requires On-die ECC\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	return nand_read_pages(nand, page, count, column, len, buf, raw, flags, retcount);
+}
+
 ufprog_status UFPROG_API ufprog_nand_write_page(struct nand_chip *nand, uint32_t page, const void *buf,
 						ufprog_bool raw)
 {
@@ -920,6 +962,17 @@ struct ufprog_nand_ecc_chip *UFPROG_API ufprog_nand_default_ecc(struct nand_chip
 	return nand->default_ecc;
 }
 
+ufprog_status UFPROG_API ufprog_nand_set_ecc_report_cb(struct nand_chip *nand, nand_ecc_report_cb cb, void *priv)
+{
+	if (!nand)
+		return UFP_INVALID_PARAMETER;
+
+	nand->ecc_report_cb = cb;
+	nand->ecc_report_priv = priv;
+
+	return UFP_OK;
+}
+
 ufprog_status UFPROG_API ufprog_nand_get_bbm_config(struct nand_chip *nand, struct nand_bbm_config *ret_bbmcfg)
 {
 	if (!nand || !ret_bbmcfg)
@@ -1089,22 +1142,249 @@ uint32_t UFPROG_API ufprog_nand_fill_page_by_layout(const struct nand_page_layou
 	return n;
 }
 
-static ufprog_status nand_torture_check_pattern(const uint8_t *buf, uint32_t count, uint8_t pat)
+static bool nand_page_layout_type_filled(uint32_t type, uint32_t flags)
 {
-	uint32_t i;
+	switch (type) {
+	case NAND_PAGE_BYTE_DATA:
+		return true;
 
-	for (i = 0; i < count; i++) {
-		if (buf[i] != pat)
-			return UFP_FAIL;
+	case NAND_PAGE_BYTE_OOB_DATA:
+		return !!(flags & PAGE_FILL_F_FILL_OOB);
+
+	case NAND_PAGE_BYTE_OOB_FREE:
+		return !!(flags & PAGE_FILL_F_FILL_UNPROTECTED_OOB);
+
+	case NAND_PAGE_BYTE_UNUSED:
+		return !!(flags & PAGE_FILL_F_FILL_UNUSED);
+
+	case NAND_PAGE_BYTE_ECC_PARITY:
+		return !!(flags & PAGE_FILL_F_FILL_ECC_PARITY);
+
+	default:
+		return false;
+	}
+}
+
+static void nand_page_layout_prog_add_op(struct nand_page_layout_prog *prog, uint32_t op, uint32_t dst, uint32_t src,
+					 uint32_t len)
+{
+	struct nand_page_layout_op *last;
+
+	if (prog->num_ops) {
+		last = &prog->ops[prog->num_ops - 1];
+
+		if (last->op == op && last->dst + last->len == dst &&
+		    (op != NAND_PAGE_LAYOUT_OP_COPY || last->src + last->len == src)) {
+			last->len += len;
+			return;
+		}
+	}
+
+	prog->ops[prog->num_ops].op = op;
+	prog->ops[prog->num_ops].dst = dst;
+	prog->ops[prog->num_ops].src = src;
+	prog->ops[prog->num_ops].len = len;
+	prog->num_ops++;
+}
+
+static void nand_page_layout_prog_add_run(struct nand_page_layout_prog *prog, uint32_t offset, uint32_t len)
+{
+	struct nand_page_layout_run *last;
+
+	if (prog->num_runs) {
+		last = &prog->runs[prog->num_runs - 1];
+
+		if (last->offset + last->len == offset) {
+			last->len += len;
+			return;
+		}
+	}
+
+	prog->runs[prog->num_runs].offset = offset;
+	prog->runs[prog->num_runs].len = len;
+	prog->num_runs++;
+}
+
+ufprog_status UFPROG_API ufprog_nand_compile_page_layout(const struct nand_page_layout *layout, uint32_t fill_flags,
+							 uint32_t cmp_types, struct nand_page_layout_prog **out_prog)
+{
+	struct nand_page_layout_prog *prog;
+	uint32_t i, num, type, n = 0, s = 0;
+
+	if (!layout || !out_prog)
+		return UFP_INVALID_PARAMETER;
+
+	prog = malloc(sizeof(*prog) + layout->count * (sizeof(prog->ops[0]) + sizeof(prog->runs[0])));
+	if (!prog)
+		return UFP_NOMEM;
+
+	prog->ops = (struct nand_page_layout_op *)(prog + 1);
+	prog->runs = (struct nand_page_layout_run *)(prog->ops + layout->count);
+	prog->num_ops = 0;
+	prog->num_runs = 0;
+
+	/* Adjacent entries with the same action are merged into one run */
+	for (i = 0; i < layout->count; i++) {
+		num = layout->entries[i].num;
+		type = layout->entries[i].type;
+
+		if (!num)
+			continue;
+
+		if (nand_page_layout_type_filled(type, fill_flags)) {
+			nand_page_layout_prog_add_op(prog, NAND_PAGE_LAYOUT_OP_COPY, n, s, num);
+			s += num;
+		} else {
+			if (fill_flags & PAGE_FILL_F_FILL_NON_DATA_FF)
+				nand_page_layout_prog_add_op(prog, NAND_PAGE_LAYOUT_OP_FILL_FF, n, 0, num);
+
+			if (fill_flags & PAGE_FILL_F_SRC_SKIP_NON_DATA)
+				s += num;
+		}
+
+		if (type < 32 && (cmp_types & BIT(type)))
+			nand_page_layout_prog_add_run(prog, n, num);
+
+		n += num;
+	}
+
+	prog->size = n;
+
+	*out_prog = prog;
+
+	return UFP_OK;
+}
+
+void UFPROG_API ufprog_nand_free_page_layout_prog(struct nand_page_layout_prog *prog)
+{
+	if (prog)
+		free(prog);
+}
+
+uint32_t UFPROG_API ufprog_nand_fill_page_by_prog(const struct nand_page_layout_prog *prog, void *dst, const void *src,
+						  uint32_t count)
+{
+	const struct nand_page_layout_op *op;
+	const uint8_t *s = src;
+	uint8_t *p = dst;
+	uint32_t i, cpycnt;
+
+	if (!prog || !dst || !src)
+		return 0;
+
+	for (i = 0; i < prog->num_ops; i++) {
+		op = &prog->ops[i];
+
+		if (op->op == NAND_PAGE_LAYOUT_OP_FILL_FF) {
+			memset(p + op->dst, 0xff, op->len);
+			continue;
+		}
+
+		/* Same as ufprog_nand_fill_page_by_layout(), count limits bytes copied by page offset */
+		if (op->dst < count) {
+			cpycnt = count - op->dst;
+			if (cpycnt > op->len)
+				cpycnt = op->len;
+
+			memcpy(p + op->dst, s + op->src, cpycnt);
+		} else {
+			cpycnt = 0;
+		}
+
+		if (op->len > cpycnt)
+			memset(p + op->dst + cpycnt, 0xff, op->len - cpycnt);
 	}
 
+	return prog->size;
+}
+
+ufprog_bool UFPROG_API ufprog_nand_compare_page_by_prog(const struct nand_page_layout_prog *prog, const void *buf,
+							const void *gold, uint32_t len, uint32_t *retpos)
+{
+	const struct nand_page_layout_run *run;
+	const uint8_t *b = buf, *g = gold;
+	uint32_t i, j, cmplen;
+
+	if (!prog || !buf || !gold)
+		return false;
+
+	for (i = 0; i < prog->num_runs; i++) {
+		run = &prog->runs[i];
+
+		if (run->offset >= len)
+			break;
+
+		cmplen = len - run->offset;
+		if (cmplen > run->len)
+			cmplen = run->len;
+
+		if (!memcmp(b + run->offset, g + run->offset, cmplen))
+			continue;
+
+		for (j = run->offset; j < run->offset + cmplen; j++) {
+			if (b[j] != g[j])
+				break;
+		}
+
+		if (retpos)
+			*retpos = j;
+
+		return false;
+	}
+
+	return true;
+}
+
+uint32_t UFPROG_API ufprog_nand_count_bitflips_by_prog(const struct nand_page_layout_prog *prog, const void *buf,
+						       const void *gold, uint32_t len)
+{
+	const struct nand_page_layout_run *run;
+	const uint8_t *b = buf, *g = gold;
+	uint32_t i, j, end, cnt = 0;
+
+	if (!prog || !buf)
+		return 0;
+
+	for (i = 0; i < prog->num_runs; i++) {
+		run = &prog->runs[i];
+
+		if (run->offset >= len)
+			break;
+
+		end = run->offset + run->len;
+		if (end > len)
+			end = len;
+
+		/* Compare against all-zero if gold is not specified */
+		if (!g) {
+			for (j = run->offset; j < end; j++)
+				cnt += hweight8(b[j]);
+
+			continue;
+		}
+
+		if (!memcmp(b + run->offset, g + run->offset, end - run->offset))
+			continue;
+
+		for (j = run->offset; j < end; j++)
+			cnt += hweight8(b[j] ^ g[j]);
+	}
+
+	return cnt;
+}
+
+/* Every byte equals to @pat if the first one does and the buffer equals to itself shifted by one byte */
+static ufprog_status nand_torture_check_pattern(const uint8_t *buf, uint32_t count, uint8_t pat)
+{
+	if (buf[0] != pat || memcmp(buf, buf + 1, count - 1))
+		return UFP_FAIL;
+
 	return UFP_OK;
 }
 
-static ufprog_status nand_torture_test_pattern(struct nand_chip *nand, uint32_t block, uint8_t pat, uint8_t check,
-					       bool erase)
+static ufprog_status nand_torture_test_pattern(struct nand_chip *nand, uint32_t block, void *buf, uint8_t pat,
+					       uint8_t check, bool erase)
 {
-	void *buf = nand->page_cache[0];
 	ufprog_status ret;
 
 	if (erase) {
@@ -1124,7 +1404,8 @@ static ufprog_status nand_torture_test_pattern(struct nand_chip *nand, uint32_t
 			return ret;
 		}
 
-		ret = nand_torture_check_pattern(buf, nand->maux.oob_block_size, 0xff); {
+		ret = nand_torture_check_pattern(buf, nand->maux.oob_block_size, 0xff);
+		if (ret) {
 			logm_err("Non-0xFF byte found in erased block %u at 0x%" PRIx64 "\n", block,
 				 (uint64_t)block << nand->maux.block_shift);
 			return ret;
@@ -1151,31 +1432,33 @@ static ufprog_status nand_torture_test_pattern(struct nand_chip *nand, uint32_t
 		return ret;
 	}
 
-	ret = nand_torture_check_pattern(buf, nand->maux.oob_block_size, pat);
+	/* Without erasing, the data read back is the previous pattern ANDed with @pat */
+	ret = nand_torture_check_pattern(buf, nand->maux.oob_block_size, check);
 	if (ret) {
-		logm_err("Non-0x%02X byte found in erased block %u at 0x%" PRIx64 "\n", pat, block,
-			 (uint64_t)block << nand->maux.block_shift);
+		logm_err("Non-0x%02X byte found in block %u at 0x%" PRIx64 " after writting test pattern 0x%02x\n",
+			 check, block, (uint64_t)block << nand->maux.block_shift, pat);
 		return ret;
 	}
 
 	return UFP_OK;
 }
 
-ufprog_status UFPROG_API ufprog_nand_torture_block(struct nand_chip *nand, uint32_t block)
+ufprog_status UFPROG_API ufprog_nand_torture_block_with_buf(struct nand_chip *nand, uint32_t block, void *buf)
 {
 	ufprog_status ret;
 
-	if (!nand)
+	if (!nand || !buf)
 		return UFP_INVALID_PARAMETER;
 
 	if (block >= nand->maux.block_count)
 		return UFP_INVALID_PARAMETER;
 
-	STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, TORTURE_TEST_PAT, TORTURE_TEST_PAT, true));
-	STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, TORTURE_TEST_CMP_PAT, TORTURE_TEST_CMP_PAT, true));
+	STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, buf, TORTURE_TEST_PAT, TORTURE_TEST_PAT, true));
+	STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, buf, TORTURE_TEST_CMP_PAT, TORTURE_TEST_CMP_PAT,
+						   true));
 
 	if (nand->random_page_write && nand->nops > 1)
-		STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, TORTURE_TEST_PAT, 0, false));
+		STATUS_CHECK_RET(nand_torture_test_pattern(nand, block, buf, TORTURE_TEST_PAT, 0, false));
 
 	/* Test passed. Erase this block. */
 	ret = ufprog_nand_erase_block(nand, block << nand->maux.pages_per_block_shift);
@@ -1186,3 +1469,25 @@ ufprog_status UFPROG_API ufprog_nand_torture_block(struct nand_chip *nand, uint3
 
 	return ret;
 }
+
+ufprog_status UFPROG_API ufprog_nand_torture_block(struct nand_chip *nand, uint32_t block)
+{
+	ufprog_status ret;
+	void *buf;
+
+	if (!nand)
+		return UFP_INVALID_PARAMETER;
+
+	/* The page cache holds only one page, while the test works on a whole block */
+	buf = malloc(nand->maux.oob_block_size);
+	if (!buf) {
+		logm_err("No memory for torture test buffer\n");
+		return UFP_NOMEM;
+	}
+
+	ret = ufprog_nand_torture_block_with_buf(nand, block, buf);
+
+	free(buf);
+
+	return ret;
+}
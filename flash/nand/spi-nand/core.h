@@ -24,6 +24,9 @@
 #define SNAND_SPEED_LOW				10000000
 #define SNAND_SPEED_HIGH			60000000
 
+#define SNAND_CALIBRATE_MAX_STEPS		32
+#define SNAND_CALIBRATE_DFL_ROUNDS		4
+
 #define SNAND_RESET_WAIT_US			1000000
 #define SNAND_POLL_MAX_US			5000000
 #define SNAND_POLL_WARN_US			1000000
@@ -130,6 +133,16 @@ struct spi_nand_state {
 
 	uint8_t seq_rd_feature_addr;
 	uint8_t seq_rd_crbsy_mask;
+
+	/* Status captured by the busy poll of the last read-to-cache, consumed by ECC status checking */
+	bool ecc_sr_valid;
+	uint8_t ecc_sr;
+
+	uint32_t poll_rtt_us;
+	struct busy_poll_stat read_poll;
+	struct busy_poll_stat cache_read_poll;
+	struct busy_poll_stat pp_poll;
+	struct busy_poll_stat erase_poll;
 };
 
 struct spi_nand {
@@ -161,6 +174,8 @@ ufprog_status spi_nand_get_feature(struct spi_nand *snand, uint32_t addr, uint8_
 ufprog_status spi_nand_set_feature(struct spi_nand *snand, uint32_t addr, uint8_t val);
 
 ufprog_status spi_nand_read_status(struct spi_nand *snand, uint8_t *retval);
+ufprog_status spi_nand_get_ecc_status_sr(struct spi_nand *snand, uint8_t *retsr);
+bool spi_nand_ecc_sr_no_bitflips(struct spi_nand *snand);
 ufprog_status spi_nand_wait_busy(struct spi_nand *snand, uint32_t wait_ms, uint8_t *retsr);
 uint8_t spi_nand_get_config(struct spi_nand *snand);
 ufprog_status spi_nand_update_config(struct spi_nand *snand, uint8_t clr, uint8_t set);
@@ -46,6 +46,9 @@ static ufprog_status spi_nand_check_extended_ecc_bfr(struct spi_nand *snand, uin
 
 	snand->ecc_status->per_step = true;
 
+	if (spi_nand_ecc_sr_no_bitflips(snand))
+		return UFP_OK;
+
 	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_BFR7_0_ADDR, &bfr0));
 	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_BFR15_8_ADDR, &bfr1));
 
@@ -95,7 +98,7 @@ ufprog_status spi_nand_check_ecc_1bit_per_step(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -119,7 +122,7 @@ ufprog_status spi_nand_check_ecc_8bits_sr_2bits(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
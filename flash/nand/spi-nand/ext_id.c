@@ -1745,6 +1745,8 @@ ufprog_status spi_nand_load_ext_id_list(void)
 	STATUS_CHECK_GOTO_RET(spi_nand_load_ext_memorg(jroot), ret, cleanup);
 	STATUS_CHECK_GOTO_RET(spi_nand_load_ext_vendors(jroot), ret, cleanup);
 
+	spi_nand_invalidate_part_index();
+
 	logm_notice("Successfully loaded external flash table\n");
 
 	ret = UFP_OK;
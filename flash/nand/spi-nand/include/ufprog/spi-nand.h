@@ -13,6 +13,7 @@
 #include <ufprog/device.h>
 #include <ufprog/api_spi.h>
 #include <ufprog/spi.h>
+#include <ufprog/busy_poll.h>
 #include <ufprog/nand.h>
 
 EXTERN_C_BEGIN
@@ -59,6 +60,14 @@ struct spi_nand_info {
 	const void *onfi_data;
 };
 
+struct spi_nand_busy_poll_info {
+	uint32_t rtt_us;
+	struct busy_poll_info read;
+	struct busy_poll_info cache_read;
+	struct busy_poll_info pp;
+	struct busy_poll_info erase;
+};
+
 struct spi_nand_vendor_item {
 	const char *id;
 	const char *name;
@@ -97,6 +106,9 @@ uint32_t UFPROG_API ufprog_spi_nand_get_speed_limit(struct spi_nand *snand);
 void UFPROG_API ufprog_spi_nand_set_speed_limit(struct spi_nand *snand, uint32_t hz);
 uint32_t UFPROG_API ufprog_spi_nand_get_speed_low(struct spi_nand *snand);
 uint32_t UFPROG_API ufprog_spi_nand_get_speed_high(struct spi_nand *snand);
+ufprog_status UFPROG_API ufprog_spi_nand_set_speed_high(struct spi_nand *snand, uint32_t hz);
+ufprog_status UFPROG_API ufprog_spi_nand_calibrate_speed(struct spi_nand *snand, uint32_t page, uint32_t count,
+							 uint32_t rounds, uint32_t *rethz);
 
 ufprog_status UFPROG_API ufprog_spi_nand_list_vendors(struct spi_nand_vendor_item **outlist, uint32_t *retcount);
 
@@ -113,6 +125,8 @@ ufprog_status UFPROG_API ufprog_spi_nand_probe_init(struct spi_nand *snand);
 ufprog_bool UFPROG_API ufprog_spi_nand_valid(struct spi_nand *snand);
 uint32_t UFPROG_API ufprog_spi_nand_flash_param_signature(struct spi_nand *snand);
 ufprog_status UFPROG_API ufprog_spi_nand_info(struct spi_nand *snand, struct spi_nand_info *info);
+ufprog_status UFPROG_API ufprog_spi_nand_get_busy_poll_info(struct spi_nand *snand,
+							    struct spi_nand_busy_poll_info *info);
 
 ufprog_bool UFPROG_API ufprog_spi_nand_supports_nor_read(struct spi_nand *snand);
 ufprog_status UFPROG_API ufprog_spi_nand_enable_nor_read(struct spi_nand *snand);
@@ -26,8 +26,8 @@ static inline ufprog_status spi_nand_op_read_page_to_cache(struct spi_nand *snan
 
 static ufprog_status spi_nand_ops_read_page(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
 					    void *buf);
-static ufprog_status spi_nand_ops_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
-					     uint32_t flags, uint32_t *retcount);
+static ufprog_status spi_nand_ops_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, uint32_t column,
+					     uint32_t len, void *buf, uint32_t flags, uint32_t *retcount);
 static ufprog_status spi_nand_ops_write_page(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
 					     const void *buf);
 static ufprog_status spi_nand_ops_erase_block(struct nand_chip *nand, uint32_t page);
@@ -213,6 +213,168 @@ ufprog_status spi_nand_set_high_speed(struct spi_nand *snand)
 	return spi_nand_set_speed(snand, snand->state.speed_high);
 }
 
+static ufprog_status spi_nand_apply_speed_high(struct spi_nand *snand, uint32_t hz)
+{
+	snand->state.speed_high = hz;
+
+	/* Set and read back the real highest speed */
+	STATUS_CHECK_RET(spi_nand_set_high_speed(snand));
+	snand->state.speed_high = ufprog_spi_get_speed(snand->spi);
+
+	if (!snand->state.speed_high)
+		snand->state.speed_high = hz;
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_spi_nand_set_speed_high(struct spi_nand *snand, uint32_t hz)
+{
+	if (!snand || !hz)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snand->nand.memorg.page_size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (hz > snand->param.max_speed)
+		hz = snand->param.max_speed;
+
+	if (hz > snand->max_speed)
+		hz = snand->max_speed;
+
+	if (hz < snand->state.speed_low)
+		hz = snand->state.speed_low;
+
+	return spi_nand_apply_speed_high(snand, hz);
+}
+
+static ufprog_status spi_nand_calibrate_check(struct spi_nand *snand, uint32_t page, uint32_t count, uint8_t *buf,
+					      uint32_t rounds, uint32_t ref_crc)
+{
+	uint32_t i, j, crc;
+
+	STATUS_CHECK_RET(spi_nand_set_high_speed(snand));
+
+	for (i = 0; i < rounds; i++) {
+		crc = 0;
+
+		for (j = 0; j < count; j++) {
+			STATUS_CHECK_RET(ufprog_nand_read_page(&snand->nand, page + j, buf, false));
+			crc = crc32(crc, buf, snand->nand.maux.oob_page_size);
+		}
+
+		if (crc != ref_crc)
+			return UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_spi_nand_calibrate_speed(struct spi_nand *snand, uint32_t page, uint32_t count,
+							 uint32_t rounds, uint32_t *rethz)
+{
+	uint32_t speeds[SNAND_CALIBRATE_MAX_STEPS], nspeeds, speed_high, speed_max, ref_crc = 0, i, sel;
+	ufprog_status ret;
+	uint8_t *buf;
+
+	if (!snand || !rethz)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snand->nand.memorg.page_size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (!count)
+		count = 1;
+
+	if (page >= snand->nand.maux.page_count || count > snand->nand.maux.page_count - page)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	if (!rounds)
+		rounds = SNAND_CALIBRATE_DFL_ROUNDS;
+
+	/*
+	 * Only speeds allowed by both the part and the configured limit are candidates. The current high speed may
+	 * already have been lowered by a previous calibration, so it can't be used as the upper bound.
+	 */
+	speed_high = snand->state.speed_high;
+
+	speed_max = snand->param.max_speed;
+	if (speed_max > snand->max_speed)
+		speed_max = snand->max_speed;
+
+	nspeeds = ufprog_spi_get_speed_steps(snand->spi, speed_max, speeds, ARRAY_SIZE(speeds));
+	if (!nspeeds) {
+		logm_err("Controller does not support changing SPI clock\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	buf = malloc(snand->nand.maux.oob_page_size);
+	if (!buf) {
+		logm_err("No memory for calibration buffer\n");
+		return UFP_NOMEM;
+	}
+
+	/*
+	 * Reference data is read at the lowest speed with on-die ECC enabled, so that array bit flips are corrected
+	 * before the data reaches the bus.
+	 */
+	snand->state.speed_high = snand->state.speed_low;
+	STATUS_CHECK_GOTO_RET(spi_nand_set_high_speed(snand), ret, out);
+
+	for (i = 0; i < count; i++) {
+		ret = ufprog_nand_read_page(&snand->nand, page + i, buf, false);
+		if (ret) {
+			logm_err("Failed to read reference page %u\n", page + i);
+			goto out;
+		}
+
+		ref_crc = crc32(ref_crc, buf, snand->nand.maux.oob_page_size);
+	}
+
+	ret = spi_nand_calibrate_check(snand, page, count, buf, 1, ref_crc);
+	if (ret) {
+		logm_err("Reference data is not stable even at the lowest speed\n");
+		goto out;
+	}
+
+	for (i = 0; i < nspeeds; i++) {
+		snand->state.speed_high = speeds[i];
+
+		ret = spi_nand_calibrate_check(snand, page, count, buf, rounds, ref_crc);
+		logm_dbg("Calibrating %uHz: %s\n", speeds[i], ret ? "failed" : "passed");
+
+		if (!ret)
+			break;
+	}
+
+	if (i >= nspeeds) {
+		logm_err("No SPI clock passed the calibration\n");
+		ret = UFP_DATA_VERIFICATION_FAIL;
+		goto out;
+	}
+
+	/* Keep one step of margin if a faster clock has failed */
+	sel = i;
+	if (i && i + 1 < nspeeds)
+		sel = i + 1;
+
+	*rethz = speeds[sel];
+
+	ret = UFP_OK;
+
+out:
+	free(buf);
+
+	if (ret)
+		spi_nand_apply_speed_high(snand, speed_high);
+	else
+		ret = spi_nand_apply_speed_high(snand, *rethz);
+
+	if (!ret)
+		*rethz = snand->state.speed_high;
+
+	return ret;
+}
+
 ufprog_status spi_nand_issue_single_opcode(struct spi_nand *snand, uint8_t opcode)
 {
 	struct ufprog_spi_mem_op op = SNAND_SINGLE_OP(opcode);
@@ -266,22 +428,80 @@ ufprog_status spi_nand_read_status(struct spi_nand *snand, uint8_t *retval)
 	return ret;
 }
 
+/* Status register for ECC status decoding. Uses the value captured by read-to-cache polling if available. */
+ufprog_status spi_nand_get_ecc_status_sr(struct spi_nand *snand, uint8_t *retsr)
+{
+	if (snand->state.ecc_sr_valid) {
+		snand->state.ecc_sr_valid = false;
+		*retsr = snand->state.ecc_sr;
+		return UFP_OK;
+	}
+
+	return spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, retsr);
+}
+
+/* Used by checkers reading extended ECC registers to skip them if the captured status shows no bitflips */
+bool spi_nand_ecc_sr_no_bitflips(struct spi_nand *snand)
+{
+	if (!snand->state.ecc_sr_valid)
+		return false;
+
+	snand->state.ecc_sr_valid = false;
+
+	return !(snand->state.ecc_sr & SPI_NAND_STATUS_ECC_MASK);
+}
+
 static ufprog_status spi_nand_wait_busy_bit(struct spi_nand *snand, uint8_t addr, uint8_t bitm, uint32_t wait_us,
-					    uint8_t *retsr)
+					    struct busy_poll_stat *stat, uint8_t *retsr)
 {
-	uint64_t tst = os_get_timer_us(), tmo = tst + wait_us;
+	uint64_t tst = os_get_timer_us(), tmo = tst + wait_us, t;
+	struct busy_poll_info pi;
 	ufprog_status ret;
 	uint8_t sr = 0;
+	struct ufprog_spi_mem_op op = SNAND_GET_FEATURE_OP(addr, &sr);
+
+	busy_poll_stat_info(stat, snand->state.poll_rtt_us, &pi);
+
+	/* Let the controller poll the feature register if it has native support */
+	if (ufprog_spi_supports_mem_poll_status(snand->spi)) {
+		ret = ufprog_spi_mem_poll_status(snand->spi, &op, bitm, 0, pi.initial_delay_us, pi.interval_us,
+						 (wait_us + 999) / 1000);
+		if (ret != UFP_UNSUPPORTED) {
+			if (!ret)
+				busy_poll_stat_add(stat, os_get_timer_us() - tst);
+			else if (ret != UFP_TIMEOUT)
+				logm_err("Failed to read feature address 0x%02x\n", addr);
+
+			if (retsr)
+				*retsr = sr;
+
+			return ret;
+		}
+	}
+
+	tst = os_get_timer_us();
+	tmo = tst + wait_us;
+
+	if (pi.initial_delay_us)
+		os_usleep(pi.initial_delay_us);
 
 	do {
+		t = os_get_timer_us();
 		ret = spi_nand_get_feature(snand, addr, &sr);
 		if (ret) {
 			logm_err("Failed to read feature address 0x%02x\n", addr);
 			return ret;
 		}
 
-		if (!(sr & bitm))
+		busy_poll_rtt_update(&snand->state.poll_rtt_us, os_get_timer_us() - t);
+
+		if (!(sr & bitm)) {
+			busy_poll_stat_add(stat, t - tst);
 			break;
+		}
+
+		if (pi.interval_us)
+			os_usleep(pi.interval_us);
 	} while (os_get_timer_us() <= tmo);
 
 	/* Last check */
@@ -302,17 +522,23 @@ static ufprog_status spi_nand_wait_busy_bit(struct spi_nand *snand, uint8_t addr
 	return UFP_TIMEOUT;
 }
 
-ufprog_status spi_nand_wait_busy(struct spi_nand *snand, uint32_t wait_us, uint8_t *retsr)
+static ufprog_status spi_nand_wait_busy_adaptive(struct spi_nand *snand, uint32_t wait_us, struct busy_poll_stat *stat,
+						 uint8_t *retsr)
 {
 	ufprog_status ret;
 
-	ret = spi_nand_wait_busy_bit(snand, SPI_NAND_FEATURE_STATUS_ADDR, SPI_NAND_STATUS_OIP, wait_us, retsr);
+	ret = spi_nand_wait_busy_bit(snand, SPI_NAND_FEATURE_STATUS_ADDR, SPI_NAND_STATUS_OIP, wait_us, stat, retsr);
 	if (ret)
 		logm_err("Timed out waiting for flash idle\n");
 
 	return ret;
 }
 
+ufprog_status spi_nand_wait_busy(struct spi_nand *snand, uint32_t wait_us, uint8_t *retsr)
+{
+	return spi_nand_wait_busy_adaptive(snand, wait_us, NULL, retsr);
+}
+
 static ufprog_status spi_nand_refresh_config(struct spi_nand *snand)
 {
 	ufprog_status ret;
@@ -1742,6 +1968,25 @@ ufprog_status UFPROG_API ufprog_spi_nand_info(struct spi_nand *snand, struct spi
 	return UFP_OK;
 }
 
+ufprog_status UFPROG_API ufprog_spi_nand_get_busy_poll_info(struct spi_nand *snand,
+							    struct spi_nand_busy_poll_info *info)
+{
+	if (!snand || !info)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snand->nand.memorg.page_size)
+		return UFP_FLASH_NOT_PROBED;
+
+	info->rtt_us = snand->state.poll_rtt_us;
+
+	busy_poll_stat_info(&snand->state.read_poll, info->rtt_us, &info->read);
+	busy_poll_stat_info(&snand->state.cache_read_poll, info->rtt_us, &info->cache_read);
+	busy_poll_stat_info(&snand->state.pp_poll, info->rtt_us, &info->pp);
+	busy_poll_stat_info(&snand->state.erase_poll, info->rtt_us, &info->erase);
+
+	return UFP_OK;
+}
+
 ufprog_status spi_nand_page_op(struct spi_nand *snand, uint32_t page, uint8_t cmd)
 {
 	struct ufprog_spi_mem_op op = SNAND_PAGE_OP(cmd, page);
@@ -1803,22 +2048,38 @@ ufprog_status spi_nand_read_cache_single(struct spi_nand *snand, uint32_t column
 					  ufprog_spi_mem_io_bus_width_info(SPI_MEM_IO_1_1_1), column, len, data);
 }
 
+static ufprog_status spi_nand_check_ecc_sr(struct spi_nand *snand, uint8_t sr)
+{
+	ufprog_status ret;
+
+	/* ECC status bits are valid once OIP is cleared, so the last polled status saves a register read */
+	snand->state.ecc_sr = sr;
+	snand->state.ecc_sr_valid = true;
+
+	ret = snand->ext_param.ops.check_ecc(snand);
+
+	snand->state.ecc_sr_valid = false;
+
+	return ret;
+}
+
 static ufprog_status spi_nand_die_read_page(struct spi_nand *snand, uint32_t page, uint32_t column, uint32_t len,
 					    void *data, bool check_ecc)
 {
 	ufprog_status ret;
+	uint8_t sr;
 
 	column |= spi_nand_get_plane_address(snand, page);
 
 	STATUS_CHECK_RET(spi_nand_op_read_page_to_cache(snand, page));
-	ret = spi_nand_wait_busy(snand, snand->param.max_r_time_us, NULL);
+	ret = spi_nand_wait_busy_adaptive(snand, snand->param.max_r_time_us, &snand->state.read_poll, &sr);
 	if (ret) {
 		logm_err("Read to cache command timed out in page %u\n", page);
 		return ret;
 	}
 
 	if (check_ecc) {
-		snand->ecc_ret = snand->ext_param.ops.check_ecc(snand);
+		snand->ecc_ret = spi_nand_check_ecc_sr(snand, sr);
 		switch (snand->ecc_ret) {
 		case UFP_OK:
 		case UFP_ECC_CORRECTED:
@@ -1838,11 +2099,42 @@ static ufprog_status spi_nand_die_read_page(struct spi_nand *snand, uint32_t pag
 	return ret;
 }
 
-static ufprog_status spi_nand_die_read_pages(struct spi_nand *snand, uint32_t page, uint32_t count, void *buf,
-					     bool check_ecc, uint32_t flags, uint32_t *retcount)
+/* ECC check of a page in sequential/random cache read. Returns non-zero only if reading must stop. */
+static ufprog_status spi_nand_read_pages_check_ecc(struct spi_nand *snand, uint32_t page, uint8_t sr, uint32_t flags)
 {
-	uint8_t faddr, crbsym, *p = buf;
-	uint32_t column, rdcnt = 0;
+	ufprog_status ret;
+
+	ret = spi_nand_check_ecc_sr(snand, sr);
+	snand->ecc_ret = UFP_OK;
+
+	switch (ret) {
+	case UFP_OK:
+		return UFP_OK;
+
+	case UFP_ECC_CORRECTED:
+	case UFP_ECC_UNCORRECTABLE:
+		ufprog_nand_print_ecc_result(&snand->nand, page);
+
+		if (ret == UFP_ECC_UNCORRECTABLE && !(flags & NAND_READ_F_IGNORE_ECC_ERROR))
+			return ret;
+
+		return UFP_OK;
+
+	default:
+		if (flags & NAND_READ_F_IGNORE_IO_ERROR)
+			return UFP_OK;
+
+		logm_err("Failed to read ECC status\n");
+		return ret;
+	}
+}
+
+static ufprog_status spi_nand_die_read_pages(struct spi_nand *snand, uint32_t page, uint32_t count,
+					     uint32_t column, uint32_t len, void *buf, bool check_ecc, uint32_t flags,
+					     uint32_t *retcount)
+{
+	uint8_t faddr, crbsym, sr, *p = buf;
+	uint32_t plane_column, rdcnt = 0;
 	bool seq_mode = false;
 	ufprog_status ret;
 
@@ -1857,47 +2149,33 @@ static ufprog_status spi_nand_die_read_pages(struct spi_nand *snand, uint32_t pa
 
 	STATUS_CHECK_RET(spi_nand_op_read_page_to_cache(snand, page));
 
-	ret = spi_nand_wait_busy(snand, snand->param.max_r_time_us, NULL);
+	ret = spi_nand_wait_busy_adaptive(snand, snand->param.max_r_time_us, &snand->state.read_poll, &sr);
 	if (ret) {
 		logm_err("Read to cache command timed out in page %u\n", page);
 		return ret;
 	}
 
 	while (count > 1) {
-		if (check_ecc) {
-			snand->ecc_ret = snand->ext_param.ops.check_ecc(snand);
-			if (snand->ecc_ret) {
-				if (snand->ecc_ret == UFP_ECC_CORRECTED || snand->ecc_ret == UFP_ECC_UNCORRECTABLE) {
-					ufprog_nand_print_ecc_result(&snand->nand, page);
-
-					if (ret == UFP_ECC_UNCORRECTABLE) {
-						if (!(flags & NAND_READ_F_IGNORE_ECC_ERROR))
-							goto cleanup;
-					}
-				} else if (!(flags & NAND_READ_F_IGNORE_IO_ERROR)) {
-					goto cleanup;
-				}
-			}
-		}
-
-		snand->ecc_ret = UFP_OK;
+		if (check_ecc)
+			STATUS_CHECK_GOTO_RET(spi_nand_read_pages_check_ecc(snand, page, sr, flags), ret, cleanup);
 
 		if (seq_mode)
 			STATUS_CHECK_GOTO_RET(spi_nand_issue_single_opcode(snand, SNAND_CMD_READ_FROM_CACHE_SEQ), ret, cleanup);
 		else
 			STATUS_CHECK_GOTO_RET(spi_nand_page_op(snand, page + 1, SNAND_CMD_READ_FROM_CACHE_RANDOM), ret, cleanup);
 
-		ret = spi_nand_wait_busy_bit(snand, faddr, crbsym, snand->param.max_r_time_us, NULL);
+		ret = spi_nand_wait_busy_bit(snand, faddr, crbsym, snand->param.max_r_time_us,
+					     &snand->state.cache_read_poll, NULL);
 		if (ret) {
 			logm_err("Read to cache random command timed out in page %u\n", page + 1);
 			goto cleanup;
 		}
 
-		column = spi_nand_get_plane_address(snand, page);
+		plane_column = spi_nand_get_plane_address(snand, page) | column;
 
-		STATUS_CHECK_GOTO_RET(spi_nand_read_cache(snand, column, snand->nand.maux.oob_page_size, p), ret, cleanup);
+		STATUS_CHECK_GOTO_RET(spi_nand_read_cache(snand, plane_column, len, p), ret, cleanup);
 
-		ret = spi_nand_wait_busy(snand, snand->param.max_r_time_us, NULL);
+		ret = spi_nand_wait_busy_adaptive(snand, snand->param.max_r_time_us, &snand->state.read_poll, &sr);
 		if (ret) {
 			logm_err("Read to cache command timed out in page %u\n", page + 1);
 			goto cleanup;
@@ -1906,20 +2184,25 @@ static ufprog_status spi_nand_die_read_pages(struct spi_nand *snand, uint32_t pa
 		rdcnt++;
 		page++;
 		count--;
-		p += snand->nand.maux.oob_page_size;
+		p += len;
 	}
 
+	/* Status of the final page was captured by the last read-to-cache wait */
+	if (check_ecc)
+		STATUS_CHECK_GOTO_RET(spi_nand_read_pages_check_ecc(snand, page, sr, flags), ret, cleanup);
+
 	STATUS_CHECK_GOTO_RET(spi_nand_issue_single_opcode(snand, SNAND_CMD_READ_FROM_CACHE_END), ret, cleanup);
 
-	ret = spi_nand_wait_busy_bit(snand, faddr, crbsym, snand->param.max_r_time_us, NULL);;
+	ret = spi_nand_wait_busy_bit(snand, faddr, crbsym, snand->param.max_r_time_us,
+				     &snand->state.cache_read_poll, NULL);
 	if (ret) {
 		logm_err("Read to cache random command timed out in page %u\n", page + 1);
 		goto cleanup;
 	}
 
-	column = spi_nand_get_plane_address(snand, page);
+	plane_column = spi_nand_get_plane_address(snand, page) | column;
 
-	STATUS_CHECK_GOTO_RET(spi_nand_read_cache(snand, column, snand->nand.maux.oob_page_size, p), ret, cleanup);
+	STATUS_CHECK_GOTO_RET(spi_nand_read_cache(snand, plane_column, len, p), ret, cleanup);
 
 	if (retcount)
 		*retcount = rdcnt + 1;
@@ -1953,24 +2236,25 @@ static ufprog_status spi_nand_ops_read_page(struct nand_chip *nand, uint32_t pag
 	return spi_nand_chip_read_page(snand, page, column, len, buf, snand->state.ecc_enabled);
 }
 
-static ufprog_status spi_nand_chip_read_pages(struct spi_nand *snand, uint32_t page, uint32_t count, void *buf,
-					      bool enable_ecc, uint32_t flags, uint32_t *retcount)
+static ufprog_status spi_nand_chip_read_pages(struct spi_nand *snand, uint32_t page, uint32_t count,
+					      uint32_t column, uint32_t len, void *buf, bool enable_ecc, uint32_t flags,
+					      uint32_t *retcount)
 {
 	STATUS_CHECK_RET(spi_nand_select_die_page(snand, &page));
 
 	STATUS_CHECK_RET(spi_nand_ondie_ecc_control(snand, enable_ecc));
 
-	return spi_nand_die_read_pages(snand, page, count, buf, enable_ecc, flags, retcount);
+	return spi_nand_die_read_pages(snand, page, count, column, len, buf, enable_ecc, flags, retcount);
 }
 
-static ufprog_status spi_nand_ops_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, void *buf,
-					     uint32_t flags, uint32_t *retcount)
+static ufprog_status spi_nand_ops_read_pages(struct nand_chip *nand, uint32_t page, uint32_t count, uint32_t column,
+					     uint32_t len, void *buf, uint32_t flags, uint32_t *retcount)
 {
 	struct spi_nand *snand = container_of(nand, struct spi_nand, nand);
 	uint32_t start_die, end_die;
 
 	if (count == 1)
-		return spi_nand_chip_read_page(snand, page, 0, nand->maux.oob_page_size, buf, snand->state.ecc_enabled);
+		return spi_nand_chip_read_page(snand, page, column, len, buf, snand->state.ecc_enabled);
 
 	start_die = page >> (nand->maux.lun_shift - nand->maux.page_shift);
 	end_die = (page + count - 1) >> (nand->maux.lun_shift - nand->maux.page_shift);
@@ -1980,7 +2264,8 @@ static ufprog_status spi_nand_ops_read_pages(struct nand_chip *nand, uint32_t pa
 		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
 	}
 
-	return spi_nand_chip_read_pages(snand, page, count, buf, snand->state.ecc_enabled, flags, retcount);
+	return spi_nand_chip_read_pages(snand, page, count, column, len, buf, snand->state.ecc_enabled, flags,
+					retcount);
 }
 
 ufprog_status spi_nand_program_load_custom(struct spi_nand *snand, const struct spi_nand_io_opcode *pl_opcode,
@@ -2037,7 +2322,7 @@ static ufprog_status spi_nand_die_write_page(struct spi_nand *snand, uint32_t pa
 	STATUS_CHECK_GOTO_RET(spi_nand_program_load(snand, column, len, data), ret, errout);
 	STATUS_CHECK_GOTO_RET(spi_nand_op_program_execute(snand, page), ret, errout);
 
-	ret = spi_nand_wait_busy(snand, snand->param.max_pp_time_us, &sr);
+	ret = spi_nand_wait_busy_adaptive(snand, snand->param.max_pp_time_us, &snand->state.pp_poll, &sr);
 	if (ret) {
 		logm_err("Page program command timed out in page %u\n", page);
 		goto errout;
@@ -2087,7 +2372,7 @@ static ufprog_status spi_nand_die_erase_block(struct spi_nand *snand, uint32_t p
 	STATUS_CHECK_RET(spi_nand_write_enable(snand));
 	STATUS_CHECK_GOTO_RET(spi_nand_op_block_erase(snand, page), ret, errout);
 
-	ret = spi_nand_wait_busy(snand, snand->param.max_be_time_us, &sr);
+	ret = spi_nand_wait_busy_adaptive(snand, snand->param.max_be_time_us, &snand->state.erase_poll, &sr);
 	if (ret) {
 		logm_err("Block erase command timed out on block %u\n", block);
 		goto errout;
@@ -151,7 +151,7 @@ static ufprog_status corestage_check_ecc_4_bits(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -174,7 +174,7 @@ static ufprog_status corestage_check_ecc_8_bits(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & CS_SR_ECC_STATUS_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -133,7 +133,7 @@ static ufprog_status spi_nand_check_ecc_fs35xqa(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 	if (!sr)
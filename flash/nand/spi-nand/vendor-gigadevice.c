@@ -666,7 +666,7 @@ static ufprog_status spi_nand_check_ecc_gd_sr_3bits(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & GD_SR_ECC_SR_3_BITS_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -694,7 +694,7 @@ static ufprog_status spi_nand_check_ecc_gd_sr2_2bits_common(struct spi_nand *sna
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -189,7 +189,7 @@ static ufprog_status heyangtek_check_ecc(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -309,7 +309,7 @@ static ufprog_status hyf1gq4utacae_check_ecc(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -337,7 +337,7 @@ static ufprog_status hyf2gq4utacae_check_ecc(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & SPI_NAND_STATUS_ECC_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
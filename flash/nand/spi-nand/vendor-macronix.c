@@ -345,6 +345,9 @@ static ufprog_status spi_nand_check_ecc_macronix(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
+	if (spi_nand_ecc_sr_no_bitflips(snand))
+		return UFP_OK;
+
 	STATUS_CHECK_RET(ufprog_spi_mem_exec_op(snand->spi, &op));
 
 	eccst &= MACRONIX_ECC_SR_CURR_MASK;
@@ -390,7 +390,7 @@ ufprog_status spi_nand_check_ecc_micron_8bits(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & MICRON_SR_ECC_8_BITS_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
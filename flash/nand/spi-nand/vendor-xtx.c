@@ -149,7 +149,7 @@ static ufprog_status spi_nand_check_ecc_xtx(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & XTX_SR_ECC_STATUS_MASK) >> XTX_SR_ECC_STATUS_SHIFT;
 
@@ -177,7 +177,7 @@ static ufprog_status spi_nand_check_ecc_xt26g01c(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & XT26G01C_SR_ECC_STATUS_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
@@ -200,7 +200,7 @@ static ufprog_status spi_nand_check_ecc_xt26q01d(struct spi_nand *snand)
 
 	spi_nand_reset_ecc_status(snand);
 
-	STATUS_CHECK_RET(spi_nand_get_feature(snand, SPI_NAND_FEATURE_STATUS_ADDR, &sr));
+	STATUS_CHECK_RET(spi_nand_get_ecc_status_sr(snand, &sr));
 
 	sr = (sr & XT26G01C_SR_ECC_STATUS_MASK) >> SPI_NAND_STATUS_ECC_SHIFT;
 
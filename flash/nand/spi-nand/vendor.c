@@ -10,11 +10,38 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <ctype.h>
+#include <ufprog/bits.h>
 #include <ufprog/log.h>
 #include "vendor.h"
 
 #define SNAND_EXT_VENDOR_INCREMENT			10
 
+/* Number of leading ID bytes used as the hash key of the part ID index */
+#define SNAND_PART_INDEX_ID_KEY_LEN			2
+
+struct spi_nand_part_index_entry {
+	const struct spi_nand_vendor *vendor;
+	const struct spi_nand_flash_part *part;
+	const char *model;
+	uint32_t hash;
+	uint32_t seq;
+};
+
+struct spi_nand_part_index {
+	bool valid;
+
+	struct spi_nand_part_index_entry *id_slots;
+	uint32_t id_slot_mask;
+
+	/* Parts whose ID is shorter than the key bytes */
+	struct spi_nand_part_index_entry *id_wildcards;
+	uint32_t num_id_wildcards;
+
+	struct spi_nand_part_index_entry *name_slots;
+	uint32_t name_slot_mask;
+};
+
 static const struct spi_nand_vendor *vendors[] = {
 	&vendor_alliance_memory,
 	&vendor_ato,
@@ -43,6 +70,8 @@ static struct spi_nand_vendor *ext_vendors;
 static uint32_t ext_vendor_capacity;
 static uint32_t num_ext_vendors;
 
+static struct spi_nand_part_index part_index;
+
 ufprog_status spi_nand_vendors_init(void)
 {
 	uint32_t i;
@@ -96,7 +125,8 @@ const struct spi_nand_vendor *spi_nand_find_vendor_by_id(const char *id)
 	return spi_nand_find_builtin_vendor_by_id(id);
 }
 
-bool spi_nand_find_vendor_part(enum spi_nand_id_type type, const uint8_t *id, struct spi_nand_vendor_part *retvp)
+static bool spi_nand_find_vendor_part_linear(enum spi_nand_id_type type, const uint8_t *id,
+					     struct spi_nand_vendor_part *retvp)
 {
 	const struct spi_nand_flash_part *part;
 	uint32_t i;
@@ -125,7 +155,7 @@ bool spi_nand_find_vendor_part(enum spi_nand_id_type type, const uint8_t *id, st
 	return false;
 }
 
-bool spi_nand_find_vendor_part_by_name(const char *model, struct spi_nand_vendor_part *retvp)
+static bool spi_nand_find_vendor_part_by_name_linear(const char *model, struct spi_nand_vendor_part *retvp)
 {
 	const struct spi_nand_flash_part *part;
 	uint32_t i;
@@ -154,28 +184,286 @@ bool spi_nand_find_vendor_part_by_name(const char *model, struct spi_nand_vendor
 	return false;
 }
 
-const struct spi_nand_flash_part *spi_nand_vendor_find_part_by_name(const char *model,
-								    const struct spi_nand_vendor *vendor)
+static uint32_t spi_nand_part_index_hash(const void *data, size_t len, bool nocase)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 0x811c9dc5;
+	size_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < len; i++) {
+		hash ^= nocase ? (uint8_t)tolower(p[i]) : p[i];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+static uint32_t spi_nand_part_index_id_hash(enum spi_nand_id_type type, const uint8_t *id)
+{
+	uint8_t key[1 + SNAND_PART_INDEX_ID_KEY_LEN];
+
+	key[0] = (uint8_t)type;
+	memcpy(key + 1, id, SNAND_PART_INDEX_ID_KEY_LEN);
+
+	return spi_nand_part_index_hash(key, sizeof(key), false);
+}
+
+static uint32_t spi_nand_part_index_slots(uint32_t n)
+{
+	/* Keep load factor at or below 50% */
+	if (n < 8)
+		n = 8;
+
+	return 1U << fls(n * 2 - 1);
+}
+
+static void spi_nand_part_index_insert(struct spi_nand_part_index_entry *slots, uint32_t mask,
+				       const struct spi_nand_part_index_entry *entry)
+{
+	uint32_t i = entry->hash & mask;
+
+	while (slots[i].part)
+		i = (i + 1) & mask;
+
+	memcpy(&slots[i], entry, sizeof(*entry));
+}
+
+static void spi_nand_part_index_free(void)
+{
+	if (part_index.id_slots)
+		free(part_index.id_slots);
+
+	if (part_index.id_wildcards)
+		free(part_index.id_wildcards);
+
+	if (part_index.name_slots)
+		free(part_index.name_slots);
+
+	memset(&part_index, 0, sizeof(part_index));
+}
+
+void spi_nand_invalidate_part_index(void)
+{
+	spi_nand_part_index_free();
+}
+
+static void spi_nand_part_index_count_vendor(const struct spi_nand_vendor *vendor, uint32_t *retnids,
+					     uint32_t *retnwildcards, uint32_t *retnnames)
 {
 	const struct spi_nand_flash_part *part;
 	uint32_t i;
 
-	if (vendor)
-		return spi_nand_find_part_by_name(vendor->parts, vendor->nparts, model);
+	for (i = 0; i < vendor->nparts; i++) {
+		part = &vendor->parts[i];
 
-	for (i = 0; i < ARRAY_SIZE(vendors); i++) {
-		part = spi_nand_find_part_by_name(vendors[i]->parts, vendors[i]->nparts, model);
-		if (part)
-			return part;
+		if (part->id.val.len) {
+			if (part->id.val.len >= SNAND_PART_INDEX_ID_KEY_LEN)
+				(*retnids)++;
+			else
+				(*retnwildcards)++;
+		}
+
+		(*retnnames)++;
+
+		if (part->alias)
+			*retnnames += part->alias->num;
 	}
+}
 
-	for (i = 0; i < num_ext_vendors; i++) {
-		part = spi_nand_find_part_by_name(ext_vendors[i].parts, ext_vendors[i].nparts, model);
-		if (part)
-			return part;
+static void spi_nand_part_index_add_vendor(const struct spi_nand_vendor *vendor, uint32_t *id_seq,
+					   uint32_t *name_seq)
+{
+	struct spi_nand_part_index_entry entry;
+	const struct spi_nand_flash_part *part;
+	uint32_t i, j;
+
+	for (i = 0; i < vendor->nparts; i++) {
+		part = &vendor->parts[i];
+
+		memset(&entry, 0, sizeof(entry));
+		entry.vendor = vendor;
+		entry.part = part;
+		entry.seq = (*id_seq)++;
+
+		if (part->id.val.len) {
+			if (part->id.val.len >= SNAND_PART_INDEX_ID_KEY_LEN) {
+				entry.hash = spi_nand_part_index_id_hash(part->id.type, part->id.val.id);
+				spi_nand_part_index_insert(part_index.id_slots, part_index.id_slot_mask, &entry);
+			} else {
+				memcpy(&part_index.id_wildcards[part_index.num_id_wildcards++], &entry, sizeof(entry));
+			}
+		}
+
+		entry.model = part->model;
+		entry.seq = (*name_seq)++;
+		entry.hash = spi_nand_part_index_hash(part->model, strlen(part->model), true);
+		spi_nand_part_index_insert(part_index.name_slots, part_index.name_slot_mask, &entry);
+
+		if (!part->alias)
+			continue;
+
+		for (j = 0; j < part->alias->num; j++) {
+			entry.model = part->alias->items[j].model;
+			entry.seq = (*name_seq)++;
+			entry.hash = spi_nand_part_index_hash(entry.model, strlen(entry.model), true);
+			spi_nand_part_index_insert(part_index.name_slots, part_index.name_slot_mask, &entry);
+		}
 	}
+}
 
-	return NULL;
+static bool spi_nand_part_index_build(void)
+{
+	uint32_t i, nids = 0, nwildcards = 0, nnames = 0, id_seq = 0, name_seq = 0;
+
+	if (part_index.valid)
+		return true;
+
+	spi_nand_part_index_free();
+
+	for (i = 0; i < ARRAY_SIZE(vendors); i++)
+		spi_nand_part_index_count_vendor(vendors[i], &nids, &nwildcards, &nnames);
+
+	for (i = 0; i < num_ext_vendors; i++)
+		spi_nand_part_index_count_vendor(&ext_vendors[i], &nids, &nwildcards, &nnames);
+
+	part_index.id_slot_mask = spi_nand_part_index_slots(nids) - 1;
+	part_index.name_slot_mask = spi_nand_part_index_slots(nnames) - 1;
+
+	part_index.id_slots = calloc(part_index.id_slot_mask + 1, sizeof(*part_index.id_slots));
+	part_index.name_slots = calloc(part_index.name_slot_mask + 1, sizeof(*part_index.name_slots));
+	part_index.id_wildcards = calloc(nwildcards + 1, sizeof(*part_index.id_wildcards));
+
+	if (!part_index.id_slots || !part_index.name_slots || !part_index.id_wildcards) {
+		logm_warn("No memory for flash part index. Falling back to linear search\n");
+		spi_nand_part_index_free();
+		return false;
+	}
+
+	/* Sequence numbers preserve the search order of the linear lookup */
+	for (i = 0; i < ARRAY_SIZE(vendors); i++)
+		spi_nand_part_index_add_vendor(vendors[i], &id_seq, &name_seq);
+
+	for (i = 0; i < num_ext_vendors; i++)
+		spi_nand_part_index_add_vendor(&ext_vendors[i], &id_seq, &name_seq);
+
+	part_index.valid = true;
+
+	return true;
+}
+
+static bool spi_nand_part_index_id_match(const struct spi_nand_flash_part *part, enum spi_nand_id_type type,
+					 const uint8_t *id)
+{
+	return part->id.type == type && !memcmp(part->id.val.id, id, part->id.val.len);
+}
+
+static const struct spi_nand_part_index_entry *spi_nand_part_index_find_id(enum spi_nand_id_type type,
+									   const uint8_t *id)
+{
+	const struct spi_nand_part_index_entry *entry, *best = NULL;
+	uint32_t i, hash;
+
+	hash = spi_nand_part_index_id_hash(type, id);
+
+	for (i = hash & part_index.id_slot_mask; part_index.id_slots[i].part; i = (i + 1) & part_index.id_slot_mask) {
+		entry = &part_index.id_slots[i];
+
+		if (entry->hash != hash || (best && entry->seq > best->seq))
+			continue;
+
+		if (spi_nand_part_index_id_match(entry->part, type, id))
+			best = entry;
+	}
+
+	for (i = 0; i < part_index.num_id_wildcards; i++) {
+		entry = &part_index.id_wildcards[i];
+
+		if (best && entry->seq > best->seq)
+			break;
+
+		if (spi_nand_part_index_id_match(entry->part, type, id)) {
+			best = entry;
+			break;
+		}
+	}
+
+	return best;
+}
+
+static const struct spi_nand_part_index_entry *spi_nand_part_index_find_name(const char *model)
+{
+	const struct spi_nand_part_index_entry *entry, *best = NULL;
+	uint32_t i, hash;
+
+	hash = spi_nand_part_index_hash(model, strlen(model), true);
+
+	for (i = hash & part_index.name_slot_mask; part_index.name_slots[i].part;
+	     i = (i + 1) & part_index.name_slot_mask) {
+		entry = &part_index.name_slots[i];
+
+		if (entry->hash != hash || (best && entry->seq > best->seq))
+			continue;
+
+		if (!strcasecmp(entry->model, model))
+			best = entry;
+	}
+
+	return best;
+}
+
+bool spi_nand_find_vendor_part(enum spi_nand_id_type type, const uint8_t *id, struct spi_nand_vendor_part *retvp)
+{
+	const struct spi_nand_part_index_entry *entry;
+
+	if (!spi_nand_part_index_build())
+		return spi_nand_find_vendor_part_linear(type, id, retvp);
+
+	retvp->vendor = NULL;
+	retvp->part = NULL;
+
+	entry = spi_nand_part_index_find_id(type, id);
+	if (!entry)
+		return false;
+
+	retvp->vendor = entry->vendor;
+	retvp->part = entry->part;
+
+	return true;
+}
+
+bool spi_nand_find_vendor_part_by_name(const char *model, struct spi_nand_vendor_part *retvp)
+{
+	const struct spi_nand_part_index_entry *entry;
+
+	if (!spi_nand_part_index_build())
+		return spi_nand_find_vendor_part_by_name_linear(model, retvp);
+
+	retvp->vendor = NULL;
+	retvp->part = NULL;
+
+	entry = spi_nand_part_index_find_name(model);
+	if (!entry)
+		return false;
+
+	retvp->vendor = entry->vendor;
+	retvp->part = entry->part;
+
+	return true;
+}
+
+const struct spi_nand_flash_part *spi_nand_vendor_find_part_by_name(const char *model,
+								    const struct spi_nand_vendor *vendor)
+{
+	struct spi_nand_vendor_part vp;
+
+	if (vendor)
+		return spi_nand_find_part_by_name(vendor->parts, vendor->nparts, model);
+
+	if (!spi_nand_find_vendor_part_by_name(model, &vp))
+		return NULL;
+
+	return vp.part;
 }
 
 static int spi_nand_part_item_cmp(void const *a, void const *b)
@@ -290,6 +578,8 @@ bool spi_nand_set_ext_vendor_capacity(uint32_t n)
 	ext_vendors = newptr;
 	ext_vendor_capacity = n;
 
+	spi_nand_invalidate_part_index();
+
 	return true;
 }
 
@@ -308,6 +598,8 @@ struct spi_nand_vendor *spi_nand_alloc_ext_vendor(void)
 
 		memset(vendor, 0, sizeof(struct spi_nand_vendor));
 
+		spi_nand_invalidate_part_index();
+
 		return vendor;
 	}
 
@@ -339,6 +631,8 @@ void spi_nand_reset_ext_vendors(spi_nand_reset_ext_vendor_cb cb)
 	}
 
 	num_ext_vendors = 0;
+
+	spi_nand_invalidate_part_index();
 }
 
 static int spi_nand_vendor_item_cmp(void const *a, void const *b)
@@ -99,6 +99,8 @@ bool spi_nand_set_ext_vendor_capacity(uint32_t n);
 struct spi_nand_vendor *spi_nand_alloc_ext_vendor(void);
 bool spi_nand_is_ext_vendor(const struct spi_nand_vendor *vendor);
 
+void spi_nand_invalidate_part_index(void);
+
 typedef void (*spi_nand_reset_ext_vendor_cb)(struct spi_nand_vendor *vendor);
 void spi_nand_reset_ext_vendors(spi_nand_reset_ext_vendor_cb cb);
 
@@ -22,6 +22,10 @@
 #define SNOR_SPEED_LOW				10000000
 #define SNOR_SPEED_HIGH				60000000
 
+#define SNOR_CALIBRATE_MAX_STEPS		32
+#define SNOR_CALIBRATE_DFL_LEN			0x10000
+#define SNOR_CALIBRATE_DFL_ROUNDS		4
+
 #define SNOR_PP_TIMEOUT_MS			1000
 #define SNOR_ERASE_TIMEOUT_MS			2500
 #define SNOR_RESET_WAIT_MS			25
@@ -139,6 +143,10 @@ struct spi_nor_state {
 
 	uint32_t max_nvcr_pp_time_ms;
 
+	uint32_t poll_rtt_us;
+	struct busy_poll_stat pp_poll;
+	struct busy_poll_stat erase_poll[SPI_NOR_MAX_ERASE_INFO];
+
 	bool qe_set;
 	bool a4b_mode;
 
@@ -1687,6 +1687,8 @@ ufprog_status spi_nor_load_ext_id_list(void)
 	STATUS_CHECK_GOTO_RET(spi_nor_load_ext_erase_groups(jroot), ret, cleanup);
 	STATUS_CHECK_GOTO_RET(spi_nor_load_ext_vendors(jroot), ret, cleanup);
 
+	spi_nor_invalidate_part_index();
+
 	logm_notice("Successfully loaded external flash table\n");
 
 	ret = UFP_OK;
@@ -13,6 +13,8 @@
 #include <ufprog/device.h>
 #include <ufprog/api_spi.h>
 #include <ufprog/spi.h>
+#include <ufprog/busy_poll.h>
+#include <ufprog/job.h>
 
 EXTERN_C_BEGIN
 
@@ -127,6 +129,12 @@ struct spi_nor_info {
 	const struct snor_reg_info *regs;
 };
 
+struct spi_nor_busy_poll_info {
+	uint32_t rtt_us;
+	struct busy_poll_info pp;
+	struct busy_poll_info erase[SPI_NOR_MAX_ERASE_INFO];
+};
+
 struct spi_nor_vendor_item {
 	const char *id;
 	const char *name;
@@ -161,6 +169,9 @@ uint32_t UFPROG_API ufprog_spi_nor_get_speed_limit(struct spi_nor *snor);
 void UFPROG_API ufprog_spi_nor_set_speed_limit(struct spi_nor *snor, uint32_t hz);
 uint32_t UFPROG_API ufprog_spi_nor_get_speed_low(struct spi_nor *snor);
 uint32_t UFPROG_API ufprog_spi_nor_get_speed_high(struct spi_nor *snor);
+ufprog_status UFPROG_API ufprog_spi_nor_set_speed_high(struct spi_nor *snor, uint32_t hz);
+ufprog_status UFPROG_API ufprog_spi_nor_calibrate_speed(struct spi_nor *snor, uint64_t addr, size_t len,
+							uint32_t rounds, uint32_t *rethz);
 
 ufprog_status UFPROG_API ufprog_spi_nor_list_vendors(struct spi_nor_vendor_item **outlist, uint32_t *retcount);
 
@@ -178,6 +189,7 @@ ufprog_status UFPROG_API ufprog_spi_nor_probe_init(struct spi_nor *snor);
 ufprog_bool UFPROG_API ufprog_spi_nor_valid(struct spi_nor *snor);
 uint32_t UFPROG_API ufprog_spi_nor_flash_param_signature(struct spi_nor *snor);
 ufprog_status UFPROG_API ufprog_spi_nor_info(struct spi_nor *snor, struct spi_nor_info *info);
+ufprog_status UFPROG_API ufprog_spi_nor_get_busy_poll_info(struct spi_nor *snor, struct spi_nor_busy_poll_info *info);
 
 ufprog_status UFPROG_API ufprog_spi_nor_select_die(struct spi_nor *snor, uint32_t index);
 
@@ -199,6 +211,20 @@ ufprog_status UFPROG_API ufprog_spi_nor_erase_at(struct spi_nor *snor, uint64_t
 						 uint32_t *ret_eraseszie);
 ufprog_status UFPROG_API ufprog_spi_nor_erase(struct spi_nor *snor, uint64_t addr, uint64_t len);
 
+typedef void (UFPROG_API *ufprog_spi_nor_progress_cb)(void *priv, uint64_t size_done);
+
+ufprog_status UFPROG_API ufprog_spi_nor_erase_dies(struct spi_nor *snor, uint32_t die_start, uint32_t die_count,
+						   uint64_t addr, uint64_t len, ufprog_spi_nor_progress_cb cb,
+						   void *priv);
+ufprog_status UFPROG_API ufprog_spi_nor_write_dies(struct spi_nor *snor, uint32_t die_start, uint32_t die_count,
+						   uint64_t addr, uint64_t len, const void *data,
+						   ufprog_spi_nor_progress_cb cb, void *priv);
+
+/* buf is the source for write, the destination for read, and the expected data for verify. Unused for erase. */
+ufprog_status UFPROG_API ufprog_spi_nor_submit_job(struct ufprog_job_queue *q, struct spi_nor *snor,
+						   enum ufprog_job_op op, uint64_t addr, uint64_t len, void *buf,
+						   const struct ufprog_job_callbacks *cbs, struct ufprog_job **outjob);
+
 ufprog_status UFPROG_API ufprog_spi_nor_read_uid(struct spi_nor *snor, void *data, uint32_t *retlen);
 
 uint32_t UFPROG_API ufprog_spi_nor_get_reg_bytes(const struct spi_nor_reg_access *access);
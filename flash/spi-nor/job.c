@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SPI-NOR flash asynchronous jobs
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <ufprog/log.h>
+#include "core.h"
+
+/* Granularity of cancellation checking and progress reporting */
+#define SPI_NOR_JOB_CHUNK_SIZE			0x10000
+
+struct spi_nor_job {
+	struct spi_nor *snor;
+	enum ufprog_job_op op;
+	uint64_t addr;
+	uint64_t len;
+	void *buf;
+	uint8_t *vbuf;
+};
+
+static ufprog_status spi_nor_job_erase(struct ufprog_job *job, struct spi_nor_job *j)
+{
+	uint64_t start, end, pos;
+	ufprog_status ret;
+	uint32_t size;
+
+	ret = ufprog_spi_nor_get_erase_range(j->snor, j->addr, j->len, &start, &end);
+	if (ret) {
+		logm_err("Failed to calculate erase region\n");
+		return ret;
+	}
+
+	for (pos = start; pos < end; pos += size) {
+		if (ufprog_job_cancelled(job))
+			return UFP_CANCELLED;
+
+		ret = ufprog_spi_nor_erase_at(j->snor, pos, end - pos, &size);
+		if (ret)
+			return ret;
+
+		if (!size)
+			return UFP_FLASH_ERASE_FAILED;
+
+		ufprog_job_report_progress(job, pos + size - start, end - start);
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status UFPROG_API spi_nor_job_run(struct ufprog_job *job, void *priv)
+{
+	struct spi_nor_job *j = priv;
+	uint8_t *p = j->buf;
+	ufprog_status ret;
+	uint64_t done;
+	size_t chunk;
+
+	if (j->op == UFPROG_JOB_ERASE)
+		return spi_nor_job_erase(job, j);
+
+	for (done = 0; done < j->len; done += chunk) {
+		if (ufprog_job_cancelled(job))
+			return UFP_CANCELLED;
+
+		chunk = SPI_NOR_JOB_CHUNK_SIZE;
+		if (chunk > j->len - done)
+			chunk = (size_t)(j->len - done);
+
+		switch (j->op) {
+		case UFPROG_JOB_READ:
+			ret = ufprog_spi_nor_read(j->snor, j->addr + done, chunk, p + done);
+			break;
+
+		case UFPROG_JOB_WRITE:
+			ret = ufprog_spi_nor_write(j->snor, j->addr + done, chunk, p + done);
+			break;
+
+		default:
+			ret = ufprog_spi_nor_read(j->snor, j->addr + done, chunk, j->vbuf);
+			if (!ret && memcmp(j->vbuf, p + done, chunk)) {
+				logm_err("Data verification failed in range 0x%" PRIx64 " - 0x%" PRIx64 "\n",
+					 j->addr + done, j->addr + done + chunk - 1);
+				ret = UFP_DATA_VERIFICATION_FAIL;
+			}
+		}
+
+		if (ret)
+			return ret;
+
+		ufprog_job_report_progress(job, done + chunk, j->len);
+	}
+
+	return UFP_OK;
+}
+
+static void UFPROG_API spi_nor_job_free(void *priv)
+{
+	free(priv);
+}
+
+ufprog_status UFPROG_API ufprog_spi_nor_submit_job(struct ufprog_job_queue *q, struct spi_nor *snor,
+						   enum ufprog_job_op op, uint64_t addr, uint64_t len, void *buf,
+						   const struct ufprog_job_callbacks *cbs, struct ufprog_job **outjob)
+{
+	struct spi_nor_job *j;
+	ufprog_status ret;
+
+	if (!q || !snor || op >= __MAX_UFPROG_JOB_OP || !len || (op != UFPROG_JOB_ERASE && !buf))
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (addr >= snor->param.size || addr + len > snor->param.size)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	j = calloc(1, sizeof(*j) + (op == UFPROG_JOB_VERIFY ? SPI_NOR_JOB_CHUNK_SIZE : 0));
+	if (!j) {
+		logm_err("No memory for job\n");
+		return UFP_NOMEM;
+	}
+
+	j->snor = snor;
+	j->op = op;
+	j->addr = addr;
+	j->len = len;
+	j->buf = buf;
+
+	if (op == UFPROG_JOB_VERIFY)
+		j->vbuf = (uint8_t *)j + sizeof(*j);
+
+	ret = ufprog_job_submit(q, spi_nor_job_run, spi_nor_job_free, j, cbs, outjob);
+	if (ret)
+		free(j);
+
+	return ret;
+}
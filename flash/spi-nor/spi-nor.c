@@ -191,6 +191,40 @@ ufprog_status spi_nor_set_high_speed(struct spi_nor *snor)
 	return spi_nor_set_speed(snor, snor->state.speed_high);
 }
 
+static ufprog_status spi_nor_apply_speed_high(struct spi_nor *snor, uint32_t hz)
+{
+	snor->state.speed_high = hz;
+
+	/* Set and read back the real highest speed */
+	STATUS_CHECK_RET(spi_nor_set_high_speed(snor));
+	snor->state.speed_high = ufprog_spi_get_speed(snor->spi);
+
+	if (!snor->state.speed_high)
+		snor->state.speed_high = hz;
+
+	return spi_nor_set_low_speed(snor);
+}
+
+ufprog_status UFPROG_API ufprog_spi_nor_set_speed_high(struct spi_nor *snor, uint32_t hz)
+{
+	if (!snor || !hz)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (hz > snor->state.max_speed)
+		hz = snor->state.max_speed;
+
+	if (hz > snor->max_speed)
+		hz = snor->max_speed;
+
+	if (hz < snor->state.speed_low)
+		hz = snor->state.speed_low;
+
+	return spi_nor_apply_speed_high(snor, hz);
+}
+
 ufprog_status spi_nor_read_reg(struct spi_nor *snor, uint8_t regopcode, uint8_t *retval)
 {
 	struct ufprog_spi_mem_op op = SNOR_READ_NO_ADDR_DUMMY_OP(regopcode, snor->state.cmd_buswidth_curr, 1, retval);
@@ -2522,6 +2556,26 @@ ufprog_status UFPROG_API ufprog_spi_nor_info(struct spi_nor *snor, struct spi_no
 	return UFP_OK;
 }
 
+ufprog_status UFPROG_API ufprog_spi_nor_get_busy_poll_info(struct spi_nor *snor, struct spi_nor_busy_poll_info *info)
+{
+	uint32_t i;
+
+	if (!snor || !info)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	info->rtt_us = snor->state.poll_rtt_us;
+
+	busy_poll_stat_info(&snor->state.pp_poll, info->rtt_us, &info->pp);
+
+	for (i = 0; i < SPI_NOR_MAX_ERASE_INFO; i++)
+		busy_poll_stat_info(&snor->state.erase_poll[i], info->rtt_us, &info->erase[i]);
+
+	return UFP_OK;
+}
+
 ufprog_status UFPROG_API ufprog_spi_nor_select_die(struct spi_nor *snor, uint32_t index)
 {
 	ufprog_status ret;
@@ -2598,16 +2652,72 @@ ufprog_status UFPROG_API ufprog_spi_nor_set_bus_width(struct spi_nor *snor, uint
 	return spi_nor_set_bus_width(snor, buswidth);
 }
 
-ufprog_status spi_nor_wait_busy(struct spi_nor *snor, uint32_t wait_ms)
+/* Let the controller poll SR natively if it can be read by a single plain operation */
+static ufprog_status spi_nor_poll_sr_idle(struct spi_nor *snor, uint32_t wait_ms, const struct busy_poll_info *pi)
 {
-	uint64_t tmo = os_get_timer_us() + wait_ms * 1000;
+	const struct spi_nor_reg_access *access = snor->state.reg.sr_r;
+	const struct spi_nor_reg_desc *desc = &access->desc[0];
 	uint8_t sr;
+	struct ufprog_spi_mem_op op = SPI_MEM_OP(
+		SPI_MEM_OP_CMD(desc->read_opcode, snor->state.cmd_buswidth_curr),
+		SPI_MEM_OP_ADDR(desc->naddr, desc->addr, snor->state.cmd_buswidth_curr),
+		SPI_MEM_OP_DUMMY(desc->ndummy_read, snor->state.cmd_buswidth_curr),
+		SPI_MEM_OP_DATA_IN(1, &sr, snor->state.cmd_buswidth_curr)
+	);
+
+	if (!ufprog_spi_supports_mem_poll_status(snor->spi))
+		return UFP_UNSUPPORTED;
+
+	if (access->num != 1 || access->pre_acc || access->post_acc || desc->ndata != 1 ||
+	    (desc->flags & SNOR_REGACC_F_DATA_ACC_TIMING))
+		return UFP_UNSUPPORTED;
+
+	if (desc->flags & SNOR_REGACC_F_ADDR_4B_MODE)
+		op.addr.len = snor->state.a4b_mode ? 4 : 3;
+
+	return ufprog_spi_mem_poll_status(snor->spi, &op, SR_BUSY, 0, pi->initial_delay_us, pi->interval_us, wait_ms);
+}
+
+static ufprog_status spi_nor_wait_busy_adaptive(struct spi_nor *snor, uint32_t wait_ms, struct busy_poll_stat *stat)
+{
+	uint64_t tst = os_get_timer_us(), tmo = tst + wait_ms * 1000, t;
+	struct busy_poll_info pi;
+	ufprog_status ret;
+	uint8_t sr;
+
+	busy_poll_stat_info(stat, snor->state.poll_rtt_us, &pi);
+
+	ret = spi_nor_poll_sr_idle(snor, wait_ms, &pi);
+	if (!ret) {
+		busy_poll_stat_add(stat, os_get_timer_us() - tst);
+		return UFP_OK;
+	}
+
+	if (ret == UFP_TIMEOUT)
+		goto timeout;
+
+	if (ret != UFP_UNSUPPORTED)
+		return ret;
+
+	/* Status register needs special access. Poll it here. */
+	tst = os_get_timer_us();
+	tmo = tst + wait_ms * 1000;
+
+	if (pi.initial_delay_us)
+		os_usleep(pi.initial_delay_us);
 
 	do {
+		t = os_get_timer_us();
 		STATUS_CHECK_RET(spi_nor_read_sr(snor, &sr));
+		busy_poll_rtt_update(&snor->state.poll_rtt_us, os_get_timer_us() - t);
 
-		if (!(sr & SR_BUSY))
+		if (!(sr & SR_BUSY)) {
+			busy_poll_stat_add(stat, t - tst);
 			break;
+		}
+
+		if (pi.interval_us)
+			os_usleep(pi.interval_us);
 	} while (os_get_timer_us() <= tmo);
 
 	/* Last check */
@@ -2617,11 +2727,17 @@ ufprog_status spi_nor_wait_busy(struct spi_nor *snor, uint32_t wait_ms)
 	if (!(sr & SR_BUSY))
 		return UFP_OK;
 
+timeout:
 	logm_err("Timed out waiting for flash idle\n");
 
 	return UFP_TIMEOUT;
 }
 
+ufprog_status spi_nor_wait_busy(struct spi_nor *snor, uint32_t wait_ms)
+{
+	return spi_nor_wait_busy_adaptive(snor, wait_ms, NULL);
+}
+
 ufprog_status UFPROG_API ufprog_spi_nor_read_no_check(struct spi_nor *snor, uint64_t addr, size_t len, void *data)
 {
 	ufprog_status ret = UFP_OK;
@@ -2690,8 +2806,126 @@ out:
 	return ret;
 }
 
-static ufprog_status spi_nor_page_program(struct spi_nor *snor, uint64_t addr, size_t len, const void *data,
-					  size_t *retlen)
+static ufprog_status spi_nor_calibrate_check(struct spi_nor *snor, uint64_t addr, size_t len, void *buf,
+					     uint32_t rounds, uint32_t ref_crc)
+{
+	uint32_t i;
+
+	for (i = 0; i < rounds; i++) {
+		STATUS_CHECK_RET(ufprog_spi_nor_read(snor, addr, len, buf));
+
+		if (crc32(0, buf, len) != ref_crc)
+			return UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	return UFP_OK;
+}
+
+ufprog_status UFPROG_API ufprog_spi_nor_calibrate_speed(struct spi_nor *snor, uint64_t addr, size_t len,
+							uint32_t rounds, uint32_t *rethz)
+{
+	uint32_t speeds[SNOR_CALIBRATE_MAX_STEPS], nspeeds, speed_high, speed_max, ref_crc, i, sel;
+	ufprog_status ret;
+	void *buf;
+
+	if (!snor || !rethz)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (!len) {
+		len = SNOR_CALIBRATE_DFL_LEN;
+		if (addr < snor->param.size && len > snor->param.size - addr)
+			len = snor->param.size - addr;
+	}
+
+	if (addr >= snor->param.size || addr + len > snor->param.size)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	if (!rounds)
+		rounds = SNOR_CALIBRATE_DFL_ROUNDS;
+
+	/*
+	 * Only speeds allowed by both the part and the configured limit are candidates. The current high speed may
+	 * already have been lowered by a previous calibration, so it can't be used as the upper bound.
+	 */
+	speed_high = snor->state.speed_high;
+
+	speed_max = snor->state.max_speed;
+	if (speed_max > snor->max_speed)
+		speed_max = snor->max_speed;
+
+	nspeeds = ufprog_spi_get_speed_steps(snor->spi, speed_max, speeds, ARRAY_SIZE(speeds));
+	if (!nspeeds) {
+		logm_err("Controller does not support changing SPI clock\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	buf = malloc(len);
+	if (!buf) {
+		logm_err("No memory for calibration buffer\n");
+		return UFP_NOMEM;
+	}
+
+	/* Reference data is read at the lowest speed */
+	snor->state.speed_high = snor->state.speed_low;
+
+	ret = ufprog_spi_nor_read(snor, addr, len, buf);
+	if (ret) {
+		logm_err("Failed to read reference data\n");
+		goto out;
+	}
+
+	ref_crc = crc32(0, buf, len);
+
+	ret = spi_nor_calibrate_check(snor, addr, len, buf, 1, ref_crc);
+	if (ret) {
+		logm_err("Reference data is not stable even at the lowest speed\n");
+		goto out;
+	}
+
+	for (i = 0; i < nspeeds; i++) {
+		snor->state.speed_high = speeds[i];
+
+		ret = spi_nor_calibrate_check(snor, addr, len, buf, rounds, ref_crc);
+		logm_dbg("Calibrating %uHz: %s\n", speeds[i], ret ? "failed" : "passed");
+
+		if (!ret)
+			break;
+	}
+
+	if (i >= nspeeds) {
+		logm_err("No SPI clock passed the calibration\n");
+		ret = UFP_DATA_VERIFICATION_FAIL;
+		goto out;
+	}
+
+	/* Keep one step of margin if a faster clock has failed */
+	sel = i;
+	if (i && i + 1 < nspeeds)
+		sel = i + 1;
+
+	*rethz = speeds[sel];
+
+	ret = UFP_OK;
+
+out:
+	free(buf);
+
+	if (ret)
+		spi_nor_apply_speed_high(snor, speed_high);
+	else
+		ret = spi_nor_apply_speed_high(snor, *rethz);
+
+	if (!ret)
+		*rethz = snor->state.speed_high;
+
+	return ret;
+}
+
+static ufprog_status spi_nor_page_program_issue(struct spi_nor *snor, uint64_t addr, size_t len, const void *data,
+						size_t *retlen)
 {
 	size_t proglen;
 
@@ -2706,29 +2940,43 @@ static ufprog_status spi_nor_page_program(struct spi_nor *snor, uint64_t addr, s
 	if (proglen > len)
 		proglen = len;
 
-	len = proglen;
 	op.data.len = proglen;
 
-	while (proglen) {
-		STATUS_CHECK_RET(spi_nor_setup_addr(snor, &op.addr.val));
+	STATUS_CHECK_RET(spi_nor_setup_addr(snor, &op.addr.val));
 
-		STATUS_CHECK_RET(spi_nor_data_write_enable(snor));
+	STATUS_CHECK_RET(spi_nor_data_write_enable(snor));
 
-		STATUS_CHECK_RET(ufprog_spi_mem_adjust_op_size(snor->spi, &op));
+	STATUS_CHECK_RET(ufprog_spi_mem_adjust_op_size(snor->spi, &op));
 
-		STATUS_CHECK_RET(spi_nor_set_high_speed(snor));
-		STATUS_CHECK_RET(ufprog_spi_mem_exec_op(snor->spi, &op));
-		STATUS_CHECK_RET(spi_nor_set_low_speed(snor));
+	STATUS_CHECK_RET(spi_nor_set_high_speed(snor));
+	STATUS_CHECK_RET(ufprog_spi_mem_exec_op(snor->spi, &op));
+	STATUS_CHECK_RET(spi_nor_set_low_speed(snor));
 
-		STATUS_CHECK_RET(spi_nor_wait_busy(snor, snor->param.max_pp_time_ms));
+	*retlen = op.data.len;
 
-		op.data.buf.tx = (const void *)((uintptr_t)op.data.buf.tx + op.data.len);
+	return UFP_OK;
+}
 
-		addr += op.data.len;
-		op.addr.val = addr;
+static ufprog_status spi_nor_page_program(struct spi_nor *snor, uint64_t addr, size_t len, const void *data,
+					  size_t *retlen)
+{
+	const uint8_t *p = data;
+	size_t proglen, chklen;
+
+	proglen = snor->param.page_size - (addr & (snor->param.page_size - 1));
+	if (proglen > len)
+		proglen = len;
+
+	len = proglen;
 
-		proglen -= op.data.len;
-		op.data.len = proglen;
+	while (proglen) {
+		STATUS_CHECK_RET(spi_nor_page_program_issue(snor, addr, proglen, p, &chklen));
+
+		STATUS_CHECK_RET(spi_nor_wait_busy_adaptive(snor, snor->param.max_pp_time_ms, &snor->state.pp_poll));
+
+		p += chklen;
+		addr += chklen;
+		proglen -= chklen;
 	}
 
 	if (retlen)
@@ -2897,7 +3145,8 @@ out:
 	return UFP_OK;
 }
 
-static ufprog_status spi_nor_erase_block(struct spi_nor *snor, uint64_t addr, const struct spi_nor_erase_sector_info *ei)
+static ufprog_status spi_nor_erase_block_issue(struct spi_nor *snor, uint64_t addr,
+					       const struct spi_nor_erase_sector_info *ei)
 {
 	struct ufprog_spi_mem_op op = SPI_MEM_OP(
 		SPI_MEM_OP_CMD(ei->opcode, snor->state.cmd_buswidth_curr),
@@ -2910,7 +3159,21 @@ static ufprog_status spi_nor_erase_block(struct spi_nor *snor, uint64_t addr, co
 	STATUS_CHECK_RET(spi_nor_setup_addr(snor, &op.addr.val));
 	STATUS_CHECK_RET(spi_nor_data_write_enable(snor));
 	STATUS_CHECK_RET(ufprog_spi_mem_exec_op(snor->spi, &op));
-	STATUS_CHECK_RET(spi_nor_wait_busy(snor, ei->max_erase_time_ms));
+
+	return UFP_OK;
+}
+
+static ufprog_status spi_nor_erase_block(struct spi_nor *snor, uint64_t addr, const struct spi_nor_erase_sector_info *ei)
+{
+	struct busy_poll_stat *stat = NULL;
+	uint32_t idx;
+
+	idx = (uint32_t)(ei - snor->param.erase_info.info);
+	if (idx < SPI_NOR_MAX_ERASE_INFO)
+		stat = &snor->state.erase_poll[idx];
+
+	STATUS_CHECK_RET(spi_nor_erase_block_issue(snor, addr, ei));
+	STATUS_CHECK_RET(spi_nor_wait_busy_adaptive(snor, ei->max_erase_time_ms, stat));
 
 	return UFP_OK;
 }
@@ -2996,17 +3259,18 @@ ufprog_status UFPROG_API ufprog_spi_nor_get_erase_range(struct spi_nor *snor, ui
 	return UFP_OK;
 }
 
-static ufprog_status spi_nor_erase_at(struct spi_nor *snor, uint64_t addr, uint64_t maxlen, uint32_t *ret_eraseszie)
+static const struct spi_nor_erase_sector_info *spi_nor_get_erase_sector_at(struct spi_nor *snor, uint64_t addr,
+									    uint64_t maxlen, uint64_t *ret_start,
+									    uint32_t *ret_len)
 {
 	const struct spi_nor_erase_sector_info *ei = NULL;
 	uint64_t erase_start, erase_end, region_base, n;
 	const struct spi_nor_erase_region *erg;
-	uint32_t i, erasesize, len_erased = 0;
-	ufprog_status ret = UFP_OK;
+	uint32_t i, erasesize;
 
 	erg = spi_nor_get_erase_region_at(snor, addr, &region_base);
 	if (!erg)
-		return UFP_UNSUPPORTED;
+		return NULL;
 
 	if (is_power_of_2(erg->min_erasesize)) {
 		erase_start = addr & ~((uint64_t)erg->min_erasesize - 1);
@@ -3045,16 +3309,36 @@ static ufprog_status spi_nor_erase_at(struct spi_nor *snor, uint64_t addr, uint6
 			ei = &snor->param.erase_info.info[i];
 	}
 
+	if (!ei)
+		return NULL;
+
+	*ret_start = erase_start;
+
+	if (ei->size > erase_end - erase_start)
+		*ret_len = (uint32_t)(erase_end - erase_start);
+	else
+		*ret_len = ei->size;
+
+	return ei;
+}
+
+static ufprog_status spi_nor_erase_at(struct spi_nor *snor, uint64_t addr, uint64_t maxlen, uint32_t *ret_eraseszie)
+{
+	const struct spi_nor_erase_sector_info *ei;
+	uint32_t len_erased = 0, len;
+	ufprog_status ret = UFP_OK;
+	uint64_t erase_start;
+
+	if (!spi_nor_get_erase_region_at(snor, addr, NULL))
+		return UFP_UNSUPPORTED;
+
+	ei = spi_nor_get_erase_sector_at(snor, addr, maxlen, &erase_start, &len);
 	if (ei) {
 		ret = spi_nor_erase_block(snor, erase_start, ei);
-		if (ret) {
+		if (ret)
 			logm_err("Failed to erase at 0x%" PRIx64 ", erase size 0x%x\n", erase_start, ei->size);
-		} else {
-			if (ei->size > erase_end - erase_start)
-				len_erased = (uint32_t)(erase_end - erase_start);
-			else
-				len_erased = ei->size;
-		}
+		else
+			len_erased = len;
 	}
 
 	*ret_eraseszie = len_erased;
@@ -3118,6 +3402,229 @@ ufprog_status UFPROG_API ufprog_spi_nor_erase(struct spi_nor *snor, uint64_t add
 	return ret;
 }
 
+struct spi_nor_die_job {
+	uint64_t addr;
+	uint64_t end;
+	const uint8_t *data;
+	uint64_t tmo;
+	uint32_t oplen;
+	bool busy;
+};
+
+static bool spi_nor_die_interleave_supported(struct spi_nor *snor, bool write)
+{
+	if (snor->param.ndies <= 1)
+		return false;
+
+	/* Address high byte register is shared state and can not be tracked per die */
+	if (snor->ext_param.ops.write_addr_high_byte)
+		return false;
+
+	if (write && snor->ext_param.write_page != spi_nor_page_program)
+		return false;
+
+	return true;
+}
+
+static ufprog_status spi_nor_die_job_issue(struct spi_nor *snor, struct spi_nor_die_job *job, bool write)
+{
+	const struct spi_nor_erase_sector_info *ei;
+	uint64_t erase_start;
+	size_t retlen;
+
+	if (write) {
+		STATUS_CHECK_RET(spi_nor_page_program_issue(snor, job->addr, (size_t)(job->end - job->addr),
+							    job->data, &retlen));
+
+		job->oplen = (uint32_t)retlen;
+		job->tmo = os_get_timer_us() + snor->param.max_pp_time_ms * 1000;
+	} else {
+		ei = spi_nor_get_erase_sector_at(snor, job->addr, job->end - job->addr, &erase_start, &job->oplen);
+		if (!ei) {
+			logm_err("No suitable erase sector at 0x%" PRIx64 "\n", job->addr);
+			return UFP_FAIL;
+		}
+
+		STATUS_CHECK_RET(spi_nor_erase_block_issue(snor, erase_start, ei));
+
+		job->tmo = os_get_timer_us() + ei->max_erase_time_ms * 1000;
+	}
+
+	job->busy = true;
+
+	return UFP_OK;
+}
+
+static ufprog_status spi_nor_die_interleave(struct spi_nor *snor, uint32_t die_start, uint32_t die_count,
+					    uint64_t addr, uint64_t len, const void *data,
+					    ufprog_spi_nor_progress_cb cb, void *priv)
+{
+	uint64_t dieaddr = 0, opsize, done = 0, now;
+	uint32_t i, active = 0, orig_die;
+	struct spi_nor_die_job *jobs;
+	struct spi_nor_die_job *job;
+	const uint8_t *p = data;
+	ufprog_status ret;
+	uint8_t sr;
+
+	jobs = calloc(die_count, sizeof(*jobs));
+	if (!jobs) {
+		logm_err("No memory for die job list\n");
+		return UFP_NOMEM;
+	}
+
+	for (i = 0; len && i < die_count; i++) {
+		if (addr >= dieaddr && addr < dieaddr + snor->param.size) {
+			opsize = snor->param.size - (addr - dieaddr);
+			if (opsize > len)
+				opsize = len;
+
+			jobs[i].addr = addr - dieaddr;
+			jobs[i].end = jobs[i].addr + opsize;
+			jobs[i].data = p;
+
+			if (p)
+				p += opsize;
+
+			addr += opsize;
+			len -= opsize;
+			active++;
+		}
+
+		dieaddr += snor->param.size;
+	}
+
+	orig_die = snor->state.curr_die;
+
+	while (active) {
+		for (i = 0; i < die_count; i++) {
+			job = &jobs[i];
+
+			if (!job->busy && job->addr >= job->end)
+				continue;
+
+			STATUS_CHECK_GOTO_RET(spi_nor_select_die(snor, (uint8_t)(die_start + i)), ret, out);
+			snor->state.curr_die = die_start + i;
+
+			if (job->busy) {
+				STATUS_CHECK_GOTO_RET(spi_nor_read_sr(snor, &sr), ret, out);
+
+				if (sr & SR_BUSY) {
+					if (os_get_timer_us() > job->tmo) {
+						logm_err("Timed out waiting for Die %u idle\n", die_start + i);
+						ret = UFP_TIMEOUT;
+						goto out;
+					}
+
+					continue;
+				}
+
+				job->busy = false;
+				job->addr += job->oplen;
+
+				if (job->data)
+					job->data += job->oplen;
+
+				done += job->oplen;
+
+				if (cb)
+					cb(priv, done);
+
+				if (job->addr >= job->end) {
+					active--;
+					continue;
+				}
+			}
+
+			ret = spi_nor_die_job_issue(snor, job, !!data);
+			if (ret) {
+				logm_err("Failed to %s Die %u at 0x%" PRIx64 "\n", data ? "program" : "erase",
+					 die_start + i, job->addr);
+				goto out;
+			}
+		}
+	}
+
+	ret = UFP_OK;
+
+out:
+	/* Leave no die busy before returning */
+	for (i = 0; i < die_count; i++) {
+		if (!jobs[i].busy)
+			continue;
+
+		if (spi_nor_select_die(snor, (uint8_t)(die_start + i)))
+			continue;
+
+		now = os_get_timer_us();
+		spi_nor_wait_busy(snor, now < jobs[i].tmo ? (uint32_t)((jobs[i].tmo - now + 999) / 1000) : 0);
+	}
+
+	if (!spi_nor_select_die(snor, (uint8_t)orig_die))
+		snor->state.curr_die = orig_die;
+
+	free(jobs);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_spi_nor_erase_dies(struct spi_nor *snor, uint32_t die_start, uint32_t die_count,
+						   uint64_t addr, uint64_t len, ufprog_spi_nor_progress_cb cb,
+						   void *priv)
+{
+	ufprog_status ret;
+
+	if (!snor || !die_count || !len)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (die_start + die_count > snor->param.ndies ||
+	    addr >= snor->param.size * die_count || addr + len > snor->param.size * die_count)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	if (!spi_nor_die_interleave_supported(snor, false))
+		return UFP_UNSUPPORTED;
+
+	ufprog_spi_nor_bus_lock(snor);
+	ret = spi_nor_die_interleave(snor, die_start, die_count, addr, len, NULL, cb, priv);
+	ufprog_spi_nor_bus_unlock(snor);
+
+	return ret;
+}
+
+ufprog_status UFPROG_API ufprog_spi_nor_write_dies(struct spi_nor *snor, uint32_t die_start, uint32_t die_count,
+						   uint64_t addr, uint64_t len, const void *data,
+						   ufprog_spi_nor_progress_cb cb, void *priv)
+{
+	ufprog_status ret;
+
+	if (!snor || !die_count || !len || !data)
+		return UFP_INVALID_PARAMETER;
+
+	if (!snor->param.size)
+		return UFP_FLASH_NOT_PROBED;
+
+	if (die_start + die_count > snor->param.ndies ||
+	    addr >= snor->param.size * die_count || addr + len > snor->param.size * die_count)
+		return UFP_FLASH_ADDRESS_OUT_OF_RANGE;
+
+	if (!spi_nor_die_interleave_supported(snor, true))
+		return UFP_UNSUPPORTED;
+
+	ufprog_spi_nor_bus_lock(snor);
+
+	STATUS_CHECK_GOTO_RET(spi_nor_set_bus_width(snor, spi_mem_io_info_cmd_bw(snor->state.pp_io_info)), ret, out);
+	STATUS_CHECK_GOTO_RET(spi_nor_die_interleave(snor, die_start, die_count, addr, len, data, cb, priv), ret, out);
+	STATUS_CHECK_GOTO_RET(spi_nor_set_bus_width(snor, snor->state.cmd_buswidth), ret, out);
+
+out:
+	ufprog_spi_nor_bus_unlock(snor);
+
+	return ret;
+}
+
 ufprog_status UFPROG_API ufprog_spi_nor_read_uid(struct spi_nor *snor, void *data, uint32_t *retlen)
 {
 	ufprog_status ret;
@@ -10,11 +10,39 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <ctype.h>
+#include <ufprog/bits.h>
 #include <ufprog/log.h>
 #include "vendor.h"
 
 #define SNOR_EXT_VENDOR_INCREMENT			10
 
+/* Number of leading ID bytes used as the hash key of the part ID index */
+#define SNOR_PART_INDEX_ID_KEY_LEN			3
+
+struct spi_nor_part_index_entry {
+	const struct spi_nor_vendor *vendor;
+	const struct spi_nor_vendor *alias_vendor;
+	const struct spi_nor_flash_part *part;
+	const char *model;
+	uint32_t hash;
+	uint32_t seq;
+};
+
+struct spi_nor_part_index {
+	bool valid;
+
+	struct spi_nor_part_index_entry *id_slots;
+	uint32_t id_slot_mask;
+
+	/* Parts whose ID is too short or masked within the key bytes */
+	struct spi_nor_part_index_entry *id_wildcards;
+	uint32_t num_id_wildcards;
+
+	struct spi_nor_part_index_entry *name_slots;
+	uint32_t name_slot_mask;
+};
+
 static const struct spi_nor_vendor *vendors[] = {
 	&vendor_atmel,
 	&vendor_eon,
@@ -36,6 +64,8 @@ static struct spi_nor_vendor *ext_vendors;
 static uint32_t ext_vendor_capacity;
 static uint32_t num_ext_vendors;
 
+static struct spi_nor_part_index part_index;
+
 ufprog_status spi_nor_vendors_init(void)
 {
 	uint32_t i;
@@ -89,7 +119,7 @@ const struct spi_nor_vendor *spi_nor_find_vendor_by_id(const char *id)
 	return spi_nor_find_builtin_vendor_by_id(id);
 }
 
-bool spi_nor_find_vendor_part(const uint8_t *id, struct spi_nor_vendor_part *retvp)
+static bool spi_nor_find_vendor_part_linear(const uint8_t *id, struct spi_nor_vendor_part *retvp)
 {
 	const struct spi_nor_flash_part *part;
 	uint32_t i;
@@ -129,7 +159,7 @@ bool spi_nor_find_vendor_part(const uint8_t *id, struct spi_nor_vendor_part *ret
 	return false;
 }
 
-bool spi_nor_find_vendor_part_by_name(const char *model, struct spi_nor_vendor_part *retvp)
+static bool spi_nor_find_vendor_part_by_name_linear(const char *model, struct spi_nor_vendor_part *retvp)
 {
 	const struct spi_nor_flash_part *part;
 	const struct spi_nor_vendor *vendor;
@@ -176,6 +206,293 @@ bool spi_nor_find_vendor_part_by_name(const char *model, struct spi_nor_vendor_p
 	return false;
 }
 
+static uint32_t spi_nor_part_index_hash(const void *data, size_t len, bool nocase)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 0x811c9dc5;
+	size_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < len; i++) {
+		hash ^= nocase ? (uint8_t)tolower(p[i]) : p[i];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+static bool spi_nor_part_id_hashable(const struct spi_nor_flash_part *part)
+{
+	uint32_t i;
+
+	if (part->id.len < SNOR_PART_INDEX_ID_KEY_LEN)
+		return false;
+
+	if (!part->id_mask)
+		return true;
+
+	for (i = 0; i < SNOR_PART_INDEX_ID_KEY_LEN; i++) {
+		if (part->id_mask[i] != 0xff)
+			return false;
+	}
+
+	return true;
+}
+
+static uint32_t spi_nor_part_index_slots(uint32_t n)
+{
+	/* Keep load factor at or below 50% */
+	if (n < 8)
+		n = 8;
+
+	return 1U << fls(n * 2 - 1);
+}
+
+static void spi_nor_part_index_insert(struct spi_nor_part_index_entry *slots, uint32_t mask,
+				      const struct spi_nor_part_index_entry *entry)
+{
+	uint32_t i = entry->hash & mask;
+
+	while (slots[i].part)
+		i = (i + 1) & mask;
+
+	memcpy(&slots[i], entry, sizeof(*entry));
+}
+
+static void spi_nor_part_index_free(void)
+{
+	if (part_index.id_slots)
+		free(part_index.id_slots);
+
+	if (part_index.id_wildcards)
+		free(part_index.id_wildcards);
+
+	if (part_index.name_slots)
+		free(part_index.name_slots);
+
+	memset(&part_index, 0, sizeof(part_index));
+}
+
+void spi_nor_invalidate_part_index(void)
+{
+	spi_nor_part_index_free();
+}
+
+static void spi_nor_part_index_count_vendor(const struct spi_nor_vendor *vendor, uint32_t *retnids,
+					    uint32_t *retnwildcards, uint32_t *retnnames)
+{
+	const struct spi_nor_flash_part *part;
+	uint32_t i;
+
+	for (i = 0; i < vendor->nparts; i++) {
+		part = &vendor->parts[i];
+
+		if (part->id.len) {
+			if (spi_nor_part_id_hashable(part))
+				(*retnids)++;
+			else
+				(*retnwildcards)++;
+		}
+
+		(*retnnames)++;
+
+		if (part->alias)
+			*retnnames += part->alias->num;
+	}
+}
+
+static void spi_nor_part_index_add_vendor(const struct spi_nor_vendor *vendor, uint32_t *id_seq,
+					  uint32_t *name_seq)
+{
+	struct spi_nor_part_index_entry entry;
+	const struct spi_nor_flash_part *part;
+	uint32_t i, j;
+
+	for (i = 0; i < vendor->nparts; i++) {
+		part = &vendor->parts[i];
+
+		memset(&entry, 0, sizeof(entry));
+		entry.vendor = vendor;
+		entry.part = part;
+		entry.seq = (*id_seq)++;
+
+		if (part->id.len) {
+			if (spi_nor_part_id_hashable(part)) {
+				entry.hash = spi_nor_part_index_hash(part->id.id, SNOR_PART_INDEX_ID_KEY_LEN, false);
+				spi_nor_part_index_insert(part_index.id_slots, part_index.id_slot_mask, &entry);
+			} else {
+				memcpy(&part_index.id_wildcards[part_index.num_id_wildcards++], &entry, sizeof(entry));
+			}
+		}
+
+		entry.model = part->model;
+		entry.seq = (*name_seq)++;
+		entry.hash = spi_nor_part_index_hash(part->model, strlen(part->model), true);
+		spi_nor_part_index_insert(part_index.name_slots, part_index.name_slot_mask, &entry);
+
+		if (!part->alias)
+			continue;
+
+		for (j = 0; j < part->alias->num; j++) {
+			entry.model = part->alias->items[j].model;
+			entry.alias_vendor = part->alias->items[j].vendor;
+			entry.seq = (*name_seq)++;
+			entry.hash = spi_nor_part_index_hash(entry.model, strlen(entry.model), true);
+			spi_nor_part_index_insert(part_index.name_slots, part_index.name_slot_mask, &entry);
+		}
+	}
+}
+
+static bool spi_nor_part_index_build(void)
+{
+	uint32_t i, nids = 0, nwildcards = 0, nnames = 0, id_seq = 0, name_seq = 0;
+
+	if (part_index.valid)
+		return true;
+
+	spi_nor_part_index_free();
+
+	for (i = 0; i < ARRAY_SIZE(vendors); i++)
+		spi_nor_part_index_count_vendor(vendors[i], &nids, &nwildcards, &nnames);
+
+	for (i = 0; i < num_ext_vendors; i++)
+		spi_nor_part_index_count_vendor(&ext_vendors[i], &nids, &nwildcards, &nnames);
+
+	part_index.id_slot_mask = spi_nor_part_index_slots(nids) - 1;
+	part_index.name_slot_mask = spi_nor_part_index_slots(nnames) - 1;
+
+	part_index.id_slots = calloc(part_index.id_slot_mask + 1, sizeof(*part_index.id_slots));
+	part_index.name_slots = calloc(part_index.name_slot_mask + 1, sizeof(*part_index.name_slots));
+	part_index.id_wildcards = calloc(nwildcards + 1, sizeof(*part_index.id_wildcards));
+
+	if (!part_index.id_slots || !part_index.name_slots || !part_index.id_wildcards) {
+		logm_warn("No memory for flash part index. Falling back to linear search\n");
+		spi_nor_part_index_free();
+		return false;
+	}
+
+	/* Sequence numbers preserve the search order of the linear lookup */
+	for (i = 0; i < ARRAY_SIZE(vendors); i++)
+		spi_nor_part_index_add_vendor(vendors[i], &id_seq, &name_seq);
+
+	for (i = 0; i < num_ext_vendors; i++)
+		spi_nor_part_index_add_vendor(&ext_vendors[i], &id_seq, &name_seq);
+
+	part_index.valid = true;
+
+	return true;
+}
+
+static const struct spi_nor_part_index_entry *spi_nor_part_index_find_id(const uint8_t *id)
+{
+	const struct spi_nor_part_index_entry *entry, *best = NULL;
+	uint32_t i, hash;
+
+	hash = spi_nor_part_index_hash(id, SNOR_PART_INDEX_ID_KEY_LEN, false);
+
+	for (i = hash & part_index.id_slot_mask; part_index.id_slots[i].part; i = (i + 1) & part_index.id_slot_mask) {
+		entry = &part_index.id_slots[i];
+
+		if (entry->hash != hash || (best && entry->seq > best->seq))
+			continue;
+
+		if (spi_nor_id_match(entry->part->id.id, id, entry->part->id_mask, entry->part->id.len))
+			best = entry;
+	}
+
+	for (i = 0; i < part_index.num_id_wildcards; i++) {
+		entry = &part_index.id_wildcards[i];
+
+		if (best && entry->seq > best->seq)
+			break;
+
+		if (spi_nor_id_match(entry->part->id.id, id, entry->part->id_mask, entry->part->id.len)) {
+			best = entry;
+			break;
+		}
+	}
+
+	return best;
+}
+
+static const struct spi_nor_part_index_entry *spi_nor_part_index_find_name(const char *model)
+{
+	const struct spi_nor_part_index_entry *entry, *best = NULL;
+	uint32_t i, hash;
+
+	hash = spi_nor_part_index_hash(model, strlen(model), true);
+
+	for (i = hash & part_index.name_slot_mask; part_index.name_slots[i].part;
+	     i = (i + 1) & part_index.name_slot_mask) {
+		entry = &part_index.name_slots[i];
+
+		if (entry->hash != hash || (best && entry->seq > best->seq))
+			continue;
+
+		if (!strcasecmp(entry->model, model))
+			best = entry;
+	}
+
+	return best;
+}
+
+bool spi_nor_find_vendor_part(const uint8_t *id, struct spi_nor_vendor_part *retvp)
+{
+	const struct spi_nor_part_index_entry *entry;
+
+	if (!spi_nor_part_index_build())
+		return spi_nor_find_vendor_part_linear(id, retvp);
+
+	retvp->vendor = NULL;
+	retvp->vendor_init = NULL;
+	retvp->part = NULL;
+
+	entry = spi_nor_part_index_find_id(id);
+	if (!entry)
+		return false;
+
+	if (entry->part->display_vendor) {
+		retvp->vendor = entry->part->display_vendor;
+		retvp->vendor_init = entry->vendor;
+	} else {
+		retvp->vendor = entry->vendor;
+	}
+
+	retvp->part = entry->part;
+
+	return true;
+}
+
+bool spi_nor_find_vendor_part_by_name(const char *model, struct spi_nor_vendor_part *retvp)
+{
+	const struct spi_nor_part_index_entry *entry;
+
+	if (!spi_nor_part_index_build())
+		return spi_nor_find_vendor_part_by_name_linear(model, retvp);
+
+	retvp->vendor = NULL;
+	retvp->vendor_init = NULL;
+	retvp->part = NULL;
+
+	entry = spi_nor_part_index_find_name(model);
+	if (!entry)
+		return false;
+
+	if (entry->alias_vendor) {
+		retvp->vendor = entry->alias_vendor;
+		retvp->vendor_init = entry->vendor;
+	} else if (entry->part->display_vendor) {
+		retvp->vendor = entry->part->display_vendor;
+		retvp->vendor_init = entry->vendor;
+	} else {
+		retvp->vendor = entry->vendor;
+	}
+
+	retvp->part = entry->part;
+
+	return true;
+}
+
 bool spi_nor_vendor_find_part_by_name(const char *model, const struct spi_nor_vendor *vendor,
 				      struct spi_nor_vendor_part *retvp)
 {
@@ -426,6 +743,8 @@ bool spi_nor_set_ext_vendor_capacity(uint32_t n)
 	ext_vendors = newptr;
 	ext_vendor_capacity = n;
 
+	spi_nor_invalidate_part_index();
+
 	return true;
 }
 
@@ -444,6 +763,8 @@ struct spi_nor_vendor *spi_nor_alloc_ext_vendor(void)
 
 		memset(vendor, 0, sizeof(struct spi_nor_vendor));
 
+		spi_nor_invalidate_part_index();
+
 		return vendor;
 	}
 
@@ -459,6 +780,8 @@ void spi_nor_reset_ext_vendors(spi_nor_reset_ext_vendor_cb cb)
 {
 	uint32_t i;
 
+	spi_nor_invalidate_part_index();
+
 	if (ext_vendors) {
 		for (i = 0; i < num_ext_vendors; i++) {
 			if (cb)
@@ -89,6 +89,8 @@ bool spi_nor_set_ext_vendor_capacity(uint32_t n);
 struct spi_nor_vendor *spi_nor_alloc_ext_vendor(void);
 bool spi_nor_is_ext_vendor(const struct spi_nor_vendor *vendor);
 
+void spi_nor_invalidate_part_index(void);
+
 typedef void (*spi_nor_reset_ext_vendor_cb)(struct spi_nor_vendor *vendor);
 void spi_nor_reset_ext_vendors(spi_nor_reset_ext_vendor_cb cb);
 
@@ -37,6 +37,8 @@ uint32_t UFPROG_API ufprog_spi_get_speed(struct ufprog_spi *spi);
 ufprog_status UFPROG_API ufprog_spi_get_speed_range(struct ufprog_spi *spi, uint32_t *retlowhz, uint32_t *rethighhz);
 uint32_t UFPROG_API ufprog_spi_get_speed_list(struct ufprog_spi *spi, uint32_t *retlist, int32_t count);
 ufprog_status UFPROG_API ufprog_spi_get_speed_limit(struct ufprog_spi *spi, uint32_t *retmin, uint32_t *retmax);
+uint32_t UFPROG_API ufprog_spi_get_speed_steps(struct ufprog_spi *spi, uint32_t max_hz, uint32_t *retlist,
+					       uint32_t count);
 
 ufprog_status UFPROG_API ufprog_spi_set_wp(struct ufprog_spi *spi, ufprog_bool high);
 ufprog_status UFPROG_API ufprog_spi_set_hold(struct ufprog_spi *spi, ufprog_bool high);
@@ -98,6 +100,7 @@ ufprog_status UFPROG_API ufprog_spi_mem_poll_status(struct ufprog_spi *spi, cons
 						    uint16_t mask, uint16_t match, uint32_t initial_delay_us,
 						    uint32_t polling_rate_us, uint32_t timeout_ms);
 
+ufprog_bool UFPROG_API ufprog_spi_supports_mem_poll_status(struct ufprog_spi *spi);
 ufprog_bool UFPROG_API ufprog_spi_supports_drive_4io_ones(struct ufprog_spi *spi);
 ufprog_status UFPROG_API ufprog_spi_drive_4io_ones(struct ufprog_spi *spi, uint32_t clocks);
 
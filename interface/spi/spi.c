@@ -411,6 +411,42 @@ ufprog_status UFPROG_API ufprog_spi_get_speed_limit(struct ufprog_spi *spi, uint
 	return UFP_OK;
 }
 
+uint32_t UFPROG_API ufprog_spi_get_speed_steps(struct ufprog_spi *spi, uint32_t max_hz, uint32_t *retlist,
+					       uint32_t count)
+{
+	uint32_t i, hz, n = 0;
+
+	if (!spi || !retlist || !spi->set_speed || !spi->speed_max)
+		return 0;
+
+	if (!max_hz || max_hz > spi->speed_max)
+		max_hz = spi->speed_max;
+
+	if (spi->speed_list) {
+		/* The list is sorted from the highest speed */
+		for (i = 0; i < spi->num_speeds && n < count; i++) {
+			if (spi->speed_list[i] <= max_hz)
+				retlist[n++] = spi->speed_list[i];
+		}
+
+		return n;
+	}
+
+	/* Continuous speed range. Step down by 1/8 each time. */
+	hz = max_hz;
+
+	while (n < count && hz >= spi->speed_min && hz) {
+		retlist[n++] = hz;
+
+		if (hz < UFPROG_SPI_SPEED_STEP_DIV)
+			break;
+
+		hz -= hz / UFPROG_SPI_SPEED_STEP_DIV;
+	}
+
+	return n;
+}
+
 ufprog_status UFPROG_API ufprog_spi_set_wp(struct ufprog_spi *spi, ufprog_bool high)
 {
 	if (!spi)
@@ -811,7 +847,8 @@ static ufprog_status ufprog_spi_mem_generic_poll_status(struct ufprog_spi *spi,
 	if (!ufprog_spi_mem_supports_op(spi, op))
 		return UFP_UNSUPPORTED;
 
-	os_udelay(initial_delay_us);
+	if (initial_delay_us)
+		os_usleep(initial_delay_us);
 
 	buf = op->data.buf.rx;
 	end_us = os_get_timer_us() + (uint64_t)timeout_ms * 1000;
@@ -828,9 +865,20 @@ static ufprog_status ufprog_spi_mem_generic_poll_status(struct ufprog_spi *spi,
 			return UFP_OK;
 
 		if (polling_rate_us)
-			os_udelay(polling_rate_us);
+			os_usleep(polling_rate_us);
 	} while (os_get_timer_us() <= end_us);
 
+	/* Last check */
+	STATUS_CHECK_RET(ufprog_spi_mem_exec_op(spi, op));
+
+	if (op->data.len == 2)
+		val = ((uint16_t)buf[0] << 8) | buf[1];
+	else
+		val = buf[0];
+
+	if ((val & mask) == match)
+		return UFP_OK;
+
 	return UFP_TIMEOUT;
 }
 
@@ -880,6 +928,14 @@ ufprog_status UFPROG_API ufprog_spi_mem_poll_status(struct ufprog_spi *spi, cons
 	return ufprog_spi_mem_generic_poll_status(spi, op, mask, match, initial_delay_us, polling_rate_us, timeout_ms);
 }
 
+ufprog_bool UFPROG_API ufprog_spi_supports_mem_poll_status(struct ufprog_spi *spi)
+{
+	if (!spi)
+		return false;
+
+	return !!(spi->poll_status);
+}
+
 ufprog_bool UFPROG_API ufprog_spi_supports_drive_4io_ones(struct ufprog_spi *spi)
 {
 	if (!spi)
@@ -12,6 +12,7 @@
 #include <ufprog/spi.h>
 
 #define UFPROG_SPI_XFER_BUFFER_LEN		0x10000
+#define UFPROG_SPI_SPEED_STEP_DIV		8
 
 struct ufprog_spi {
 	struct ufprog_controller_device *dev;
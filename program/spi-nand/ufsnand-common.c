@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ufprog/misc.h>
+#include <ufprog/crc32.h>
 #include <ufprog/sizes.h>
 #include <ufprog/osdef.h>
 #include <ufprog/config.h>
@@ -52,6 +53,7 @@ ufprog_status load_config(struct ufsnand_options *retcfg, const char *curr_devic
 		if (ret == UFP_FILE_NOT_EXIST) {
 			retcfg->last_device = NULL;
 			retcfg->log_level = DEFAULT_LOG_LEVEL;
+			retcfg->async_log = false;
 			retcfg->global_max_speed = UFSNAND_MAX_SPEED;
 			retcfg->max_speed = UFSNAND_MAX_SPEED;
 			return UFP_OK;
@@ -92,6 +94,13 @@ ufprog_status load_config(struct ufsnand_options *retcfg, const char *curr_devic
 		goto cleanup;
 	}
 
+	ret = json_read_bool(jroot, "async-log", &retcfg->async_log);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/async-log' in config file is invalid\n");
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
 	ret = json_read_uint32(jroot, "max-speed-hz", &retcfg->global_max_speed, UFSNAND_MAX_SPEED);
 	if (ret == UFP_JSON_TYPE_INVALID) {
 		os_fprintf(stderr, "'/max-speed-hz' in config file is invalid\n");
@@ -246,11 +255,239 @@ cleanup:
 	return ret;
 }
 
+static void calibration_key(char *key, size_t size, const char *model, uint32_t signature)
+{
+	snprintf(key, size, "%s@%08x", model, signature);
+}
+
+ufprog_status load_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t *rethz)
+{
+	struct json_object *jroot, *device_cfgs, *device_cfg, *speeds;
+	char key[UFSNAND_CALIBRATION_KEY_LEN];
+	ufprog_status ret;
+
+	*rethz = 0;
+
+	if (!device)
+		return UFP_OK;
+
+	ret = json_open_config(os_prog_name(), &jroot);
+	if (ret) {
+		if (ret == UFP_FILE_NOT_EXIST)
+			return UFP_OK;
+
+		return ret;
+	}
+
+	ret = json_read_obj(jroot, "device-configs", &device_cfgs);
+	if (ret || !device_cfgs)
+		goto cleanup;
+
+	ret = json_read_obj(device_cfgs, device, &device_cfg);
+	if (ret || !device_cfg)
+		goto cleanup;
+
+	ret = json_read_obj(device_cfg, "calibrated-speed", &speeds);
+	if (ret || !speeds)
+		goto cleanup;
+
+	calibration_key(key, sizeof(key), model, signature);
+
+	ret = json_read_uint32(speeds, key, rethz, 0);
+	if (ret == UFP_JSON_TYPE_INVALID)
+		os_fprintf(stderr, "'/device-configs/%s/calibrated-speed/%s' in config file is invalid\n", device, key);
+
+cleanup:
+	json_free(jroot);
+
+	return ret;
+}
+
+ufprog_status save_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t hz)
+{
+	struct json_object *jroot, *device_cfgs, *device_cfg, *speeds;
+	char key[UFSNAND_CALIBRATION_KEY_LEN];
+	ufprog_status ret;
+
+	ret = json_open_config(os_prog_name(), &jroot);
+	if (ret) {
+		if (ret == UFP_FILE_NOT_EXIST) {
+			ret = json_from_str("{}", &jroot);
+			if (ret) {
+				os_fprintf(stderr, "No memory to create json object\n");
+				return ret;
+			}
+		} else {
+			os_fprintf(stderr, "Failed to load config file\n");
+			return ret;
+		}
+	}
+
+	ret = json_read_obj(jroot, "device-configs", &device_cfgs);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs' in config is invalid\n");
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!device_cfgs) {
+		ret = json_create_obj(&device_cfgs);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs'\n");
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(jroot, "device-configs", device_cfgs);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs' in to config\n");
+			json_put_obj(device_cfgs);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	ret = json_read_obj(device_cfgs, device, &device_cfg);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs/%s' in config file is invalid\n", device);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!device_cfg) {
+		ret = json_create_obj(&device_cfg);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs/%s'\n", device);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(device_cfgs, device, device_cfg);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs/%s' in to config\n", device);
+			json_put_obj(device_cfg);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	ret = json_read_obj(device_cfg, "calibrated-speed", &speeds);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs/%s/calibrated-speed' in config file is invalid\n", device);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!speeds) {
+		ret = json_create_obj(&speeds);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs/%s/calibrated-speed'\n", device);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(device_cfg, "calibrated-speed", speeds);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs/%s/calibrated-speed' in to config\n", device);
+			json_put_obj(speeds);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	calibration_key(key, sizeof(key), model, signature);
+
+	ret = json_set_uint(speeds, key, hz);
+	if (ret) {
+		os_fprintf(stderr, "Failed to set '/device-configs/%s/calibrated-speed/%s' in config\n", device, key);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	ret = json_save_config(os_prog_name(), jroot);
+	if (ret)
+		os_fprintf(stderr, "Failed to save config file\n");
+
+cleanup:
+	json_free(jroot);
+
+	return ret;
+}
+
+bool digest_init(struct ufnand_digest *dg, const char *crc32_str, const char *sha256_str)
+{
+	size_t len;
+	char *end;
+
+	memset(dg, 0, sizeof(*dg));
+
+	if (crc32_str) {
+		dg->expected_crc32 = strtoul(crc32_str, &end, 16);
+		if (end == crc32_str || *end) {
+			os_fprintf(stderr, "Expected CRC32 value is invalid\n");
+			return false;
+		}
+
+		dg->check_crc32 = true;
+	}
+
+	if (sha256_str) {
+		if (!hex_str_to_bin(sha256_str, dg->expected_sha256, sizeof(dg->expected_sha256), &len) ||
+		    len != sizeof(dg->expected_sha256)) {
+			os_fprintf(stderr, "Expected SHA-256 value is invalid\n");
+			return false;
+		}
+
+		dg->check_sha256 = true;
+	}
+
+	dg->crc32 = 0xffffffff;
+	sha256_init(&dg->sha256);
+
+	return true;
+}
+
+void digest_update(struct ufnand_digest *dg, const void *data, size_t len)
+{
+	dg->crc32 = crc32_no_comp(dg->crc32, data, len);
+	sha256_update(&dg->sha256, data, len);
+}
+
+ufprog_status digest_finish(struct ufnand_digest *dg)
+{
+	uint8_t sha256_result[SHA256_DIGEST_SIZE];
+	char sha256_str[SHA256_DIGEST_SIZE * 2 + 1];
+	ufprog_status ret = UFP_OK;
+
+	dg->crc32 ^= 0xffffffff;
+	sha256_final(&dg->sha256, sha256_result);
+
+	bin_to_hex_str(sha256_str, sizeof(sha256_str), sha256_result, sizeof(sha256_result), false, false);
+
+	os_printf("CRC32:   %08x\n", dg->crc32);
+	os_printf("SHA-256: %s\n", sha256_str);
+
+	if (dg->check_crc32 && dg->crc32 != dg->expected_crc32) {
+		os_fprintf(stderr, "CRC32 mismatch: expect %08x\n", dg->expected_crc32);
+		ret = UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	if (dg->check_sha256 && memcmp(sha256_result, dg->expected_sha256, sizeof(sha256_result))) {
+		bin_to_hex_str(sha256_str, sizeof(sha256_str), dg->expected_sha256, sizeof(dg->expected_sha256),
+			       false, false);
+		os_fprintf(stderr, "SHA-256 mismatch: expect %s\n", sha256_str);
+		ret = UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	return ret;
+}
+
 ufprog_status open_device(const char *device_name, const char *part, uint32_t max_speed,
 			  struct ufsnand_instance *retinst, bool list_only)
 {
 	ufprog_bool nor_read_enabled = false;
 	ufprog_status ret;
+	uint32_t speed;
 	uint64_t size;
 	char *unit;
 
@@ -310,6 +547,13 @@ ufprog_status open_device(const char *device_name, const char *part, uint32_t ma
 	ufprog_spi_nand_info(retinst->snand, &retinst->sinfo);
 	ufprog_nand_info(retinst->nand.chip, &retinst->nand.info);
 
+	retinst->device_name = device_name;
+
+	if (!load_calibrated_speed(device_name, retinst->nand.info.model, retinst->sinfo.signature, &speed) && speed) {
+		if (ufprog_spi_nand_set_speed_high(retinst->snand, speed))
+			os_fprintf(stderr, "Failed to apply calibrated speed\n");
+	}
+
 	retinst->speed = ufprog_spi_nand_get_speed_high(retinst->snand);
 
 	ufprog_spi_get_speed_limit(retinst->spi, NULL, &retinst->max_speed);
@@ -665,121 +909,426 @@ void print_speed(uint64_t size, uint64_t time_us)
 	os_printf("Time used: %.2fs, speed: %.2f%sB/s\n", (double)time_us / 1000000.0, speed, speed_unit);
 }
 
-static void nand_progressbar_cb(struct ufnand_progress_status *prog, uint32_t count)
+static ufprog_status nand_map_file(file_mapping fm, uint64_t offset, uint8_t **retbase, size_t *retsize)
 {
-	uint32_t percentage;
+	uint64_t real_offset;
+	uint8_t *base;
+	size_t size;
 
-	prog->current += count;
-	percentage = prog->current * 100ULL / prog->total;
+	if (!os_set_file_mapping_offset(fm, offset, (void **)&base)) {
+		os_fprintf(stderr, "Failed to adjust file mapping\n");
+		return UFP_FAIL;
+	}
 
-	if (percentage > prog->last_percentage)
-		progress_show(percentage);
+	real_offset = os_get_file_mapping_offset(fm);
+	size = os_get_file_mapping_size(fm);
 
-	prog->last_percentage = percentage;
-}
+	if (real_offset < offset) {
+		size -= offset - real_offset;
+		base += offset - real_offset;
+	}
 
-static void nand_progressbar_init(struct ufnand_progress_status *prog, uint32_t total_count)
-{
-	prog->total = total_count;
-	prog->current = 0;
-	prog->last_percentage = 0;
+	*retbase = base;
+	*retsize = size;
 
-	progress_init();
+	return UFP_OK;
 }
 
-static void nand_progressbar_done(struct ufnand_progress_status *prog)
+/* Feed the first @size bytes of the mapped file into a SHA-256 context and/or a digest */
+static ufprog_status nand_hash_file(file_mapping fm, uint64_t size, struct sha256_context *ctx,
+				    struct ufnand_digest *dg)
 {
-	progress_done();
-}
+	uint64_t offset = 0;
+	ufprog_status ret;
+	uint8_t *base;
+	size_t len;
 
-static void print_rwe_status(struct ufnand_rwe_data *rwedata, bool read, bool dump)
-{
-	const char *oob_state, *ecc_state, *fmt_state = NULL;
+	while (offset < size) {
+		ret = nand_map_file(fm, offset, &base, &len);
+		if (ret)
+			return ret;
 
-	if (rwedata->oob)
-		oob_state = "included";
-	else
-		oob_state = "excluded";
+		if (!len)
+			return UFP_FAIL;
 
-	if (rwedata->raw)
-		ecc_state = "disabled";
-	else
-		ecc_state = "enabled";
+		if (len > size - offset)
+			len = (size_t)(size - offset);
 
-	if (rwedata->fmt) {
-		if (read)
-			fmt_state = "Input";
-		else
-			fmt_state = "Output";
-	}
+		if (ctx)
+			sha256_update(ctx, base, len);
 
-	if (fmt_state) {
-		if (dump)
-			os_printf("OOB: %s. ECC: %s. Data is in canonical layout.\n", oob_state, ecc_state);
-		else
-			os_printf("OOB: %s. ECC: %s. %s file is in canonical layout.\n", oob_state, ecc_state,
-				  fmt_state);
-	} else {
-		os_printf("OOB: %s. ECC: %s.\n", oob_state, ecc_state);
+		if (dg)
+			digest_update(dg, base, len);
+
+		offset += len;
 	}
+
+	return UFP_OK;
 }
 
-static ufprog_status nand_process_read_page_data(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
-						 void *dst, const void *src, uint32_t count, bool fmt)
+static ufprog_status nand_verify_at(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+				    const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
+				    uint32_t map_page, uint32_t page, uint32_t count, uint32_t last_page_padding);
+
+static void journal_chip_id(struct ufnand_instance *nandinst, char *buf, size_t size)
 {
-	const uint8_t *s = src;
-	ufprog_status ret;
-	uint8_t *p = dst;
-	uint32_t i;
+	uint8_t uid[UFNAND_JOURNAL_UID_MAX_LEN];
+	uint32_t uidlen = nandinst->info.uid_length;
+	size_t n;
 
-	for (i = 0; i < count; i++) {
-		if (!fmt) {
-			memcpy(p, s, opdata->page_size);
-		} else {
-			ret = ufprog_nand_convert_page_format(nandinst->chip, s, opdata->buf[1], false);
-			if (ret) {
-				os_fprintf(stderr, "Failed to convert page data\n");
-				return ret;
-			}
+	n = snprintf(buf, size, "%s %s ", nandinst->info.vendor, nandinst->info.model);
+	if (n >= size)
+		return;
 
-			memcpy(p, opdata->buf[1], opdata->page_size);
-		}
+	bin_to_hex_str(buf + n, size - n, nandinst->info.id.id, nandinst->info.id.len, false, false);
 
-		p += opdata->page_size;
-		s += nandinst->info.maux.oob_page_size;
-	}
+	/* Tie the journal to this very chip if it has a Unique ID */
+	if (!uidlen || uidlen > sizeof(uid))
+		return;
 
-	return UFP_OK;
+	if (ufprog_nand_read_uid(nandinst->chip, uid, NULL))
+		return;
+
+	n = strlen(buf);
+	if (n + 2 >= size)
+		return;
+
+	buf[n++] = '@';
+	bin_to_hex_str(buf + n, size - n, uid, uidlen, false, false);
 }
 
-static ufprog_status nand_ftl_read_post_cb(struct ufprog_ftl_callback *cb, uint32_t actual_count)
+ufprog_status journal_open(struct ufnand_instance *nandinst, const char *path, enum ufprog_journal_op op,
+			   const struct ufnand_rwe_data *rwedata, uint32_t page, uint32_t count, file_mapping fm,
+			   uint64_t image_size, bool resume, struct ufnand_journal *retjnl)
 {
-	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
+	struct ufprog_journal_info info;
+	struct sha256_context ctx;
 	ufprog_status ret;
 
-	ret = nand_process_read_page_data(ftlcb->nandinst, ftlcb->opdata, ftlcb->buf.rx, ftlcb->cb.buffer,
-					  actual_count, ftlcb->rwedata->fmt);
-	if (ret)
-		return ret;
+	memset(&info, 0, sizeof(info));
+	memset(retjnl, 0, sizeof(*retjnl));
 
-	ftlcb->buf.rx += ftlcb->opdata->page_size * actual_count;
+	info.op = op;
+	info.start = ((uint64_t)rwedata->part.base_block << nandinst->info.maux.pages_per_block_shift) + page;
+	info.size = count;
+	info.flags = (rwedata->raw ? 1 : 0) | (rwedata->oob ? 2 : 0) | (rwedata->fmt ? 4 : 0) |
+		     (rwedata->nospread ? 8 : 0) | (rwedata->erase ? 0x10 : 0);
 
-	nand_progressbar_cb(&ftlcb->prog, actual_count);
+	journal_chip_id(nandinst, info.chip_id, sizeof(info.chip_id));
 
-	return UFP_OK;
-}
+	if (image_size) {
+		sha256_init(&ctx);
 
-ufprog_status nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
-			const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
-			uint32_t page, uint32_t count)
-{
-	uint64_t total_size, map_offset, real_map_offset, t0, t1;
-	uint32_t real_page, num_to_read, retnum;
-	struct ufnand_ftl_callback ftlcb;
+		ret = nand_hash_file(fm, image_size, &ctx, NULL);
+		if (ret)
+			return ret;
+
+		sha256_final(&ctx, info.image_digest);
+	}
+
+	ret = ufprog_journal_open(path, &info, resume, &retjnl->jnl, &retjnl->phase, &retjnl->pos);
+	if (ret) {
+		os_fprintf(stderr, "Failed to open journal '%s'\n", path);
+		return ret;
+	}
+
+	if (!retjnl->pos && op == JOURNAL_OP_READ)
+		retjnl->phase = NAND_JOURNAL_PHASE_READ;
+
+	retjnl->page = page;
+	retjnl->count = count;
+
+	if (retjnl->phase == UFPROG_JOURNAL_PHASE_DONE)
+		os_printf("Journal shows this operation has been completed\n");
+	else if (retjnl->pos && retjnl->phase == NAND_JOURNAL_PHASE_ERASE)
+		os_printf("Journal shows erasing stopped after %" PRIu64 " block(s)\n", retjnl->pos);
+	else if (retjnl->pos)
+		os_printf("Journal shows this operation stopped after %" PRIu64 " page(s)\n", retjnl->pos);
+
+	return UFP_OK;
+}
+
+ufprog_status journal_checkpoint(struct ufnand_instance *nandinst, uint32_t phase, uint64_t pos, bool force)
+{
+	struct ufnand_journal *j = nandinst->journal;
+	ufprog_status ret;
+
+	if (!j)
+		return UFP_OK;
+
+	if (!force) {
+		/* Erase issued while programming (boundary re-erase) must not be recorded as erase progress */
+		if (phase != j->phase)
+			return UFP_OK;
+
+		/* Page positions are only recorded on block boundaries so that resuming never splits a block */
+		if (phase != NAND_JOURNAL_PHASE_ERASE && pos < j->count &&
+		    ((j->page + pos) & (nandinst->info.memorg.pages_per_block - 1)))
+			return UFP_OK;
+	}
+
+	ret = ufprog_journal_checkpoint(j->jnl, phase, pos);
+	if (ret) {
+		os_fprintf(stderr, "Failed to update journal\n");
+		return ret;
+	}
+
+	j->phase = phase;
+	j->pos = pos;
+
+	return UFP_OK;
+}
+
+bool journal_done(struct ufnand_instance *nandinst)
+{
+	if (!nandinst->journal || nandinst->journal->phase != UFPROG_JOURNAL_PHASE_DONE)
+		return false;
+
+	os_printf("Skipped as already completed\n");
+
+	return true;
+}
+
+ufprog_status journal_finish(struct ufnand_instance *nandinst)
+{
+	if (!nandinst->journal || nandinst->journal->phase == UFPROG_JOURNAL_PHASE_DONE)
+		return UFP_OK;
+
+	return journal_checkpoint(nandinst, UFPROG_JOURNAL_PHASE_DONE, 0, true);
+}
+
+void journal_close(struct ufnand_journal *jnl)
+{
+	ufprog_journal_close(jnl->jnl);
+	jnl->jnl = NULL;
+}
+
+/* Number of pages of the last recorded block which are covered by the operation */
+static uint32_t journal_last_block_pages(struct ufnand_instance *nandinst, uint32_t page, uint32_t pos)
+{
+	uint32_t n;
+
+	n = (page + pos) & (nandinst->info.memorg.pages_per_block - 1);
+	if (!n)
+		n = nandinst->info.memorg.pages_per_block;
+
+	if (n > pos)
+		n = pos;
+
+	return n;
+}
+
+static void nand_progressbar_cb(struct ufnand_progress_status *prog, uint32_t count)
+{
+	uint32_t percentage;
+
+	prog->current += count;
+	percentage = prog->current * 100ULL / prog->total;
+
+	if (percentage > prog->last_percentage)
+		progress_show(percentage);
+
+	prog->last_percentage = percentage;
+}
+
+static void nand_progressbar_init(struct ufnand_progress_status *prog, uint32_t total_count)
+{
+	prog->total = total_count;
+	prog->current = 0;
+	prog->last_percentage = 0;
+
+	progress_init();
+}
+
+static void nand_progressbar_done(struct ufnand_progress_status *prog)
+{
+	progress_done();
+}
+
+static void print_rwe_status(struct ufnand_rwe_data *rwedata, bool read, bool dump)
+{
+	const char *oob_state, *ecc_state, *fmt_state = NULL;
+
+	if (rwedata->oob)
+		oob_state = "included";
+	else
+		oob_state = "excluded";
+
+	if (rwedata->raw)
+		ecc_state = "disabled";
+	else
+		ecc_state = "enabled";
+
+	if (rwedata->fmt) {
+		if (read)
+			fmt_state = "Input";
+		else
+			fmt_state = "Output";
+	}
+
+	if (fmt_state) {
+		if (dump)
+			os_printf("OOB: %s. ECC: %s. Data is in canonical layout.\n", oob_state, ecc_state);
+		else
+			os_printf("OOB: %s. ECC: %s. %s file is in canonical layout.\n", oob_state, ecc_state,
+				  fmt_state);
+	} else {
+		os_printf("OOB: %s. ECC: %s.\n", oob_state, ecc_state);
+	}
+}
+
+static ufprog_status nand_process_read_page_data(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
+						 void *dst, const void *src, uint32_t count, bool fmt)
+{
+	const uint8_t *s = src;
+	ufprog_status ret;
+	uint8_t *p = dst;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		if (!fmt) {
+			memcpy(p, s, opdata->page_size);
+		} else {
+			ret = ufprog_nand_convert_page_format(nandinst->chip, s, opdata->buf[1], false);
+			if (ret) {
+				os_fprintf(stderr, "Failed to convert page data\n");
+				return ret;
+			}
+
+			memcpy(p, opdata->buf[1], opdata->page_size);
+		}
+
+		p += opdata->page_size;
+		s += nandinst->info.maux.oob_page_size;
+	}
+
+	return UFP_OK;
+}
+
+static bool nand_read_direct_capable(struct ufnand_instance *nandinst, const struct ufnand_rwe_data *rwedata)
+{
+	struct ufprog_nand_ecc_chip *ecc;
+	uint32_t ecc_type;
+
+	if (rwedata->fmt)
+		return false;
+
+	if (rwedata->oob || rwedata->raw)
+		return true;
+
+	/* Reading only the data part of a page leaves nothing for an external ECC engine to decode */
+	ecc = ufprog_nand_get_ecc(nandinst->chip);
+	if (!ecc)
+		return true;
+
+	ecc_type = ufprog_ecc_chip_type(ecc);
+
+	return ecc_type == NAND_ECC_NONE || ecc_type == NAND_ECC_ON_DIE;
+}
+
+static ufprog_status nand_ftl_read_pre_cb(struct ufprog_ftl_callback *cb, uint32_t requested_count)
+{
+	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
+
+	ftlcb->cb.direct = ftlcb->buf.rx;
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_ftl_read_post_cb(struct ufprog_ftl_callback *cb, uint32_t actual_count)
+{
+	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
+	ufprog_status ret;
+
+	if (!ftlcb->cb.direct_len) {
+		ret = nand_process_read_page_data(ftlcb->nandinst, ftlcb->opdata, ftlcb->buf.rx, ftlcb->cb.buffer,
+						  actual_count, ftlcb->rwedata->fmt);
+		if (ret)
+			return ret;
+	}
+
+	if (ftlcb->rwedata->dg)
+		digest_update(ftlcb->rwedata->dg, ftlcb->buf.rx, (size_t)ftlcb->opdata->page_size * actual_count);
+
+	ftlcb->buf.rx += ftlcb->opdata->page_size * actual_count;
+
+	nand_progressbar_cb(&ftlcb->prog, actual_count);
+
+	return journal_checkpoint(ftlcb->nandinst, NAND_JOURNAL_PHASE_READ, ftlcb->journal_base + ftlcb->prog.current,
+				  false);
+}
+
+static ufprog_status nand_read_resume(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+				      const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata,
+				      file_mapping fm, uint32_t page, uint32_t count, uint32_t *retskip)
+{
+	struct ufnand_journal *j = nandinst->journal;
+	uint32_t pos, vcount;
+	ufprog_status ret;
+
+	*retskip = 0;
+
+	if (j->phase != NAND_JOURNAL_PHASE_READ || !j->pos || j->pos > count)
+		return UFP_OK;
+
+	pos = (uint32_t)j->pos;
+	vcount = journal_last_block_pages(nandinst, page, pos);
+
+	/* The last recorded block is the one most likely to be incomplete in the output file */
+	os_printf("Validating last saved block ...\n");
+
+	ret = nand_verify_at(nandinst, rwedata, part, opdata, fm, pos - vcount, page + pos - vcount, vcount, 0);
+	if (ret) {
+		os_printf("Last saved block is not intact and will be read again\n");
+		pos -= vcount;
+	}
+
+	if (pos && rwedata->dg) {
+		ret = nand_hash_file(fm, (uint64_t)opdata->page_size * pos, NULL, rwedata->dg);
+		if (ret)
+			return ret;
+	}
+
+	*retskip = pos;
+
+	return UFP_OK;
+}
+
+ufprog_status nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+			const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
+			uint32_t page, uint32_t count)
+{
+	uint32_t real_page, num_to_read, retnum, skip = 0;
+	uint64_t total_size, map_offset, t0, t1;
+	struct ufnand_ftl_callback ftlcb;
 	ufprog_status ret = UFP_OK;
 	uint8_t *map_base;
 	size_t map_size;
 
+	if (nandinst->journal) {
+		if (journal_done(nandinst)) {
+			if (rwedata->dg)
+				return nand_hash_file(fm, (uint64_t)opdata->page_size * count, NULL, rwedata->dg);
+
+			return UFP_OK;
+		}
+
+		ret = nand_read_resume(nandinst, rwedata, part, opdata, fm, page, count, &skip);
+		if (ret)
+			return ret;
+
+		if (skip == count) {
+			os_printf("Nothing left to be read\n");
+			return journal_checkpoint(nandinst, NAND_JOURNAL_PHASE_READ, count, true);
+		}
+
+		if (skip)
+			os_printf("Resuming after %u page(s) already read\n", skip);
+
+		page += skip;
+		count -= skip;
+	}
+
 	total_size = (uint64_t)opdata->page_size * count;
 
 	if (part->base_block && page) {
@@ -793,13 +1342,11 @@ ufprog_status nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data
 
 	print_rwe_status(rwedata, true, false);
 
-	if (!os_set_file_mapping_offset(fm, 0, (void **)&map_base)) {
-		os_fprintf(stderr, "Failed to adjust file mapping\n");
-		return UFP_FAIL;
-	}
+	map_offset = (uint64_t)opdata->page_size * skip;
 
-	map_offset = os_get_file_mapping_offset(fm);
-	map_size = os_get_file_mapping_size(fm);
+	ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+	if (ret)
+		return ret;
 
 	memset(&ftlcb, 0, sizeof(ftlcb));
 	nand_progressbar_init(&ftlcb.prog, count);
@@ -808,6 +1355,13 @@ ufprog_status nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data
 	ftlcb.nandinst = nandinst;
 	ftlcb.rwedata = rwedata;
 	ftlcb.opdata = opdata;
+	ftlcb.journal_base = skip;
+
+	/* Pages need no conversion can be read into the file mapping directly */
+	if (nand_read_direct_capable(nandinst, rwedata)) {
+		ftlcb.cb.pre = nand_ftl_read_pre_cb;
+		ftlcb.cb.direct_len = opdata->page_size;
+	}
 
 	t0 = os_get_timer_us();
 
@@ -841,19 +1395,9 @@ ufprog_status nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data
 		/* Move file mapping */
 		map_offset += (size_t)opdata->page_size * num_to_read;
 
-		if (!os_set_file_mapping_offset(fm, map_offset, (void **)&map_base)) {
-			os_fprintf(stderr, "Failed to adjust file mapping\n");
-			ret = UFP_FAIL;
+		ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+		if (ret)
 			break;
-		}
-
-		real_map_offset = os_get_file_mapping_offset(fm);
-		map_size = os_get_file_mapping_size(fm);
-
-		if (real_map_offset < map_offset) {
-			map_size -= map_offset - real_map_offset;
-			map_base += map_offset - real_map_offset;
-		}
 	}
 
 	if (!ret) {
@@ -962,22 +1506,98 @@ ufprog_status nand_dump(struct ufnand_instance *nandinst, struct ufnand_rwe_data
 	return ret;
 }
 
+static void nand_dump_range_line(uint32_t page, const void *data, uint32_t len, char *line)
+{
+	bin_to_hex_str(line, len * 2 + 1, data, len, false, false);
+	os_printf("%08x %s\n", page, line);
+}
+
+ufprog_status nand_dump_range(struct ufnand_instance *nandinst, uint32_t page, uint32_t count, uint32_t column,
+			      uint32_t len, bool raw)
+{
+	uint32_t i, n, rdcnt, ppb = nandinst->info.memorg.pages_per_block;
+	bool has_last = false, repeated = false;
+	ufprog_status ret = UFP_OK;
+	uint8_t *buf, *last, *p;
+	char *line;
+
+	os_printf("Dump of flash at page %u, count %u, column %u, length %u ...\n", page, count, column, len);
+
+	buf = malloc((size_t)(ppb + 1) * len);
+	if (!buf) {
+		os_fprintf(stderr, "No memory for page buffer\n");
+		return UFP_NOMEM;
+	}
+
+	line = malloc((size_t)len * 2 + 1);
+	if (!line) {
+		os_fprintf(stderr, "No memory for line buffer\n");
+		free(buf);
+		return UFP_NOMEM;
+	}
+
+	last = buf + (size_t)ppb * len;
+
+	/*
+	 * One line per page. Lines identical to the previous one are collapsed into a single '*', and the last page is
+	 * always printed to mark the end of the range.
+	 */
+	while (count) {
+		n = ppb - (page & nandinst->info.maux.pages_per_block_mask);
+		if (n > count)
+			n = count;
+
+		ret = ufprog_nand_read_pages_range(nandinst->chip, page, n, column, len, buf, raw,
+						   NAND_READ_F_IGNORE_ECC_ERROR, &rdcnt);
+		if (ret) {
+			os_fprintf(stderr, "Failed to read page %u\n", page + rdcnt);
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			p = buf + (size_t)i * len;
+
+			if (has_last && !memcmp(p, last, len)) {
+				if (!repeated)
+					os_printf("*\n");
+
+				repeated = true;
+
+				if (i + 1 == count)
+					nand_dump_range_line(page + i, p, len, line);
+
+				continue;
+			}
+
+			nand_dump_range_line(page + i, p, len, line);
+			memcpy(last, p, len);
+			has_last = true;
+			repeated = false;
+		}
+
+		page += n;
+		count -= n;
+	}
+
+	free(line);
+	free(buf);
+
+	return ret;
+}
+
 static ufprog_status nand_prepare_write_page_data(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
 						  void *dst, const void *src, uint32_t count, bool fmt)
 {
-	uint32_t i, flags;
 	const uint8_t *s = src;
 	ufprog_status ret;
 	uint8_t *p = dst;
-
-	flags = PAGE_FILL_F_FILL_NON_DATA_FF | PAGE_FILL_F_FILL_OOB | PAGE_FILL_F_FILL_UNPROTECTED_OOB |
-		PAGE_FILL_F_SRC_SKIP_NON_DATA;
+	uint32_t i;
 
 	for (i = 0; i < count; i++) {
 		if (!fmt) {
-			ufprog_nand_fill_page_by_layout(opdata->layout, p, s, opdata->page_size, flags);
+			ufprog_nand_fill_page_by_prog(opdata->prog, p, s, opdata->page_size);
 		} else {
-			ufprog_nand_fill_page_by_layout(opdata->layout, opdata->buf[1], s, opdata->page_size, flags);
+			ufprog_nand_fill_page_by_prog(opdata->prog, opdata->buf[1], s, opdata->page_size);
 
 			ret = ufprog_nand_convert_page_format(nandinst->chip, opdata->buf[1], p, true);
 			if (ret) {
@@ -1031,12 +1651,151 @@ static ufprog_status nand_ftl_write_pre_cb(struct ufprog_ftl_callback *cb, uint3
 	return UFP_OK;
 }
 
+static bool nand_verify_page(struct ufnand_op_data *opdata, const uint8_t *buf, const uint8_t *gold, uint32_t page,
+			     uint32_t verify_len)
+{
+	uint32_t pos;
+
+	if (ufprog_nand_compare_page_by_prog(opdata->prog, buf, gold, verify_len, &pos))
+		return true;
+
+	os_fprintf(stderr, "Page %u data at 0x%x are different: expect 0x%02x, got 0x%02x\n", page, pos, gold[pos],
+		   buf[pos]);
+
+	return false;
+}
+
+static ufprog_status nand_verify_buf(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
+				     const uint8_t *buf, const uint8_t *gold, uint32_t page, uint32_t count,
+				     uint32_t verify_len, bool fmt)
+{
+	ufprog_status ret;
+	const uint8_t *p;
+	uint32_t i;
+	bool rc;
+
+	for (i = 0; i < count; i++) {
+		if (fmt) {
+			ret = ufprog_nand_convert_page_format(nandinst->chip, buf, opdata->buf[1], false);
+			if (ret) {
+				os_fprintf(stderr, "Failed to convert page data\n");
+				return ret;
+			}
+
+			p = opdata->buf[1];
+		} else {
+			p = buf;
+		}
+
+
+		rc = nand_verify_page(opdata, p, gold, page, verify_len);
+		if (!rc)
+			return UFP_DATA_VERIFICATION_FAIL;
+
+		gold += opdata->page_size;
+		buf += nandinst->info.maux.oob_page_size;
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_ftl_write_verify_cb(struct ufprog_ftl_callback *cb, const void *data, uint32_t count)
+{
+	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
+	uint32_t verify_len = ftlcb->opdata->page_size;
+	const uint8_t *gold;
+	ufprog_status ret;
+
+	/* Source data of these pages has already been consumed by the pre callback */
+	gold = ftlcb->buf.tx - ftlcb->opdata->page_size * count;
+
+	/* Verify all but last page */
+	ret = nand_verify_buf(ftlcb->nandinst, ftlcb->opdata, data, gold, ftlcb->page, count - 1, verify_len,
+			      ftlcb->rwedata->fmt);
+	if (ret)
+		return ret;
+
+	/* Verify last page */
+	if (ftlcb->last_batch && ftlcb->last_page_padding && !ftlcb->count_left)
+		verify_len -= ftlcb->last_page_padding;
+
+	return nand_verify_buf(ftlcb->nandinst, ftlcb->opdata,
+			       (const uint8_t *)data + ftlcb->nandinst->info.maux.oob_page_size * (count - 1),
+			       gold + ftlcb->opdata->page_size * (count - 1), ftlcb->page + count - 1, 1, verify_len,
+			       ftlcb->rwedata->fmt);
+}
+
 static ufprog_status nand_ftl_write_post_cb(struct ufprog_ftl_callback *cb, uint32_t actual_count)
 {
 	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
 
+	ftlcb->page += actual_count;
+
 	nand_progressbar_cb(&ftlcb->prog, actual_count);
 
+	return journal_checkpoint(ftlcb->nandinst, NAND_JOURNAL_PHASE_PROGRAM,
+				  ftlcb->journal_base + ftlcb->prog.current, false);
+}
+
+static ufprog_status nand_write_resume(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+				       const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata,
+				       file_mapping fm, uint32_t page, uint32_t count, uint32_t last_page_padding,
+				       uint32_t *retskip)
+{
+	uint32_t pos, vcount, first, last_page, nblocks, retcnt, ppb_mask;
+	struct ufnand_journal *j = nandinst->journal;
+	ufprog_status ret;
+
+	*retskip = 0;
+
+	if (j->phase != NAND_JOURNAL_PHASE_PROGRAM || !j->pos || j->pos > count)
+		return UFP_OK;
+
+	ppb_mask = nandinst->info.memorg.pages_per_block - 1;
+	pos = (uint32_t)j->pos;
+	vcount = journal_last_block_pages(nandinst, page, pos);
+
+	os_printf("Validating last programmed block ...\n");
+
+	ret = nand_verify_at(nandinst, rwedata, part, opdata, fm, pos - vcount, page + pos - vcount, vcount,
+			     pos == count ? last_page_padding : 0);
+	if (!ret && pos == count) {
+		*retskip = count;
+		return UFP_OK;
+	}
+
+	/* The block next to the recorded position may have been partially programmed */
+	last_page = page + pos + nandinst->info.memorg.pages_per_block - ((page + pos) & ppb_mask);
+	if (last_page > page + count)
+		last_page = page + count;
+	last_page--;
+
+	if (ret) {
+		os_printf("Last programmed block is not intact and will be programmed again\n");
+		pos -= vcount;
+	}
+
+	first = (page + pos) >> nandinst->info.maux.pages_per_block_shift;
+	nblocks = (last_page >> nandinst->info.maux.pages_per_block_shift) - first + 1;
+
+	if (!rwedata->erase && (((page + pos) & ppb_mask) || ((last_page + 1) & ppb_mask))) {
+		os_fprintf(stderr, "Block to be erased again contains data out of the range.\n");
+		os_fprintf(stderr, "Please restart the operation without resume\n");
+		return UFP_FAIL;
+	}
+
+	ret = ufprog_ftl_erase_blocks(nandinst->ftl, part, first, nblocks, !rwedata->nospread, &retcnt, NULL);
+	if (ret) {
+		os_fprintf(stderr, "Failed to erase block(s) for resuming\n");
+		return ret;
+	}
+
+	ret = journal_checkpoint(nandinst, NAND_JOURNAL_PHASE_PROGRAM, pos, true);
+	if (ret)
+		return ret;
+
+	*retskip = pos;
+
 	return UFP_OK;
 }
 
@@ -1044,13 +1803,33 @@ ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_dat
 			 const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
 			 uint32_t page, uint32_t count, uint32_t last_page_padding)
 {
-	uint64_t total_size, map_offset, real_map_offset, t0, t1;
-	uint32_t real_page, num_to_write, retnum;
+	uint32_t real_page, num_to_write, retnum, skip = 0;
+	uint64_t total_size, map_offset, t0, t1;
 	struct ufnand_ftl_callback ftlcb;
 	ufprog_status ret = UFP_OK;
 	uint8_t *map_base;
 	size_t map_size;
 
+	if (nandinst->journal) {
+		if (journal_done(nandinst))
+			return UFP_OK;
+
+		ret = nand_write_resume(nandinst, rwedata, part, opdata, fm, page, count, last_page_padding, &skip);
+		if (ret)
+			return ret;
+
+		if (skip == count) {
+			os_printf("Nothing left to be written\n");
+			return journal_checkpoint(nandinst, NAND_JOURNAL_PHASE_PROGRAM, count, true);
+		}
+
+		if (skip)
+			os_printf("Resuming after %u page(s) already written\n", skip);
+
+		page += skip;
+		count -= skip;
+	}
+
 	total_size = (uint64_t)opdata->page_size * count;
 
 	if (part->base_block && page) {
@@ -1064,13 +1843,11 @@ ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_dat
 
 	print_rwe_status(rwedata, true, false);
 
-	if (!os_set_file_mapping_offset(fm, 0, (void **)&map_base)) {
-		os_fprintf(stderr, "Failed to adjust file mapping\n");
-		return UFP_FAIL;
-	}
+	map_offset = (uint64_t)opdata->page_size * skip;
 
-	map_offset = os_get_file_mapping_offset(fm);
-	map_size = os_get_file_mapping_size(fm);
+	ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+	if (ret)
+		return ret;
 
 	memset(&ftlcb, 0, sizeof(ftlcb));
 	nand_progressbar_init(&ftlcb.prog, count);
@@ -1078,10 +1855,17 @@ ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_dat
 	ftlcb.cb.post = nand_ftl_write_post_cb;
 	ftlcb.cb.buffer = opdata->buf[0];
 	ftlcb.nandinst = nandinst;
+	ftlcb.page = page;
 	ftlcb.rwedata = rwedata;
 	ftlcb.opdata = opdata;
 	ftlcb.last_page_padding = last_page_padding;
 	ftlcb.count_left = count;
+	ftlcb.journal_base = skip;
+
+	if (rwedata->verify) {
+		ftlcb.cb.verify = nand_ftl_write_verify_cb;
+		ftlcb.cb.verify_buffer = opdata->vbuf;
+	}
 
 	t0 = os_get_timer_us();
 
@@ -1116,19 +1900,9 @@ ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_dat
 		/* Move file mapping */
 		map_offset += (size_t)opdata->page_size * num_to_write;
 
-		if (!os_set_file_mapping_offset(fm, map_offset, (void **)&map_base)) {
-			os_fprintf(stderr, "Failed to adjust file mapping\n");
-			ret = UFP_FAIL;
+		ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+		if (ret)
 			break;
-		}
-
-		real_map_offset = os_get_file_mapping_offset(fm);
-		map_size = os_get_file_mapping_size(fm);
-
-		if (real_map_offset < map_offset) {
-			map_size -= map_offset - real_map_offset;
-			map_base += map_offset - real_map_offset;
-		}
 	}
 
 	if (!ret) {
@@ -1147,68 +1921,6 @@ ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_dat
 	return ret;
 }
 
-static bool nand_verify_page(struct ufnand_op_data *opdata, const uint8_t *buf, const uint8_t *gold, uint32_t page,
-			     uint32_t verify_len)
-{
-	bool check;
-	uint32_t i;
-
-	for (i = 0; i < verify_len; i++) {
-		switch (opdata->map[i]) {
-		case NAND_PAGE_BYTE_DATA:
-		case NAND_PAGE_BYTE_OOB_DATA:
-		case NAND_PAGE_BYTE_OOB_FREE:
-			check = true;
-			break;
-
-		default:
-			check = false;
-		}
-
-		if (check && buf[i] != gold[i]) {
-			os_fprintf(stderr, "Page %u data at 0x%x are different: expect 0x%02x, got 0x%02x\n",
-				   page, i, gold[i], buf[i]);
-			return false;
-		}
-	}
-
-	return true;
-}
-
-static ufprog_status nand_verify_buf(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
-				     const uint8_t *buf, const uint8_t *gold, uint32_t page, uint32_t count,
-				     uint32_t verify_len, bool fmt)
-{
-	ufprog_status ret;
-	const uint8_t *p;
-	uint32_t i;
-	bool rc;
-
-	for (i = 0; i < count; i++) {
-		if (fmt) {
-			ret = ufprog_nand_convert_page_format(nandinst->chip, buf, opdata->buf[1], false);
-			if (ret) {
-				os_fprintf(stderr, "Failed to convert page data\n");
-				return ret;
-			}
-
-			p = opdata->buf[1];
-		} else {
-			p = buf;
-		}
-
-
-		rc = nand_verify_page(opdata, p, gold, page, verify_len);
-		if (!rc)
-			return UFP_FAIL;
-
-		gold += opdata->page_size;
-		buf += nandinst->info.maux.oob_page_size;
-	}
-
-	return UFP_OK;
-}
-
 static ufprog_status nand_ftl_verify_post_cb(struct ufprog_ftl_callback *cb, uint32_t actual_count)
 {
 	struct ufnand_ftl_callback *ftlcb = container_of(cb, struct ufnand_ftl_callback, cb);
@@ -1243,11 +1955,11 @@ static ufprog_status nand_ftl_verify_post_cb(struct ufprog_ftl_callback *cb, uin
 	return UFP_OK;
 }
 
-ufprog_status nand_verify(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
-			  const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
-			  uint32_t page, uint32_t count, uint32_t last_page_padding)
+static ufprog_status nand_verify_at(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+				    const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
+				    uint32_t map_page, uint32_t page, uint32_t count, uint32_t last_page_padding)
 {
-	uint64_t total_size, map_offset, real_map_offset, t0, t1;
+	uint64_t total_size, map_offset, t0, t1;
 	uint32_t real_page, num_to_read, retnum;
 	struct ufnand_ftl_callback ftlcb;
 	ufprog_status ret = UFP_OK;
@@ -1267,13 +1979,11 @@ ufprog_status nand_verify(struct ufnand_instance *nandinst, struct ufnand_rwe_da
 
 	print_rwe_status(rwedata, true, false);
 
-	if (!os_set_file_mapping_offset(fm, 0, (void **)&map_base)) {
-		os_fprintf(stderr, "Failed to adjust file mapping\n");
-		return UFP_FAIL;
-	}
+	map_offset = (uint64_t)opdata->page_size * map_page;
 
-	map_offset = os_get_file_mapping_offset(fm);
-	map_size = os_get_file_mapping_size(fm);
+	ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+	if (ret)
+		return ret;
 
 	memset(&ftlcb, 0, sizeof(ftlcb));
 	nand_progressbar_init(&ftlcb.prog, count);
@@ -1319,19 +2029,9 @@ ufprog_status nand_verify(struct ufnand_instance *nandinst, struct ufnand_rwe_da
 		/* Move file mapping */
 		map_offset += (size_t)opdata->page_size * num_to_read;
 
-		if (!os_set_file_mapping_offset(fm, map_offset, (void **)&map_base)) {
-			os_fprintf(stderr, "Failed to adjust file mapping\n");
-			ret = UFP_FAIL;
+		ret = nand_map_file(fm, map_offset, &map_base, &map_size);
+		if (ret)
 			break;
-		}
-
-		real_map_offset = os_get_file_mapping_offset(fm);
-		map_size = os_get_file_mapping_size(fm);
-
-		if (real_map_offset < map_offset) {
-			map_size -= map_offset - real_map_offset;
-			map_base += map_offset - real_map_offset;
-		}
 	}
 
 	if (!ret) {
@@ -1356,13 +2056,15 @@ static ufprog_status nand_ftl_erase_post_cb(struct ufprog_ftl_callback *cb, uint
 
 	nand_progressbar_cb(&ftlcb->prog, actual_count);
 
-	return UFP_OK;
+	return journal_checkpoint(ftlcb->nandinst, NAND_JOURNAL_PHASE_ERASE, ftlcb->journal_base + ftlcb->prog.current,
+				  false);
 }
 
 ufprog_status nand_erase(struct ufnand_instance *nandinst, const struct ufprog_ftl_part *part, uint32_t page,
 			 uint32_t count, bool nospread)
 {
-	uint32_t real_block, block, block_count, end, retcnt;
+	uint32_t real_block, block, block_count, end, retcnt, skip = 0;
+	struct ufnand_journal *j = nandinst->journal;
 	struct ufnand_ftl_callback ftlcb;
 	uint64_t total_size, t0, t1;
 	ufprog_status ret;
@@ -1371,6 +2073,23 @@ ufprog_status nand_erase(struct ufnand_instance *nandinst, const struct ufprog_f
 	end = (page + count + nandinst->info.memorg.pages_per_block - 1) >> nandinst->info.maux.pages_per_block_shift;
 	block_count = end - block;
 
+	if (j) {
+		if (journal_done(nandinst))
+			return UFP_OK;
+
+		/* Erasing is idempotent, simply continue from the last recorded block */
+		if (j->phase == NAND_JOURNAL_PHASE_ERASE && j->pos) {
+			skip = j->pos < block_count ? (uint32_t)j->pos : block_count;
+			os_printf("Resuming after %u block(s) already erased\n", skip);
+
+			if (skip == block_count)
+				return UFP_OK;
+
+			block += skip;
+			block_count -= skip;
+		}
+	}
+
 	total_size = (uint64_t)nandinst->info.maux.block_size * block_count;
 
 	if (part->base_block && block) {
@@ -1385,6 +2104,8 @@ ufprog_status nand_erase(struct ufnand_instance *nandinst, const struct ufprog_f
 	memset(&ftlcb, 0, sizeof(ftlcb));
 	nand_progressbar_init(&ftlcb.prog, block_count);
 	ftlcb.cb.post = nand_ftl_erase_post_cb;
+	ftlcb.nandinst = nandinst;
+	ftlcb.journal_base = skip;
 
 	t0 = os_get_timer_us();
 
@@ -15,6 +15,7 @@
 #include <ufprog/log.h>
 #include <ufprog/cmdarg.h>
 #include <ufprog/progbar.h>
+#include <ufprog/sha256.h>
 #include <ufprog/spi.h>
 #include <ufprog/spi-nand.h>
 #include <ufprog/ecc.h>
@@ -23,11 +24,23 @@
 #include <ufprog/bbt-ram.h>
 #include <ufprog/ftl-basic.h>
 #include <ufprog/ftl-driver.h>
+#include <ufprog/journal.h>
 
 #define UFSNAND_MAX_SPEED				80000000
 
+#define UFSNAND_CALIBRATION_KEY_LEN			128
+
+#define UFNAND_JOURNAL_UID_MAX_LEN			32
+
+enum ufnand_journal_phase {
+	NAND_JOURNAL_PHASE_ERASE,
+	NAND_JOURNAL_PHASE_PROGRAM,
+	NAND_JOURNAL_PHASE_READ,
+};
+
 struct ufsnand_options {
 	uint32_t log_level;
+	ufprog_bool async_log;
 	char *last_device;
 	uint32_t global_max_speed;
 	uint32_t max_speed;
@@ -39,6 +52,15 @@ struct ufnand_progress_status {
 	uint32_t last_percentage;
 };
 
+/* Erase positions are in blocks, read/program positions are in pages. Both are relative to the start. */
+struct ufnand_journal {
+	struct ufprog_journal *jnl;
+	uint32_t phase;
+	uint64_t pos;
+	uint32_t page;
+	uint32_t count;
+};
+
 struct ufnand_instance {
 	struct nand_chip *chip;
 	struct ufprog_nand_bbt *bbt;
@@ -46,15 +68,33 @@ struct ufnand_instance {
 	struct nand_info info;
 	uint64_t ftl_size;
 	bool bbt_used;
+	struct ufnand_journal *journal;
 };
 
+/* Page fill flags and compared byte types for writing pages from file and verifying them */
+#define NAND_WRITE_FILL_FLAGS		(PAGE_FILL_F_FILL_NON_DATA_FF | PAGE_FILL_F_FILL_OOB | \
+					 PAGE_FILL_F_FILL_UNPROTECTED_OOB | PAGE_FILL_F_SRC_SKIP_NON_DATA)
+#define NAND_VERIFY_BYTE_TYPES		(BIT(NAND_PAGE_BYTE_DATA) | BIT(NAND_PAGE_BYTE_OOB_DATA) | \
+					 BIT(NAND_PAGE_BYTE_OOB_FREE))
+
 struct ufnand_op_data {
 	const struct nand_page_layout *layout;
 	bool layout_needs_free;
+	struct nand_page_layout_prog *prog;
 	uint32_t page_size;
 	uint8_t *buf[2];
-	uint8_t *map;
 	uint8_t *tmp;
+	uint8_t *vbuf;
+};
+
+struct ufnand_digest {
+	uint32_t crc32;
+	struct sha256_context sha256;
+
+	bool check_crc32;
+	bool check_sha256;
+	uint32_t expected_crc32;
+	uint8_t expected_sha256[SHA256_DIGEST_SIZE];
 };
 
 struct ufnand_rwe_data {
@@ -66,11 +106,18 @@ struct ufnand_rwe_data {
 	ufprog_bool raw;
 	ufprog_bool oob;
 	ufprog_bool fmt;
+	ufprog_bool digest;
+	char *crc32;
+	char *sha256;
+	char *journal;
+	ufprog_bool resume;
+	struct ufnand_digest *dg;
 };
 
 struct ufsnand_instance {
 	struct ufnand_instance nand;
 
+	const char *device_name;
 	struct ufprog_spi *spi;
 	struct spi_nand *snand;
 	struct ufprog_nand_ecc_chip *ecc;
@@ -90,6 +137,7 @@ struct ufnand_ftl_callback {
 		const uint8_t *tx;
 	} buf;
 	uint32_t page;
+	uint32_t journal_base;
 
 	bool last_batch;
 	uint32_t last_page_padding;
@@ -100,6 +148,20 @@ bool parse_args(struct cmdarg_entry *entries, uint32_t count, int argc, char *ar
 
 ufprog_status load_config(struct ufsnand_options *retcfg, const char *curr_device);
 ufprog_status save_config(const struct ufsnand_options *cfg);
+ufprog_status load_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t *rethz);
+ufprog_status save_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t hz);
+
+bool digest_init(struct ufnand_digest *dg, const char *crc32_str, const char *sha256_str);
+void digest_update(struct ufnand_digest *dg, const void *data, size_t len);
+ufprog_status digest_finish(struct ufnand_digest *dg);
+
+ufprog_status journal_open(struct ufnand_instance *nandinst, const char *path, enum ufprog_journal_op op,
+			   const struct ufnand_rwe_data *rwedata, uint32_t page, uint32_t count, file_mapping fm,
+			   uint64_t image_size, bool resume, struct ufnand_journal *retjnl);
+ufprog_status journal_checkpoint(struct ufnand_instance *nandinst, uint32_t phase, uint64_t pos, bool force);
+bool journal_done(struct ufnand_instance *nandinst);
+ufprog_status journal_finish(struct ufnand_instance *nandinst);
+void journal_close(struct ufnand_journal *jnl);
 
 ufprog_status open_device(const char *device_name, const char *part, uint32_t max_speed,
 			  struct ufsnand_instance *retinst, bool list_only);
@@ -122,14 +184,13 @@ ufprog_status nand_dump(struct ufnand_instance *nandinst, struct ufnand_rwe_data
 			const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, uint32_t page,
 			uint32_t count);
 
+ufprog_status nand_dump_range(struct ufnand_instance *nandinst, uint32_t page, uint32_t count, uint32_t column,
+			      uint32_t len, bool raw);
+
 ufprog_status nand_write(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
 			 const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
 			 uint32_t page, uint32_t count, uint32_t last_page_padding);
 
-ufprog_status nand_verify(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
-			  const struct ufprog_ftl_part *part, struct ufnand_op_data *opdata, file_mapping fm,
-			  uint32_t page, uint32_t count, uint32_t last_page_padding);
-
 ufprog_status nand_erase(struct ufnand_instance *nandinst, const struct ufprog_ftl_part *part, uint32_t page,
 			 uint32_t count, bool nospread);
 
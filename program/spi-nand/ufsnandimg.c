@@ -0,0 +1,926 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * SPI-NAND offline production image builder
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ufprog/dirs.h>
+#include <ufprog/misc.h>
+#include <ufprog/sizes.h>
+#include <ufprog/osdef.h>
+#include "ufsnand-common.h"
+
+#define NAND_IMG_DFL_WORKERS			4
+#define NAND_IMG_MAX_WORKERS			32
+#define NAND_IMG_BLOCKS_PER_WORKER		4
+
+struct nand_img_part {
+	const char *name;
+	const char *file;
+	uint32_t block;
+	uint32_t count;
+	file_handle fh;
+	uint64_t left;
+};
+
+struct nand_img_block {
+	uint32_t data_pages;
+	bool bad;
+};
+
+struct nand_img_data;
+
+struct nand_img_worker {
+	struct nand_img_data *nid;
+	struct ufprog_nand_ecc_chip *ecc;
+	thread_handle thread;
+	event_handle start;
+	event_handle done;
+	volatile bool stop;
+	uint8_t *tmp;
+
+	/* Job description, owned by the worker between start and done */
+	uint32_t first;
+	uint32_t count;
+	bool busy;
+	ufprog_status ret;
+};
+
+struct nand_img_data {
+	uint32_t page_size;
+	uint32_t oob_size;
+	uint32_t pages_per_block;
+	uint32_t block_count;
+	uint32_t oob_page_size;
+	size_t block_data_size;
+	size_t oob_block_size;
+
+	struct ufprog_nand_ecc_chip *ecc;
+	const struct nand_page_layout *layout;
+	struct nand_page_layout_prog *prog;
+	struct nand_bbm_config bbmcfg;
+	bool canonical;
+	bool *bad;
+
+	char *partmap;
+	struct nand_img_part *parts;
+	uint32_t num_parts;
+
+	/* Blocks being generated in one round */
+	struct nand_img_block *blocks;
+	uint32_t group_blocks;
+	uint8_t *src;
+	uint8_t *out;
+
+	struct nand_img_worker *workers;
+	uint32_t num_workers;
+};
+
+static struct ufsnand_options configs;
+
+static const char usage[] =
+	"Usage:\n"
+	"    %s ecc=<ecccfg> page=<size> oob=<size> ppb=<n> blocks=<n>\n"
+	"       [bad=<n>[,<n>...]] [threads=<n>] in=<file>|parts=<partmap> out=<file>\n"
+	"       [skip=<file>]\n"
+	"\n"
+	"Options:\n"
+	"        ecc     - Specify the ECC engine used by the target controller.\n"
+	"                  Its value can be one of the following type:\n"
+	"                    <ecc-plugin>: Use specified ECC engine plugin\n"
+	"                    <ecc-plugin>,<config>: Use specified ECC engine plugin with\n"
+	"                                           configuration file\n"
+	"        page    - Page size of the target flash, not including OOB.\n"
+	"        oob     - OOB size of the target flash.\n"
+	"        ppb     - Pages per block of the target flash.\n"
+	"        blocks  - Total number of blocks of the target flash.\n"
+	"        bad     - Known bad blocks of the target flash. Images skip over these\n"
+	"                  blocks, and bad block markers are written to them.\n"
+	"        threads - Number of worker threads used for ECC encoding. Default is %u.\n"
+	"        in      - Logical image to be placed from the beginning of the flash.\n"
+	"        parts   - Partition map file. Each line describes one partition:\n"
+	"                    <name> <offset> <size> [<image>]\n"
+	"                  Offset and size must be aligned to block boundary.\n"
+	"                  Partitions without image are left erased.\n"
+	"                  Empty lines and lines starting with '#' are ignored.\n"
+	"        out     - Output raw image containing data, OOB and ECC parity of\n"
+	"                  every page of the target flash.\n"
+	"        skip    - Output skip table listing known bad blocks, one block index\n"
+	"                  per line.\n"
+	"\n"
+	"Images are laid out in the same way as writing through ufsnandprog with basic\n"
+	"FTL. Pages not covered by any image are left erased without ECC parity.\n";
+
+static void show_usage(void)
+{
+	os_printf(usage, os_prog_name(), NAND_IMG_DFL_WORKERS);
+}
+
+static ufprog_status nand_img_encode_page(struct nand_img_worker *w, uint8_t *dst, const uint8_t *src)
+{
+	struct nand_img_data *nid = w->nid;
+	ufprog_status ret;
+
+	if (!nid->canonical) {
+		ufprog_nand_fill_page_by_prog(nid->prog, dst, src, nid->oob_page_size);
+	} else {
+		ufprog_nand_fill_page_by_prog(nid->prog, w->tmp, src, nid->oob_page_size);
+
+		ret = ufprog_ecc_convert_page_layout(w->ecc, w->tmp, dst, true);
+		if (ret) {
+			os_fprintf(stderr, "Failed to convert page layout\n");
+			return ret;
+		}
+	}
+
+	ret = ufprog_ecc_encode_page(w->ecc, dst);
+	if (ret)
+		os_fprintf(stderr, "Failed to encode page\n");
+
+	return ret;
+}
+
+/* Same bad block marker as ufprog_nand_write_bbm() on a chip with 8-bit bus */
+static ufprog_status nand_img_mark_bad(struct nand_img_worker *w, uint8_t *blk)
+{
+	struct nand_img_data *nid = w->nid;
+	const struct nand_bbm_config *bbmcfg = &nid->bbmcfg;
+	uint32_t i, j, bytes;
+	uint8_t *page, *buf;
+	ufprog_status ret;
+
+	memset(blk, 0xff, nid->oob_block_size);
+
+	bytes = bbmcfg->mark.bytes;
+	if (!bytes)
+		bytes = 1;
+
+	for (i = 0; i < bbmcfg->pages.num; i++) {
+		page = blk + (size_t)bbmcfg->pages.idx[i] * nid->oob_page_size;
+
+		if ((bbmcfg->flags & ECC_F_BBM_CANONICAL_LAYOUT) && nid->canonical)
+			buf = w->tmp;
+		else
+			buf = page;
+
+		if (bbmcfg->flags & ECC_F_BBM_MARK_WHOLE_PAGE) {
+			memset(buf, 0, nid->oob_page_size);
+		} else {
+			memset(buf, 0xff, nid->oob_page_size);
+
+			for (j = 0; j < bbmcfg->mark.num; j++)
+				memset(buf + bbmcfg->mark.pos[j], 0, bytes);
+		}
+
+		if (buf != page) {
+			ret = ufprog_ecc_convert_page_layout(w->ecc, buf, page, true);
+			if (ret) {
+				os_fprintf(stderr, "Failed to convert page layout\n");
+				return ret;
+			}
+		}
+
+		if (!(bbmcfg->flags & ECC_F_BBM_RAW)) {
+			ret = ufprog_ecc_encode_page(w->ecc, page);
+			if (ret) {
+				os_fprintf(stderr, "Failed to encode page\n");
+				return ret;
+			}
+		}
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_img_run_job(struct nand_img_worker *w)
+{
+	struct nand_img_data *nid = w->nid;
+	const struct nand_img_block *blk;
+	const uint8_t *src;
+	ufprog_status ret;
+	uint32_t i, j;
+	uint8_t *out;
+
+	for (i = w->first; i < w->first + w->count; i++) {
+		blk = &nid->blocks[i];
+		src = nid->src + i * nid->block_data_size;
+		out = nid->out + i * nid->oob_block_size;
+
+		if (blk->bad) {
+			ret = nand_img_mark_bad(w, out);
+			if (ret)
+				return ret;
+
+			continue;
+		}
+
+		for (j = 0; j < blk->data_pages; j++) {
+			ret = nand_img_encode_page(w, out, src);
+			if (ret)
+				return ret;
+
+			src += nid->page_size;
+			out += nid->oob_page_size;
+		}
+
+		memset(out, 0xff, (size_t)(nid->pages_per_block - j) * nid->oob_page_size);
+	}
+
+	return UFP_OK;
+}
+
+static void UFPROG_API nand_img_worker_thread(void *priv)
+{
+	struct nand_img_worker *w = priv;
+
+	while (true) {
+		os_wait_event(w->start, OS_WAIT_INFINITE);
+
+		if (w->stop)
+			break;
+
+		w->ret = nand_img_run_job(w);
+
+		os_set_event(w->done);
+	}
+}
+
+static void nand_img_stop_workers(struct nand_img_data *nid)
+{
+	struct nand_img_worker *w;
+	uint32_t i;
+
+	if (!nid->workers)
+		return;
+
+	for (i = 0; i < nid->num_workers; i++) {
+		w = &nid->workers[i];
+
+		if (w->thread) {
+			w->stop = true;
+			os_set_event(w->start);
+			os_join_thread(w->thread);
+		}
+
+		if (w->start)
+			os_free_event(w->start);
+
+		if (w->done)
+			os_free_event(w->done);
+
+		if (w->ecc)
+			ufprog_ecc_free_chip(w->ecc);
+
+		if (w->tmp)
+			free(w->tmp);
+	}
+
+	free(nid->workers);
+	nid->workers = NULL;
+}
+
+static ufprog_status nand_img_start_workers(struct nand_img_data *nid, const char *ecc_cfg, uint32_t num)
+{
+	struct nand_img_worker *w;
+	uint32_t i;
+
+	nid->workers = calloc(num, sizeof(*nid->workers));
+	if (!nid->workers) {
+		os_fprintf(stderr, "No memory for image workers\n");
+		return UFP_NOMEM;
+	}
+
+	nid->num_workers = num;
+
+	for (i = 0; i < num; i++) {
+		w = &nid->workers[i];
+		w->nid = nid;
+
+		/* ECC engine instances may keep per-page state, so each worker owns one */
+		if (open_ecc_chip(ecc_cfg, nid->page_size, nid->oob_size, &w->ecc) || !w->ecc)
+			goto cleanup;
+
+		w->tmp = malloc(nid->oob_page_size);
+		if (!w->tmp) {
+			os_fprintf(stderr, "No memory for image worker buffer\n");
+			goto cleanup;
+		}
+
+		if (!os_create_event(&w->start) || !os_create_event(&w->done)) {
+			os_fprintf(stderr, "Failed to create event for image worker\n");
+			goto cleanup;
+		}
+
+		if (!os_create_thread(&w->thread, nand_img_worker_thread, w)) {
+			os_fprintf(stderr, "Failed to create image worker thread\n");
+			goto cleanup;
+		}
+	}
+
+	return UFP_OK;
+
+cleanup:
+	nand_img_stop_workers(nid);
+
+	return UFP_FAIL;
+}
+
+/* Split @count blocks of current round among all workers, and wait for all of them */
+static ufprog_status nand_img_run_workers(struct nand_img_data *nid, uint32_t count)
+{
+	uint32_t i, first = 0, n, per = (count + nid->num_workers - 1) / nid->num_workers;
+	ufprog_status ret = UFP_OK;
+	struct nand_img_worker *w;
+
+	for (i = 0; i < nid->num_workers; i++) {
+		w = &nid->workers[i];
+
+		n = count - first;
+		if (n > per)
+			n = per;
+
+		if (!n) {
+			w->busy = false;
+			continue;
+		}
+
+		w->first = first;
+		w->count = n;
+		w->ret = UFP_OK;
+		w->busy = true;
+
+		os_set_event(w->start);
+
+		first += n;
+	}
+
+	for (i = 0; i < nid->num_workers; i++) {
+		w = &nid->workers[i];
+
+		if (!w->busy)
+			continue;
+
+		os_wait_event(w->done, OS_WAIT_INFINITE);
+		w->busy = false;
+
+		if (w->ret && !ret)
+			ret = w->ret;
+	}
+
+	return ret;
+}
+
+static ufprog_status nand_img_parse_bad_blocks(struct nand_img_data *nid, const char *list)
+{
+	const char *p = list;
+	unsigned long block;
+	char *end;
+
+	while (*p) {
+		block = strtoul(p, &end, 0);
+		if (end == p || (*end && *end != ',')) {
+			os_fprintf(stderr, "Invalid bad block list\n");
+			return UFP_INVALID_PARAMETER;
+		}
+
+		if (block >= nid->block_count) {
+			os_fprintf(stderr, "Bad block %lu is out of range\n", block);
+			return UFP_INVALID_PARAMETER;
+		}
+
+		nid->bad[block] = true;
+
+		p = *end ? end + 1 : end;
+	}
+
+	return UFP_OK;
+}
+
+static char *nand_img_next_token(char **str)
+{
+	char *p = *str, *tok;
+
+	while (*p == ' ' || *p == '\t' || *p == '\r')
+		p++;
+
+	if (!*p) {
+		*str = p;
+		return NULL;
+	}
+
+	tok = p;
+
+	while (*p && *p != ' ' && *p != '\t' && *p != '\r')
+		p++;
+
+	if (*p)
+		*p++ = 0;
+
+	*str = p;
+
+	return tok;
+}
+
+static int nand_img_part_cmp(const void *a, const void *b)
+{
+	const struct nand_img_part *pa = a, *pb = b;
+
+	if (pa->block < pb->block)
+		return -1;
+
+	if (pa->block > pb->block)
+		return 1;
+
+	return 0;
+}
+
+static ufprog_status nand_img_add_part(struct nand_img_data *nid, const char *name, uint64_t offset, uint64_t size,
+				       const char *file)
+{
+	uint64_t block_size = (uint64_t)nid->block_data_size, flash_size = block_size * nid->block_count;
+	struct nand_img_part *parts, *part;
+
+	if (offset % block_size || size % block_size || !size) {
+		os_fprintf(stderr, "Partition '%s' is not aligned to block boundary\n", name);
+		return UFP_INVALID_PARAMETER;
+	}
+
+	if (offset >= flash_size || size > flash_size - offset) {
+		os_fprintf(stderr, "Partition '%s' exceeds flash size\n", name);
+		return UFP_INVALID_PARAMETER;
+	}
+
+	parts = realloc(nid->parts, (nid->num_parts + 1) * sizeof(*parts));
+	if (!parts) {
+		os_fprintf(stderr, "No memory for partition list\n");
+		return UFP_NOMEM;
+	}
+
+	nid->parts = parts;
+
+	part = &parts[nid->num_parts++];
+	memset(part, 0, sizeof(*part));
+	part->name = name;
+	part->file = file;
+	part->block = (uint32_t)(offset / block_size);
+	part->count = (uint32_t)(size / block_size);
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_img_load_part_map(struct nand_img_data *nid, const char *path)
+{
+	char *line, *next, *p, *name, *offstr, *sizestr, *file, *end;
+	uint64_t offset, size;
+	uint32_t lineno = 0;
+	ufprog_status ret;
+
+	ret = os_read_text_file(path, &nid->partmap, NULL);
+	if (ret) {
+		os_fprintf(stderr, "Failed to read partition map '%s'\n", path);
+		return ret;
+	}
+
+	for (line = nid->partmap; line; line = next) {
+		lineno++;
+
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = 0;
+
+		p = line;
+
+		name = nand_img_next_token(&p);
+		if (!name || *name == '#')
+			continue;
+
+		offstr = nand_img_next_token(&p);
+		sizestr = nand_img_next_token(&p);
+		file = nand_img_next_token(&p);
+
+		if (!offstr || !sizestr || nand_img_next_token(&p)) {
+			os_fprintf(stderr, "Invalid partition definition at line %u\n", lineno);
+			return UFP_FAIL;
+		}
+
+		offset = strtoull(offstr, &end, 0);
+		if (*end) {
+			os_fprintf(stderr, "Invalid partition offset at line %u\n", lineno);
+			return UFP_FAIL;
+		}
+
+		size = strtoull(sizestr, &end, 0);
+		if (*end) {
+			os_fprintf(stderr, "Invalid partition size at line %u\n", lineno);
+			return UFP_FAIL;
+		}
+
+		STATUS_CHECK_RET(nand_img_add_part(nid, name, offset, size, file));
+	}
+
+	if (!nid->num_parts) {
+		os_fprintf(stderr, "No partition defined in partition map\n");
+		return UFP_FAIL;
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_img_prepare_parts(struct nand_img_data *nid)
+{
+	uint32_t i, j, good;
+	struct nand_img_part *part;
+	uint64_t size, cap;
+	ufprog_status ret;
+
+	qsort(nid->parts, nid->num_parts, sizeof(*nid->parts), nand_img_part_cmp);
+
+	for (i = 0; i < nid->num_parts; i++) {
+		part = &nid->parts[i];
+
+		if (i && part->block < nid->parts[i - 1].block + nid->parts[i - 1].count) {
+			os_fprintf(stderr, "Partition '%s' overlaps with partition '%s'\n", part->name,
+				   nid->parts[i - 1].name);
+			return UFP_INVALID_PARAMETER;
+		}
+
+		for (j = 0, good = 0; j < part->count; j++) {
+			if (!nid->bad[part->block + j])
+				good++;
+		}
+
+		os_printf("%-16s 0x%09" PRIx64 " - 0x%09" PRIx64 " %s\n", part->name,
+			  (uint64_t)part->block * nid->block_data_size,
+			  (uint64_t)(part->block + part->count) * nid->block_data_size,
+			  part->file ? part->file : "<empty>");
+
+		if (!part->file)
+			continue;
+
+		ret = os_open_file(part->file, true, false, false, false, &part->fh);
+		if (ret) {
+			os_fprintf(stderr, "Failed to open image '%s'\n", part->file);
+			return ret;
+		}
+
+		if (!os_get_file_size(part->fh, &size)) {
+			os_fprintf(stderr, "Failed to get size of image '%s'\n", part->file);
+			return UFP_FILE_READ_FAILURE;
+		}
+
+		cap = (uint64_t)good * nid->block_data_size;
+
+		if (size > cap) {
+			os_fprintf(stderr, "Image '%s' is too large for partition '%s' with %u bad block(s)\n",
+				   part->file, part->name, part->count - good);
+			return UFP_FAIL;
+		}
+
+		part->left = size;
+	}
+
+	os_printf("\n");
+
+	return UFP_OK;
+}
+
+static void nand_img_close_parts(struct nand_img_data *nid)
+{
+	uint32_t i;
+
+	for (i = 0; i < nid->num_parts; i++) {
+		if (nid->parts[i].fh)
+			os_close_file(nid->parts[i].fh);
+	}
+
+	free(nid->parts);
+	nid->parts = NULL;
+	nid->num_parts = 0;
+}
+
+static struct nand_img_part *nand_img_find_part(struct nand_img_data *nid, uint32_t block)
+{
+	uint32_t i;
+
+	for (i = 0; i < nid->num_parts; i++) {
+		if (block >= nid->parts[i].block && block < nid->parts[i].block + nid->parts[i].count)
+			return &nid->parts[i];
+	}
+
+	return NULL;
+}
+
+static ufprog_status nand_img_load_block(struct nand_img_data *nid, uint32_t block, struct nand_img_block *blk,
+					 uint8_t *src)
+{
+	struct nand_img_part *part;
+	size_t len, padded;
+
+	blk->bad = nid->bad[block];
+	blk->data_pages = 0;
+
+	if (blk->bad)
+		return UFP_OK;
+
+	part = nand_img_find_part(nid, block);
+	if (!part || !part->left)
+		return UFP_OK;
+
+	len = nid->block_data_size;
+	if (len > part->left)
+		len = (size_t)part->left;
+
+	if (!os_read_file(part->fh, len, src, NULL)) {
+		os_fprintf(stderr, "Failed to read image '%s'\n", part->file);
+		return UFP_FILE_READ_FAILURE;
+	}
+
+	part->left -= len;
+
+	blk->data_pages = (uint32_t)((len + nid->page_size - 1) / nid->page_size);
+
+	/* Last page is padded with 0xff, same as writing to flash */
+	padded = (size_t)blk->data_pages * nid->page_size;
+	if (padded > len)
+		memset(src + len, 0xff, padded - len);
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_img_generate(struct nand_img_data *nid, const char *outfile)
+{
+	uint32_t block, i, n, percentage, last_percentage = 0;
+	ufprog_status ret;
+	file_handle fh;
+	uint64_t t0, t1;
+
+	ret = os_open_file(outfile, false, true, true, true, &fh);
+	if (ret) {
+		os_fprintf(stderr, "Failed to create output image '%s'\n", outfile);
+		return ret;
+	}
+
+	progress_init();
+
+	t0 = os_get_timer_us();
+
+	for (block = 0; block < nid->block_count; block += n) {
+		n = nid->block_count - block;
+		if (n > nid->group_blocks)
+			n = nid->group_blocks;
+
+		for (i = 0; i < n; i++) {
+			ret = nand_img_load_block(nid, block + i, &nid->blocks[i], nid->src + i * nid->block_data_size);
+			if (ret)
+				goto out;
+		}
+
+		ret = nand_img_run_workers(nid, n);
+		if (ret) {
+			os_fprintf(stderr, "Failed to generate block %u\n", block);
+			goto out;
+		}
+
+		if (!os_write_file(fh, n * nid->oob_block_size, nid->out, NULL)) {
+			os_fprintf(stderr, "Failed to write output image\n");
+			ret = UFP_FILE_WRITE_FAILURE;
+			goto out;
+		}
+
+		percentage = (uint32_t)(((block + n) * 100ULL) / nid->block_count);
+		if (percentage > last_percentage) {
+			last_percentage = percentage;
+			progress_show(last_percentage);
+		}
+	}
+
+	t1 = os_get_timer_us();
+
+	progress_done();
+	print_speed((uint64_t)nid->block_count * nid->oob_block_size, t1 - t0);
+
+out:
+	os_close_file(fh);
+
+	return ret;
+}
+
+static ufprog_status nand_img_write_skip_table(struct nand_img_data *nid, const char *path)
+{
+	ufprog_status ret = UFP_OK;
+	file_handle fh;
+	char line[16];
+	uint32_t i;
+	int len;
+
+	ret = os_open_file(path, false, true, true, true, &fh);
+	if (ret) {
+		os_fprintf(stderr, "Failed to create skip table '%s'\n", path);
+		return ret;
+	}
+
+	for (i = 0; i < nid->block_count; i++) {
+		if (!nid->bad[i])
+			continue;
+
+		len = snprintf(line, sizeof(line), "%u\n", i);
+
+		if (!os_write_file(fh, len, line, NULL)) {
+			os_fprintf(stderr, "Failed to write skip table\n");
+			ret = UFP_FILE_WRITE_FAILURE;
+			break;
+		}
+	}
+
+	os_close_file(fh);
+
+	return ret;
+}
+
+static int nand_img_build(struct nand_img_data *nid, const char *ecc_cfg, const char *bad, const char *infile,
+			  const char *partmap, const char *outfile, const char *skipfile, uint32_t threads)
+{
+	int exitcode = 1;
+	ufprog_status ret;
+	uint32_t i;
+
+	nid->oob_page_size = nid->page_size + nid->oob_size;
+	nid->block_data_size = (size_t)nid->page_size * nid->pages_per_block;
+	nid->oob_block_size = (size_t)nid->oob_page_size * nid->pages_per_block;
+
+	nid->bad = calloc(nid->block_count, sizeof(*nid->bad));
+	if (!nid->bad) {
+		os_fprintf(stderr, "No memory for bad block list\n");
+		return 1;
+	}
+
+	if (bad && nand_img_parse_bad_blocks(nid, bad))
+		goto cleanup;
+
+	ret = open_ecc_chip(ecc_cfg, nid->page_size, nid->oob_size, &nid->ecc);
+	if (ret)
+		goto cleanup;
+
+	if (!nid->ecc) {
+		os_fprintf(stderr, "An ECC engine plugin must be specified\n");
+		goto cleanup;
+	}
+
+	ret = ufprog_ecc_get_bbm_config(nid->ecc, &nid->bbmcfg);
+	if (ret) {
+		os_fprintf(stderr, "Failed to get bad block marker config of ECC engine\n");
+		goto cleanup;
+	}
+
+	for (i = 0; i < nid->bbmcfg.pages.num; i++) {
+		if (nid->bbmcfg.pages.idx[i] >= nid->pages_per_block) {
+			os_fprintf(stderr, "Bad block marker page %u is out of block\n", nid->bbmcfg.pages.idx[i]);
+			goto cleanup;
+		}
+	}
+
+	/* Image data are placed in canonical layout if possible, same as what the controller reads back */
+	nid->canonical = ufprog_ecc_support_convert_page_layout(nid->ecc);
+	nid->layout = ufprog_ecc_get_page_layout(nid->ecc, nid->canonical);
+	if (!nid->layout) {
+		os_fprintf(stderr, "ECC engine does not provide page layout\n");
+		goto cleanup;
+	}
+
+	ret = ufprog_nand_compile_page_layout(nid->layout, PAGE_FILL_F_FILL_NON_DATA_FF, 0, &nid->prog);
+	if (ret) {
+		os_fprintf(stderr, "Failed to compile page layout\n");
+		goto cleanup;
+	}
+
+	if (partmap) {
+		if (nand_img_load_part_map(nid, partmap))
+			goto cleanup;
+	} else {
+		if (nand_img_add_part(nid, "image", 0, (uint64_t)nid->block_data_size * nid->block_count, infile))
+			goto cleanup;
+	}
+
+	if (nand_img_prepare_parts(nid))
+		goto cleanup;
+
+	nid->group_blocks = threads * NAND_IMG_BLOCKS_PER_WORKER;
+	if (nid->group_blocks > nid->block_count)
+		nid->group_blocks = nid->block_count;
+
+	nid->blocks = calloc(nid->group_blocks, sizeof(*nid->blocks));
+	nid->src = malloc(nid->group_blocks * (nid->block_data_size + nid->oob_block_size));
+	if (!nid->blocks || !nid->src) {
+		os_fprintf(stderr, "No memory for image buffer\n");
+		goto cleanup;
+	}
+
+	nid->out = nid->src + nid->group_blocks * nid->block_data_size;
+
+	if (nand_img_start_workers(nid, ecc_cfg, threads))
+		goto cleanup;
+
+	ret = nand_img_generate(nid, outfile);
+	if (ret)
+		goto cleanup;
+
+	if (skipfile) {
+		ret = nand_img_write_skip_table(nid, skipfile);
+		if (ret)
+			goto cleanup;
+	}
+
+	exitcode = 0;
+
+cleanup:
+	nand_img_stop_workers(nid);
+	nand_img_close_parts(nid);
+
+	if (nid->prog)
+		ufprog_nand_free_page_layout_prog(nid->prog);
+
+	if (nid->ecc)
+		ufprog_ecc_free_chip(nid->ecc);
+
+	free(nid->src);
+	free(nid->blocks);
+	free(nid->partmap);
+	free(nid->bad);
+
+	return exitcode;
+}
+
+static int ufprog_main(int argc, char *argv[])
+{
+	char *ecc_cfg = NULL, *bad = NULL, *infile = NULL, *partmap = NULL, *outfile = NULL, *skipfile = NULL;
+	uint32_t threads = NAND_IMG_DFL_WORKERS;
+	struct nand_img_data nid;
+	ufprog_status ret;
+	int argp;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_STRING_OPT("ecc", ecc_cfg),
+		CMDARG_U32_OPT("page", nid.page_size),
+		CMDARG_U32_OPT("oob", nid.oob_size),
+		CMDARG_U32_OPT("ppb", nid.pages_per_block),
+		CMDARG_U32_OPT("blocks", nid.block_count),
+		CMDARG_STRING_OPT("bad", bad),
+		CMDARG_U32_OPT("threads", threads),
+		CMDARG_STRING_OPT("in", infile),
+		CMDARG_STRING_OPT("parts", partmap),
+		CMDARG_STRING_OPT("out", outfile),
+		CMDARG_STRING_OPT("skip", skipfile),
+	};
+
+	memset(&nid, 0, sizeof(nid));
+
+	set_os_default_log_print();
+	os_init();
+
+	os_printf("Universal flash programmer for SPI-NAND %s %s\n", UFP_VERSION,
+		  uses_portable_dirs() ? "[Portable]" : "");
+	os_printf("Offline Production Image Builder\n");
+	os_printf("Author: Weijie Gao <hackpascal@gmail.com>\n");
+	os_printf("\n");
+
+	ret = load_config(&configs, NULL);
+	if (ret)
+		return 1;
+
+	set_log_print_level(configs.log_level);
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp)) {
+		show_usage();
+		return 1;
+	}
+
+	if (!ecc_cfg || !nid.page_size || !nid.oob_size || !nid.pages_per_block || !nid.block_count || !outfile ||
+	    !infile == !partmap) {
+		show_usage();
+		return 1;
+	}
+
+	if (!threads)
+		threads = 1;
+	else if (threads > NAND_IMG_MAX_WORKERS)
+		threads = NAND_IMG_MAX_WORKERS;
+
+	os_printf("Geometry: %u + %u bytes/page, %u pages/block, %u blocks\n", nid.page_size, nid.oob_size,
+		  nid.pages_per_block, nid.block_count);
+	os_printf("\n");
+
+	return nand_img_build(&nid, ecc_cfg, bad, infile, partmap, outfile, skipfile, threads);
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t *argv[])
+#else
+int main(int argc, char *argv[])
+#endif
+{
+	return os_main(ufprog_main, argc, argv);
+}
@@ -18,12 +18,39 @@
 
 #define DEFAULT_UID_MAX_LEN				32
 #define NAND_MAX_MAP_SIZE				(512 << 20)
+#define NAND_SCREEN_MAP_BLOCKS_PER_LINE			64
+#define NAND_SCRUB_DEFAULT_THRESHOLD			50
 
 struct ufsnand_otp_instance {
 	struct ufnand_instance *nandinst;
 	uint32_t index;
 };
 
+enum nand_scrub_state {
+	SCRUB_ST_OK,
+	SCRUB_ST_BAD,
+	SCRUB_ST_RESERVED,
+	SCRUB_ST_UNCORRECTABLE,
+	SCRUB_ST_STALE,
+	SCRUB_ST_REFRESHED,
+};
+
+static const char *const nand_scrub_state_names[] = {
+	[SCRUB_ST_OK] = "ok",
+	[SCRUB_ST_BAD] = "bad",
+	[SCRUB_ST_RESERVED] = "reserved",
+	[SCRUB_ST_UNCORRECTABLE] = "uncorrectable",
+	[SCRUB_ST_STALE] = "stale",
+	[SCRUB_ST_REFRESHED] = "refreshed",
+};
+
+struct nand_scrub_data {
+	uint32_t pages_per_block_shift;
+	uint32_t block;
+	uint32_t count;
+	int *bitflips;
+};
+
 static struct ufsnand_options configs;
 static struct ufsnand_instance snand_inst;
 
@@ -71,6 +98,7 @@ static const char usage[] =
 	"\n"
 	"Read/write/erase common options:\n"
 	"    ... [raw] [oob] [fmt] [nospread] [part-base=<base>] [part-size=<size>]\n"
+	"        [journal=<jfile> [resume]]\n"
 	"\n"
 	"        raw  - Turn off ECC engine for read/write. But page data layout\n"
 	"               conversion is still available.\n"
@@ -102,6 +130,11 @@ static const char usage[] =
 	"        part-size - Specify the size of the partition.\n"
 	"               If unspecified, the maximum size from part base will be used.\n"
 	"               The part size must be block size aligned.\n"
+	"        journal - Only for read/write/erase. Record progress into <jfile> so\n"
+	"               that an interrupted operation can be resumed later.\n"
+	"        resume - Continue the operation recorded in <jfile>. The journal must\n"
+	"               match the flash chip, the options, the range and the input\n"
+	"               file. The last completed block is validated before resuming.\n"
 	"\n"
 	"Subcommands:\n"
 	"    list vendors\n"
@@ -120,8 +153,13 @@ static const char usage[] =
 	"    bad\n"
 	"        Scan bad blocks.\n"
 	"\n"
-	"    read [r/w/e options] <file> [<addr> [<size>|count=<n>]]\n"
+	"    read [r/w/e options] [digest] [crc32=<val>] [sha256=<val>] <file>\n"
+	"         [<addr> [<size>|count=<n>]]\n"
 	"        Read flash data to file.\n"
+	"        digest - Calculate and display CRC32 and SHA-256 of data written to\n"
+	"                 file.\n"
+	"        crc32  - Expected CRC32 of data written to file. Implies digest.\n"
+	"        sha256 - Expected SHA-256 of data written to file. Implies digest.\n"
 	"        file  - The file path used to store flash data.\n"
 	"        addr  - The start flash address to read from.\n"
 	"                The value of address must be page size (not including OOB)\n"
@@ -146,11 +184,27 @@ static const char usage[] =
 	"                aligned.\n"
 	"                Default is one page.\n"
 	"        count - Number of pages to be read for dump.\n"
+	"    dump oob [raw] [column=<col>] [len=<len>] [<addr> [<size>|count=<n>]]\n"
+	"        Dump OOB data, or a column range, of each page to stdout, one line\n"
+	"        per page. Lines identical to the previous one are shown as '*'.\n"
+	"        Physical pages are read directly. FTL and part options are not used.\n"
+	"        raw    - Turn off ECC engine. Required unless On-die ECC is used.\n"
+	"        column - The column in page to start dump. Default is the start of\n"
+	"                 OOB.\n"
+	"        len    - Number of bytes to be dumped from each page. Default is up\n"
+	"                 to the end of OOB.\n"
+	"        addr   - The start flash address to be dumped. Default is 0.\n"
+	"        size   - The size to be dumped, not including OOB. Default is the\n"
+	"                 size from start address to end of flash.\n"
+	"        count  - Number of pages to be dumped.\n"
 	"\n"
 	"    write [r/w/e options] [erase] [verify] <file> [<addr> [<size>|count=<n>]]\n"
 	"        Write flash data from file.\n"
 	"        erase  - Erase block(s) the data will be written to.\n"
-	"        verify - Verify the data being written.\n"
+	"        verify - Read back and verify each block right after it is written.\n"
+	"                 A block failed verification is tested and retired if\n"
+	"                 it is bad, and its data is written to the next good block\n"
+	"                 unless nospread is set.\n"
 	"        file   - The file to be written to flash.\n"
 	"                 The file size must be page size (w/ or w/o OOB) aligned.\n"
 	"        addr   - The start flash address to be written to.\n"
@@ -176,9 +230,50 @@ static const char usage[] =
 	"    markbad [<addr>]\n"
 	"        Write bad block marker to block specified by <addr>.\n"
 	"\n"
+	"    screen [mark] [<addr> [<size>|count=<n>]]\n"
+	"        Torture test each block in range with erase/program/read of test\n"
+	"        patterns, and display a per-block pass/fail map and timing.\n"
+	"        Blocks already marked bad are skipped. Failed blocks are set bad in\n"
+	"        BBT. ALL DATA IN RANGE WILL BE LOST!\n"
+	"        Physical blocks are tested. FTL and part options are not used.\n"
+	"        mark  - Also write bad block marker to failed blocks.\n"
+	"        addr  - The start flash address. Must be block aligned. Default is 0.\n"
+	"        size  - The size to be screened. Default is the size from start\n"
+	"                address to end of flash.\n"
+	"        count - Number of blocks to be screened.\n"
+	"\n"
+	"    scrub [threshold=<percent>] [heatmap=<file>] [dry] [<addr> [<size>|count=<n>]]\n"
+	"        Read all blocks in range once with ECC and record the maximum\n"
+	"        corrected bitflips per ECC step of each block. Only blocks reaching\n"
+	"        the threshold are refreshed by read, erase, program and verify.\n"
+	"        Data of each block is saved to scrub-block-<n>.bin in the current\n"
+	"        directory before it is erased, and the file is removed once the\n"
+	"        block is verified. Pages are saved with OOB after ECC correction.\n"
+	"        Physical blocks are scrubbed. FTL and part options are not used.\n"
+	"        threshold - Percentage of ECC strength. Default is 50.\n"
+	"        heatmap   - Write per-block bitflip counts to file in CSV format.\n"
+	"        dry       - Scan and report only. Do not refresh any block.\n"
+	"        addr      - The start flash address. Must be block aligned.\n"
+	"                    Default is 0.\n"
+	"        size      - The size to be scrubbed. Default is the size from start\n"
+	"                    address to end of flash.\n"
+	"        count     - Number of blocks to be scrubbed.\n"
+	"\n"
 	"    uid\n"
 	"        Read the Unique ID if supported.\n"
 	"\n"
+	"    calibrate [rounds=<n>] [<addr> [<count>]]\n"
+	"        Find the highest reliable SPI clock for this device and flash chip.\n"
+	"        Pages are read repeatedly at each available clock and compared with\n"
+	"        the data read at the lowest clock. One slower clock is chosen as\n"
+	"        margin if a faster clock failed. The result is stored in config and\n"
+	"        used for this device and flash chip afterwards.\n"
+	"        rounds - Number of reads at each clock. Default is 4.\n"
+	"        addr   - The flash address of the first page to be read.\n"
+	"                 Default is 0 if not specified.\n"
+	"        count  - Number of pages to be read. Default is 1.\n"
+	"                 Pages should not be blank for a meaningful result.\n"
+	"\n"
 	"    otp info\n"
 	"        Display OTP region information.\n"
 	"    otp [index=<index>] read [raw] [oob] [fmt] <file>\n"
@@ -336,17 +431,26 @@ static ufprog_status nand_prepare_opdata(struct ufnand_instance *nandinst, struc
 		opdata->layout_needs_free = false;
 	}
 
-	opdata->buf[0] = malloc(nandinst->info.maux.oob_block_size * 2 + nandinst->info.maux.oob_page_size * 2);
+	ret = ufprog_nand_compile_page_layout(opdata->layout, NAND_WRITE_FILL_FLAGS, NAND_VERIFY_BYTE_TYPES,
+					      &opdata->prog);
+	if (ret) {
+		os_fprintf(stderr, "Failed to compile page layout\n");
+		goto cleanup_layout;
+	}
+
+	opdata->buf[0] = malloc(nandinst->info.maux.oob_block_size * (rwedata->verify ? 3 : 2) +
+				nandinst->info.maux.oob_page_size);
 	if (!opdata->buf[0]) {
 		os_fprintf(stderr, "No memory for R/W buffer\n");
-		goto cleanup_layout;
+		ret = UFP_NOMEM;
+		goto cleanup_prog;
 	}
 
 	opdata->buf[1] = opdata->buf[0] + nandinst->info.maux.oob_block_size;
-	opdata->map = opdata->buf[1] + nandinst->info.maux.oob_block_size;
-	opdata->tmp = opdata->map + nandinst->info.maux.oob_page_size;
+	opdata->tmp = opdata->buf[1] + nandinst->info.maux.oob_block_size;
 
-	ufprog_nand_page_layout_to_map(opdata->layout, opdata->map);
+	if (rwedata->verify)
+		opdata->vbuf = opdata->tmp + nandinst->info.maux.oob_page_size;
 
 	if (rwedata->oob)
 		opdata->page_size = nandinst->info.maux.oob_page_size;
@@ -355,17 +459,22 @@ static ufprog_status nand_prepare_opdata(struct ufnand_instance *nandinst, struc
 
 	return UFP_OK;
 
+cleanup_prog:
+	ufprog_nand_free_page_layout_prog(opdata->prog);
+
 cleanup_layout:
 	if (opdata->layout_needs_free)
 		ufprog_nand_free_page_layout((void *)opdata->layout);
 
 	memset(opdata, 0, sizeof(*opdata));
 
-	return UFP_NOMEM;
+	return ret;
 }
 
 static void nand_cleanup_opdata(struct ufnand_op_data *opdata)
 {
+	ufprog_nand_free_page_layout_prog(opdata->prog);
+
 	if (opdata->layout_needs_free)
 		ufprog_nand_free_page_layout((void *)opdata->layout);
 
@@ -382,10 +491,36 @@ static void print_part_info(struct ufnand_instance *nandinst, struct ufprog_ftl_
 		  (uint64_t)(part->base_block + part->block_count) << nandinst->info.maux.block_shift);
 }
 
+static ufprog_status nand_open_journal(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata,
+				       enum ufprog_journal_op op, uint32_t page, uint32_t count, file_mapping fm,
+				       uint64_t image_size, struct ufnand_journal *jnl)
+{
+	ufprog_status ret;
+
+	ret = journal_open(nandinst, rwedata->journal, op, rwedata, page, count, fm, image_size, rwedata->resume, jnl);
+	if (ret)
+		return ret;
+
+	nandinst->journal = jnl;
+
+	return UFP_OK;
+}
+
+static void nand_close_journal(struct ufnand_instance *nandinst)
+{
+	if (!nandinst->journal)
+		return;
+
+	journal_close(nandinst->journal);
+	nandinst->journal = NULL;
+}
+
 static ufprog_status do_nand_read(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata, uint32_t page,
 				  uint32_t count, const char *file)
 {
 	struct ufnand_op_data opdata;
+	struct ufnand_journal jnl;
+	struct ufnand_digest dg;
 	uint64_t data_size;
 	ufprog_status ret;
 	file_mapping fm;
@@ -403,7 +538,7 @@ static ufprog_status do_nand_read(struct ufnand_instance *nandinst, struct ufnan
 
 	data_size = (uint64_t)opdata.page_size * count;
 
-	ret = os_open_file_mapping(file, data_size, NAND_MAX_MAP_SIZE, true, true, &fm);
+	ret = os_open_file_mapping(file, data_size, NAND_MAX_MAP_SIZE, true, !rwedata->resume, &fm);
 	if (ret)
 		goto cleanup_opdata;
 
@@ -415,9 +550,33 @@ static ufprog_status do_nand_read(struct ufnand_instance *nandinst, struct ufnan
 	if (rwedata->part_set)
 		print_part_info(nandinst, &rwedata->part);
 
+	if (rwedata->journal) {
+		ret = nand_open_journal(nandinst, rwedata, JOURNAL_OP_READ, page, count, NULL, 0, &jnl);
+		if (ret)
+			goto cleanup;
+	}
+
+	if (rwedata->digest || rwedata->crc32 || rwedata->sha256) {
+		if (!digest_init(&dg, rwedata->crc32, rwedata->sha256)) {
+			ret = UFP_INVALID_PARAMETER;
+			goto cleanup;
+		}
+
+		rwedata->dg = &dg;
+	}
+
 	ret = nand_read(nandinst, rwedata, &rwedata->part, &opdata, fm, page, count);
 
+	if (!ret)
+		ret = journal_finish(nandinst);
+
+	if (rwedata->dg && !ret)
+		ret = digest_finish(rwedata->dg);
+
+	rwedata->dg = NULL;
+
 cleanup:
+	nand_close_journal(nandinst);
 	os_close_file_mapping(fm);
 
 cleanup_opdata:
@@ -459,6 +618,7 @@ static ufprog_status do_nand_write(struct ufnand_instance *nandinst, struct ufna
 	uint32_t last_page_padding = 0;
 	uint64_t data_size, file_size;
 	struct ufnand_op_data opdata;
+	struct ufnand_journal jnl;
 	file_handle fileh;
 	ufprog_status ret;
 	file_mapping fm;
@@ -513,7 +673,14 @@ static ufprog_status do_nand_write(struct ufnand_instance *nandinst, struct ufna
 	if (rwedata->part_set)
 		print_part_info(nandinst, &rwedata->part);
 
-	if (rwedata->erase) {
+	if (rwedata->journal) {
+		ret = nand_open_journal(nandinst, rwedata, JOURNAL_OP_WRITE, page, count, fm,
+					file_size < data_size ? file_size : data_size, &jnl);
+		if (ret)
+			goto cleanup;
+	}
+
+	if (rwedata->erase && (!nandinst->journal || nandinst->journal->phase == NAND_JOURNAL_PHASE_ERASE)) {
 		ret = nand_erase(nandinst, &rwedata->part, page, count, rwedata->nospread);
 		if (ret)
 			goto cleanup;
@@ -521,19 +688,20 @@ static ufprog_status do_nand_write(struct ufnand_instance *nandinst, struct ufna
 		os_printf("\n");
 	}
 
+	if (nandinst->journal && nandinst->journal->phase == NAND_JOURNAL_PHASE_ERASE) {
+		ret = journal_checkpoint(nandinst, NAND_JOURNAL_PHASE_PROGRAM, 0, true);
+		if (ret)
+			goto cleanup;
+	}
+
 	ret = nand_write(nandinst, rwedata, &rwedata->part, &opdata, fm, page, count, last_page_padding);
 	if (ret)
 		goto cleanup;
 
-	if (rwedata->verify) {
-		os_printf("\n");
-
-		ret = nand_verify(nandinst, rwedata, &rwedata->part, &opdata, fm, page, count, last_page_padding);
-		if (ret)
-			goto cleanup;
-	}
+	ret = journal_finish(nandinst);
 
 cleanup:
+	nand_close_journal(nandinst);
 	os_close_file_mapping(fm);
 
 cleanup_opdata:
@@ -545,6 +713,9 @@ cleanup_opdata:
 static ufprog_status do_nand_erase(struct ufnand_instance *nandinst, struct ufnand_rwe_data *rwedata, uint32_t page,
 				   uint32_t count)
 {
+	struct ufnand_journal jnl;
+	ufprog_status ret;
+
 	if (!rwedata->part_set) {
 		rwedata->part.base_block = page >> nandinst->info.maux.pages_per_block_shift;
 		rwedata->part.block_count = (uint32_t)(nandinst->ftl_size >> nandinst->info.maux.block_shift) -
@@ -555,7 +726,19 @@ static ufprog_status do_nand_erase(struct ufnand_instance *nandinst, struct ufna
 	if (rwedata->part_set)
 		print_part_info(nandinst, &rwedata->part);
 
-	return nand_erase(nandinst, &rwedata->part, page, count, rwedata->nospread);
+	if (rwedata->journal) {
+		ret = nand_open_journal(nandinst, rwedata, JOURNAL_OP_ERASE, page, count, NULL, 0, &jnl);
+		if (ret)
+			return ret;
+	}
+
+	ret = nand_erase(nandinst, &rwedata->part, page, count, rwedata->nospread);
+	if (!ret)
+		ret = journal_finish(nandinst);
+
+	nand_close_journal(nandinst);
+
+	return ret;
 }
 
 static ufprog_status do_nand_markbad(struct ufnand_instance *nandinst, uint64_t addr)
@@ -575,6 +758,477 @@ static ufprog_status do_nand_markbad(struct ufnand_instance *nandinst, uint64_t
 	return ret;
 }
 
+static bool nand_screen_block_failed(ufprog_status ret)
+{
+	switch (ret) {
+	case UFP_FAIL:
+	case UFP_FLASH_PROGRAM_FAILED:
+	case UFP_FLASH_ERASE_FAILED:
+	case UFP_ECC_UNCORRECTABLE:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static void nand_screen_print_map(struct ufnand_instance *nandinst, uint32_t block, const char *result,
+				  uint32_t count)
+{
+	uint32_t i, n;
+
+	os_printf("Block map ('.' passed, 'X' failed, 'B' already bad, 'R' reserved):\n");
+
+	for (i = 0; i < count; i += n) {
+		n = count - i;
+		if (n > NAND_SCREEN_MAP_BLOCKS_PER_LINE)
+			n = NAND_SCREEN_MAP_BLOCKS_PER_LINE;
+
+		os_printf("%6u 0x%09" PRIx64 ": %.*s\n", block + i,
+			  (uint64_t)(block + i) << nandinst->info.maux.block_shift, n, result + i);
+	}
+}
+
+static ufprog_status do_nand_screen(struct ufnand_instance *nandinst, uint32_t block, uint32_t count, bool mark)
+{
+	uint32_t i, curr, tested = 0, failed = 0, bad = 0, percentage, last_percentage = 0;
+	ufprog_status ret = UFP_OK;
+	uint64_t t0, t1;
+	char *result;
+	void *buf;
+
+	/* One block buffer is reused for all patterns of all blocks */
+	buf = malloc(nandinst->info.maux.oob_block_size + count);
+	if (!buf) {
+		os_fprintf(stderr, "No memory for screening buffer\n");
+		return UFP_NOMEM;
+	}
+
+	result = (char *)buf + nandinst->info.maux.oob_block_size;
+
+	os_printf("Screening %u block(s) from block %u at 0x%" PRIx64 " ...\n", count, block,
+		  (uint64_t)block << nandinst->info.maux.block_shift);
+
+	progress_init();
+
+	t0 = os_get_timer_us();
+
+	for (i = 0; i < count; i++) {
+		curr = block + i;
+
+		if (ufprog_bbt_is_reserved(nandinst->bbt, curr)) {
+			result[i] = 'R';
+			goto next_block;
+		}
+
+		/* Never erase a marked bad block, or its factory marker will be lost */
+		if (ufprog_bbt_is_bad(nandinst->bbt, curr) ||
+		    ufprog_nand_checkbad(nandinst->chip, NULL, curr) == UFP_FAIL) {
+			result[i] = 'B';
+			bad++;
+			goto next_block;
+		}
+
+		tested++;
+
+		ret = ufprog_nand_torture_block_with_buf(nandinst->chip, curr, buf);
+		if (!ret) {
+			result[i] = '.';
+			ufprog_bbt_set_state(nandinst->bbt, curr, BBT_ST_ERASED);
+			goto next_block;
+		}
+
+		if (!nand_screen_block_failed(ret)) {
+			os_fprintf(stderr, "Failed to screen block %u at 0x%" PRIx64 "\n", curr,
+				   (uint64_t)curr << nandinst->info.maux.block_shift);
+			break;
+		}
+
+		result[i] = 'X';
+		failed++;
+
+		ufprog_bbt_set_state(nandinst->bbt, curr, BBT_ST_BAD);
+
+		if (mark) {
+			ret = ufprog_nand_markbad(nandinst->chip, NULL, curr);
+			if (ret) {
+				os_fprintf(stderr, "Failed to mark bad block %u at 0x%" PRIx64 "\n", curr,
+					   (uint64_t)curr << nandinst->info.maux.block_shift);
+				i++;
+				break;
+			}
+		}
+
+		ret = UFP_OK;
+
+	next_block:
+		percentage = (uint32_t)(((i + 1) * 100ULL) / count);
+		if (percentage > last_percentage) {
+			last_percentage = percentage;
+			progress_show(last_percentage);
+		}
+	}
+
+	t1 = os_get_timer_us();
+
+	if (!ret)
+		progress_done();
+
+	os_printf("\n");
+
+	nand_screen_print_map(nandinst, block, result, i);
+
+	os_printf("\n");
+	os_printf("%u block(s) tested, %u failed, %u already bad\n", tested, failed, bad);
+
+	if (tested) {
+		os_printf("Time: %" PRIu64 ".%03" PRIu64 " s, %" PRIu64 " us per tested block\n", (t1 - t0) / 1000000,
+			  ((t1 - t0) / 1000) % 1000, (t1 - t0) / tested);
+	}
+
+	free(buf);
+
+	return ret;
+}
+
+static void UFPROG_API nand_scrub_ecc_report(void *priv, uint32_t page, int bitflips)
+{
+	struct nand_scrub_data *sd = priv;
+	uint32_t idx = (page >> sd->pages_per_block_shift) - sd->block;
+
+	if (idx >= sd->count || sd->bitflips[idx] < 0)
+		return;
+
+	if (bitflips < 0 || bitflips > sd->bitflips[idx])
+		sd->bitflips[idx] = bitflips;
+}
+
+static bool nand_scrub_page_erased(const uint8_t *buf, uint32_t len)
+{
+	return buf[0] == 0xff && !memcmp(buf, buf + 1, len - 1);
+}
+
+static ufprog_status nand_scrub_save_block(const char *file, const void *data, size_t len)
+{
+	file_handle fh;
+	ufprog_status ret;
+
+	ret = os_open_file(file, false, true, true, true, &fh);
+	if (ret) {
+		os_fprintf(stderr, "Failed to create recovery file '%s'\n", file);
+		return ret;
+	}
+
+	if (!os_write_file(fh, len, data, NULL) || !os_flush_file(fh)) {
+		os_fprintf(stderr, "Failed to write recovery file '%s'\n", file);
+		os_close_file(fh);
+		return UFP_FILE_WRITE_FAILURE;
+	}
+
+	os_close_file(fh);
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_scrub_refresh_block(struct ufnand_instance *nandinst, struct ufnand_op_data *opdata,
+					      uint32_t block)
+{
+	const struct nand_memaux_info *maux = &nandinst->info.maux;
+	uint32_t ppb = nandinst->info.memorg.pages_per_block;
+	uint32_t page = block << maux->pages_per_block_shift;
+	uint64_t addr = (uint64_t)block << maux->block_shift;
+	uint32_t i, n, pos;
+	ufprog_status ret;
+	char file[64];
+	uint8_t *p;
+
+	ret = ufprog_nand_read_pages(nandinst->chip, page, ppb, opdata->buf[0], false, 0, NULL);
+	if (ret) {
+		os_fprintf(stderr, "Failed to read block %u at 0x%" PRIx64 "\n", block, addr);
+		return ret;
+	}
+
+	/* The buffer is the only copy of the block data once it is erased */
+	snprintf(file, sizeof(file), "scrub-block-%u.bin", block);
+
+	ret = nand_scrub_save_block(file, opdata->buf[0], (size_t)ppb * maux->oob_page_size);
+	if (ret) {
+		os_fprintf(stderr, "Block %u at 0x%" PRIx64 " is not refreshed\n", block, addr);
+		return ret;
+	}
+
+	ret = ufprog_nand_erase_block(nandinst->chip, page);
+	if (ret) {
+		os_fprintf(stderr, "Failed to erase block %u at 0x%" PRIx64 "\n", block, addr);
+		goto out;
+	}
+
+	/* Pages read back as erased are left erased. Programming them would also program ECC parity of 0xff. */
+	for (i = 0; i < ppb; i += n) {
+		p = opdata->buf[0] + (size_t)i * maux->oob_page_size;
+
+		if (nand_scrub_page_erased(p, maux->oob_page_size)) {
+			n = 1;
+			continue;
+		}
+
+		for (n = 1; i + n < ppb; n++) {
+			if (nand_scrub_page_erased(p + (size_t)n * maux->oob_page_size, maux->oob_page_size))
+				break;
+		}
+
+		ret = ufprog_nand_write_pages(nandinst->chip, page + i, n, p, false, false, NULL);
+		if (ret) {
+			os_fprintf(stderr, "Failed to program block %u at 0x%" PRIx64 "\n", block, addr);
+			goto out;
+		}
+	}
+
+	ret = ufprog_nand_read_pages(nandinst->chip, page, ppb, opdata->buf[1], false, 0, NULL);
+	if (ret) {
+		os_fprintf(stderr, "Failed to read back block %u at 0x%" PRIx64 "\n", block, addr);
+		goto out;
+	}
+
+	for (i = 0; i < ppb; i++) {
+		p = opdata->buf[0] + (size_t)i * maux->oob_page_size;
+
+		if (!ufprog_nand_compare_page_by_prog(opdata->prog, opdata->buf[1] + (size_t)i * maux->oob_page_size, p,
+						      maux->oob_page_size, &pos)) {
+			os_fprintf(stderr, "Page %u data at 0x%x are different after refreshing\n", page + i, pos);
+			ret = UFP_DATA_VERIFICATION_FAIL;
+			goto out;
+		}
+	}
+
+out:
+	if (ret) {
+		os_fprintf(stderr, "Original data of block %u (%u pages with OOB) has been saved to '%s'\n", block, ppb,
+			   file);
+		return ret;
+	}
+
+	os_delete_file(file);
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_scrub_write_heatmap(struct ufnand_instance *nandinst, const char *file, uint32_t block,
+					      uint32_t count, const int *bitflips, const uint8_t *state)
+{
+	ufprog_status ret = UFP_OK;
+	file_handle fh;
+	char line[128];
+	uint32_t i;
+	int len;
+
+	ret = os_open_file(file, false, true, true, true, &fh);
+	if (ret) {
+		os_fprintf(stderr, "Failed to create heatmap file '%s'\n", file);
+		return ret;
+	}
+
+	len = snprintf(line, sizeof(line), "block,address,bitflips,state\n");
+
+	if (!os_write_file(fh, len, line, NULL))
+		goto write_fail;
+
+	for (i = 0; i < count; i++) {
+		if (state[i] == SCRUB_ST_BAD || state[i] == SCRUB_ST_RESERVED) {
+			len = snprintf(line, sizeof(line), "%u,0x%" PRIx64 ",,%s\n", block + i,
+				       (uint64_t)(block + i) << nandinst->info.maux.block_shift,
+				       nand_scrub_state_names[state[i]]);
+		} else {
+			len = snprintf(line, sizeof(line), "%u,0x%" PRIx64 ",%d,%s\n", block + i,
+				       (uint64_t)(block + i) << nandinst->info.maux.block_shift, bitflips[i],
+				       nand_scrub_state_names[state[i]]);
+		}
+
+		if (!os_write_file(fh, len, line, NULL))
+			goto write_fail;
+	}
+
+	os_close_file(fh);
+
+	return UFP_OK;
+
+write_fail:
+	os_fprintf(stderr, "Failed to write heatmap file '%s'\n", file);
+	os_close_file(fh);
+
+	return UFP_FILE_WRITE_FAILURE;
+}
+
+static ufprog_status do_nand_scrub(struct ufnand_instance *nandinst, uint32_t block, uint32_t count,
+				   uint32_t threshold, const char *heatmap, bool dry)
+{
+	uint32_t i, j, curr, limit, scanned = 0, bad = 0, stale = 0, uncorrectable = 0, refreshed = 0;
+	const struct nand_memaux_info *maux = &nandinst->info.maux;
+	uint32_t percentage, last_percentage = 0;
+	struct ufprog_nand_ecc_chip *ecc;
+	struct ufnand_rwe_data rwedata;
+	struct ufnand_op_data opdata;
+	struct nand_ecc_config ecccfg;
+	struct nand_scrub_data sd;
+	ufprog_status ret, ret2;
+	uint64_t t0, t1;
+	uint8_t *state;
+
+	ecc = ufprog_nand_get_ecc(nandinst->chip);
+	if (!ecc) {
+		os_fprintf(stderr, "Scrubbing requires ECC to be enabled\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	ret = ufprog_ecc_get_config(ecc, &ecccfg);
+	if (ret) {
+		os_fprintf(stderr, "Failed to get ECC configuration\n");
+		return ret;
+	}
+
+	limit = (ecccfg.strength_per_step * threshold + 99) / 100;
+	if (!limit)
+		limit = 1;
+
+	memset(&rwedata, 0, sizeof(rwedata));
+
+	ret = nand_prepare_opdata(nandinst, &rwedata, &opdata);
+	if (ret)
+		return ret;
+
+	sd.pages_per_block_shift = maux->pages_per_block_shift;
+	sd.block = block;
+	sd.count = count;
+
+	sd.bitflips = calloc(count, sizeof(*sd.bitflips) + sizeof(*state));
+	if (!sd.bitflips) {
+		os_fprintf(stderr, "No memory for scrubbing statistics\n");
+		ret = UFP_NOMEM;
+		goto cleanup;
+	}
+
+	state = (uint8_t *)(sd.bitflips + count);
+
+	os_printf("Scanning %u block(s) from block %u at 0x%" PRIx64 " ...\n", count, block,
+		  (uint64_t)block << maux->block_shift);
+	os_printf("Blocks with %u or more corrected bitflips per ECC step (%u%% of %u) will be refreshed\n", limit,
+		  threshold, ecccfg.strength_per_step);
+
+	ufprog_nand_set_ecc_report_cb(nandinst->chip, nand_scrub_ecc_report, &sd);
+
+	progress_init();
+
+	t0 = os_get_timer_us();
+
+	for (i = 0; i < count; i++) {
+		curr = block + i;
+
+		if (ufprog_bbt_is_reserved(nandinst->bbt, curr)) {
+			state[i] = SCRUB_ST_RESERVED;
+			goto next_scan;
+		}
+
+		if (ufprog_bbt_is_bad(nandinst->bbt, curr) ||
+		    ufprog_nand_checkbad(nandinst->chip, NULL, curr) == UFP_FAIL) {
+			state[i] = SCRUB_ST_BAD;
+			bad++;
+			goto next_scan;
+		}
+
+		ret = ufprog_nand_read_pages(nandinst->chip, curr << maux->pages_per_block_shift,
+					     nandinst->info.memorg.pages_per_block, opdata.buf[0], false,
+					     NAND_READ_F_IGNORE_ECC_ERROR, NULL);
+		if (ret) {
+			os_fprintf(stderr, "Failed to read block %u at 0x%" PRIx64 "\n", curr,
+				   (uint64_t)curr << maux->block_shift);
+			break;
+		}
+
+		scanned++;
+
+		if (sd.bitflips[i] < 0) {
+			state[i] = SCRUB_ST_UNCORRECTABLE;
+			uncorrectable++;
+		} else if ((uint32_t)sd.bitflips[i] >= limit) {
+			state[i] = SCRUB_ST_STALE;
+			stale++;
+		} else {
+			state[i] = SCRUB_ST_OK;
+		}
+
+	next_scan:
+		percentage = (uint32_t)(((i + 1) * 100ULL) / count);
+		if (percentage > last_percentage) {
+			last_percentage = percentage;
+			progress_show(last_percentage);
+		}
+	}
+
+	ufprog_nand_set_ecc_report_cb(nandinst->chip, NULL, NULL);
+
+	if (ret)
+		goto cleanup;
+
+	progress_done();
+
+	os_printf("\n");
+	os_printf("%u block(s) scanned, %u need refreshing, %u uncorrectable, %u bad\n", scanned, stale,
+		  uncorrectable, bad);
+
+	if (uncorrectable)
+		os_printf("Blocks with uncorrectable bitflips are not refreshed as their data can not be recovered\n");
+
+	if (stale && !dry) {
+		os_printf("\n");
+		os_printf("Refreshing %u block(s) ...\n", stale);
+
+		progress_init();
+		last_percentage = 0;
+
+		for (i = 0, j = 0; i < count; i++) {
+			if (state[i] != SCRUB_ST_STALE)
+				continue;
+
+			ret = nand_scrub_refresh_block(nandinst, &opdata, block + i);
+			if (ret)
+				break;
+
+			state[i] = SCRUB_ST_REFRESHED;
+			refreshed++;
+
+			percentage = (uint32_t)((++j * 100ULL) / stale);
+			if (percentage > last_percentage) {
+				last_percentage = percentage;
+				progress_show(last_percentage);
+			}
+		}
+
+		if (!ret)
+			progress_done();
+
+		os_printf("\n");
+		os_printf("%u of %u block(s) refreshed\n", refreshed, stale);
+	}
+
+	t1 = os_get_timer_us();
+
+	os_printf("Time: %" PRIu64 ".%03" PRIu64 " s\n", (t1 - t0) / 1000000, ((t1 - t0) / 1000) % 1000);
+
+	if (heatmap) {
+		ret2 = nand_scrub_write_heatmap(nandinst, heatmap, block, count, sd.bitflips, state);
+		if (!ret)
+			ret = ret2;
+	}
+
+cleanup:
+	if (sd.bitflips)
+		free(sd.bitflips);
+
+	nand_cleanup_opdata(&opdata);
+
+	return ret;
+}
+
 static ufprog_status do_nand_uid(struct ufnand_instance *nandinst)
 {
 	uint8_t uiddfl[DEFAULT_UID_MAX_LEN], *uid = NULL;
@@ -971,8 +1625,13 @@ static int parse_rwe_options(struct ufnand_rwe_data *rwedata, const struct nand_
 		CMDARG_BOOL_OPT("nospread", rwedata->nospread),
 		CMDARG_BOOL_OPT("verify", rwedata->verify),
 		CMDARG_BOOL_OPT("erase", rwedata->erase),
+		CMDARG_BOOL_OPT("digest", rwedata->digest),
+		CMDARG_STRING_OPT("crc32", rwedata->crc32),
+		CMDARG_STRING_OPT("sha256", rwedata->sha256),
 		CMDARG_U64_OPT_SET("part-base", part_base, rwedata->part_set),
 		CMDARG_U64_OPT_SET("part-size", part_size, part_size_set),
+		CMDARG_STRING_OPT("journal", rwedata->journal),
+		CMDARG_BOOL_OPT("resume", rwedata->resume),
 	};
 
 	memset(rwedata, 0, sizeof(*rwedata));
@@ -980,6 +1639,11 @@ static int parse_rwe_options(struct ufnand_rwe_data *rwedata, const struct nand_
 	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
 		return -1;
 
+	if (rwedata->resume && !rwedata->journal) {
+		os_fprintf(stderr, "resume requires a journal file\n");
+		return -1;
+	}
+
 	if (rwedata->part_set) {
 		if (part_base & maux->block_mask) {
 			os_fprintf(stderr, "part-base must be aligned to block boundary\n");
@@ -1159,6 +1823,49 @@ static int do_snand_read(void *priv, int argc, char *argv[])
 	return 0;
 }
 
+static int do_snand_dump_range(struct ufsnand_instance *inst, int argc, char *argv[])
+{
+	const struct nand_memaux_info *maux = &inst->nand.info.maux;
+	uint32_t page, count, column = inst->nand.info.memorg.page_size, len = 0;
+	ufprog_bool raw = false, len_set = false;
+	struct ufnand_rwe_data rwedata;
+	ufprog_status ret;
+	int rc;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_BOOL_OPT("raw", raw),
+		CMDARG_U32_OPT("column", column),
+		CMDARG_U32_OPT_SET("len", len, len_set),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &rc))
+		return 1;
+
+	if (column >= maux->oob_page_size) {
+		os_fprintf(stderr, "Column exceeds page size\n");
+		return 1;
+	}
+
+	if (!len_set) {
+		len = maux->oob_page_size - column;
+	} else if (!len || len > maux->oob_page_size - column) {
+		os_fprintf(stderr, "Length is invalid\n");
+		return 1;
+	}
+
+	memset(&rwedata, 0, sizeof(rwedata));
+
+	rc = parse_addr_size(&rwedata, &page, &count, maux, false, false, maux->size, argc - rc, argv + rc);
+	if (rc < 0)
+		return 1;
+
+	ret = nand_dump_range(&inst->nand, page, count, column, len, raw);
+	if (ret)
+		return 1;
+
+	return 0;
+}
+
 static int do_snand_dump(void *priv, int argc, char *argv[])
 {
 	struct ufsnand_instance *inst = priv;
@@ -1177,6 +1884,9 @@ static int do_snand_dump(void *priv, int argc, char *argv[])
 		return 0;
 	}
 
+	if (!strcmp(argv[1], "oob"))
+		return do_snand_dump_range(inst, argc - 1, argv + 1);
+
 	rc = parse_rwe_options(&rwedata, &inst->nand.info.maux, inst->nand.ftl_size, argc, argv);
 	if (rc < 0)
 		return 1;
@@ -1300,6 +2010,77 @@ static int do_snand_markbad(void *priv, int argc, char *argv[])
 	return 0;
 }
 
+static int do_snand_screen(void *priv, int argc, char *argv[])
+{
+	struct ufsnand_instance *inst = priv;
+	const struct nand_memaux_info *maux = &inst->nand.info.maux;
+	struct ufnand_rwe_data rwedata;
+	ufprog_bool mark = false;
+	uint32_t page, count;
+	ufprog_status ret;
+	int rc;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_BOOL_OPT("mark", mark),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &rc))
+		return 1;
+
+	memset(&rwedata, 0, sizeof(rwedata));
+
+	rc = parse_addr_size(&rwedata, &page, &count, maux, true, false, maux->size, argc - rc, argv + rc);
+	if (rc < 0)
+		return 1;
+
+	ret = do_nand_screen(&inst->nand, page >> maux->pages_per_block_shift, count >> maux->pages_per_block_shift,
+			     mark);
+	if (ret)
+		return 1;
+
+	return 0;
+}
+
+static int do_snand_scrub(void *priv, int argc, char *argv[])
+{
+	struct ufsnand_instance *inst = priv;
+	const struct nand_memaux_info *maux = &inst->nand.info.maux;
+	uint32_t threshold = NAND_SCRUB_DEFAULT_THRESHOLD;
+	struct ufnand_rwe_data rwedata;
+	ufprog_bool dry = false;
+	char *heatmap = NULL;
+	uint32_t page, count;
+	ufprog_status ret;
+	int rc;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_U32_OPT("threshold", threshold),
+		CMDARG_STRING_OPT("heatmap", heatmap),
+		CMDARG_BOOL_OPT("dry", dry),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &rc))
+		return 1;
+
+	if (threshold > 100) {
+		os_fprintf(stderr, "Threshold must not be larger than 100\n");
+		return 1;
+	}
+
+	memset(&rwedata, 0, sizeof(rwedata));
+
+	rc = parse_addr_size(&rwedata, &page, &count, maux, true, false, maux->size, argc - rc, argv + rc);
+	if (rc < 0)
+		return 1;
+
+	ret = do_nand_scrub(&inst->nand, page >> maux->pages_per_block_shift, count >> maux->pages_per_block_shift,
+			    threshold, heatmap, dry);
+	if (ret)
+		return 1;
+
+	return 0;
+}
+
 static int do_snand_uid(void *priv, int argc, char *argv[])
 {
 	struct ufsnand_instance *inst = priv;
@@ -1312,6 +2093,71 @@ static int do_snand_uid(void *priv, int argc, char *argv[])
 	return 0;
 }
 
+static int do_snand_calibrate(void *priv, int argc, char *argv[])
+{
+	struct ufsnand_instance *inst = priv;
+	uint32_t rounds = 0, count = 0, page, hz;
+	ufprog_status ret;
+	uint64_t addr = 0;
+	int argp;
+	char *end;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_U32_OPT("rounds", rounds),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
+		return 1;
+
+	if (argc > argp) {
+		addr = strtoull(argv[argp], &end, 0);
+		if (end == argv[argp] || *end || addr == ULONG_MAX) {
+			os_fprintf(stderr, "Flash address is invalid\n");
+			return 1;
+		}
+
+		if (addr >= inst->nand.info.maux.size) {
+			os_fprintf(stderr, "Flash address exceeds flash size\n");
+			return 1;
+		}
+
+		argp++;
+	}
+
+	page = (uint32_t)(addr >> inst->nand.info.maux.page_shift);
+
+	if (argc > argp) {
+		count = strtoul(argv[argp], &end, 0);
+		if (end == argv[argp] || *end) {
+			os_fprintf(stderr, "Page count is invalid\n");
+			return 1;
+		}
+
+		if (count > inst->nand.info.maux.page_count - page) {
+			count = inst->nand.info.maux.page_count - page;
+			os_fprintf(stderr, "Page count exceeds flash size. Adjusted to %u\n", count);
+		}
+	}
+
+	os_printf("Calibrating SPI clock ...\n");
+
+	ret = ufprog_spi_nand_calibrate_speed(inst->snand, page, count, rounds, &hz);
+	if (ret) {
+		os_fprintf(stderr, "SPI clock calibration failed\n");
+		return 1;
+	}
+
+	os_printf("Calibrated SPI clock: %u.%03uMHz\n", hz / 1000000, (hz / 1000) % 1000);
+
+	if (!inst->device_name)
+		return 0;
+
+	if (save_calibrated_speed(inst->device_name, inst->nand.info.model, inst->sinfo.signature, hz))
+		return 1;
+
+	return 0;
+}
+
 static int do_snand_otp_info(void *priv, int argc, char *argv[])
 {
 	struct ufsnand_otp_instance *inst = priv;
@@ -1525,7 +2371,10 @@ static const struct subcmd_entry cmds[] = {
 	SUBCMD("write", do_snand_write),
 	SUBCMD("erase", do_snand_erase),
 	SUBCMD("markbad", do_snand_markbad),
+	SUBCMD("screen", do_snand_screen),
+	SUBCMD("scrub", do_snand_scrub),
 	SUBCMD("uid", do_snand_uid),
+	SUBCMD("calibrate", do_snand_calibrate),
 	SUBCMD("otp", do_snand_otp),
 	SUBCMD("nor_read", do_snand_nor_read),
 };
@@ -1589,9 +2438,14 @@ static int ufprog_main(int argc, char *argv[])
 
 	list_only = !strcmp(argv[argp], "list");
 
+	if (configs.async_log)
+		log_async_start();
+
 	ret = open_device(devname, part, configs.max_speed, &snand_inst, list_only);
-	if (ret)
+	if (ret) {
+		log_async_stop();
 		return 1;
+	}
 
 	if (snand_inst.snand && devname) {
 		if (configs.last_device)
@@ -1695,6 +2549,8 @@ cleanup:
 	if (snand_inst.nand.bbt)
 		ufprog_bbt_free(snand_inst.nand.bbt);
 
+	log_async_stop();
+
 	return exitcode;
 }
 
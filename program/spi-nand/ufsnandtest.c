@@ -14,16 +14,51 @@
 #include <ufprog/osdef.h>
 #include "ufsnand-common.h"
 
+#define NAND_TEST_DFL_WORKERS			4
+#define NAND_TEST_MAX_WORKERS			32
+
+enum nand_test_job {
+	NAND_TEST_JOB_GENERATE,
+	NAND_TEST_JOB_VERIFY,
+	NAND_TEST_JOB_CHECK_ZERO,
+};
+
+struct nand_test_data;
+
+struct nand_test_worker {
+	struct nand_test_data *ntd;
+	thread_handle thread;
+	event_handle start;
+	event_handle done;
+	volatile bool stop;
+	uint8_t *tmp;
+
+	/* Job description, owned by the worker between start and done */
+	enum nand_test_job job;
+	uint8_t *buf;
+	uint32_t page;
+	uint32_t first;
+	uint32_t count;
+	uint8_t pat_xor;
+	bool busy;
+	ufprog_status ret;
+};
+
 struct nand_test_data {
+	struct ufnand_instance *nandinst;
 	const struct nand_page_layout *layout;
+	struct nand_page_layout_prog *prog;
 	uint8_t *buf[2];
-	uint8_t *map;
-	uint32_t seed;
+	uint32_t *flips;
+	uint64_t seed;
 	uint32_t start_block;
 	uint32_t block_count;
 	bool raw;
 	bool oob;
 	bool fmt;
+
+	struct nand_test_worker *workers;
+	uint32_t num_workers;
 };
 
 static struct ufsnand_options configs;
@@ -32,7 +67,7 @@ static struct ufsnand_instance snand_inst;
 static const char usage[] =
 	"Usage:\n"
 	"    %s [dev=<dev>] [part=<partmodel>] [ecc=<ecccfg>] [raw] [oob] [fmt]\n"
-	"       [addr=<addr>] [len=<len>] all\n"
+	"       [addr=<addr>] [len=<len>] [seed=<n>] [threads=<n>] all\n"
 	"\n"
 	"Global options:\n"
 	"        dev  - Specify the device to be opened.\n"
@@ -54,6 +89,11 @@ static const char usage[] =
 	"        len  - Specify the size for test starting from <addr>. Default is\n"
 	"               the whole flash size.\n"
 	"               This address will be rounded up to block boundary.\n"
+	"        seed - Seed of the random test pattern. A new seed is generated if not\n"
+	"               specified. The seed used is always printed so that a failure can\n"
+	"               be reproduced.\n"
+	"        threads - Number of worker threads used for generating and checking\n"
+	"               test pattern. Default is %u.\n"
 	"\n"
 	"Test items:\n"
 	"    all - Confirm to test\n"
@@ -64,15 +104,21 @@ static const char usage[] =
 
 static void show_usage(void)
 {
-	os_printf(usage, os_prog_name());
+	os_printf(usage, os_prog_name(), NAND_TEST_DFL_WORKERS);
 }
 
-static void gen_pat(uint8_t *pat, size_t len)
+/* Pattern of each page depends only on seed and page index, so it can be regenerated in any order */
+static void gen_pat(uint8_t *pat, uint32_t page, size_t len, uint64_t seed, uint8_t pat_xor)
 {
-	size_t i;
+	uint64_t base = (uint64_t)page << 32, val;
+	size_t i, j;
 
-	for (i = 0; i < len; i++)
-		pat[i] = (uint8_t)(rand() * UCHAR_MAX / RAND_MAX);
+	for (i = 0; i < len; i += sizeof(val)) {
+		val = splitmix64(seed, base + (i >> 3));
+
+		for (j = 0; j < sizeof(val) && i + j < len; j++)
+			pat[i + j] = (uint8_t)(val >> (j * 8)) ^ pat_xor;
+	}
 }
 
 static ufprog_status nand_test_erase_flash(struct ufnand_instance *nandinst, struct nand_test_data *ntd)
@@ -215,281 +261,376 @@ static ufprog_status nand_test_check_bitflips(struct ufnand_instance *nandinst,
 	return ret;
 }
 
-static ufprog_status nand_test_generate_block_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-						      uint8_t *dst, uint8_t *tmp, uint8_t pat_xor)
+static ufprog_status nand_test_generate_page(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
+					     uint8_t *dst, uint8_t *tmp, uint32_t page, uint8_t pat_xor)
 {
-	uint8_t *p = dst, *pat = tmp, *fmtpat = pat + nandinst->info.maux.oob_page_size;
-	uint32_t i, j, flags = PAGE_FILL_F_FILL_NON_DATA_FF;
+	uint8_t *pat = tmp, *fmtpat = pat + nandinst->info.maux.oob_page_size;
 	ufprog_status ret;
 
-	for (i = 0; i < nandinst->info.memorg.pages_per_block; i++) {
-		gen_pat(pat, nandinst->info.maux.oob_page_size);
-
-		for (j = 0; j < nandinst->info.maux.oob_page_size; j++)
-			pat[j] ^= pat_xor;
-
-		if (ntd->oob) {
-			flags |= PAGE_FILL_F_FILL_OOB;
-
-			if (ntd->raw) {
-				flags |= PAGE_FILL_F_FILL_UNPROTECTED_OOB | PAGE_FILL_F_FILL_UNUSED |
-					PAGE_FILL_F_FILL_ECC_PARITY;
-			}
-		}
+	gen_pat(pat, page, nandinst->info.maux.oob_page_size, ntd->seed, pat_xor);
 
-		if (!ntd->fmt) {
-			ufprog_nand_fill_page_by_layout(ntd->layout, p, pat, nandinst->info.maux.oob_page_size, flags);
-		} else {
-			ufprog_nand_fill_page_by_layout(ntd->layout, fmtpat, pat, nandinst->info.maux.oob_page_size,
-							flags);
+	if (!ntd->fmt) {
+		ufprog_nand_fill_page_by_prog(ntd->prog, dst, pat, nandinst->info.maux.oob_page_size);
+		return UFP_OK;
+	}
 
-			ret = ufprog_nand_convert_page_format(nandinst->chip, fmtpat, p, true);
-			if (ret) {
-				os_fprintf(stderr, "Failed to convert page data\n");
-				return ret;
-			}
-		}
+	ufprog_nand_fill_page_by_prog(ntd->prog, fmtpat, pat, nandinst->info.maux.oob_page_size);
 
-		p += nandinst->info.maux.oob_page_size;
+	ret = ufprog_nand_convert_page_format(nandinst->chip, fmtpat, dst, true);
+	if (ret) {
+		os_fprintf(stderr, "Failed to convert page data\n");
+		return ret;
 	}
 
 	return UFP_OK;
 }
 
-static ufprog_status nand_test_write_block_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-						   uint32_t page, uint8_t pat_xor)
+static ufprog_status nand_test_run_job(struct nand_test_worker *w)
 {
+	struct nand_test_data *ntd = w->ntd;
+	struct ufnand_instance *nandinst = ntd->nandinst;
+	uint32_t i, ops = nandinst->info.maux.oob_page_size;
+	uint8_t *pat = w->tmp + 2 * ops;
 	ufprog_status ret;
-	uint32_t wrcnt;
 
-	ret = nand_test_generate_block_pattern(nandinst, ntd, ntd->buf[0], ntd->buf[1], pat_xor);
-	if (ret)
-		return ret;
+	for (i = w->first; i < w->first + w->count; i++) {
+		switch (w->job) {
+		case NAND_TEST_JOB_GENERATE:
+			ret = nand_test_generate_page(nandinst, ntd, w->buf + i * ops, w->tmp, w->page + i, w->pat_xor);
+			if (ret)
+				return ret;
+			break;
 
-	ret = ufprog_nand_write_pages(nandinst->chip, page, nandinst->info.memorg.pages_per_block, ntd->buf[0],
-				      ntd->raw, false, &wrcnt);
-	if (ret) {
-		os_fprintf(stderr, "Failed to write page %u at %" PRIx64 "\n", page + wrcnt,
-			   (uint64_t)(page + wrcnt) << nandinst->info.maux.page_shift);
-		return ret;
+		case NAND_TEST_JOB_VERIFY:
+			ret = nand_test_generate_page(nandinst, ntd, pat, w->tmp, w->page + i, w->pat_xor);
+			if (ret)
+				return ret;
+
+			ntd->flips[i] = ufprog_nand_count_bitflips_by_prog(ntd->prog, w->buf + i * ops, pat, ops);
+			break;
+
+		case NAND_TEST_JOB_CHECK_ZERO:
+			ntd->flips[i] = ufprog_nand_count_bitflips_by_prog(ntd->prog, w->buf + i * ops, NULL, ops);
+		}
 	}
 
 	return UFP_OK;
 }
 
-static ufprog_status nand_test_write_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-					     uint8_t pat_xor)
+static void UFPROG_API nand_test_worker_thread(void *priv)
 {
-	uint32_t block = ntd->start_block, end = block + ntd->block_count, bcnt = 0, percentage, last_percentage = 0;
-	ufprog_status ret = UFP_OK;
-	uint64_t t0, t1;
+	struct nand_test_worker *w = priv;
 
-	srand(ntd->seed);
+	while (true) {
+		os_wait_event(w->start, OS_WAIT_INFINITE);
 
-	progress_init();
+		if (w->stop)
+			break;
 
-	t0 = os_get_timer_us();
+		w->ret = nand_test_run_job(w);
 
-	while (block < end) {
-		if (ufprog_bbt_is_bad(nandinst->bbt, block))
-			goto next_block;
+		os_set_event(w->done);
+	}
+}
 
-		ret = nand_test_write_block_pattern(nandinst, ntd, block << nandinst->info.maux.pages_per_block_shift,
-						    pat_xor);
-		if (ret) {
-			os_fprintf(stderr, "Failed to write block %u at %" PRIx64 "\n", block,
-				   (uint64_t)block << nandinst->info.maux.block_shift);
-			break;
-		}
+static void nand_test_stop_workers(struct nand_test_data *ntd)
+{
+	struct nand_test_worker *w;
+	uint32_t i;
 
-	next_block:
-		block++;
-		bcnt++;
+	if (!ntd->workers)
+		return;
 
-		percentage = (uint32_t)((bcnt * 100ULL) / ntd->block_count);
-		if (percentage > last_percentage) {
-			last_percentage = percentage;
-			progress_show(last_percentage);
+	for (i = 0; i < ntd->num_workers; i++) {
+		w = &ntd->workers[i];
+
+		if (w->thread) {
+			w->stop = true;
+			os_set_event(w->start);
+			os_join_thread(w->thread);
 		}
-	}
 
-	if (!ret) {
-		t1 = os_get_timer_us();
+		if (w->start)
+			os_free_event(w->start);
 
-		progress_done();
-		print_speed((uint64_t)ntd->block_count << nandinst->info.maux.block_shift, t1 - t0);
-		os_printf("Succeeded\n");
+		if (w->done)
+			os_free_event(w->done);
+
+		if (w->tmp)
+			free(w->tmp);
 	}
 
-	return ret;
+	free(ntd->workers);
+	ntd->workers = NULL;
 }
 
-static ufprog_status nand_test_compare_page(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-					    uint8_t *buf, const uint8_t *pat, uint32_t page)
+static ufprog_status nand_test_start_workers(struct nand_test_data *ntd, uint32_t num)
 {
-	uint32_t i, cnt = 0;
-	bool check;
-	uint8_t n;
+	struct nand_test_worker *w;
+	uint32_t i;
 
-	for (i = 0; i < nandinst->info.maux.oob_page_size; i++) {
-		check = false;
+	ntd->workers = calloc(num, sizeof(*ntd->workers));
+	if (!ntd->workers) {
+		os_fprintf(stderr, "No memory for test workers\n");
+		return UFP_NOMEM;
+	}
 
-		if (ntd->map[i] == NAND_PAGE_BYTE_DATA) {
-			check = true;
-		} else if (ntd->oob) {
-			if (ntd->raw) {
-				if (ntd->map[i] != NAND_PAGE_BYTE_MARKER)
-					check = true;
-			} else {
-				if (ntd->map[i] == NAND_PAGE_BYTE_OOB_DATA)
-					check = true;
-			}
+	ntd->num_workers = num;
+
+	for (i = 0; i < num; i++) {
+		w = &ntd->workers[i];
+		w->ntd = ntd;
+
+		/* Raw pattern, canonical page and converted page */
+		w->tmp = malloc(ntd->nandinst->info.maux.oob_page_size * 3);
+		if (!w->tmp) {
+			os_fprintf(stderr, "No memory for test worker buffer\n");
+			goto cleanup;
 		}
 
-		if (check && buf[i] != pat[i]) {
-			n = pat[i] ^ buf[i];
-			cnt += hweight8(n);
+		if (!os_create_event(&w->start) || !os_create_event(&w->done)) {
+			os_fprintf(stderr, "Failed to create event for test worker\n");
+			goto cleanup;
 		}
-	}
 
-	if (ntd->raw) {
-		if (cnt == 1)
-			os_printf("1 bitflip found in page %u\n", page);
-		else if (cnt > 1)
-			os_printf("%u bitflips found in page %u\n", cnt, page);
-	} else {
-		if (cnt == 1)
-			os_fprintf(stderr, "Error: 1 bitflip found in page %u after ECC decoding\n", page);
-		else if (cnt > 1)
-			os_fprintf(stderr, "Error: %u bitflips found in page %u after ECC decoding\n", cnt, page);
+		if (!os_create_thread(&w->thread, nand_test_worker_thread, w)) {
+			os_fprintf(stderr, "Failed to create test worker thread\n");
+			goto cleanup;
+		}
 	}
 
 	return UFP_OK;
+
+cleanup:
+	nand_test_stop_workers(ntd);
+
+	return UFP_FAIL;
 }
 
-static ufprog_status nand_test_verify_block_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-						    uint32_t page, uint8_t pat_xor)
+/* Split pages of one block among all workers. The caller must call nand_test_wait_job() before touching @buf */
+static void nand_test_submit_job(struct nand_test_data *ntd, enum nand_test_job job, uint8_t *buf, uint32_t page,
+				 uint8_t pat_xor)
 {
-	uint32_t i, rdcnt;
-	ufprog_status ret;
+	uint32_t i, first = 0, count, ppb = ntd->nandinst->info.memorg.pages_per_block;
+	uint32_t per = (ppb + ntd->num_workers - 1) / ntd->num_workers;
+	struct nand_test_worker *w;
 
-	ret = nand_test_generate_block_pattern(nandinst, ntd, ntd->buf[0], ntd->buf[1], pat_xor);
-	if (ret)
-		return ret;
+	for (i = 0; i < ntd->num_workers; i++) {
+		w = &ntd->workers[i];
 
-	ret = ufprog_nand_read_pages(nandinst->chip, page, nandinst->info.memorg.pages_per_block, ntd->buf[1], ntd->raw,
-				     NAND_READ_F_IGNORE_ECC_ERROR, &rdcnt);
-	if (ret) {
-		os_fprintf(stderr, "Failed to read page %u at %" PRIx64 "\n", page + rdcnt,
-			   (uint64_t)(page + rdcnt) << nandinst->info.maux.page_shift);
-		return ret;
-	}
+		count = ppb - first;
+		if (count > per)
+			count = per;
 
-	for (i = 0; i < nandinst->info.memorg.pages_per_block; i++) {
-		ret = nand_test_compare_page(nandinst, ntd, ntd->buf[1] + i * nandinst->info.maux.oob_page_size,
-					     ntd->buf[0] + i * nandinst->info.maux.oob_page_size, page + i);
-		if (ret) {
-			os_fprintf(stderr, "Failed to verify page %u at %" PRIx64 "\n", page + i,
-				   (uint64_t)(page + i) << nandinst->info.maux.page_shift);
-			return ret;
+		if (!count) {
+			w->busy = false;
+			continue;
 		}
-	}
 
-	return UFP_OK;
+		w->job = job;
+		w->buf = buf;
+		w->page = page;
+		w->first = first;
+		w->count = count;
+		w->pat_xor = pat_xor;
+		w->ret = UFP_OK;
+		w->busy = true;
+
+		os_set_event(w->start);
+
+		first += count;
+	}
 }
 
-static void nand_test_check_zero_page(struct ufnand_instance *nandinst, struct nand_test_data *ntd, const uint8_t *buf,
-				      uint32_t page)
+static ufprog_status nand_test_wait_job(struct nand_test_data *ntd)
 {
-	uint32_t i, cnt = 0;
-	bool check;
-
-	for (i = 0; i < nandinst->info.maux.oob_page_size; i++) {
-		check = false;
-
-		if (ntd->map[i] == NAND_PAGE_BYTE_DATA) {
-			check = true;
-		} else if (ntd->oob) {
-			if (ntd->raw) {
-				if (ntd->map[i] != NAND_PAGE_BYTE_MARKER)
-					check = true;
-			} else {
-				if (ntd->map[i] == NAND_PAGE_BYTE_OOB_DATA)
-					check = true;
-			}
-		}
+	ufprog_status ret = UFP_OK;
+	struct nand_test_worker *w;
+	uint32_t i;
 
-		if (check && buf[i])
-			cnt += hweight8(buf[i]);
+	for (i = 0; i < ntd->num_workers; i++) {
+		w = &ntd->workers[i];
+
+		if (!w->busy)
+			continue;
+
+		os_wait_event(w->done, OS_WAIT_INFINITE);
+		w->busy = false;
+
+		if (w->ret && !ret)
+			ret = w->ret;
 	}
 
-	if (cnt == 1)
-		os_printf("1 bitflip found in page %u\n", page);
-	else if (cnt > 1)
-		os_printf("%u bitflips found in page %u\n", cnt, page);
+	return ret;
 }
 
-static ufprog_status nand_test_check_zero_block(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
-						uint32_t page)
+static uint32_t nand_test_next_good_block(struct ufnand_instance *nandinst, uint32_t block, uint32_t end)
 {
-	uint32_t i, rdcnt;
-	ufprog_status ret;
+	while (block < end && ufprog_bbt_is_bad(nandinst->bbt, block))
+		block++;
 
-	ret = ufprog_nand_read_pages(nandinst->chip, page, nandinst->info.memorg.pages_per_block, ntd->buf[0], ntd->raw,
-				     NAND_READ_F_IGNORE_ECC_ERROR, &rdcnt);
-	if (ret) {
-		os_fprintf(stderr, "Failed to read page %u at %" PRIx64 "\n", page + rdcnt,
-			   (uint64_t)(page + rdcnt) << nandinst->info.maux.page_shift);
-		return ret;
+	return block;
+}
+
+static void nand_test_update_progress(struct nand_test_data *ntd, uint32_t block, uint32_t *last_percentage)
+{
+	uint32_t percentage;
+
+	percentage = (uint32_t)(((block - ntd->start_block) * 100ULL) / ntd->block_count);
+	if (percentage > *last_percentage) {
+		*last_percentage = percentage;
+		progress_show(percentage);
 	}
+}
 
-	for (i = 0; i < nandinst->info.memorg.pages_per_block; i++) {
-		nand_test_check_zero_page(nandinst, ntd, ntd->buf[0] + i * nandinst->info.maux.oob_page_size,
-					  page + i);
+static ufprog_status nand_test_write_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
+					     uint8_t pat_xor)
+{
+	uint32_t block, next, end = ntd->start_block + ntd->block_count, page, wrcnt, last_percentage = 0, idx = 0;
+	ufprog_status ret = UFP_OK, jobret;
+	uint64_t t0, t1;
+
+	progress_init();
+
+	t0 = os_get_timer_us();
+
+	block = nand_test_next_good_block(nandinst, ntd->start_block, end);
+	if (block < end) {
+		nand_test_submit_job(ntd, NAND_TEST_JOB_GENERATE, ntd->buf[idx],
+				     block << nandinst->info.maux.pages_per_block_shift, pat_xor);
+		ret = nand_test_wait_job(ntd);
 	}
 
-	return UFP_OK;
+	while (!ret && block < end) {
+		page = block << nandinst->info.maux.pages_per_block_shift;
+
+		/* Prepare pattern of next block while current block is being written */
+		next = nand_test_next_good_block(nandinst, block + 1, end);
+		if (next < end) {
+			nand_test_submit_job(ntd, NAND_TEST_JOB_GENERATE, ntd->buf[idx ^ 1],
+					     next << nandinst->info.maux.pages_per_block_shift, pat_xor);
+		}
+
+		ret = ufprog_nand_write_pages(nandinst->chip, page, nandinst->info.memorg.pages_per_block,
+					      ntd->buf[idx], ntd->raw, false, &wrcnt);
+		if (ret) {
+			os_fprintf(stderr, "Failed to write page %u at %" PRIx64 "\n", page + wrcnt,
+				   (uint64_t)(page + wrcnt) << nandinst->info.maux.page_shift);
+			os_fprintf(stderr, "Failed to write block %u at %" PRIx64 "\n", block,
+				   (uint64_t)block << nandinst->info.maux.block_shift);
+		}
+
+		jobret = nand_test_wait_job(ntd);
+		if (!ret)
+			ret = jobret;
+
+		nand_test_update_progress(ntd, next, &last_percentage);
+
+		block = next;
+		idx ^= 1;
+	}
+
+	if (!ret) {
+		t1 = os_get_timer_us();
+
+		progress_done();
+		print_speed((uint64_t)ntd->block_count << nandinst->info.maux.block_shift, t1 - t0);
+		os_printf("Succeeded\n");
+	}
+
+	return ret;
+}
+
+static void nand_test_report_flips(struct ufnand_instance *nandinst, struct nand_test_data *ntd, uint32_t page,
+				   bool check_zero)
+{
+	uint32_t i, cnt;
+
+	for (i = 0; i < nandinst->info.memorg.pages_per_block; i++) {
+		cnt = ntd->flips[i];
+
+		if (check_zero || ntd->raw) {
+			if (cnt == 1)
+				os_printf("1 bitflip found in page %u\n", page + i);
+			else if (cnt > 1)
+				os_printf("%u bitflips found in page %u\n", cnt, page + i);
+		} else {
+			if (cnt == 1)
+				os_fprintf(stderr, "Error: 1 bitflip found in page %u after ECC decoding\n", page + i);
+			else if (cnt > 1)
+				os_fprintf(stderr, "Error: %u bitflips found in page %u after ECC decoding\n", cnt,
+					   page + i);
+		}
+	}
 }
 
 static ufprog_status nand_test_verify_pattern(struct ufnand_instance *nandinst, struct nand_test_data *ntd,
 					      bool check_zero, uint8_t pat_xor)
 {
-	uint32_t block = ntd->start_block, end = block + ntd->block_count, bcnt = 0, percentage, last_percentage = 0;
-	ufprog_status ret = UFP_OK;
+	uint32_t block, prev = UINT32_MAX, end = ntd->start_block + ntd->block_count, page, rdcnt, idx = 0;
+	enum nand_test_job job = check_zero ? NAND_TEST_JOB_CHECK_ZERO : NAND_TEST_JOB_VERIFY;
+	ufprog_status ret = UFP_OK, jobret;
+	uint32_t last_percentage = 0;
 	uint64_t t0, t1;
 
-	srand(ntd->seed);
-
 	progress_init();
 
 	t0 = os_get_timer_us();
 
+	block = nand_test_next_good_block(nandinst, ntd->start_block, end);
+
 	while (block < end) {
-		if (ufprog_bbt_is_bad(nandinst->bbt, block))
-			goto next_block;
+		page = block << nandinst->info.maux.pages_per_block_shift;
 
-		if (check_zero)
-			ret = nand_test_check_zero_block(nandinst, ntd,
-							 block << nandinst->info.maux.pages_per_block_shift);
-		else
-			ret = nand_test_verify_block_pattern(nandinst, ntd,
-							     block << nandinst->info.maux.pages_per_block_shift,
-							     pat_xor);
+		/* Check readback of previous block while current block is being read */
+		if (prev != UINT32_MAX) {
+			nand_test_submit_job(ntd, job, ntd->buf[idx ^ 1],
+					     prev << nandinst->info.maux.pages_per_block_shift, pat_xor);
+		}
 
+		ret = ufprog_nand_read_pages(nandinst->chip, page, nandinst->info.memorg.pages_per_block,
+					     ntd->buf[idx], ntd->raw, NAND_READ_F_IGNORE_ECC_ERROR, &rdcnt);
 		if (ret) {
+			os_fprintf(stderr, "Failed to read page %u at %" PRIx64 "\n", page + rdcnt,
+				   (uint64_t)(page + rdcnt) << nandinst->info.maux.page_shift);
 			os_fprintf(stderr, "Failed to verify block %u at %" PRIx64 "\n", block,
 				   (uint64_t)block << nandinst->info.maux.block_shift);
-			break;
 		}
 
-	next_block:
-		block++;
-		bcnt++;
+		if (prev != UINT32_MAX) {
+			jobret = nand_test_wait_job(ntd);
+			if (jobret) {
+				os_fprintf(stderr, "Failed to verify block %u at %" PRIx64 "\n", prev,
+					   (uint64_t)prev << nandinst->info.maux.block_shift);
+				if (!ret)
+					ret = jobret;
+			} else {
+				nand_test_report_flips(nandinst, ntd, prev << nandinst->info.maux.pages_per_block_shift,
+						       check_zero);
+			}
+		}
 
-		percentage = (uint32_t)((bcnt * 100ULL) / ntd->block_count);
-		if (percentage > last_percentage) {
-			last_percentage = percentage;
-			progress_show(last_percentage);
+		if (ret)
+			break;
+
+		prev = block;
+		block = nand_test_next_good_block(nandinst, block + 1, end);
+		idx ^= 1;
+
+		nand_test_update_progress(ntd, block, &last_percentage);
+	}
+
+	if (!ret && prev != UINT32_MAX) {
+		nand_test_submit_job(ntd, job, ntd->buf[idx ^ 1], prev << nandinst->info.maux.pages_per_block_shift,
+				     pat_xor);
+
+		ret = nand_test_wait_job(ntd);
+		if (ret) {
+			os_fprintf(stderr, "Failed to verify block %u at %" PRIx64 "\n", prev,
+				   (uint64_t)prev << nandinst->info.maux.block_shift);
+		} else {
+			nand_test_report_flips(nandinst, ntd, prev << nandinst->info.maux.pages_per_block_shift,
+					       check_zero);
 		}
 	}
 
@@ -504,9 +645,11 @@ static ufprog_status nand_test_verify_pattern(struct ufnand_instance *nandinst,
 	return ret;
 }
 
-static int nand_test_rw(struct ufnand_instance *nandinst, uint64_t addr, uint64_t len, bool raw, bool oob, bool fmt)
+static int nand_test_rw(struct ufnand_instance *nandinst, uint64_t addr, uint64_t len, bool raw, bool oob, bool fmt,
+			uint64_t seed, uint32_t threads)
 {
 	struct ufprog_nand_ecc_chip *ecc;
+	uint32_t fill_flags, cmp_types;
 	struct nand_test_data ntd;
 	bool dfl_layout = false;
 	ufprog_status ret;
@@ -534,7 +677,8 @@ static int nand_test_rw(struct ufnand_instance *nandinst, uint64_t addr, uint64_
 		return 0;
 	}
 
-	ntd.seed = (unsigned int)time(NULL);
+	ntd.nandinst = nandinst;
+	ntd.seed = seed;
 	ntd.raw = raw;
 	ntd.oob = oob;
 	ntd.fmt = fmt;
@@ -557,16 +701,40 @@ static int nand_test_rw(struct ufnand_instance *nandinst, uint64_t addr, uint64_
 		dfl_layout = true;
 	}
 
-	ntd.buf[0] = malloc(nandinst->info.maux.oob_block_size * 2 + nandinst->info.maux.oob_page_size);
+	fill_flags = PAGE_FILL_F_FILL_NON_DATA_FF;
+	cmp_types = BIT(NAND_PAGE_BYTE_DATA);
+
+	if (ntd.oob) {
+		fill_flags |= PAGE_FILL_F_FILL_OOB;
+
+		if (ntd.raw) {
+			fill_flags |= PAGE_FILL_F_FILL_UNPROTECTED_OOB | PAGE_FILL_F_FILL_UNUSED |
+				      PAGE_FILL_F_FILL_ECC_PARITY;
+			cmp_types |= BIT(NAND_PAGE_BYTE_OOB_DATA) | BIT(NAND_PAGE_BYTE_OOB_FREE) |
+				     BIT(NAND_PAGE_BYTE_ECC_PARITY) | BIT(NAND_PAGE_BYTE_UNUSED);
+		} else {
+			cmp_types |= BIT(NAND_PAGE_BYTE_OOB_DATA);
+		}
+	}
+
+	ret = ufprog_nand_compile_page_layout(ntd.layout, fill_flags, cmp_types, &ntd.prog);
+	if (ret) {
+		os_fprintf(stderr, "Failed to compile page layout\n");
+		goto cleanup_layout;
+	}
+
+	ntd.buf[0] = malloc(nandinst->info.maux.oob_block_size * 2 +
+			    nandinst->info.memorg.pages_per_block * sizeof(*ntd.flips));
 	if (!ntd.buf[0]) {
 		os_fprintf(stderr, "No memory for R/W test buffer\n");
-		goto cleanup_layout;
+		goto cleanup_prog;
 	}
 
 	ntd.buf[1] = ntd.buf[0] + nandinst->info.maux.oob_block_size;
-	ntd.map = ntd.buf[1] + nandinst->info.maux.oob_block_size;
+	ntd.flips = (uint32_t *)(ntd.buf[1] + nandinst->info.maux.oob_block_size);
 
-	ufprog_nand_page_layout_to_map(ntd.layout, ntd.map);
+	if (nand_test_start_workers(&ntd, threads))
+		goto cleanup_buf;
 
 	os_printf("[ Flash regular Read/Write/Erase test ]\n");
 	os_printf("Range: 0x%" PRIx64 " - 0x%" PRIx64 "\n", addr, end);
@@ -595,7 +763,7 @@ static int nand_test_rw(struct ufnand_instance *nandinst, uint64_t addr, uint64_
 	print_bbt(nandinst, nandinst->bbt);
 	os_printf("\n");
 
-	os_printf("Using seed %u\n", ntd.seed);
+	os_printf("Using seed 0x%" PRIx64 ", %u worker thread(s)\n", ntd.seed, ntd.num_workers);
 	os_printf("\n");
 
 	os_printf("1. Erase whole flash\n");
@@ -654,8 +822,12 @@ cleanup_bbt:
 	nandinst->bbt = NULL;
 
 cleanup_buf:
+	nand_test_stop_workers(&ntd);
 	free(ntd.buf[0]);
 
+cleanup_prog:
+	ufprog_nand_free_page_layout_prog(ntd.prog);
+
 cleanup_layout:
 	if (dfl_layout)
 		ufprog_nand_free_page_layout((struct nand_page_layout *)ntd.layout);
@@ -665,10 +837,11 @@ cleanup_layout:
 
 static int ufprog_main(int argc, char *argv[])
 {
-	ufprog_bool test_all = false, raw = false, oob = false, fmt = false;
+	ufprog_bool test_all = false, raw = false, oob = false, fmt = false, seed_set;
+	uint32_t threads = NAND_TEST_DFL_WORKERS;
 	char *device_name = NULL, *part = NULL, *ecc_cfg = NULL;
 	struct ufsnand_options nopt;
-	uint64_t addr = 0, len = 0;
+	uint64_t addr = 0, len = 0, seed = 0;
 	const char *last_devname;
 	int exitcode = 0, argp;
 	ufprog_status ret;
@@ -684,6 +857,8 @@ static int ufprog_main(int argc, char *argv[])
 		CMDARG_BOOL_OPT("fmt", fmt),
 		CMDARG_U64_OPT("addr", addr),
 		CMDARG_U64_OPT("len", len),
+		CMDARG_U64_OPT_SET("seed", seed, seed_set),
+		CMDARG_U32_OPT("threads", threads),
 	};
 
 	set_os_default_log_print();
@@ -712,6 +887,14 @@ static int ufprog_main(int argc, char *argv[])
 		return 0;
 	}
 
+	if (!seed_set)
+		seed = ((uint64_t)time(NULL) << 32) ^ os_get_timer_us();
+
+	if (!threads)
+		threads = 1;
+	else if (threads > NAND_TEST_MAX_WORKERS)
+		threads = NAND_TEST_MAX_WORKERS;
+
 	ufprog_spi_nand_load_ext_id_file();
 
 	ret = load_config(&configs, device_name);
@@ -766,7 +949,7 @@ static int ufprog_main(int argc, char *argv[])
 		}
 	}
 
-	exitcode = nand_test_rw(&snand_inst.nand, addr, len, raw, oob, fmt);
+	exitcode = nand_test_rw(&snand_inst.nand, addr, len, raw, oob, fmt, seed, threads);
 
 	os_printf("[ Flash test finished ]\n");
 
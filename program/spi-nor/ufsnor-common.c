@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ufprog/misc.h>
+#include <ufprog/crc32.h>
 #include <ufprog/sizes.h>
 #include <ufprog/osdef.h>
 #include <ufprog/config.h>
@@ -254,10 +255,238 @@ cleanup:
 	return ret;
 }
 
+static void calibration_key(char *key, size_t size, const char *model, uint32_t signature)
+{
+	snprintf(key, size, "%s@%08x", model, signature);
+}
+
+ufprog_status load_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t *rethz)
+{
+	struct json_object *jroot, *device_cfgs, *device_cfg, *speeds;
+	char key[UFSNOR_CALIBRATION_KEY_LEN];
+	ufprog_status ret;
+
+	*rethz = 0;
+
+	if (!device)
+		return UFP_OK;
+
+	ret = json_open_config(os_prog_name(), &jroot);
+	if (ret) {
+		if (ret == UFP_FILE_NOT_EXIST)
+			return UFP_OK;
+
+		return ret;
+	}
+
+	ret = json_read_obj(jroot, "device-configs", &device_cfgs);
+	if (ret || !device_cfgs)
+		goto cleanup;
+
+	ret = json_read_obj(device_cfgs, device, &device_cfg);
+	if (ret || !device_cfg)
+		goto cleanup;
+
+	ret = json_read_obj(device_cfg, "calibrated-speed", &speeds);
+	if (ret || !speeds)
+		goto cleanup;
+
+	calibration_key(key, sizeof(key), model, signature);
+
+	ret = json_read_uint32(speeds, key, rethz, 0);
+	if (ret == UFP_JSON_TYPE_INVALID)
+		os_fprintf(stderr, "'/device-configs/%s/calibrated-speed/%s' in config file is invalid\n", device, key);
+
+cleanup:
+	json_free(jroot);
+
+	return ret;
+}
+
+ufprog_status save_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t hz)
+{
+	struct json_object *jroot, *device_cfgs, *device_cfg, *speeds;
+	char key[UFSNOR_CALIBRATION_KEY_LEN];
+	ufprog_status ret;
+
+	ret = json_open_config(os_prog_name(), &jroot);
+	if (ret) {
+		if (ret == UFP_FILE_NOT_EXIST) {
+			ret = json_from_str("{}", &jroot);
+			if (ret) {
+				os_fprintf(stderr, "No memory to create json object\n");
+				return ret;
+			}
+		} else {
+			os_fprintf(stderr, "Failed to load config file\n");
+			return ret;
+		}
+	}
+
+	ret = json_read_obj(jroot, "device-configs", &device_cfgs);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs' in config is invalid\n");
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!device_cfgs) {
+		ret = json_create_obj(&device_cfgs);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs'\n");
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(jroot, "device-configs", device_cfgs);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs' in to config\n");
+			json_put_obj(device_cfgs);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	ret = json_read_obj(device_cfgs, device, &device_cfg);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs/%s' in config file is invalid\n", device);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!device_cfg) {
+		ret = json_create_obj(&device_cfg);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs/%s'\n", device);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(device_cfgs, device, device_cfg);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs/%s' in to config\n", device);
+			json_put_obj(device_cfg);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	ret = json_read_obj(device_cfg, "calibrated-speed", &speeds);
+	if (ret == UFP_JSON_TYPE_INVALID) {
+		os_fprintf(stderr, "'/device-configs/%s/calibrated-speed' in config file is invalid\n", device);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	if (!speeds) {
+		ret = json_create_obj(&speeds);
+		if (ret) {
+			os_fprintf(stderr, "Failed to create '/device-configs/%s/calibrated-speed'\n", device);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+
+		ret = json_add_obj(device_cfg, "calibrated-speed", speeds);
+		if (ret) {
+			os_fprintf(stderr, "Failed to add '/device-configs/%s/calibrated-speed' in to config\n", device);
+			json_put_obj(speeds);
+			ret = UFP_FAIL;
+			goto cleanup;
+		}
+	}
+
+	calibration_key(key, sizeof(key), model, signature);
+
+	ret = json_set_uint(speeds, key, hz);
+	if (ret) {
+		os_fprintf(stderr, "Failed to set '/device-configs/%s/calibrated-speed/%s' in config\n", device, key);
+		ret = UFP_FAIL;
+		goto cleanup;
+	}
+
+	ret = json_save_config(os_prog_name(), jroot);
+	if (ret)
+		os_fprintf(stderr, "Failed to save config file\n");
+
+cleanup:
+	json_free(jroot);
+
+	return ret;
+}
+
+bool digest_init(struct ufsnor_digest *dg, const char *crc32_str, const char *sha256_str)
+{
+	size_t len;
+	char *end;
+
+	memset(dg, 0, sizeof(*dg));
+
+	if (crc32_str) {
+		dg->expected_crc32 = strtoul(crc32_str, &end, 16);
+		if (end == crc32_str || *end) {
+			os_fprintf(stderr, "Expected CRC32 value is invalid\n");
+			return false;
+		}
+
+		dg->check_crc32 = true;
+	}
+
+	if (sha256_str) {
+		if (!hex_str_to_bin(sha256_str, dg->expected_sha256, sizeof(dg->expected_sha256), &len) ||
+		    len != sizeof(dg->expected_sha256)) {
+			os_fprintf(stderr, "Expected SHA-256 value is invalid\n");
+			return false;
+		}
+
+		dg->check_sha256 = true;
+	}
+
+	dg->crc32 = 0xffffffff;
+	sha256_init(&dg->sha256);
+
+	return true;
+}
+
+void digest_update(struct ufsnor_digest *dg, const void *data, size_t len)
+{
+	dg->crc32 = crc32_no_comp(dg->crc32, data, len);
+	sha256_update(&dg->sha256, data, len);
+}
+
+ufprog_status digest_finish(struct ufsnor_digest *dg)
+{
+	uint8_t sha256_result[SHA256_DIGEST_SIZE];
+	char sha256_str[SHA256_DIGEST_SIZE * 2 + 1];
+	ufprog_status ret = UFP_OK;
+
+	dg->crc32 ^= 0xffffffff;
+	sha256_final(&dg->sha256, sha256_result);
+
+	bin_to_hex_str(sha256_str, sizeof(sha256_str), sha256_result, sizeof(sha256_result), false, false);
+
+	os_printf("CRC32:   %08x\n", dg->crc32);
+	os_printf("SHA-256: %s\n", sha256_str);
+
+	if (dg->check_crc32 && dg->crc32 != dg->expected_crc32) {
+		os_fprintf(stderr, "CRC32 mismatch: expect %08x\n", dg->expected_crc32);
+		ret = UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	if (dg->check_sha256 && memcmp(sha256_result, dg->expected_sha256, sizeof(sha256_result))) {
+		bin_to_hex_str(sha256_str, sizeof(sha256_str), dg->expected_sha256, sizeof(dg->expected_sha256),
+			       false, false);
+		os_fprintf(stderr, "SHA-256 mismatch: expect %s\n", sha256_str);
+		ret = UFP_DATA_VERIFICATION_FAIL;
+	}
+
+	return ret;
+}
+
 ufprog_status open_device(const char *device_name, const char *part, uint32_t max_speed,
 			  struct ufsnor_instance *retinst, bool allow_fail)
 {
 	ufprog_status ret;
+	uint32_t speed;
 	uint64_t size;
 	char *unit;
 
@@ -319,6 +548,13 @@ ufprog_status open_device(const char *device_name, const char *part, uint32_t ma
 
 	ufprog_spi_nor_info(retinst->snor, &retinst->info);
 
+	retinst->device_name = device_name;
+
+	if (!load_calibrated_speed(device_name, retinst->info.model, retinst->info.signature, &speed) && speed) {
+		if (ufprog_spi_nor_set_speed_high(retinst->snor, speed))
+			os_fprintf(stderr, "Failed to apply calibrated speed\n");
+	}
+
 	retinst->max_read_granularity = ufprog_spi_max_read_granularity(retinst->spi);
 	retinst->speed = ufprog_spi_nor_get_speed_high(retinst->snor);
 
@@ -372,7 +608,7 @@ errout:
 	return UFP_OK;
 }
 
-static void print_speed(uint64_t size, uint64_t time_us)
+void print_speed(uint64_t size, uint64_t time_us)
 {
 	const char *speed_unit;
 	double speed;
@@ -394,6 +630,177 @@ static void print_speed(uint64_t size, uint64_t time_us)
 	os_printf("Time used: %.2fs, speed: %.2f%sB/s\n", (double)time_us / 1000000.0, speed, speed_unit);
 }
 
+static void journal_chip_id(struct ufsnor_instance *inst, char *buf, size_t size)
+{
+	uint8_t uid[UFSNOR_JOURNAL_UID_MAX_LEN];
+	uint32_t uidlen;
+	size_t n;
+
+	n = snprintf(buf, size, "%s %s ", inst->info.vendor, inst->info.model);
+	if (n >= size)
+		return;
+
+	bin_to_hex_str(buf + n, size - n, inst->info.id.id, inst->info.id.len, false, false);
+
+	/* Tie the journal to this very chip if it has a Unique ID */
+	if (ufprog_spi_nor_read_uid(inst->snor, NULL, &uidlen) || !uidlen || uidlen > sizeof(uid))
+		return;
+
+	if (ufprog_spi_nor_read_uid(inst->snor, uid, NULL))
+		return;
+
+	n = strlen(buf);
+	if (n + 2 >= size)
+		return;
+
+	buf[n++] = '@';
+	bin_to_hex_str(buf + n, size - n, uid, uidlen, false, false);
+}
+
+ufprog_status journal_open(struct ufsnor_instance *inst, const char *path, enum ufprog_journal_op op, uint64_t addr,
+			   uint64_t size, const void *image, bool resume, struct ufsnor_journal *retjnl)
+{
+	struct ufprog_journal_info info;
+	ufprog_status ret;
+
+	memset(&info, 0, sizeof(info));
+	memset(retjnl, 0, sizeof(*retjnl));
+
+	info.op = op;
+	info.start = addr;
+	info.size = size;
+	info.flags = inst->die_start | (inst->die_count << 16);
+
+	journal_chip_id(inst, info.chip_id, sizeof(info.chip_id));
+
+	if (image)
+		sha256(image, size, info.image_digest);
+
+	ret = ufprog_journal_open(path, &info, resume, &retjnl->jnl, &retjnl->phase, &retjnl->pos);
+	if (ret) {
+		os_fprintf(stderr, "Failed to open journal '%s'\n", path);
+		return ret;
+	}
+
+	if (!retjnl->pos && op == JOURNAL_OP_READ)
+		retjnl->phase = SNOR_JOURNAL_PHASE_READ;
+
+	retjnl->last_pos = retjnl->pos;
+
+	if (retjnl->phase == UFPROG_JOURNAL_PHASE_DONE)
+		os_printf("Journal shows this operation has been completed\n");
+	else if (retjnl->pos)
+		os_printf("Journal shows this operation stopped at 0x%" PRIx64 "\n", retjnl->pos);
+
+	return UFP_OK;
+}
+
+static ufprog_status journal_checkpoint(struct ufsnor_instance *inst, uint32_t phase, uint64_t pos, bool force)
+{
+	struct ufsnor_journal *j = inst->journal;
+	ufprog_status ret;
+
+	if (!j)
+		return UFP_OK;
+
+	/* Erase issued while programming (boundary re-erase) must not be recorded as erase progress */
+	if (!force && (phase != j->phase || pos - j->last_pos < UFSNOR_JOURNAL_UNIT))
+		return UFP_OK;
+
+	ret = ufprog_journal_checkpoint(j->jnl, phase, pos);
+	if (ret) {
+		os_fprintf(stderr, "Failed to update journal\n");
+		return ret;
+	}
+
+	j->phase = phase;
+	j->pos = pos;
+	j->last_pos = pos;
+
+	return UFP_OK;
+}
+
+ufprog_status journal_finish(struct ufsnor_instance *inst)
+{
+	if (!inst->journal || inst->journal->phase == UFPROG_JOURNAL_PHASE_DONE)
+		return UFP_OK;
+
+	return journal_checkpoint(inst, UFPROG_JOURNAL_PHASE_DONE, 0, true);
+}
+
+void journal_close(struct ufsnor_journal *jnl)
+{
+	ufprog_journal_close(jnl->jnl);
+	jnl->jnl = NULL;
+}
+
+static bool journal_done(struct ufsnor_instance *inst)
+{
+	if (!inst->journal || inst->journal->phase != UFPROG_JOURNAL_PHASE_DONE)
+		return false;
+
+	os_printf("Skipped as already completed\n");
+
+	return true;
+}
+
+/* Read back data for boundary validation without touching progress bar or digest */
+static ufprog_status journal_read_back(struct ufsnor_instance *inst, uint64_t addr, size_t len, void *buf)
+{
+	uint32_t die = inst->die_start + (uint32_t)(addr / inst->info.size);
+	ufprog_status ret;
+
+	ret = ufprog_spi_nor_select_die(inst->snor, die);
+	if (ret) {
+		os_fprintf(stderr, "Failed to select Die %u\n", die);
+		return ret;
+	}
+
+	ret = ufprog_spi_nor_read(inst->snor, addr % inst->info.size, len, buf);
+	if (ret)
+		os_fprintf(stderr, "Failed to read flash at 0x%" PRIx64 "\n", addr);
+
+	return ret;
+}
+
+/* Find the unit before @pos which must be intact for resuming at @pos */
+static uint64_t journal_check_start(struct ufsnor_instance *inst, uint64_t addr, uint64_t pos)
+{
+	uint64_t start = addr, die_base = ((pos - 1) / inst->info.size) * inst->info.size;
+
+	if (pos - start > UFSNOR_JOURNAL_UNIT)
+		start = pos - UFSNOR_JOURNAL_UNIT;
+
+	if (start < die_base)
+		start = die_base;
+
+	return start;
+}
+
+static ufprog_status journal_check_boundary(struct ufsnor_instance *inst, uint64_t addr, uint64_t pos,
+					    const uint8_t *gold, bool *retok)
+{
+	uint64_t start = journal_check_start(inst, addr, pos);
+	ufprog_status ret;
+	uint8_t *tmp;
+
+	*retok = false;
+
+	tmp = malloc((size_t)(pos - start));
+	if (!tmp) {
+		os_fprintf(stderr, "No memory for boundary validation\n");
+		return UFP_NOMEM;
+	}
+
+	ret = journal_read_back(inst, start, (size_t)(pos - start), tmp);
+	if (!ret)
+		*retok = !memcmp(tmp, gold + (start - addr), (size_t)(pos - start));
+
+	free(tmp);
+
+	return ret;
+}
+
 static ufprog_status read_flash_die(struct ufsnor_instance *inst, uint64_t addr, uint64_t size, void *buf,
 				    uint64_t base_addr, uint64_t base_size, uint64_t total_size)
 {
@@ -425,10 +832,17 @@ static ufprog_status read_flash_die(struct ufsnor_instance *inst, uint64_t addr,
 			goto cleanup;
 		}
 
+		if (inst->digest)
+			digest_update(inst->digest, p, chksz);
+
 		addr += chksz;
 		p += chksz;
 		sizerd += chksz;
 
+		ret = journal_checkpoint(inst, SNOR_JOURNAL_PHASE_READ, base_addr + sizerd, sizerd == size);
+		if (ret)
+			goto cleanup;
+
 		percentage = (uint32_t)(((base_size + sizerd) * 100) / total_size);
 		if (percentage > last_percentage) {
 			last_percentage = percentage;
@@ -445,13 +859,66 @@ cleanup:
 	return ret;
 }
 
+static ufprog_status read_flash_resume(struct ufsnor_instance *inst, uint64_t addr, uint64_t size, const void *buf,
+				       uint64_t *retpos)
+{
+	uint64_t pos = inst->journal->pos;
+	ufprog_status ret;
+	bool ok;
+
+	*retpos = addr;
+
+	if (inst->journal->phase != SNOR_JOURNAL_PHASE_READ || pos <= addr || pos > addr + size)
+		return UFP_OK;
+
+	ret = journal_check_boundary(inst, addr, pos, buf, &ok);
+	if (ret)
+		return ret;
+
+	if (!ok) {
+		pos = journal_check_start(inst, addr, pos);
+		os_printf("Data before 0x%" PRIx64 " does not match file. Re-reading from 0x%" PRIx64 "\n",
+			  inst->journal->pos, pos);
+	}
+
+	*retpos = pos;
+
+	return UFP_OK;
+}
+
 ufprog_status read_flash(struct ufsnor_instance *inst, uint64_t addr, uint64_t size, void *buf)
 {
-	uint64_t dieaddr = 0, opaddr, opsize, sizerd = 0, total_size = size, t0, t1;
+	uint64_t dieaddr = 0, opaddr, opsize, sizerd = 0, total_size, pos, t0, t1;
 	ufprog_status ret = UFP_OK;
 	uint8_t *p = buf;
 	uint32_t die;
 
+	if (inst->journal) {
+		if (journal_done(inst)) {
+			if (inst->digest)
+				digest_update(inst->digest, buf, size);
+			return UFP_OK;
+		}
+
+		ret = read_flash_resume(inst, addr, size, buf, &pos);
+		if (ret)
+			return ret;
+
+		if (pos > addr) {
+			os_printf("Resuming from 0x%" PRIx64 "\n", pos);
+
+			/* Digest must still cover data read in previous run */
+			if (inst->digest)
+				digest_update(inst->digest, buf, (size_t)(pos - addr));
+
+			p += pos - addr;
+			size -= pos - addr;
+			addr = pos;
+		}
+	}
+
+	total_size = size;
+
 	os_printf("Reading from flash at 0x%" PRIx64 ", size 0x%" PRIx64 " ...\n", addr, size);
 
 	progress_init();
@@ -634,6 +1101,9 @@ static ufprog_status verify_flash_die(struct ufsnor_instance *inst, uint64_t add
 			goto cleanup;
 		}
 
+		if (inst->digest)
+			digest_update(inst->digest, verify_buffer, chksz);
+
 		addr += chksz;
 		p += chksz;
 		sizerd += chksz;
@@ -709,6 +1179,31 @@ out:
 	return ret;
 }
 
+struct ufsnor_die_progress {
+	uint64_t total_size;
+	uint32_t last_percentage;
+};
+
+static void UFPROG_API ufsnor_die_progress_cb(void *priv, uint64_t size_done)
+{
+	struct ufsnor_die_progress *dp = priv;
+	uint32_t percentage;
+
+	percentage = (uint32_t)((size_done * 100) / dp->total_size);
+	if (percentage > dp->last_percentage) {
+		dp->last_percentage = percentage;
+		progress_show(percentage);
+	}
+}
+
+static bool range_spans_dies(struct ufsnor_instance *inst, uint64_t addr, uint64_t size)
+{
+	if (inst->die_count <= 1)
+		return false;
+
+	return addr / inst->info.size != (addr + size - 1) / inst->info.size;
+}
+
 static ufprog_status erase_flash_die(struct ufsnor_instance *inst, uint64_t addr, uint64_t size, uint64_t base_addr,
 				     uint64_t base_size, uint64_t total_size)
 {
@@ -731,6 +1226,10 @@ static ufprog_status erase_flash_die(struct ufsnor_instance *inst, uint64_t addr
 		addr += len;
 		sizeerased += len;
 
+		ret = journal_checkpoint(inst, SNOR_JOURNAL_PHASE_ERASE, base_addr + sizeerased, false);
+		if (ret)
+			return ret;
+
 		percentage = (uint32_t)(((base_size + sizeerased) * 100) / total_size);
 		if (percentage > last_percentage) {
 			last_percentage = percentage;
@@ -744,15 +1243,26 @@ static ufprog_status erase_flash_die(struct ufsnor_instance *inst, uint64_t addr
 ufprog_status erase_flash(struct ufsnor_instance *inst, uint64_t addr, uint64_t size)
 {
 	uint64_t end, dieaddr = 0, opaddr, opsize, sizeerased = 0, total_size, t0, t1;
+	struct ufsnor_die_progress dp;
 	ufprog_status ret = UFP_OK;
 	uint32_t die;
 
+	if (journal_done(inst))
+		return UFP_OK;
+
 	ret = ufprog_spi_nor_get_erase_range(inst->snor, addr, size, &addr, &end);
 	if (ret) {
 		os_fprintf(stderr, "Failed to calculate erase region\n");
 		return ret;
 	}
 
+	if (inst->journal && inst->journal->phase == SNOR_JOURNAL_PHASE_ERASE && inst->journal->pos > addr &&
+	    inst->journal->pos < end) {
+		/* Erase is always recorded at erase block boundary */
+		addr = inst->journal->pos;
+		os_printf("Resuming from 0x%" PRIx64 "\n", addr);
+	}
+
 	size = end - addr;
 	total_size = size;
 
@@ -762,6 +1272,22 @@ ufprog_status erase_flash(struct ufsnor_instance *inst, uint64_t addr, uint64_t
 
 	t0 = os_get_timer_us();
 
+	/* Interleaved erase does not complete in address order, thus can't be journaled */
+	if (!inst->journal && range_spans_dies(inst, addr, size)) {
+		dp.total_size = total_size;
+		dp.last_percentage = 0;
+
+		ret = ufprog_spi_nor_erase_dies(inst->snor, inst->die_start, inst->die_count, addr, size,
+						ufsnor_die_progress_cb, &dp);
+		if (ret != UFP_UNSUPPORTED) {
+			if (ret)
+				os_fprintf(stderr, "Interleaved erase failed\n");
+			goto out;
+		}
+
+		ret = UFP_OK;
+	}
+
 	for (die = inst->die_start; size && die < inst->die_start + inst->die_count; die++) {
 		if (addr < dieaddr || addr >= dieaddr + inst->info.size)
 			goto next;
@@ -833,6 +1359,10 @@ static ufprog_status write_flash_die_no_erase(struct ufsnor_instance *inst, uint
 		p += retlen;
 		sizewr += retlen;
 
+		ret = journal_checkpoint(inst, SNOR_JOURNAL_PHASE_PROGRAM, base_addr + sizewr, false);
+		if (ret)
+			goto cleanup;
+
 		percentage = (uint32_t)(((base_size + sizewr) * 100) / total_size);
 		if (percentage > last_percentage) {
 			last_percentage = percentage;
@@ -853,6 +1383,7 @@ ufprog_status write_flash_no_erase(struct ufsnor_instance *inst, uint64_t addr,
 				   bool verify)
 {
 	uint64_t dieaddr = 0, opaddr, opsize, sizewr = 0, orig_addr = addr, total_size = size, t0, t1;
+	struct ufsnor_die_progress dp;
 	ufprog_status ret = UFP_OK;
 	const uint8_t *p = buf;
 	uint32_t die;
@@ -863,6 +1394,21 @@ ufprog_status write_flash_no_erase(struct ufsnor_instance *inst, uint64_t addr,
 
 	t0 = os_get_timer_us();
 
+	if (!inst->journal && range_spans_dies(inst, addr, size)) {
+		dp.total_size = total_size;
+		dp.last_percentage = 0;
+
+		ret = ufprog_spi_nor_write_dies(inst->snor, inst->die_start, inst->die_count, addr, size, buf,
+						ufsnor_die_progress_cb, &dp);
+		if (ret != UFP_UNSUPPORTED) {
+			if (ret)
+				os_fprintf(stderr, "Interleaved write failed\n");
+			goto out;
+		}
+
+		ret = UFP_OK;
+	}
+
 	for (die = inst->die_start; size && die < inst->die_start + inst->die_count; die++) {
 		if (addr < dieaddr || addr >= dieaddr + inst->info.size)
 			goto next;
@@ -910,21 +1456,159 @@ out:
 	return ret;
 }
 
+static ufprog_status write_flash_resume(struct ufsnor_instance *inst, uint64_t addr, uint64_t size, const void *buf,
+					uint64_t *retpos)
+{
+	uint64_t pos = inst->journal->pos, end, eb_start, eb_end, tmp;
+	ufprog_status ret;
+	bool ok;
+
+	*retpos = addr;
+
+	if (pos <= addr)
+		return UFP_OK;
+
+	if (pos >= addr + size) {
+		*retpos = addr + size;
+		return UFP_OK;
+	}
+
+	/*
+	 * Checkpoints are written once per journal unit, so anything up to one unit after @pos may have been
+	 * programmed, and the last page may be incomplete. All erase blocks covering this window must be erased again.
+	 */
+	end = pos + UFSNOR_JOURNAL_UNIT;
+	if (end > addr + size)
+		end = addr + size;
+
+	ret = ufprog_spi_nor_get_erase_range(inst->snor, pos, end - pos, &eb_start, &eb_end);
+	if (ret) {
+		os_fprintf(stderr, "Failed to calculate erase region\n");
+		return ret;
+	}
+
+	if (eb_start > addr) {
+		ret = journal_check_boundary(inst, addr, eb_start, buf, &ok);
+		if (ret)
+			return ret;
+
+		if (!ok) {
+			os_printf("Data before 0x%" PRIx64 " does not match image\n", eb_start);
+
+			ret = ufprog_spi_nor_get_erase_range(inst->snor, journal_check_start(inst, addr, eb_start), 1,
+							     &eb_start, &tmp);
+			if (ret) {
+				os_fprintf(stderr, "Failed to calculate erase region\n");
+				return ret;
+			}
+		}
+	}
+
+	if (eb_start < addr)
+		eb_start = addr;
+
+	os_printf("Resuming from 0x%" PRIx64 "\n", eb_start);
+
+	ret = erase_flash(inst, eb_start, eb_end - eb_start);
+	if (ret)
+		return ret;
+
+	os_printf("\n");
+
+	ret = journal_checkpoint(inst, SNOR_JOURNAL_PHASE_PROGRAM, eb_start, true);
+	if (ret)
+		return ret;
+
+	*retpos = eb_start;
+
+	return UFP_OK;
+}
+
+static ufprog_status write_flash_journaled(struct ufsnor_instance *inst, uint64_t addr, size_t size, const void *buf,
+					   bool update, bool verify)
+{
+	struct ufsnor_journal *j = inst->journal;
+	uint64_t erase_start, erase_end, pos;
+	struct ufsnor_digest *digest;
+	ufprog_status ret;
+
+	ret = ufprog_spi_nor_get_erase_range(inst->snor, addr, size, &erase_start, &erase_end);
+	if (ret) {
+		os_fprintf(stderr, "Failed to calculate erase region\n");
+		return ret;
+	}
+
+	if (update && (erase_start < addr || erase_end > addr + size)) {
+		os_fprintf(stderr, "Journal can not be used for updating partial erase blocks\n");
+		return UFP_UNSUPPORTED;
+	}
+
+	if (journal_done(inst))
+		goto verify;
+
+	digest = inst->digest;
+	inst->digest = NULL;
+
+	if (j->phase == SNOR_JOURNAL_PHASE_ERASE) {
+		ret = erase_flash(inst, addr, size);
+		if (ret)
+			goto out;
+
+		os_printf("\n");
+
+		ret = journal_checkpoint(inst, SNOR_JOURNAL_PHASE_PROGRAM, addr, true);
+		if (ret)
+			goto out;
+	}
+
+	ret = write_flash_resume(inst, addr, size, buf, &pos);
+	if (ret)
+		goto out;
+
+	if (pos < addr + size) {
+		ret = write_flash_no_erase(inst, pos, addr + size - pos, (const uint8_t *)buf + (pos - addr), false);
+		if (ret)
+			goto out;
+
+		os_printf("\n");
+	}
+
+out:
+	inst->digest = digest;
+
+	if (ret)
+		return ret;
+
+verify:
+	if (!verify)
+		return UFP_OK;
+
+	/* Always verify the whole range as part of the data was written by previous run */
+	return verify_flash(inst, addr, size, buf);
+}
+
 ufprog_status write_flash(struct ufsnor_instance *inst, uint64_t addr, size_t size, const void *buf, bool update,
 			  bool verify)
 {
 	uint64_t erase_start, erase_end, backup_size;
+	struct ufsnor_digest *digest = inst->digest;
 	struct snor_update_backup_info backup_info[2];
 	size_t backup_count = 0;
 	ufprog_status ret;
 	uint32_t i;
 
+	if (inst->journal)
+		return write_flash_journaled(inst, addr, size, buf, update, verify);
+
 	ret = ufprog_spi_nor_get_erase_range(inst->snor, addr, size, &erase_start, &erase_end);
 	if (ret) {
 		os_fprintf(stderr, "Failed to calculate erase region\n");
 		return ret;
 	}
 
+	/* Digest only covers the data being written, not the backup data */
+	inst->digest = NULL;
+
 	if (update) {
 		if (erase_start < addr) {
 			backup_info[backup_count].addr = erase_start;
@@ -946,7 +1630,8 @@ ufprog_status write_flash(struct ufsnor_instance *inst, uint64_t addr, size_t si
 			backup_info[0].data = malloc(backup_size);
 			if (!backup_info[0].data) {
 				os_fprintf(stderr, "No memory for update backup data\n");
-				return UFP_NOMEM;
+				ret = UFP_NOMEM;
+				goto cleanup;
 			}
 
 			if (backup_count > 1)
@@ -970,7 +1655,9 @@ ufprog_status write_flash(struct ufsnor_instance *inst, uint64_t addr, size_t si
 
 	os_printf("\n");
 
+	inst->digest = digest;
 	ret = write_flash_no_erase(inst, addr, size, buf, verify);
+	inst->digest = NULL;
 	if (ret)
 		goto cleanup;
 
@@ -997,5 +1684,7 @@ cleanup:
 			free(backup_info[0].data);
 	}
 
+	inst->digest = digest;
+
 	return ret;
 }
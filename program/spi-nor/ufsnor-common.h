@@ -14,6 +14,8 @@
 #include <inttypes.h>
 #include <ufprog/log.h>
 #include <ufprog/cmdarg.h>
+#include <ufprog/sha256.h>
+#include <ufprog/journal.h>
 #include <ufprog/spi.h>
 #include <ufprog/spi-nor.h>
 
@@ -21,6 +23,17 @@
 #define UFSNOR_READ_GRANULARITY				0x10000
 #define UFSNOR_WRITE_GRANULARITY			0x200
 
+#define UFSNOR_CALIBRATION_KEY_LEN			128
+
+#define UFSNOR_JOURNAL_UNIT				0x10000
+#define UFSNOR_JOURNAL_UID_MAX_LEN			32
+
+enum ufsnor_journal_phase {
+	SNOR_JOURNAL_PHASE_ERASE,
+	SNOR_JOURNAL_PHASE_PROGRAM,
+	SNOR_JOURNAL_PHASE_READ,
+};
+
 struct ufsnor_options {
 	uint32_t log_level;
 	char *last_device;
@@ -28,7 +41,25 @@ struct ufsnor_options {
 	uint32_t max_speed;
 };
 
+struct ufsnor_digest {
+	uint32_t crc32;
+	struct sha256_context sha256;
+
+	bool check_crc32;
+	bool check_sha256;
+	uint32_t expected_crc32;
+	uint8_t expected_sha256[SHA256_DIGEST_SIZE];
+};
+
+struct ufsnor_journal {
+	struct ufprog_journal *jnl;
+	uint32_t phase;
+	uint64_t pos;
+	uint64_t last_pos;
+};
+
 struct ufsnor_instance {
+	const char *device_name;
 	struct ufprog_spi *spi;
 	struct spi_nor *snor;
 	struct spi_nor_info info;
@@ -37,12 +68,27 @@ struct ufsnor_instance {
 	uint32_t max_speed;
 	uint32_t die_start;
 	uint32_t die_count;
+	struct ufsnor_digest *digest;
+	struct ufsnor_journal *journal;
 };
 
 bool parse_args(struct cmdarg_entry *entries, uint32_t count, int argc, char *argv[], int *next_argc);
 
 ufprog_status load_config(struct ufsnor_options *retcfg, const char *curr_device);
 ufprog_status save_config(const struct ufsnor_options *cfg);
+ufprog_status load_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t *rethz);
+ufprog_status save_calibrated_speed(const char *device, const char *model, uint32_t signature, uint32_t hz);
+
+bool digest_init(struct ufsnor_digest *dg, const char *crc32_str, const char *sha256_str);
+void digest_update(struct ufsnor_digest *dg, const void *data, size_t len);
+ufprog_status digest_finish(struct ufsnor_digest *dg);
+
+void print_speed(uint64_t size, uint64_t time_us);
+
+ufprog_status journal_open(struct ufsnor_instance *inst, const char *path, enum ufprog_journal_op op, uint64_t addr,
+			   uint64_t size, const void *image, bool resume, struct ufsnor_journal *retjnl);
+ufprog_status journal_finish(struct ufsnor_instance *inst);
+void journal_close(struct ufsnor_journal *jnl);
 
 ufprog_status open_device(const char *device_name, const char *part, uint32_t max_speed,
 			  struct ufsnor_instance *retinst, bool allow_fail);
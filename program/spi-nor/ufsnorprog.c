@@ -62,13 +62,22 @@ static const char usage[] =
 	"    probe\n"
 	"        Detect the flash chip model and display its information.\n"
 	"\n"
-	"    read <file> [<addr> [<size>]]\n"
+	"    read [digest] [crc32=<val>] [sha256=<val>] [journal=<jfile> [resume]] <file>\n"
+	"         [<addr> [<size>]]\n"
 	"        Read flash data to file.\n"
-	"        file - The file path used to store flash data.\n"
-	"        addr - The start flash address to read from.\n"
-	"               Default is 0 if not specified.\n"
-	"        size - The size to be read.\n"
-	"               Default is the size from start address to end of flash.\n"
+	"        digest - Calculate and display CRC32 and SHA-256 of data read.\n"
+	"        crc32  - Expected CRC32 of data read. Implies digest.\n"
+	"        sha256 - Expected SHA-256 of data read. Implies digest.\n"
+	"        journal - Record progress into <jfile> so that an interrupted operation\n"
+	"                 can be resumed.\n"
+	"        resume - Continue the operation recorded in <jfile>. The journal must\n"
+	"                 match the flash chip, the file and the range. Data around\n"
+	"                 the point of interruption is validated before continuing.\n"
+	"        file   - The file path used to store flash data.\n"
+	"        addr   - The start flash address to read from.\n"
+	"                 Default is 0 if not specified.\n"
+	"        size   - The size to be read.\n"
+	"                 Default is the size from start address to end of flash.\n"
 	"\n"
 	"    dump sfdp\n"
 	"        Dump SFDP data to stdout if exists.\n"
@@ -78,13 +87,21 @@ static const char usage[] =
 	"               Default is 0 if not specified.\n"
 	"        size - The size to be dumped. Default is which to the end of page.\n"
 	"\n"
-	"    write [verify] <file> [<addr> [<size>]]\n"
-	"    update [verify] <file> [<addr> [<size>]]\n"
+	"    write [verify [digest] [crc32=<val>] [sha256=<val>]] [journal=<jfile> [resume]]\n"
+	"          <file> [<addr> [<size>]]\n"
+	"    update [verify [digest] [crc32=<val>] [sha256=<val>]] [journal=<jfile> [resume]]\n"
+	"           <file> [<addr> [<size>]]\n"
 	"        Write/update flash data from file.\n"
 	"        If a block has only part of its data being written, the rest of its\n"
 	"        data will be kept untouched by update subcommand while write subcommand\n"
 	"        will not.\n"
 	"        verify - Verify the data being written.\n"
+	"        digest - Calculate and display CRC32 and SHA-256 of data read back\n"
+	"                 during verification.\n"
+	"        crc32  - Expected CRC32 of data read back. Implies digest.\n"
+	"        sha256 - Expected SHA-256 of data read back. Implies digest.\n"
+	"        journal, resume - Same as read subcommand. For update subcommand, the\n"
+	"                 range must be aligned to erase blocks.\n"
 	"        file   - The file to be written to flash.\n"
 	"        addr   - The start flash address to be written to.\n"
 	"                 Default is 0 if not specified.\n"
@@ -93,8 +110,9 @@ static const char usage[] =
 	"                 If the file size is smaller that specified size, only available\n"
 	"                 file data will be written.\n"
 	"\n"
-	"    erase chip|[<addr> [<size>]]\n"
+	"    erase [journal=<jfile> [resume]] chip|[<addr> [<size>]]\n"
 	"        Erase flash range.\n"
+	"        journal, resume - Same as read subcommand.\n"
 	"        chip - Erase the whole chip.\n"
 	"        addr - The start flash address to be erased.\n"
 	"               Default is 0 if not specified.\n"
@@ -105,6 +123,18 @@ static const char usage[] =
 	"    uid\n"
 	"        Read the Unique ID if supported.\n"
 	"\n"
+	"    calibrate [rounds=<n>] [<addr> [<size>]]\n"
+	"        Find the highest reliable SPI clock for this device and flash chip.\n"
+	"        Data is read repeatedly at each available clock and compared with\n"
+	"        the data read at the lowest clock. One slower clock is chosen as\n"
+	"        margin if a faster clock failed. The result is stored in config and\n"
+	"        used for this device and flash chip afterwards.\n"
+	"        rounds - Number of reads at each clock. Default is 4.\n"
+	"        addr   - The start flash address of the data to be read.\n"
+	"                 Default is 0 if not specified.\n"
+	"        size   - The size of the data to be read. Default is 64KB.\n"
+	"                 Data should not be blank for a meaningful result.\n"
+	"\n"
 	"    reg list [<name>]\n"
 	"        List non-volatile configuration registers if supported.\n"
 	"    reg get [<name>] <field>\n"
@@ -309,24 +339,68 @@ cleanup:
 	return 0;
 }
 
+static bool check_journal_args(const char *journal_file, bool resume)
+{
+	if (resume && !journal_file) {
+		os_fprintf(stderr, "Journal file must be specified for resuming\n");
+		return false;
+	}
+
+	return true;
+}
+
+static void cleanup_journal(struct ufsnor_instance *inst)
+{
+	if (!inst->journal)
+		return;
+
+	journal_close(inst->journal);
+	inst->journal = NULL;
+}
+
 static int do_snor_read(void *priv, int argc, char *argv[])
 {
+	char *file, *end, *crc32_str = NULL, *sha256_str = NULL, *journal_file = NULL;
+	ufprog_bool use_digest = false, resume = false;
 	struct ufsnor_instance *inst = priv;
 	uint64_t addr = 0, opsize, size;
+	struct ufsnor_digest digest;
+	struct ufsnor_journal jnl;
 	ufprog_status ret;
-	char *file, *end;
 	int exitcode = 1;
 	file_mapping fm;
+	int argp;
 	void *p;
 
-	if (argc == 1) {
+	struct cmdarg_entry args[] = {
+		CMDARG_BOOL_OPT("digest", use_digest),
+		CMDARG_STRING_OPT("crc32", crc32_str),
+		CMDARG_STRING_OPT("sha256", sha256_str),
+		CMDARG_STRING_OPT("journal", journal_file),
+		CMDARG_BOOL_OPT("resume", resume),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
+		return 1;
+
+	if (!check_journal_args(journal_file, resume))
+		return 1;
+
+	if (argc == argp) {
 		os_fprintf(stderr, "File not specified for storing data\n");
 		return 1;
 	}
 
+	if (use_digest || crc32_str || sha256_str) {
+		if (!digest_init(&digest, crc32_str, sha256_str))
+			return 1;
+	}
+
 	opsize = inst->info.size * (uint64_t)inst->die_count;
 
-	file = argv[1];
+	file = argv[argp];
+	argc -= argp - 1;
+	argv += argp - 1;
 
 	if (argc > 2) {
 		addr = strtoull(argv[2], &end, 0);
@@ -362,18 +436,40 @@ static int do_snor_read(void *priv, int argc, char *argv[])
 		size = opsize - addr;
 	}
 
-	ret = os_open_file_mapping(file, size, size, true, true, &fm);
+	/* Data read by previous run must be kept for resuming */
+	ret = os_open_file_mapping(file, size, size, true, !resume, &fm);
 	if (ret)
 		return 1;
 
 	if (!os_set_file_mapping_offset(fm, 0, &p))
 		goto cleanup;
 
+	if (journal_file) {
+		ret = journal_open(inst, journal_file, JOURNAL_OP_READ, addr, size, NULL, resume, &jnl);
+		if (ret)
+			goto cleanup;
+
+		inst->journal = &jnl;
+	}
+
+	if (use_digest || crc32_str || sha256_str)
+		inst->digest = &digest;
+
 	ret = read_flash(inst, addr, size, p);
+
+	if (!ret)
+		ret = journal_finish(inst);
+
+	if (inst->digest && !ret)
+		ret = digest_finish(inst->digest);
+
+	inst->digest = NULL;
+
 	if (!ret)
 		exitcode = 0;
 
 cleanup:
+	cleanup_journal(inst);
 	os_close_file_mapping(fm);
 
 	return exitcode;
@@ -441,11 +537,13 @@ static int do_snor_dump(void *priv, int argc, char *argv[])
 
 static int do_snor_write_update(void *priv, int argc, char *argv[])
 {
+	char *file, *end, *crc32_str = NULL, *sha256_str = NULL, *journal_file = NULL;
+	ufprog_bool verify = false, use_digest = false, resume = false;
 	struct ufsnor_instance *inst = priv;
 	uint64_t addr = 0, opsize, maxsize, size;
-	ufprog_bool verify;
+	struct ufsnor_digest digest;
+	struct ufsnor_journal jnl;
 	ufprog_status ret;
-	char *file, *end;
 	int exitcode = 1;
 	file_mapping fm;
 	int argp;
@@ -453,11 +551,29 @@ static int do_snor_write_update(void *priv, int argc, char *argv[])
 
 	struct cmdarg_entry args[] = {
 		CMDARG_BOOL_OPT("verify", verify),
+		CMDARG_BOOL_OPT("digest", use_digest),
+		CMDARG_STRING_OPT("crc32", crc32_str),
+		CMDARG_STRING_OPT("sha256", sha256_str),
+		CMDARG_STRING_OPT("journal", journal_file),
+		CMDARG_BOOL_OPT("resume", resume),
 	};
 
 	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
 		return 1;
 
+	if (!check_journal_args(journal_file, resume))
+		return 1;
+
+	if (use_digest || crc32_str || sha256_str) {
+		if (!verify) {
+			os_fprintf(stderr, "Digest is only available with verify\n");
+			return 1;
+		}
+
+		if (!digest_init(&digest, crc32_str, sha256_str))
+			return 1;
+	}
+
 	if (argc == argp) {
 		os_fprintf(stderr, "File not specified for writing data\n");
 		return 1;
@@ -512,11 +628,32 @@ static int do_snor_write_update(void *priv, int argc, char *argv[])
 	if (size > maxsize)
 		size = maxsize;
 
+	if (journal_file) {
+		ret = journal_open(inst, journal_file, JOURNAL_OP_WRITE, addr, size, p, resume, &jnl);
+		if (ret)
+			goto cleanup;
+
+		inst->journal = &jnl;
+	}
+
+	if (use_digest || crc32_str || sha256_str)
+		inst->digest = &digest;
+
 	ret = write_flash(inst, addr, size, p, !strcmp(argv[0], "update"), verify);
+
+	if (!ret)
+		ret = journal_finish(inst);
+
+	if (inst->digest && !ret)
+		ret = digest_finish(inst->digest);
+
+	inst->digest = NULL;
+
 	if (!ret)
 		exitcode = 0;
 
 cleanup:
+	cleanup_journal(inst);
 	os_close_file_mapping(fm);
 
 	return exitcode;
@@ -526,7 +663,25 @@ static int do_snor_erase(void *priv, int argc, char *argv[])
 {
 	struct ufsnor_instance *inst = priv;
 	uint64_t addr = 0, opsize, size;
-	char *end;
+	char *end, *journal_file = NULL;
+	ufprog_bool resume = false;
+	struct ufsnor_journal jnl;
+	ufprog_status ret;
+	int argp;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_STRING_OPT("journal", journal_file),
+		CMDARG_BOOL_OPT("resume", resume),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
+		return 1;
+
+	if (!check_journal_args(journal_file, resume))
+		return 1;
+
+	argc -= argp - 1;
+	argv += argp - 1;
 
 	if (argc == 1) {
 		os_fprintf(stderr, "Erase start address not specified\n");
@@ -571,6 +726,22 @@ static int do_snor_erase(void *priv, int argc, char *argv[])
 		}
 	}
 
+	if (journal_file) {
+		ret = journal_open(inst, journal_file, JOURNAL_OP_ERASE, addr, size, NULL, resume, &jnl);
+		if (ret)
+			return 1;
+
+		inst->journal = &jnl;
+
+		ret = erase_flash(inst, addr, size);
+		if (!ret)
+			ret = journal_finish(inst);
+
+		cleanup_journal(inst);
+
+		return ret ? 1 : 0;
+	}
+
 	if (erase_flash(inst, addr, size))
 		return 1;
 
@@ -624,6 +795,70 @@ out:
 	return exitcode;
 }
 
+static int do_snor_calibrate(void *priv, int argc, char *argv[])
+{
+	struct ufsnor_instance *inst = priv;
+	uint64_t addr = 0, size = 0;
+	uint32_t rounds = 0, hz;
+	ufprog_status ret;
+	int argp;
+	char *end;
+
+	struct cmdarg_entry args[] = {
+		CMDARG_U32_OPT("rounds", rounds),
+	};
+
+	if (!parse_args(args, ARRAY_SIZE(args), argc, argv, &argp))
+		return 1;
+
+	if (argc > argp) {
+		addr = strtoull(argv[argp], &end, 0);
+		if (end == argv[argp] || *end || addr == ULONG_MAX) {
+			os_fprintf(stderr, "Start address is invalid\n");
+			return 1;
+		}
+
+		if (addr >= inst->info.size) {
+			os_fprintf(stderr, "Start address (0x%" PRIx64 ") is bigger than flash max address (0x%" PRIx64 ")\n",
+				   addr, inst->info.size - 1);
+			return 1;
+		}
+
+		argp++;
+	}
+
+	if (argc > argp) {
+		size = strtoull(argv[argp], &end, 0);
+		if (end == argv[argp] || *end || size == ULONG_MAX) {
+			os_fprintf(stderr, "Calibration size is invalid\n");
+			return 1;
+		}
+
+		if (addr + size > inst->info.size) {
+			size = inst->info.size - addr;
+			os_fprintf(stderr, "Calibration size exceeds flash size. Adjusted to 0x%" PRIx64 "\n", size);
+		}
+	}
+
+	os_printf("Calibrating SPI clock ...\n");
+
+	ret = ufprog_spi_nor_calibrate_speed(inst->snor, addr, (size_t)size, rounds, &hz);
+	if (ret) {
+		os_fprintf(stderr, "SPI clock calibration failed\n");
+		return 1;
+	}
+
+	os_printf("Calibrated SPI clock: %u.%03uMHz\n", hz / 1000000, (hz / 1000) % 1000);
+
+	if (!inst->device_name)
+		return 0;
+
+	if (save_calibrated_speed(inst->device_name, inst->info.model, inst->info.signature, hz))
+		return 1;
+
+	return 0;
+}
+
 static const char *snor_reg_field_get_value_name(const struct spi_nor_reg_field_values *values, uint32_t val)
 {
 	uint32_t i;
@@ -1490,6 +1725,7 @@ static const struct subcmd_entry cmds[] = {
 	SUBCMD("update", do_snor_write_update),
 	SUBCMD("erase", do_snor_erase),
 	SUBCMD("uid", do_snor_uid),
+	SUBCMD("calibrate", do_snor_calibrate),
 	SUBCMD("reg", do_snor_reg),
 	SUBCMD("otp", do_snor_otp),
 	SUBCMD("wp", do_snor_wp),
@@ -12,14 +12,38 @@
 #include <ufprog/misc.h>
 #include <ufprog/sizes.h>
 #include <ufprog/osdef.h>
+#include <ufprog/progbar.h>
 #include "ufsnor-common.h"
 
+#define UFSNOR_TEST_DFL_WINDOW				SZ_1M
+
+struct snor_test_param {
+	uint64_t seed;
+	uint64_t addr;
+	uint64_t size;
+	uint64_t window;
+};
+
+typedef ufprog_status (*snor_test_window_fn)(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+					     uint64_t addr, size_t len, uint8_t *buf, uint8_t *pat);
+
 static struct ufsnor_options configs;
 static struct ufsnor_instance snor_inst;
 
 static const char usage[] =
 	"Usage:\n"
-	"    %s [dev=<dev>] [part=<partmodel>] <test item> [<test item>...]\n"
+	"    %s [dev=<dev>] [part=<partmodel>] [seed=<n>] [addr=<addr>] [size=<size>]\n"
+	"       [window=<size>] <test item> [<test item>...]\n"
+	"\n"
+	"Options:\n"
+	"    seed   - Seed of the random test pattern. A new seed is generated if not\n"
+	"             specified. The seed used is always printed so that a failure can\n"
+	"             be reproduced.\n"
+	"    addr   - Start address of the R/W test range. Default is 0.\n"
+	"    size   - Size of the R/W test range. Default is to the end of flash.\n"
+	"             The range must be aligned to erase blocks.\n"
+	"    window - Size of data processed at a time by the R/W test.\n"
+	"             Default is 1MB. Memory used does not depend on flash size.\n"
 	"\n"
 	"Test items:\n"
 	"    all - Test all following items\n"
@@ -35,23 +59,159 @@ static void show_usage(void)
 	os_printf(usage, os_prog_name());
 }
 
-static void gen_pat(uint8_t *buf, size_t len)
+/* Any part of the pattern can be regenerated from its address */
+static void gen_pat(uint8_t *buf, uint64_t addr, size_t len, uint64_t seed, uint8_t xor)
 {
+	uint64_t val = 0;
 	size_t i;
 
-	srand((unsigned int)time(NULL));
+	for (i = 0; i < len; i++, addr++) {
+		if (!i || !(addr & 7))
+			val = splitmix64(seed, addr >> 3);
+
+		buf[i] = (uint8_t)(val >> ((addr & 7) * 8)) ^ xor;
+	}
+}
+
+static ufprog_status snor_test_io(struct ufsnor_instance *inst, uint64_t addr, size_t len, void *buf, bool write)
+{
+	uint8_t *p = buf;
+	ufprog_status ret;
+	uint64_t dieaddr;
+	uint32_t die;
+	size_t chksz;
+
+	while (len) {
+		die = (uint32_t)(addr / inst->info.size);
+		dieaddr = addr % inst->info.size;
+
+		chksz = len;
+		if (chksz > inst->info.size - dieaddr)
+			chksz = (size_t)(inst->info.size - dieaddr);
+
+		ret = ufprog_spi_nor_select_die(inst->snor, die);
+		if (ret) {
+			os_fprintf(stderr, "Failed to select Die %u\n", die);
+			return ret;
+		}
+
+		if (write)
+			ret = ufprog_spi_nor_write(inst->snor, dieaddr, chksz, p);
+		else
+			ret = ufprog_spi_nor_read(inst->snor, dieaddr, chksz, p);
+
+		if (ret) {
+			os_fprintf(stderr, "Failed to %s flash at 0x%" PRIx64 "\n", write ? "write" : "read", addr);
+			return ret;
+		}
+
+		addr += chksz;
+		p += chksz;
+		len -= chksz;
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status snor_test_check(const struct snor_test_param *tp, uint64_t addr, const uint8_t *buf,
+				     const uint8_t *expected, uint8_t fill, size_t len)
+{
+	uint8_t exp;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		exp = expected ? expected[i] : fill;
+
+		if (buf[i] != exp) {
+			os_fprintf(stderr, "\nData at 0x%" PRIx64 " is 0x%02x, expected 0x%02x (seed 0x%" PRIx64 ")\n",
+				   addr + i, buf[i], exp, tp->seed);
+			return UFP_DATA_VERIFICATION_FAIL;
+		}
+	}
+
+	return UFP_OK;
+}
+
+static ufprog_status snor_test_verify_erased(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+					     uint64_t addr, size_t len, uint8_t *buf, uint8_t *pat)
+{
+	STATUS_CHECK_RET(snor_test_io(inst, addr, len, buf, false));
+
+	return snor_test_check(tp, addr, buf, NULL, 0xff, len);
+}
+
+static ufprog_status snor_test_write_verify(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+					    uint64_t addr, size_t len, uint8_t *buf, uint8_t *pat)
+{
+	gen_pat(pat, addr, len, tp->seed, 0);
+
+	STATUS_CHECK_RET(snor_test_io(inst, addr, len, pat, true));
+	STATUS_CHECK_RET(snor_test_io(inst, addr, len, buf, false));
+
+	return snor_test_check(tp, addr, buf, pat, 0, len);
+}
+
+static ufprog_status snor_test_write_complement(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+						uint64_t addr, size_t len, uint8_t *buf, uint8_t *pat)
+{
+	gen_pat(pat, addr, len, tp->seed, 0xff);
+
+	return snor_test_io(inst, addr, len, pat, true);
+}
+
+static ufprog_status snor_test_verify_zero(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+					   uint64_t addr, size_t len, uint8_t *buf, uint8_t *pat)
+{
+	STATUS_CHECK_RET(snor_test_io(inst, addr, len, buf, false));
+
+	return snor_test_check(tp, addr, buf, NULL, 0, len);
+}
+
+static ufprog_status snor_test_stream(struct ufsnor_instance *inst, const struct snor_test_param *tp,
+				      snor_test_window_fn fn, uint8_t *buf, uint8_t *pat)
+{
+	uint32_t percentage, last_percentage = 0;
+	uint64_t done = 0, t0, t1;
+	ufprog_status ret;
+	size_t len;
+
+	progress_init();
+
+	t0 = os_get_timer_us();
+
+	while (done < tp->size) {
+		len = (size_t)tp->window;
+		if (len > tp->size - done)
+			len = (size_t)(tp->size - done);
+
+		ret = fn(inst, tp, tp->addr + done, len, buf, pat);
+		if (ret)
+			return ret;
+
+		done += len;
+
+		percentage = (uint32_t)((done * 100) / tp->size);
+		if (percentage > last_percentage) {
+			last_percentage = percentage;
+			progress_show(last_percentage);
+		}
+	}
+
+	t1 = os_get_timer_us();
+
+	progress_done();
+	print_speed(tp->size, t1 - t0);
+	os_printf("Succeeded\n");
 
-	for (i = 0; i < len; i++)
-		buf[i] = (uint8_t)(rand() * UCHAR_MAX / RAND_MAX);
+	return UFP_OK;
 }
 
-static int snor_test_rw(struct ufsnor_instance *inst)
+static int snor_test_rw(struct ufsnor_instance *inst, struct snor_test_param *tp)
 {
+	uint64_t opsize, erase_start, erase_end;
 	uint8_t *buf, *test_pat;
-	size_t test_size, i;
 	ufprog_status ret;
 	int exitcode = 1;
-	uint64_t opsize;
 
 	os_printf("[ Flash regular Read/Write/Erase test ]\n");
 	os_printf("\n");
@@ -61,64 +221,78 @@ static int snor_test_rw(struct ufsnor_instance *inst)
 
 	opsize = inst->info.size * (uint64_t)inst->info.ndies;
 
-	if (opsize > SIZE_MAX / 2)
-		test_size = SIZE_MAX / 2;
-	else
-		test_size = opsize;
+	if (tp->addr >= opsize) {
+		os_fprintf(stderr, "Test address 0x%" PRIx64 " exceeds flash size\n", tp->addr);
+		return 1;
+	}
 
-	buf = malloc(test_size * 2);
+	if (!tp->size || tp->size > opsize - tp->addr)
+		tp->size = opsize - tp->addr;
+
+	/* Erasing rounds the range out to erase blocks, which would destroy data outside of the test range */
+	ret = ufprog_spi_nor_get_erase_range(inst->snor, tp->addr, tp->size, &erase_start, &erase_end);
+	if (ret) {
+		os_fprintf(stderr, "Failed to calculate erase region\n");
+		return 1;
+	}
+
+	if (erase_start != tp->addr || erase_end != tp->addr + tp->size) {
+		os_fprintf(stderr, "Test range 0x%" PRIx64 " - 0x%" PRIx64 " is not aligned to erase blocks\n", tp->addr,
+			   tp->addr + tp->size - 1);
+		os_fprintf(stderr, "Erasing it would affect 0x%" PRIx64 " - 0x%" PRIx64 "\n", erase_start,
+			   erase_end - 1);
+		return 1;
+	}
+
+	if (!tp->window || tp->window > SIZE_MAX / 2)
+		tp->window = UFSNOR_TEST_DFL_WINDOW;
+
+	if (tp->window > tp->size)
+		tp->window = tp->size;
+
+	os_printf("Test range: 0x%" PRIx64 " - 0x%" PRIx64 ", window 0x%" PRIx64 ", seed 0x%" PRIx64 "\n", tp->addr,
+		  tp->addr + tp->size - 1, tp->window, tp->seed);
+	os_printf("\n");
+
+	buf = malloc((size_t)tp->window * 2);
 	if (!buf) {
 		os_fprintf(stderr, "No memory for R/W test buffer\n");
 		return 1;
 	}
 
-	test_pat = buf + test_size;
+	test_pat = buf + tp->window;
 
-	os_printf("1. Erase whole flash\n");
+	os_printf("1. Erase test range\n");
 
-	ret = erase_flash(inst, 0, test_size);
+	ret = erase_flash(inst, tp->addr, tp->size);
 	if (ret)
 		goto out;
 	os_printf("\n");
 
 	os_printf("2. Verifying if all data bytes are FFh after erase\n");
 
-	ret = read_flash(inst, 0, test_size, buf);
+	ret = snor_test_stream(inst, tp, snor_test_verify_erased, buf, test_pat);
 	if (ret)
 		goto out;
 	os_printf("\n");
 
-	for (i = 0; i < test_size; i++) {
-		if (buf[i] != 0xff) {
-			os_fprintf(stderr, "Data at 0x%zx is 0x%02x, expected 0xff\n", i, buf[i]);
-			goto out;
-		}
-	}
-
-	gen_pat(test_pat, test_size);
-
 	os_printf("3. Writing random pattern and verify\n");
 
-	ret = write_flash_no_erase(inst, 0, test_size, test_pat, true);
+	ret = snor_test_stream(inst, tp, snor_test_write_verify, buf, test_pat);
 	if (ret)
 		goto out;
 	os_printf("\n");
 
 	os_printf("4. Writing complementary pattern\n");
 
-	for (i = 0; i < test_size; i++)
-		test_pat[i] ^= 0xff;
-
-	ret = write_flash_no_erase(inst, 0, test_size, test_pat, false);
+	ret = snor_test_stream(inst, tp, snor_test_write_complement, buf, test_pat);
 	if (ret)
 		goto out;
 	os_printf("\n");
 
 	os_printf("5. Verify all zero data\n");
 
-	memset(test_pat, 0, test_size);
-
-	ret = verify_flash(inst, 0, test_size, test_pat);
+	ret = snor_test_stream(inst, tp, snor_test_verify_zero, buf, test_pat);
 	if (ret)
 		goto out;
 	os_printf("\n");
@@ -134,7 +308,7 @@ out:
 	return exitcode;
 }
 
-static ufprog_status snor_test_otp_region(struct ufsnor_instance *inst, uint32_t index)
+static ufprog_status snor_test_otp_region(struct ufsnor_instance *inst, uint32_t index, uint64_t seed)
 {
 	uint8_t *buf, *test_pat;
 	uint32_t test_size, i;
@@ -178,7 +352,7 @@ static ufprog_status snor_test_otp_region(struct ufsnor_instance *inst, uint32_t
 	}
 	os_printf("       Succeeded\n");
 
-	gen_pat(test_pat, test_size);
+	gen_pat(test_pat, 0, test_size, seed, 0);
 
 	os_printf("    3. Write random pattern\n");
 
@@ -245,7 +419,7 @@ out:
 	return exitcode;
 }
 
-static int snor_test_otp_die(struct ufsnor_instance *inst, uint32_t die)
+static int snor_test_otp_die(struct ufsnor_instance *inst, uint32_t die, uint64_t seed)
 {
 	ufprog_bool locked;
 	ufprog_status ret;
@@ -274,7 +448,7 @@ static int snor_test_otp_die(struct ufsnor_instance *inst, uint32_t die)
 			continue;
 		}
 
-		ret = snor_test_otp_region(inst, inst->info.otp->start_index + i);
+		ret = snor_test_otp_region(inst, inst->info.otp->start_index + i, seed);
 		if (ret)
 			exitcode = 1;
 
@@ -284,7 +458,7 @@ static int snor_test_otp_die(struct ufsnor_instance *inst, uint32_t die)
 	return exitcode;
 }
 
-static int snor_test_otp(struct ufsnor_instance *inst)
+static int snor_test_otp(struct ufsnor_instance *inst, uint64_t seed)
 {
 	ufprog_status ret;
 	uint32_t die;
@@ -303,7 +477,7 @@ static int snor_test_otp(struct ufsnor_instance *inst)
 	os_printf("\n");
 
 	for (die = 0; die < inst->info.ndies; die++) {
-		ret = snor_test_otp_die(inst, die);
+		ret = snor_test_otp_die(inst, die, seed);
 		if (ret) {
 			os_printf("OTP region test failed on Die %u\n", die);
 			return 1;
@@ -413,15 +587,21 @@ static int ufprog_main(int argc, char *argv[])
 {
 	ufprog_bool test_all = false, test_rw = false, test_otp = false, test_wp = false;
 	char *device_name = NULL, *part = NULL;
+	struct snor_test_param tp = { 0 };
 	struct ufsnor_options nopt;
 	const char *last_devname;
 	int exitcode = 0, argp;
+	ufprog_bool seed_set;
 	ufprog_status ret;
 	char *devname;
 
 	struct cmdarg_entry args[] = {
 		CMDARG_STRING_OPT("dev", device_name),
 		CMDARG_STRING_OPT("part", part),
+		CMDARG_U64_OPT_SET("seed", tp.seed, seed_set),
+		CMDARG_U64_OPT("addr", tp.addr),
+		CMDARG_U64_OPT("size", tp.size),
+		CMDARG_U64_OPT("window", tp.window),
 		CMDARG_BOOL_OPT("all", test_all),
 		CMDARG_BOOL_OPT("rw", test_rw),
 		CMDARG_BOOL_OPT("otp", test_otp),
@@ -448,6 +628,9 @@ static int ufprog_main(int argc, char *argv[])
 		return 1;
 	}
 
+	if (!seed_set)
+		tp.seed = ((uint64_t)time(NULL) << 32) ^ os_get_timer_us();
+
 	if (test_all) {
 		test_rw = true;
 		test_otp = true;
@@ -498,13 +681,13 @@ static int ufprog_main(int argc, char *argv[])
 	}
 
 	if (test_rw) {
-		exitcode = snor_test_rw(&snor_inst);
+		exitcode = snor_test_rw(&snor_inst, &tp);
 		if (exitcode)
 			goto out;
 	}
 
 	if (test_otp) {
-		exitcode = snor_test_otp(&snor_inst);
+		exitcode = snor_test_otp(&snor_inst, tp.seed);
 		if (exitcode)
 			goto out;
 	}
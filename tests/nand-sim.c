@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Simulated NAND flash chip with fault injection
+ */
+
+#include <malloc.h>
+#include <string.h>
+#include "nand-sim.h"
+
+static uint8_t nand_sim_fixup(struct nand_sim *sim, uint32_t page, uint32_t column, uint8_t val)
+{
+	uint32_t block = page >> sim->nand.maux.pages_per_block_shift;
+
+	if (column || (page & sim->nand.maux.pages_per_block_mask))
+		return val;
+
+	if (sim->faults[block] & NAND_SIM_F_STUCK_0)
+		val &= ~1;
+
+	if (sim->faults[block] & NAND_SIM_F_STUCK_1)
+		val |= 1;
+
+	return val;
+}
+
+static ufprog_status nand_sim_read_page(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
+					void *buf)
+{
+	struct nand_sim *sim = container_of(nand, struct nand_sim, nand);
+	const uint8_t *p = sim->array + (size_t)page * nand->maux.oob_page_size;
+	uint8_t *data = buf;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		data[i] = nand_sim_fixup(sim, page, column + i, p[column + i]);
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_sim_write_page(struct nand_chip *nand, uint32_t page, uint32_t column, uint32_t len,
+					 const void *buf)
+{
+	struct nand_sim *sim = container_of(nand, struct nand_sim, nand);
+	uint32_t block = page >> nand->maux.pages_per_block_shift;
+	uint8_t *p = sim->array + (size_t)page * nand->maux.oob_page_size;
+	const uint8_t *data = buf;
+	uint32_t i;
+
+	if (sim->programmed[page] && (sim->faults[block] & NAND_SIM_F_NO_REPROGRAM))
+		return UFP_OK;
+
+	for (i = 0; i < len; i++)
+		p[column + i] &= data[i];
+
+	sim->programmed[page] = true;
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_sim_erase_block(struct nand_chip *nand, uint32_t page)
+{
+	struct nand_sim *sim = container_of(nand, struct nand_sim, nand);
+	uint32_t block = page >> nand->maux.pages_per_block_shift;
+
+	page = block << nand->maux.pages_per_block_shift;
+
+	if (sim->faults[block] & NAND_SIM_F_ERASE_FAIL)
+		return UFP_FLASH_ERASE_FAILED;
+
+	memset(sim->array + (size_t)page * nand->maux.oob_page_size, 0xff, nand->maux.oob_block_size);
+	memset(sim->programmed + page, 0, nand->memorg.pages_per_block * sizeof(*sim->programmed));
+
+	sim->erase_count[block]++;
+
+	return UFP_OK;
+}
+
+static ufprog_status nand_sim_select_die(struct nand_chip *nand, uint32_t ce, uint32_t lun)
+{
+	return UFP_OK;
+}
+
+ufprog_status nand_sim_create(const struct nand_memorg *memorg, bool random_page_write, uint32_t nops,
+			      struct nand_sim **outsim)
+{
+	struct nand_sim *sim;
+
+	sim = calloc(1, sizeof(*sim));
+	if (!sim)
+		return UFP_NOMEM;
+
+	sim->nand.model = "SIM";
+	sim->nand.vendor = "Test";
+	sim->nand.bus_width = 8;
+	sim->nand.bits_per_cell = 1;
+	sim->nand.nops = nops;
+	sim->nand.random_page_write = random_page_write;
+	memcpy(&sim->nand.memorg, memorg, sizeof(*memorg));
+
+	sim->nand.select_die = nand_sim_select_die;
+	sim->nand.read_page = nand_sim_read_page;
+	sim->nand.write_page = nand_sim_write_page;
+	sim->nand.erase_block = nand_sim_erase_block;
+
+	ufprog_nand_update_param(&sim->nand);
+
+	sim->array = malloc((size_t)sim->nand.maux.page_count * sim->nand.maux.oob_page_size);
+	sim->programmed = calloc(sim->nand.maux.page_count, sizeof(*sim->programmed));
+	sim->faults = calloc(sim->nand.maux.block_count, sizeof(*sim->faults));
+	sim->erase_count = calloc(sim->nand.maux.block_count, sizeof(*sim->erase_count));
+	sim->nand.page_cache[0] = malloc(2 * sim->nand.maux.oob_page_size);
+
+	if (!sim->array || !sim->programmed || !sim->faults || !sim->erase_count || !sim->nand.page_cache[0]) {
+		nand_sim_free(sim);
+		return UFP_NOMEM;
+	}
+
+	sim->nand.page_cache[1] = (uint8_t *)sim->nand.page_cache[0] + sim->nand.maux.oob_page_size;
+
+	/* Factory state: all blocks erased */
+	memset(sim->array, 0xff, (size_t)sim->nand.maux.page_count * sim->nand.maux.oob_page_size);
+
+	*outsim = sim;
+
+	return UFP_OK;
+}
+
+void nand_sim_free(struct nand_sim *sim)
+{
+	if (!sim)
+		return;
+
+	free(sim->nand.page_cache[0]);
+	free(sim->erase_count);
+	free(sim->faults);
+	free(sim->programmed);
+	free(sim->array);
+	free(sim);
+}
+
+void nand_sim_inject(struct nand_sim *sim, uint32_t block, uint32_t faults)
+{
+	sim->faults[block] = faults;
+}
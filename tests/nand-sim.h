@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: LGPL-2.1-only */
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Simulated NAND flash chip with fault injection
+ */
+#pragma once
+
+#ifndef _UFPROG_TEST_NAND_SIM_H_
+#define _UFPROG_TEST_NAND_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ufprog/bits.h>
+#include <nand-internal.h>
+
+/* Faults injected per block */
+#define NAND_SIM_F_ERASE_FAIL			BIT(0)	/* Erase reports failure and leaves data unchanged */
+#define NAND_SIM_F_STUCK_0			BIT(1)	/* Bit 0 of the first byte always reads as 0 */
+#define NAND_SIM_F_STUCK_1			BIT(2)	/* Bit 0 of the first byte always reads as 1 */
+#define NAND_SIM_F_NO_REPROGRAM			BIT(3)	/* Programming a page twice without erase has no effect */
+
+/*
+ * Programming ANDs the data into the array like real NAND cells, so a page written twice without erase reads back
+ * as both patterns ANDed.
+ */
+struct nand_sim {
+	struct nand_chip nand;
+
+	uint8_t *array;
+	bool *programmed;
+	uint32_t *faults;
+	uint32_t *erase_count;
+};
+
+ufprog_status nand_sim_create(const struct nand_memorg *memorg, bool random_page_write, uint32_t nops,
+			      struct nand_sim **outsim);
+void nand_sim_free(struct nand_sim *sim);
+
+void nand_sim_inject(struct nand_sim *sim, uint32_t block, uint32_t faults);
+
+#endif /* _UFPROG_TEST_NAND_SIM_H_ */
@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * Job queue test
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <ufprog/job.h>
+#include <ufprog/osdef.h>
+
+#define DISPATCH_TIMEOUT_US			5000000
+
+#define CHECK(_cond)								\
+	do {									\
+		if (!(_cond)) {							\
+			os_fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				   __FILE__, __LINE__, #_cond);			\
+			return 1;						\
+		}								\
+	} while (0)
+
+struct test_job {
+	event_handle started;
+	event_handle release;
+	bool wait_cancel;
+
+	uint32_t *order;
+	uint32_t *norder;
+	uint32_t id;
+
+	bool completed;
+	ufprog_status result;
+};
+
+static ufprog_status UFPROG_API test_job_run(struct ufprog_job *job, void *priv)
+{
+	struct test_job *tj = priv;
+
+	if (tj->started)
+		os_set_event(tj->started);
+
+	if (tj->release)
+		os_wait_event(tj->release, OS_WAIT_INFINITE);
+
+	if (tj->wait_cancel) {
+		while (!ufprog_job_cancelled(job))
+			os_usleep(1000);
+
+		return UFP_CANCELLED;
+	}
+
+	/* Only one worker is used, so no lock is needed */
+	if (tj->order)
+		tj->order[(*tj->norder)++] = tj->id;
+
+	return UFP_OK;
+}
+
+static void UFPROG_API test_job_complete(void *priv, struct ufprog_job *job, ufprog_status result)
+{
+	struct test_job *tj = priv;
+
+	tj->completed = true;
+	tj->result = result;
+}
+
+static ufprog_status test_submit(struct ufprog_job_queue *q, struct test_job *tj, struct ufprog_job **outjob)
+{
+	struct ufprog_job_callbacks cbs = {
+		.complete = test_job_complete,
+		.priv = tj,
+	};
+
+	return ufprog_job_submit(q, test_job_run, NULL, tj, &cbs, outjob);
+}
+
+static bool test_dispatch_until(struct ufprog_job_queue *q, const struct test_job *tj)
+{
+	uint64_t end = os_get_timer_us() + DISPATCH_TIMEOUT_US;
+
+	do {
+		ufprog_job_queue_dispatch(q);
+		if (tj->completed)
+			return true;
+
+		os_usleep(1000);
+	} while (os_get_timer_us() <= end);
+
+	return false;
+}
+
+/* Jobs run in submission order. A queued job can be cancelled and never runs. */
+static int test_queue_order_cancel(void)
+{
+	struct test_job blocker = { 0 }, jobs[3] = { 0 };
+	struct ufprog_job *cancel_job;
+	struct ufprog_job_queue *q;
+	uint32_t order[4], norder = 0, i;
+
+	CHECK(!ufprog_job_queue_create(1, &q));
+	CHECK(ufprog_job_queue_workers(q) == 1);
+
+	CHECK(os_create_event(&blocker.started));
+	CHECK(os_create_event(&blocker.release));
+
+	CHECK(!test_submit(q, &blocker, NULL));
+	CHECK(os_wait_event(blocker.started, OS_WAIT_INFINITE));
+
+	for (i = 0; i < 3; i++) {
+		jobs[i].order = order;
+		jobs[i].norder = &norder;
+		jobs[i].id = i;
+
+		CHECK(!test_submit(q, &jobs[i], i == 1 ? &cancel_job : NULL));
+	}
+
+	CHECK(!ufprog_job_cancel(cancel_job));
+
+	os_set_event(blocker.release);
+
+	CHECK(test_dispatch_until(q, &jobs[2]));
+	CHECK(test_dispatch_until(q, &jobs[1]));
+	CHECK(blocker.completed && blocker.result == UFP_OK);
+
+	CHECK(jobs[0].result == UFP_OK);
+	CHECK(jobs[1].result == UFP_CANCELLED);
+	CHECK(jobs[2].result == UFP_OK);
+
+	CHECK(norder == 2);
+	CHECK(order[0] == 0 && order[1] == 2);
+
+	/* Already completed */
+	CHECK(ufprog_job_cancel(cancel_job) == UFP_FAIL);
+	ufprog_job_release(cancel_job);
+
+	CHECK(!ufprog_job_queue_destroy(q));
+
+	os_free_event(blocker.started);
+	os_free_event(blocker.release);
+
+	CHECK(ufprog_job_cancel(NULL) == UFP_INVALID_PARAMETER);
+
+	return 0;
+}
+
+/* A running job sees the cancel request */
+static int test_cancel_running(void)
+{
+	struct test_job tj = { 0 };
+	struct ufprog_job_queue *q;
+	struct ufprog_job *job;
+
+	CHECK(!ufprog_job_queue_create(1, &q));
+
+	CHECK(os_create_event(&tj.started));
+	tj.wait_cancel = true;
+
+	CHECK(!test_submit(q, &tj, &job));
+	CHECK(os_wait_event(tj.started, OS_WAIT_INFINITE));
+
+	CHECK(!ufprog_job_cancel(job));
+	CHECK(test_dispatch_until(q, &tj));
+	CHECK(tj.result == UFP_CANCELLED);
+
+	ufprog_job_release(job);
+
+	CHECK(!ufprog_job_queue_destroy(q));
+
+	os_free_event(tj.started);
+
+	return 0;
+}
+
+/* Destroying the queue completes pending jobs as cancelled */
+static int test_destroy_pending(void)
+{
+	struct test_job blocker = { 0 }, tj = { 0 };
+	struct ufprog_job_queue *q;
+
+	CHECK(!ufprog_job_queue_create(1, &q));
+
+	CHECK(os_create_event(&blocker.started));
+	blocker.wait_cancel = true;
+
+	CHECK(!test_submit(q, &blocker, NULL));
+	CHECK(os_wait_event(blocker.started, OS_WAIT_INFINITE));
+	CHECK(!test_submit(q, &tj, NULL));
+
+	CHECK(!ufprog_job_queue_destroy(q));
+
+	CHECK(blocker.completed && blocker.result == UFP_CANCELLED);
+	CHECK(tj.completed && tj.result == UFP_CANCELLED);
+
+	os_free_event(blocker.started);
+
+	return 0;
+}
+
+static int test_worker_count(void)
+{
+	struct ufprog_job_queue *q;
+
+	CHECK(!ufprog_job_queue_create(0, &q));
+	CHECK(ufprog_job_queue_workers(q) == 1);
+	CHECK(!ufprog_job_queue_destroy(q));
+
+	CHECK(!ufprog_job_queue_create(4, &q));
+	CHECK(ufprog_job_queue_workers(q) == 4);
+	CHECK(!ufprog_job_queue_destroy(q));
+
+	return 0;
+}
+
+static int ufprog_main(int argc, char *argv[])
+{
+	set_os_default_log_print();
+	os_init();
+
+	if (test_queue_order_cancel() || test_cancel_running() || test_destroy_pending() || test_worker_count())
+		return 1;
+
+	os_printf("All job queue tests passed\n");
+
+	return 0;
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t *argv[])
+#else
+int main(int argc, char *argv[])
+#endif
+{
+	return os_main(ufprog_main, argc, argv);
+}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: LGPL-2.1-only
+/*
+ * Author: Weijie Gao <hackpascal@gmail.com>
+ *
+ * NAND block torture test against a simulated chip
+ */
+
+#include <malloc.h>
+#include <ufprog/osdef.h>
+#include "nand-sim.h"
+
+#define CHECK(_cond)								\
+	do {									\
+		if (!(_cond)) {							\
+			os_fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				   __FILE__, __LINE__, #_cond);			\
+			return 1;						\
+		}								\
+	} while (0)
+
+#define SIM_BLOCKS				8
+
+static const struct nand_memorg sim_memorg = {
+	.num_chips = 1,
+	.luns_per_cs = 1,
+	.blocks_per_lun = SIM_BLOCKS,
+	.pages_per_block = 4,
+	.page_size = 512,
+	.oob_size = 16,
+	.planes_per_lun = 1,
+};
+
+static bool block_all_ff(struct nand_sim *sim, uint32_t block)
+{
+	const uint8_t *p = sim->array + (size_t)block * sim->nand.maux.oob_block_size;
+	uint32_t i;
+
+	for (i = 0; i < sim->nand.maux.oob_block_size; i++) {
+		if (p[i] != 0xff)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Chip allowing multiple partial programs, so the no-erase pass runs. Good blocks must pass and be left erased, and
+ * each injected fault must fail the block.
+ */
+static int test_torture_faults(void)
+{
+	static const uint32_t faults[SIM_BLOCKS] = {
+		[2] = NAND_SIM_F_STUCK_0,
+		[3] = NAND_SIM_F_STUCK_1,
+		[5] = NAND_SIM_F_ERASE_FAIL,
+		[6] = NAND_SIM_F_NO_REPROGRAM,
+	};
+	struct nand_sim *sim;
+	ufprog_status ret;
+	uint32_t block;
+	void *buf;
+
+	CHECK(!nand_sim_create(&sim_memorg, true, 4, &sim));
+
+	buf = malloc(sim->nand.maux.oob_block_size);
+	CHECK(buf);
+
+	for (block = 0; block < SIM_BLOCKS; block++)
+		nand_sim_inject(sim, block, faults[block]);
+
+	/* One buffer is reused for all blocks, as the screen command does */
+	for (block = 0; block < SIM_BLOCKS; block++) {
+		ret = ufprog_nand_torture_block_with_buf(&sim->nand, block, buf);
+
+		if (faults[block]) {
+			CHECK(ret != UFP_OK);
+			continue;
+		}
+
+		CHECK(ret == UFP_OK);
+		CHECK(block_all_ff(sim, block));
+
+		/* Two pattern passes and the final erase */
+		CHECK(sim->erase_count[block] == 3);
+	}
+
+	/* Allocating variant */
+	CHECK(ufprog_nand_torture_block(&sim->nand, 0) == UFP_OK);
+	CHECK(ufprog_nand_torture_block(&sim->nand, 3) != UFP_OK);
+
+	CHECK(ufprog_nand_torture_block_with_buf(&sim->nand, SIM_BLOCKS, buf) == UFP_INVALID_PARAMETER);
+
+	free(buf);
+	nand_sim_free(sim);
+
+	return 0;
+}
+
+/* The no-erase pass is skipped on chips allowing only one program per page */
+static int test_torture_single_program(void)
+{
+	struct nand_sim *sim;
+
+	CHECK(!nand_sim_create(&sim_memorg, false, 1, &sim));
+
+	nand_sim_inject(sim, 1, NAND_SIM_F_NO_REPROGRAM);
+	nand_sim_inject(sim, 2, NAND_SIM_F_STUCK_1);
+
+	CHECK(ufprog_nand_torture_block(&sim->nand, 0) == UFP_OK);
+	CHECK(ufprog_nand_torture_block(&sim->nand, 1) == UFP_OK);
+	CHECK(ufprog_nand_torture_block(&sim->nand, 2) != UFP_OK);
+
+	nand_sim_free(sim);
+
+	return 0;
+}
+
+static int ufprog_main(int argc, char *argv[])
+{
+	set_os_default_log_print();
+	os_init();
+
+	if (test_torture_faults() || test_torture_single_program())
+		return 1;
+
+	os_printf("All NAND torture tests passed\n");
+
+	return 0;
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t *argv[])
+#else
+int main(int argc, char *argv[])
+#endif
+{
+	return os_main(ufprog_main, argc, argv);
+}